@@ -25,17 +25,20 @@
 #include <opendnp3/APL/AsyncTaskContinuous.h>
 #include <opendnp3/APL/AsyncTaskGroup.h>
 #include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/TimingTools.h>
 
 #include <APLTestTools/MockTimerSource.h>
 
 #include <boost/bind.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <iostream>
 #include <queue>
 
 using namespace apl;
 using namespace boost;
 using namespace boost::posix_time;
 
+#define OUTPUT_PERF_NUMBERS	(0)
 
 
 class MockTaskHandler
@@ -260,4 +263,40 @@ BOOST_AUTO_TEST_CASE(TimerUsage)
 	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(true);
 }
 
+// Completes tasks in a large group, each completion selects the next task and
+// possibly rearms the group timer
+BOOST_AUTO_TEST_CASE(SchedulerBenchmark)
+{
+	const size_t NUM_TASKS = 5000;
+	const size_t NUM_COMPLETIONS = 20000;
+
+	MockTaskHandler mth;
+	MockTimerSource mts;
+	MockTimeSource fake_time;
+	AsyncTaskScheduler ats(&mts, &fake_time);
+
+	fake_time.SetToNow();
+
+	AsyncTaskGroup* pGroup = ats.CreateNewGroup();
+	for(size_t i = 0; i < NUM_TASKS; ++i) {
+		pGroup->Add(1000 + (i % 100) * 10, 100, i % 4, mth.GetHandler());
+	}
+
+	StopWatch sw;
+	pGroup->Enable();
+
+	for(size_t i = 0; i < NUM_COMPLETIONS; ++i) {
+		while(mth.Size() == 0) {
+			fake_time.Advance(10);
+			BOOST_REQUIRE(mts.DispatchOne());
+		}
+		mth.Complete((i % 10) != 0);
+	}
+
+	if (OUTPUT_PERF_NUMBERS) {
+		double elapsed_sec = sw.Elapsed() / 1000.0;
+		std::cout << "tasks: " << NUM_TASKS << " completions/sec: " << NUM_COMPLETIONS / elapsed_sec << std::endl;
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+#include <APLTestTools/MockNotifier.h>
+
+#include <opendnp3/APL/ChangeBuffer.h>
+#include <opendnp3/APL/FlexibleDataObserver.h>
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/MultiplexingDataObserver.h>
+#include <opendnp3/APL/TimingTools.h>
+
+#include <iostream>
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
+using namespace std;
+using namespace apl;
+
+namespace
+{
+void Write(IDataObserver* apObs, const Analog& arValue, size_t aIndex)
+{
+	Transaction tr(apObs);
+	apObs->Update(arValue, aIndex);
+}
+
+// counts how many analog batches it is handed
+class BatchCountingFDO : public FlexibleDataObserver
+{
+public:
+	BatchCountingFDO() : mNumBatches(0) {}
+
+	size_t mNumBatches;
+
+protected:
+	void _UpdateBatch(const Analog* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		++mNumBatches;
+		FlexibleDataObserver::_UpdateBatch(apValues, apIndices, aCount);
+	}
+};
+}
+
+BOOST_AUTO_TEST_SUITE(ChangeBufferSuite)
+
+BOOST_AUTO_TEST_CASE(QueuedModeKeepsEveryUpdate)
+{
+	ChangeBuffer<NullLock> buffer;
+	FlexibleDataObserver fdo;
+
+	Write(&buffer, Analog(1), 0);
+	Write(&buffer, Analog(2), 0);
+	Write(&buffer, Analog(3), 1);
+
+	BOOST_REQUIRE_EQUAL(buffer.FlushUpdates(&fdo), 3);
+	BOOST_REQUIRE_EQUAL(fdo.mAnalogMap[0].GetValue(), 2);
+	BOOST_REQUIRE_EQUAL(fdo.mAnalogMap[1].GetValue(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(CoalescingModeKeepsLatestValue)
+{
+	ChangeBuffer<NullLock> buffer(true);
+	FlexibleDataObserver fdo;
+
+	Write(&buffer, Analog(1), 4);
+	Write(&buffer, Analog(2), 0);
+	Write(&buffer, Analog(3), 4);
+
+	BOOST_REQUIRE_EQUAL(buffer.FlushUpdates(&fdo), 2);
+	BOOST_REQUIRE_EQUAL(fdo.mAnalogMap[4].GetValue(), 3);
+	BOOST_REQUIRE_EQUAL(fdo.mAnalogMap[0].GetValue(), 2);
+
+	// the table is empty after a flush
+	BOOST_REQUIRE_EQUAL(buffer.FlushUpdates(&fdo), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FlushPassesOneBatchPerType)
+{
+	for(size_t i = 0; i < 2; ++i) {
+		ChangeBuffer<NullLock> buffer(i == 1);
+		BatchCountingFDO fdo1;
+		BatchCountingFDO fdo2;
+		MultiplexingDataObserver mux(&fdo1, &fdo2);
+
+		Write(&buffer, Analog(1), 0);
+		Write(&buffer, Analog(2), 1);
+		Write(&buffer, Analog(3), 2);
+
+		BOOST_REQUIRE_EQUAL(buffer.FlushUpdates(&mux), 3);
+		BOOST_REQUIRE_EQUAL(fdo1.mNumBatches, 1);
+		BOOST_REQUIRE_EQUAL(fdo2.mNumBatches, 1);
+		BOOST_REQUIRE_EQUAL(fdo2.mAnalogMap.size(), 3);
+		BOOST_REQUIRE_EQUAL(fdo2.mAnalogMap[2].GetValue(), 3);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(OneNotificationPerFlush)
+{
+	MockNotifier mn;
+	ChangeBuffer<NullLock> buffer;
+	buffer.AddObserver(&mn);
+	FlexibleDataObserver fdo;
+
+	Write(&buffer, Analog(1), 0);
+	Write(&buffer, Analog(2), 0);
+	BOOST_REQUIRE_EQUAL(mn.GetNotifications(), 1);
+
+	buffer.FlushUpdates(&fdo);
+	BOOST_REQUIRE_EQUAL(mn.GetNotifications(), 1);
+
+	Write(&buffer, Analog(3), 0);
+	BOOST_REQUIRE_EQUAL(mn.GetNotifications(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyTransactionDoesNotNotify)
+{
+	MockNotifier mn;
+	ChangeBuffer<NullLock> buffer(true);
+	buffer.AddObserver(&mn);
+
+	{
+		Transaction tr(&buffer);
+	}
+	BOOST_REQUIRE_EQUAL(mn.GetNotifications(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(QueuedVersusCoalescingThroughput)
+{
+	const size_t NUM_POINTS = 1000;
+	const size_t NUM_ROUNDS = 50;
+
+	for(int mode = 0; mode < 2; ++mode) {
+		MockNotifier mn;
+		ChangeBuffer<SigLock> buffer(mode != 0);
+		buffer.AddObserver(&mn);
+		FlexibleDataObserver fdo;
+
+		StopWatch sw;
+		millis_t flushTime = 0;
+		for(size_t r = 0; r < NUM_ROUNDS; ++r) {
+			// several producer transactions per flush of the stack thread
+			for(size_t t = 0; t < 10; ++t) {
+				Transaction tr(&buffer);
+				for(size_t i = 0; i < NUM_POINTS; ++i) buffer.Update(Analog(static_cast<double>(r + t)), i);
+			}
+			StopWatch flush;
+			buffer.FlushUpdates(&fdo);
+			flushTime += flush.Elapsed();
+		}
+
+		BOOST_REQUIRE_EQUAL(mn.GetNotifications(), NUM_ROUNDS);
+		BOOST_REQUIRE_EQUAL(fdo.mAnalogMap[NUM_POINTS - 1].GetValue(), NUM_ROUNDS + 8);
+
+		if (OUTPUT_PERF_NUMBERS) {
+			double elapsed_sec = sw.Elapsed() / 1000.0;
+			cout << (mode ? "coalescing" : "queued") << " updates/sec: " << (NUM_ROUNDS * 10 * NUM_POINTS) / elapsed_sec;
+			cout << " average flush ms: " << static_cast<double>(flushTime) / NUM_ROUNDS << endl;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -19,7 +19,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include <APLTestTools/TestHelpers.h>
+#include <opendnp3/APL/AsyncLogDispatcher.h>
 #include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/LogEntryCircularBuffer.h>
 #include <opendnp3/APL/LogToFile.h>
 #include <APLTestTools/LogTester.h>
 #include <opendnp3/APL/Exception.h>
@@ -145,6 +148,51 @@ BOOST_AUTO_TEST_CASE( LogErrorCounting)
 	BOOST_REQUIRE_EQUAL(log.NextErrorCode(), -1);
 }
 
+namespace
+{
+class Formatted
+{
+public:
+	Formatted(size_t& arCount) : mrCount(arCount) {}
+	size_t& mrCount;
+};
+
+std::ostream& operator<<(std::ostream& arStream, const Formatted& arFormatted)
+{
+	++arFormatted.mrCount;
+	return arStream << "formatted";
+}
+}
+
+BOOST_AUTO_TEST_CASE( UnconsumedBlocksAreNotFormatted )
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_INTERPRET, "LogTest");
+	size_t count = 0;
+
+	LOGGER_BLOCK(pLogger, LEV_INTERPRET, Formatted(count));
+	BOOST_REQUIRE_EQUAL(count, 0);
+
+	// a subscriber for a specific error code only consumes that code
+	LogEntryCircularBuffer buff;
+	log.AddLogSubscriber(&buff, 10);
+	LOGGER_BLOCK(pLogger, LEV_INTERPRET, Formatted(count));
+	BOOST_REQUIRE_EQUAL(count, 0);
+	ERROR_LOGGER_BLOCK(pLogger, LEV_INTERPRET, Formatted(count), 10);
+	BOOST_REQUIRE_EQUAL(count, 1);
+	BOOST_REQUIRE_EQUAL(buff.Count(), 1);
+
+	log.AddLogSubscriber(&buff);
+	LOGGER_BLOCK(pLogger, LEV_INTERPRET, Formatted(count));
+	BOOST_REQUIRE_EQUAL(count, 2);
+	LOGGER_BLOCK(pLogger, LEV_COMM, Formatted(count));
+	BOOST_REQUIRE_EQUAL(count, 2);
+
+	log.RemoveLogSubscriber(&buff);
+	LOGGER_BLOCK(pLogger, LEV_INTERPRET, Formatted(count));
+	BOOST_REQUIRE_EQUAL(count, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(LogToFileSuite)
@@ -167,3 +215,103 @@ BOOST_AUTO_TEST_CASE(AddRemove)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(AsyncLogDispatcherSuite)
+
+// Subscriber that holds up the dispatcher thread until it is released
+class BlockingSubscriber : public ILogBase
+{
+public:
+	BlockingSubscriber() : mBlocked(true), mEntered(false), mCount(0) {}
+
+	void Log(const LogEntry&) {
+		CriticalSection cs(&mLock);
+		mEntered = true;
+		cs.Broadcast();
+		while(mBlocked) cs.Wait();
+		++mCount;
+	}
+
+	void SetVar(const std::string&, const std::string&, int) {}
+
+	void WaitForEntry() {
+		CriticalSection cs(&mLock);
+		while(!mEntered) cs.Wait();
+	}
+
+	void Release() {
+		CriticalSection cs(&mLock);
+		mBlocked = false;
+		cs.Broadcast();
+	}
+
+	size_t Count() {
+		CriticalSection cs(&mLock);
+		return mCount;
+	}
+
+private:
+	SigLock mLock;
+	bool mBlocked;
+	bool mEntered;
+	size_t mCount;
+};
+
+BOOST_AUTO_TEST_CASE(DeliversAllEntries)
+{
+	EventLog log;
+	AsyncLogDispatcher dispatcher;
+	LogEntryCircularBuffer buff(1000);
+	dispatcher.AddLogSubscriber(&buff);
+	log.AddLogSubscriber(&dispatcher);
+	Logger* pLogger = log.GetLogger(LEV_DEBUG, "LogTest");
+
+	for(size_t i = 0; i < 100; ++i) pLogger->Log(LEV_DEBUG, LOCATION, "Test message");
+
+	dispatcher.Flush();
+	BOOST_REQUIRE_EQUAL(buff.Count(), 100);
+	BOOST_REQUIRE_EQUAL(dispatcher.GetQueueDepth(), 0);
+	BOOST_REQUIRE_EQUAL(dispatcher.GetNumDropped(), 0);
+
+	// nothing is delivered after the subscriber is removed
+	dispatcher.RemoveLogSubscriber(&buff);
+	pLogger->Log(LEV_DEBUG, LOCATION, "Test message");
+	dispatcher.Flush();
+	BOOST_REQUIRE_EQUAL(buff.Count(), 100);
+
+	log.RemoveLogSubscriber(&dispatcher);
+}
+
+BOOST_AUTO_TEST_CASE(DropsWhenQueueIsFull)
+{
+	BlockingSubscriber sub;
+	AsyncLogDispatcher dispatcher(2);
+	dispatcher.AddLogSubscriber(&sub);
+
+	LogEntry le(LEV_INFO, "LogTest", LOCATION, "Test message", -1);
+	dispatcher.Log(le);
+	sub.WaitForEntry();
+
+	// the dispatcher thread is stuck on the first entry, so only two more fit
+	for(size_t i = 0; i < 5; ++i) dispatcher.Log(le);
+	BOOST_REQUIRE_EQUAL(dispatcher.GetQueueDepth(), 2);
+	BOOST_REQUIRE_EQUAL(dispatcher.GetNumDropped(), 3);
+
+	sub.Release();
+	dispatcher.Flush();
+	BOOST_REQUIRE_EQUAL(sub.Count(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(DrainsOnDestruction)
+{
+	LogEntryCircularBuffer buff(1000);
+	{
+		AsyncLogDispatcher dispatcher;
+		dispatcher.AddLogSubscriber(&buff);
+		LogEntry le(LEV_INFO, "LogTest", LOCATION, "Test message", -1);
+		for(size_t i = 0; i < 50; ++i) dispatcher.Log(le);
+	}
+	BOOST_REQUIRE_EQUAL(buff.Count(), 50);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
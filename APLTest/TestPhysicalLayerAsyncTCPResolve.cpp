@@ -0,0 +1,216 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/PhysicalLayerAsyncTCPClient.h>
+#include <opendnp3/APL/PhysicalLayerAsyncTCPv4Server.h>
+#include <opendnp3/APL/LowerLayerToPhysAdapter.h>
+#include <opendnp3/APL/TimeSource.h>
+
+#include <APLTestTools/TestHelpers.h>
+#include <APLTestTools/AsyncTestObjectASIO.h>
+#include <APLTestTools/LogTester.h>
+#include <APLTestTools/MockUpperLayer.h>
+
+using namespace apl;
+using namespace boost;
+
+namespace
+{
+
+const boost::uint16_t PORT = 50000;
+
+/** Resolver hook that answers every lookup with a fixed result without touching DNS */
+class StubResolver
+{
+public:
+	StubResolver(boost::asio::io_service* apService) :
+		mpService(apService),
+		mAddress(boost::asio::ip::address::from_string("127.0.0.1")),
+		mDefer(false),
+		mNumLookups(0)
+	{}
+
+	void Resolve(const std::string& arHost, const PhysicalLayerAsyncTCPClient::ResolveHandler& arHandler) {
+		++mNumLookups;
+		if(mDefer) mPending = arHandler;
+		else mpService->post(boost::bind(arHandler, mError, mAddress));
+	}
+
+	void CompletePending() {
+		mpService->post(boost::bind(mPending, mError, mAddress));
+	}
+
+	boost::asio::io_service* mpService;
+	boost::system::error_code mError;
+	boost::asio::ip::address mAddress;
+	bool mDefer;
+	size_t mNumLookups;
+	PhysicalLayerAsyncTCPClient::ResolveHandler mPending;
+};
+
+TcpSettings MakeSettings(millis_t aCacheTTL, millis_t aFailureTTL)
+{
+	TcpSettings s("outstation.example", PORT);
+	s.mResolveCacheTTL = aCacheTTL;
+	s.mResolveFailureTTL = aFailureTTL;
+	return s;
+}
+
+class ResolveTestObject : public AsyncTestObjectASIO, public LogTester
+{
+public:
+	ResolveTestObject(millis_t aCacheTTL = 0, millis_t aFailureTTL = 0, FilterLevel aLevel = LEV_INFO) :
+		mResolver(this->GetService()),
+		mClient(mLog.GetLogger(aLevel, "TCPClient"), this->GetService(),
+		        boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), PORT),
+		        MakeSettings(aCacheTTL, aFailureTTL), &mTime),
+		mServer(mLog.GetLogger(aLevel, "TCPServer"), this->GetService(), TcpSettings("127.0.0.1", PORT)),
+		mClientAdapter(mLog.GetLogger(aLevel, "ClientAdapter"), &mClient),
+		mServerAdapter(mLog.GetLogger(aLevel, "ServerAdapter"), &mServer),
+		mClientUpper(mLog.GetLogger(aLevel, "ClientUpper")),
+		mServerUpper(mLog.GetLogger(aLevel, "ServerUpper"))
+	{
+		mClient.SetResolver(boost::bind(&StubResolver::Resolve, &mResolver, _1, _2));
+		mClientAdapter.SetUpperLayer(&mClientUpper);
+		mServerAdapter.SetUpperLayer(&mServerUpper);
+	}
+
+	// opens both ends and waits for the connection, then tears it down again
+	void ConnectAndClose() {
+		mServer.AsyncOpen();
+		mClient.AsyncOpen();
+		BOOST_REQUIRE(this->ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper)));
+		BOOST_REQUIRE(this->ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)));
+		mClient.AsyncClose();
+		BOOST_REQUIRE(this->ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper)));
+		BOOST_REQUIRE(this->ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)));
+	}
+
+	void FailOpen(size_t aNumFailures) {
+		mClient.AsyncOpen();
+		BOOST_REQUIRE(this->ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &mClientAdapter, aNumFailures)));
+	}
+
+	MockTimeSource mTime;
+	StubResolver mResolver;
+	PhysicalLayerAsyncTCPClient mClient;
+	PhysicalLayerAsyncTCPv4Server mServer;
+	LowerLayerToPhysAdapter mClientAdapter;
+	LowerLayerToPhysAdapter mServerAdapter;
+	MockUpperLayer mClientUpper;
+	MockUpperLayer mServerUpper;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncTCPResolveSuite)
+
+BOOST_AUTO_TEST_CASE(ConnectsThroughResolver)
+{
+	ResolveTestObject t;
+	t.ConnectAndClose();
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 1);
+}
+
+BOOST_AUTO_TEST_CASE(LiteralAddressIsNotResolved)
+{
+	ResolveTestObject t;
+	PhysicalLayerAsyncTCPClient client(t.mLog.GetLogger(LEV_INFO, "Literal"), t.GetService(),
+	                                   boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), PORT),
+	                                   TcpSettings("127.0.0.1", PORT));
+	client.SetResolver(boost::bind(&StubResolver::Resolve, &t.mResolver, _1, _2));
+	LowerLayerToPhysAdapter adapter(t.mLog.GetLogger(LEV_INFO, "LiteralAdapter"), &client);
+	MockUpperLayer upper(t.mLog.GetLogger(LEV_INFO, "LiteralUpper"));
+	adapter.SetUpperLayer(&upper);
+
+	t.mServer.AsyncOpen();
+	client.AsyncOpen();
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &upper)));
+	client.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &upper)));
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 0);
+}
+
+BOOST_AUTO_TEST_CASE(NoCachingByDefault)
+{
+	ResolveTestObject t;
+	t.mResolver.mError = boost::asio::error::host_not_found;
+	t.FailOpen(1);
+	t.FailOpen(2);
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 2);
+}
+
+BOOST_AUTO_TEST_CASE(SuccessIsCachedUntilTTL)
+{
+	ResolveTestObject t(1000, 0);
+
+	t.ConnectAndClose();
+	t.ConnectAndClose();
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 1);
+
+	t.mTime.Advance(1000);
+	t.ConnectAndClose();
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 2);
+}
+
+BOOST_AUTO_TEST_CASE(FailureIsCachedUntilTTL)
+{
+	ResolveTestObject t(0, 5000);
+	t.mResolver.mError = boost::asio::error::host_not_found;
+
+	t.FailOpen(1);
+	t.FailOpen(2);
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 1);
+
+	// once the negative entry expires the next open retries the lookup and succeeds
+	t.mTime.Advance(5000);
+	t.mResolver.mError = boost::system::error_code();
+	t.ConnectAndClose();
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 2);
+}
+
+BOOST_AUTO_TEST_CASE(CloseWhileResolving)
+{
+	ResolveTestObject t(1000, 1000);
+	t.mResolver.mDefer = true;
+
+	t.mClient.AsyncOpen();
+	t.mClient.AsyncClose();
+	t.mResolver.CompletePending();
+
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mClientAdapter, 1)));
+	BOOST_REQUIRE_FALSE(t.mClientUpper.IsLowerLayerUp());
+
+	// an aborted lookup is not cached
+	t.mResolver.mDefer = false;
+	t.mServer.AsyncOpen();
+	t.mClient.AsyncOpen();
+	BOOST_REQUIRE(t.ProceedUntil(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+	BOOST_REQUIRE_EQUAL(t.mResolver.mNumLookups, 2);
+	t.mClient.AsyncClose();
+	BOOST_REQUIRE(t.ProceedUntilFalse(boost::bind(&MockUpperLayer::IsLowerLayerUp, &t.mClientUpper)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
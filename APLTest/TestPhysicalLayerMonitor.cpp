@@ -23,6 +23,8 @@
 #include <opendnp3/APL/Exception.h>
 #include <opendnp3/APL/PhysicalLayerMonitor.h>
 #include <opendnp3/APL/PhysicalLayerMonitorStates.h>
+#include <opendnp3/APL/TimeSource.h>
+#include <opendnp3/APL/TokenBucket.h>
 #include <APLTestTools/MockTimerSource.h>
 #include <APLTestTools/MockPhysicalLayerAsync.h>
 #include <APLTestTools/TestHelpers.h>
@@ -30,6 +32,8 @@
 using namespace apl;
 using namespace boost;
 
+#define OUTPUT_PERF_NUMBERS	(0)
+
 class ConcretePhysicalLayerMonitor : public PhysicalLayerMonitor
 {
 public:
@@ -59,6 +63,7 @@ protected:
 	void OnPhysicalLayerCloseCallback() {
 		++mCloseCallbackCount;
 	}
+	void OnPhysicalLayerReadWriteFailureCallback() {}
 
 	void _OnReceive(const boost::uint8_t* apData, size_t aNumBytes) {}
 	void _OnSendSuccess() {}
@@ -367,3 +372,136 @@ BOOST_AUTO_TEST_CASE(SuspendWhileWaitingCancelsTimer)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(OpenBackoffTestSuite)
+
+BOOST_AUTO_TEST_CASE(BackoffValidatesArguments)
+{
+	BOOST_REQUIRE_THROW(ExponentialBackoff(-1), ArgumentException);
+	BOOST_REQUIRE_THROW(ExponentialBackoff(1000, 2000, -0.1), ArgumentException);
+	BOOST_REQUIRE_THROW(ExponentialBackoff(1000, 2000, 1.1), ArgumentException);
+	BOOST_REQUIRE_THROW(TokenBucket(-1.0, 1), ArgumentException);
+	BOOST_REQUIRE_THROW(TokenBucket(1.0, 0), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(RetryDelayIsFixedByDefault)
+{
+	TestObject test;
+	test.monitor.Start();
+
+	for(size_t i = 0; i < 5; ++i) {
+		test.phys.SignalOpenFailure();
+		BOOST_REQUIRE_EQUAL(1000, test.mts.GetLastDelay());
+		BOOST_REQUIRE(test.mts.DispatchOne());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(RetryDelayDoublesUpToTheMaximum)
+{
+	TestObject test;
+	test.monitor.SetOpenBackoff(5000, 0.0);
+	test.monitor.Start();
+
+	millis_t expected[] = {1000, 2000, 4000, 5000, 5000};
+	for(size_t i = 0; i < 5; ++i) {
+		test.phys.SignalOpenFailure();
+		BOOST_REQUIRE_EQUAL(expected[i], test.mts.GetLastDelay());
+		BOOST_REQUIRE_EQUAL(i + 1, test.monitor.GetNumOpenRetries());
+		BOOST_REQUIRE(test.mts.DispatchOne());
+	}
+
+	// a successful open starts over at the minimum
+	test.phys.SignalOpenSuccess();
+	BOOST_REQUIRE_EQUAL(0, test.monitor.GetNumOpenRetries());
+	BOOST_REQUIRE_EQUAL(1000, test.monitor.GetOpenRetryDelay());
+	test.phys.AsyncClose();
+	test.phys.SignalOpenFailure();
+	BOOST_REQUIRE_EQUAL(PLS_WAITING, test.monitor.GetState());
+	BOOST_REQUIRE_EQUAL(1000, test.mts.GetLastDelay());
+}
+
+BOOST_AUTO_TEST_CASE(JitterSpreadsOutChannelsThatFailTogether)
+{
+	const size_t NUM_CHANNELS = 200;
+	const size_t NUM_BUCKETS = 5;
+
+	EventLog log;
+	MockTimerSource mts;
+	std::vector<MockPhysicalLayerAsync*> phys;
+	std::vector<ConcretePhysicalLayerMonitor*> monitors;
+	size_t histogram[NUM_BUCKETS] = {0};
+
+	for(size_t i = 0; i < NUM_CHANNELS; ++i) {
+		phys.push_back(new MockPhysicalLayerAsync(log.GetLogger(LEV_INFO, "mock-phys")));
+		monitors.push_back(new ConcretePhysicalLayerMonitor(log.GetLogger(LEV_INFO, "test"), phys.back(), &mts));
+		monitors.back()->SetOpenBackoff(1000, 0.5);
+		monitors.back()->Start();
+	}
+
+	// every channel fails at once, the retries are spread uniformly over the last half of the delay
+	for(size_t i = 0; i < NUM_CHANNELS; ++i) {
+		phys[i]->SignalOpenFailure();
+		millis_t delay = mts.GetLastDelay();
+		BOOST_REQUIRE(delay > 500);
+		BOOST_REQUIRE(delay <= 1000);
+		++histogram[((delay - 501) * NUM_BUCKETS) / 500];
+	}
+
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) {
+		if(OUTPUT_PERF_NUMBERS) std::cout << (500 + i * 100) << "-" << (600 + i * 100) << "ms: " << histogram[i] << std::endl;
+		BOOST_REQUIRE(histogram[i] > NUM_CHANNELS / (4 * NUM_BUCKETS));
+	}
+
+	for(size_t i = 0; i < NUM_CHANNELS; ++i) {
+		monitors[i]->Shutdown();
+		delete monitors[i];
+		delete phys[i];
+	}
+}
+
+BOOST_AUTO_TEST_CASE(LimiterSpacesOutOpenRetries)
+{
+	const size_t NUM_CHANNELS = 10;
+
+	EventLog log;
+	MockTimerSource mts;
+	MockTimeManager time;
+	TokenBucket limiter(10.0, 2, &time);	// a retry every 100ms after a burst of 2
+	std::vector<MockPhysicalLayerAsync*> phys;
+	std::vector<ConcretePhysicalLayerMonitor*> monitors;
+
+	for(size_t i = 0; i < NUM_CHANNELS; ++i) {
+		phys.push_back(new MockPhysicalLayerAsync(log.GetLogger(LEV_INFO, "mock-phys")));
+		monitors.push_back(new ConcretePhysicalLayerMonitor(log.GetLogger(LEV_INFO, "test"), phys.back(), &mts));
+		monitors.back()->SetOpenLimiter(&limiter);
+		monitors.back()->Start();
+	}
+
+	for(size_t i = 0; i < NUM_CHANNELS; ++i) {
+		phys[i]->SignalOpenFailure();
+		millis_t expected = (i < 2) ? 1000 : 1000 + (i - 1) * 100;
+		BOOST_REQUIRE_EQUAL(expected, mts.GetLastDelay());
+	}
+	BOOST_REQUIRE_EQUAL(NUM_CHANNELS, limiter.NumPending());
+	BOOST_REQUIRE_EQUAL(NUM_CHANNELS - 2, limiter.NumDelayed());
+
+	// a retry that fires or is canceled returns its reservation
+	BOOST_REQUIRE(mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(NUM_CHANNELS - 1, limiter.NumPending());
+	monitors[NUM_CHANNELS - 1]->Suspend();
+	BOOST_REQUIRE_EQUAL(NUM_CHANNELS - 2, limiter.NumPending());
+
+	// once the bucket has refilled the full burst is available again
+	time.SetTime(time.GetTime() + 10000);
+	phys[0]->SignalOpenFailure();
+	BOOST_REQUIRE_EQUAL(1000, mts.GetLastDelay());
+
+	for(size_t i = 0; i < NUM_CHANNELS; ++i) {
+		monitors[i]->Shutdown();
+		delete monitors[i];
+		delete phys[i];
+	}
+	BOOST_REQUIRE_EQUAL(0, limiter.NumPending());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
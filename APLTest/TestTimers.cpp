@@ -22,17 +22,22 @@
 
 
 #include <opendnp3/APL/TimerSourceASIO.h>
+#include <opendnp3/APL/TimerWheelSource.h>
+#include <opendnp3/APL/TimingTools.h>
 #include <opendnp3/APL/Threadable.h>
 #include <opendnp3/APL/Thread.h>
 #include <opendnp3/APL/Exception.h>
 
 #include <map>
+#include <vector>
 #include <boost/bind.hpp>
 #include <boost/asio.hpp>
 
 using namespace std;
 using namespace apl;
 
+#define OUTPUT_PERF_NUMBERS	(0)
+
 class MockTimerHandler
 {
 public:
@@ -53,7 +58,7 @@ private:
 class MonotonicReceiver : private Threadable
 {
 public:
-	MonotonicReceiver(boost::asio::io_service* apSrv, TimerSourceASIO* apTimerSrc) :
+	MonotonicReceiver(boost::asio::io_service* apSrv, ITimerSource* apTimerSrc) :
 		mLast(-1),
 		mNum(0),
 		mMonotonic(true),
@@ -91,7 +96,7 @@ private:
 	bool mMonotonic;
 
 	boost::asio::io_service* mpSrv;
-	TimerSourceASIO* mpTimerSrc;
+	ITimerSource* mpTimerSrc;
 	ITimer* mpInfinite;
 
 	void Run() {
@@ -184,3 +189,187 @@ BOOST_AUTO_TEST_CASE(MultipleOutstanding)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+// Records the order in which timers expire and whether any of them expired early
+class OrderRecorder
+{
+public:
+	OrderRecorder() : mEarly(false)
+	{}
+
+	void Start(ITimerSource* apSource, int aId, millis_t aDelay) {
+		mExpected[aId] = boost::asio::deadline_timer::traits_type::now() + boost::posix_time::milliseconds(aDelay);
+		apSource->Start(mExpected[aId], boost::bind(&OrderRecorder::OnExpiration, this, aId));
+	}
+
+	void OnExpiration(int aId) {
+		mOrder.push_back(aId);
+		if(boost::asio::deadline_timer::traits_type::now() < mExpected[aId]) mEarly = true;
+	}
+
+	std::vector<int> mOrder;
+	std::map<int, boost::posix_time::ptime> mExpected;
+	bool mEarly;
+};
+
+BOOST_AUTO_TEST_SUITE(TimerWheel)
+
+BOOST_AUTO_TEST_CASE(TickMustBePositive)
+{
+	boost::asio::io_service srv;
+	BOOST_REQUIRE_THROW(TimerWheelSource(&srv, 0), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(SyncRethrowsExceptions)
+{
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv);
+	MonotonicReceiver rcv(&srv, &ts);
+
+	BOOST_REQUIRE_THROW(ts.PostSync(boost::bind(&Timers::ThrowInvalidStateException)), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(ExpiresInOrderAndNeverEarly)
+{
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv, 1);
+	OrderRecorder rec;
+
+	// 300ms is beyond the first level of the wheel and has to be cascaded
+	rec.Start(&ts, 3, 300);
+	rec.Start(&ts, 1, 5);
+	rec.Start(&ts, 2, 30);
+	rec.Start(&ts, 0, 0);
+
+	srv.run(); // runs until all of the timers have expired
+
+	BOOST_REQUIRE_EQUAL(4, rec.mOrder.size());
+	for(int i = 0; i < 4; ++i) BOOST_REQUIRE_EQUAL(i, rec.mOrder[i]);
+	BOOST_REQUIRE_FALSE(rec.mEarly);
+	BOOST_REQUIRE_EQUAL(0, ts.NumActive());
+}
+
+BOOST_AUTO_TEST_CASE(CancelationAndReuse)
+{
+	MockTimerHandler mth1;
+	MockTimerHandler mth2;
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv, 1);
+	ITimer* pT1 = ts.Start(5, boost::bind(&MockTimerHandler::OnExpiration, &mth1));
+	ITimer* pT2 = ts.Start(10, boost::bind(&MockTimerHandler::OnExpiration, &mth2));
+	BOOST_REQUIRE_NOT_EQUAL(pT1, pT2);
+	pT1->Cancel();
+	pT1->Cancel(); // a second cancel is ignored
+
+	BOOST_REQUIRE_EQUAL(1, ts.NumActive());
+	BOOST_REQUIRE_EQUAL(1, ts.NumIdle());
+	BOOST_REQUIRE_EQUAL(pT1, ts.Start(5, boost::bind(&MockTimerHandler::OnExpiration, &mth1))); // canceled timers are reused immediately
+	pT1->Cancel();
+
+	srv.run();
+	BOOST_REQUIRE_EQUAL(0, mth1.GetCount());
+	BOOST_REQUIRE_EQUAL(1, mth2.GetCount());
+}
+
+BOOST_AUTO_TEST_CASE(CancelingAllTimersReleasesTheService)
+{
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv);
+	ITimer* pInfinite = ts.StartInfinite();
+	ITimer* pTimer = ts.Start(60000, boost::bind(&Timers::ThrowInvalidStateException));
+	pTimer->Cancel();
+	pInfinite->Cancel();
+
+	StopWatch sw;
+	srv.run();
+	BOOST_REQUIRE(sw.Elapsed() < 1000);
+}
+
+BOOST_AUTO_TEST_CASE(InfiniteTimerKeepsServiceRunning)
+{
+	MockTimerHandler mth;
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv, 1);
+	ITimer* pInfinite = ts.StartInfinite();
+	ts.Start(300, boost::bind(&MockTimerHandler::OnExpiration, &mth));
+	ts.Start(400, boost::bind(&ITimer::Cancel, pInfinite));
+
+	srv.run();
+	BOOST_REQUIRE_EQUAL(1, mth.GetCount());
+	BOOST_REQUIRE_EQUAL(0, ts.NumActive());
+}
+
+BOOST_AUTO_TEST_CASE(IdleTimersAreBounded)
+{
+	MockTimerHandler mth;
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv, 1, 10);
+	for(int i = 0; i < 100; ++i) ts.Start(1, boost::bind(&MockTimerHandler::OnExpiration, &mth));
+
+	srv.run();
+	BOOST_REQUIRE_EQUAL(100, mth.GetCount());
+	BOOST_REQUIRE_EQUAL(10, ts.NumIdle());
+}
+
+BOOST_AUTO_TEST_CASE(UnusedIdleTimersAreReclaimed)
+{
+	MockTimerHandler mth;
+	boost::asio::io_service srv;
+	TimerWheelSource ts(&srv, 1);
+	for(int i = 0; i < 100; ++i) ts.Start(1, boost::bind(&MockTimerHandler::OnExpiration, &mth));
+	srv.run();
+	srv.reset();
+	BOOST_REQUIRE_EQUAL(100, ts.NumIdle());
+
+	// a single timer that spans a couple revolutions of the wheel, the other 99 idle timers aren't needed
+	ts.Start(600, boost::bind(&MockTimerHandler::OnExpiration, &mth));
+	srv.run();
+	BOOST_REQUIRE_EQUAL(101, mth.GetCount());
+	BOOST_REQUIRE_EQUAL(1, ts.NumIdle());
+}
+
+void StartCancelLoop(ITimerSource* apSource, boost::asio::io_service* apSrv, size_t aNumOps, const std::string& arName)
+{
+	const size_t OUTSTANDING = 1000;
+	std::vector<ITimer*> timers(OUTSTANDING, NULL);
+	MockTimerHandler mth;
+
+	StopWatch sw;
+	for(size_t i = 0; i < aNumOps; ++i) {
+		ITimer*& pTimer = timers[i % OUTSTANDING];
+		if(pTimer != NULL) pTimer->Cancel();
+		pTimer = apSource->Start(1000 + static_cast<millis_t>(i % 5000), boost::bind(&MockTimerHandler::OnExpiration, &mth));
+
+		// canceled ASIO timers are only recycled once their aborted handlers have run
+		if((i % OUTSTANDING) == 0) apSrv->poll();
+	}
+	for(size_t i = 0; i < OUTSTANDING; ++i) timers[i]->Cancel();
+	apSrv->poll();
+
+	BOOST_REQUIRE_EQUAL(0, mth.GetCount());
+
+	if(OUTPUT_PERF_NUMBERS) {
+		double sec = sw.Elapsed() / 1000.0;
+		cout << arName << " start/cancel ops/sec: " << (sec > 0 ? aNumOps / sec : 0) << endl;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(StartCancelBenchmark)
+{
+	const size_t NUM_OPS = 200000;
+
+	{
+		boost::asio::io_service srv;
+		TimerSourceASIO ts(&srv);
+		StartCancelLoop(&ts, &srv, NUM_OPS, "TimerSourceASIO");
+	}
+
+	{
+		boost::asio::io_service srv;
+		TimerWheelSource ts(&srv);
+		StartCancelLoop(&ts, &srv, NUM_OPS, "TimerWheelSource");
+		BOOST_REQUIRE_EQUAL(0, ts.NumActive());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
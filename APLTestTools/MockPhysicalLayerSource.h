@@ -41,6 +41,7 @@ public:
 
 	MockPhysicalLayerAsync* GetMock(const std::string& arName);
 
+	using IPhysicalLayerSource::AcquireLayer;
 	IPhysicalLayerAsync* AcquireLayer(const std::string& arName);
 	void ReleaseLayer(const std::string& arName);
 
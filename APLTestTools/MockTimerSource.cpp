@@ -27,7 +27,7 @@ using namespace boost::posix_time;
 namespace apl
 {
 
-MockTimerSource::MockTimerSource() : mPostIsSynchronous(false)
+MockTimerSource::MockTimerSource() : mPostIsSynchronous(false), mLastDelay(0)
 {
 
 }
@@ -88,6 +88,7 @@ void MockTimerSource::PostSync(const FunctionVoidZero& arHandler)
 
 ITimer* MockTimerSource::Start(millis_t aDelay, const FunctionVoidZero& arCallback)
 {
+	mLastDelay = aDelay;
 	ptime t =  microsec_clock::universal_time() + milliseconds(aDelay);
 	return Start(t, arCallback);
 }
@@ -98,6 +99,7 @@ ITimer* MockTimerSource::Start(const boost::posix_time::ptime& arTime, const Fun
 	if(mIdle.size() > 0) {
 		pTimer = mIdle.front();
 		mIdle.pop_front();
+		pTimer->mTime = arTime;
 		pTimer->mCallback = arCallback;
 	}
 	else {
@@ -60,6 +60,11 @@ public:
 	*/
 	size_t Dispatch(size_t aMaximum = std::numeric_limits<size_t>::max());
 
+	/** @returns The delay of the last timer started with a relative expiration */
+	millis_t GetLastDelay() {
+		return mLastDelay;
+	}
+
 	/** @returns The number of active, pending timers */
 	size_t NumActive() {
 		return mTimerMap.size() + mPostQueue.size();
@@ -74,6 +79,7 @@ private:
 	typedef std::deque<MockTimer*> TimerQueue;
 
 	bool mPostIsSynchronous;
+	millis_t mLastDelay;
 	PostQueue mPostQueue;
 	TimerMap mTimerMap;
 	TimerQueue mIdle;
@@ -56,6 +56,11 @@ void PhysicalLayerWrapper::AsyncWrite(const boost::uint8_t* apData, size_t apSiz
 	return mpProxy->AsyncWrite(apData, apSize);
 }
 
+void PhysicalLayerWrapper::AsyncWriteGather(const WriteSegment* apSegments, size_t aNumSegments)
+{
+	return mpProxy->AsyncWriteGather(apSegments, aNumSegments);
+}
+
 void PhysicalLayerWrapper::AsyncRead(boost::uint8_t* apData, size_t apSize)
 { 
 	return mpProxy->AsyncRead(apData, apSize);
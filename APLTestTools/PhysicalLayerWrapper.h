@@ -53,6 +53,7 @@ public:
 	void AsyncOpen();
 	void AsyncClose();
 	void AsyncWrite(const boost::uint8_t* apData, size_t apSize);
+	void AsyncWriteGather(const WriteSegment* apSegments, size_t aNumSegments);
 	void AsyncRead(boost::uint8_t* apData, size_t apSize);
 
 	void SetHandler(IHandlerAsync* apHandler);
@@ -19,6 +19,7 @@
 #ifndef __DATABASE_TEST_OBJECT_H_
 #define __DATABASE_TEST_OBJECT_H_
 
+#include <map>
 #include <queue>
 #include <opendnp3/DNP3/Database.h>
 #include <opendnp3/APL/Log.h>
@@ -58,6 +59,12 @@ public:
 		return std::numeric_limits<size_t>::max() - mVtoEvents.size();
 	}
 
+	void ReserveIndices(apl::DataTypes aType, size_t aNumIndices) {
+		mReserved[aType] = aNumIndices;
+	}
+
+	std::map<apl::DataTypes, size_t> mReserved;
+
 	std::deque<BinaryInfo> mBinaryEvents;
 	std::deque<AnalogInfo> mAnalogEvents;
 	std::deque<CounterInfo> mCounterEvents;
@@ -50,10 +50,13 @@ IntegrationTest::IntegrationTest(Logger* apLogger, FilterLevel aLevel, boost::ui
 {
 	this->InitLocalObserver();
 
+	// the reference values must be updated before any slave is notified,
+	// otherwise a fast master can compare against the previous values
+	mFanout.AddObserver(&mLocalFDO);
+
 	for (size_t i = 0; i < aNumPairs; ++i) {
 		AddStackPair(aLevel, aNumPoints);
 	}
-	mFanout.AddObserver(&mLocalFDO);
 }
 
 void IntegrationTest::InitLocalObserver()
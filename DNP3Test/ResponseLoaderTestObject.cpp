@@ -34,7 +34,8 @@ ResponseLoaderTestObject::ResponseLoaderTestObject() :
 	log(),
 	fdo(),
 	mpLogger(log.GetLogger(LEV_INFO, "rsp")),
-	vto(mpLogger)
+	vto(mpLogger),
+	mpStats(NULL)
 {}
 
 void ResponseLoaderTestObject::Load(const std::string& arAPDU)
@@ -45,7 +46,7 @@ void ResponseLoaderTestObject::Load(const std::string& arAPDU)
 	f.Write(hs, hs.Size());
 	f.Interpret();
 
-	ResponseLoader rl(mpLogger, &fdo, &vto);
+	ResponseLoader rl(mpLogger, &fdo, &vto, mpStats);
 	for(HeaderReadIterator hdr = f.BeginRead(); !hdr.IsEnd(); ++hdr) {
 		rl.Process(hdr);
 	}
@@ -34,6 +34,8 @@ namespace apl
 namespace dnp
 {
 
+class StackStatistics;
+
 class ResponseLoaderTestObject
 {
 public:
@@ -51,6 +53,7 @@ private: EventLog log;
 public: FlexibleDataObserver fdo;
 private: Logger* mpLogger;
 public: VtoReader vto;
+public: StackStatistics* mpStats;	// passed to the loader, NULL by default
 
 };
 
@@ -29,9 +29,9 @@
 using namespace apl;
 using namespace apl::dnp;
 
-StartupTeardownTest::StartupTeardownTest(FilterLevel aLevel, bool aImmediate) :
+StartupTeardownTest::StartupTeardownTest(FilterLevel aLevel, bool aImmediate, size_t aNumThreads, millis_t aTimerWheelTick) :
 	log(),
-	manager(log.GetLogger(aLevel, "mgr"))
+	manager(log.GetLogger(aLevel, "mgr"), aNumThreads, aTimerWheelTick)
 {
 	if(aImmediate) log.AddLogSubscriber(LogToStdio::Inst());
 }
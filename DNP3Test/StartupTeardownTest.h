@@ -46,7 +46,7 @@ class StartupTeardownTest
 {
 public:
 
-	StartupTeardownTest(FilterLevel aLevel, bool aImmediate = false);
+	StartupTeardownTest(FilterLevel aLevel, bool aImmediate = false, size_t aNumThreads = 1, millis_t aTimerWheelTick = 0);
 
 	void CreatePort(const std::string& arName, FilterLevel aLevel);
 	void AddMaster(const std::string& arName, const std::string& arPortName, boost::uint16_t aLocalAddress, FilterLevel aLevel);
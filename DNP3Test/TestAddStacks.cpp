@@ -0,0 +1,249 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/TimingTools.h>
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/SlaveStack.h>
+#include <opendnp3/DNP3/StackSpec.h>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+#include <iostream>
+
+using namespace apl;
+using namespace apl::dnp;
+using namespace std;
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
+namespace
+{
+
+// Adds client ports that never come online
+void AddPorts(AsyncStackManager& arMgr, size_t aNumPorts)
+{
+	for(size_t i = 0; i < aNumPorts; ++i) {
+		std::string port = "port" + boost::lexical_cast<std::string>(i);
+		arMgr.AddTCPv4Client(port, PhysLayerSettings(LEV_WARNING, 60000), TcpSettings("127.0.0.1", 20000));
+	}
+}
+
+MasterStackConfig MasterWithAddress(boost::uint16_t aLocalAddr)
+{
+	MasterStackConfig cfg;
+	cfg.link.LocalAddr = aLocalAddr;
+	return cfg;
+}
+
+SlaveStackConfig SlaveWithAddress(boost::uint16_t aLocalAddr)
+{
+	SlaveStackConfig cfg;
+	cfg.link.LocalAddr = aLocalAddr;
+	return cfg;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(AddStacksSuite)
+
+BOOST_AUTO_TEST_CASE(MastersAndSlavesAreAddedInOneBatch)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"), 2);
+	AddPorts(mgr, 2);
+
+	boost::shared_ptr<const DeviceTemplate> pDevice = boost::make_shared<DeviceTemplate>(5, 4, 3);
+
+	std::vector<StackSpec> specs;
+	for(boost::uint16_t i = 0; i < 10; ++i) {
+		std::string n = boost::lexical_cast<std::string>(i);
+		specs.push_back(StackSpec::Master("port0", "master" + n, LEV_WARNING, NULL, MasterWithAddress(i)));
+		specs.push_back(StackSpec::Slave("port1", "slave" + n, LEV_WARNING, NULL, SlaveWithAddress(i), pDevice));
+	}
+
+	mgr.AddStacks(specs);
+
+	BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), 20);
+	BOOST_REQUIRE_EQUAL(pDevice.use_count(), 11); // the template is shared, not copied
+	BOOST_FOREACH(const StackSpec& s, specs) {
+		if(s.mIsMaster) BOOST_REQUIRE(s.mpMasterCmdAcceptor != NULL);
+		else {
+			BOOST_REQUIRE(s.mpSlaveDataObserver != NULL);
+			SlaveStack* pSlave = dynamic_cast<SlaveStack*>(mgr.GetStack(s.mStackName));
+			BOOST_REQUIRE(pSlave != NULL);
+			BOOST_REQUIRE_EQUAL(pSlave->mDB.NumType(DT_BINARY), 5);
+			BOOST_REQUIRE_EQUAL(pSlave->mDB.NumType(DT_ANALOG), 4);
+			BOOST_REQUIRE_EQUAL(pSlave->mDB.NumType(DT_COUNTER), 3);
+		}
+	}
+
+	mgr.RemoveStack("master3");
+	mgr.RemoveStack("slave3");
+	BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), 18);
+}
+
+BOOST_AUTO_TEST_CASE(DuplicateNamesAreRejectedBeforeAnyStackIsAdded)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"));
+	AddPorts(mgr, 1);
+
+	std::vector<StackSpec> specs;
+	specs.push_back(StackSpec::Master("port0", "master", LEV_WARNING, NULL, MasterWithAddress(1)));
+	specs.push_back(StackSpec::Master("port0", "master", LEV_WARNING, NULL, MasterWithAddress(2)));
+	BOOST_REQUIRE_THROW(mgr.AddStacks(specs), ArgumentException);
+	BOOST_REQUIRE(mgr.GetStackNames().empty());
+
+	mgr.AddMaster("port0", "existing", LEV_WARNING, NULL, MasterWithAddress(3));
+	specs.resize(1);
+	specs.push_back(StackSpec::Master("port0", "existing", LEV_WARNING, NULL, MasterWithAddress(4)));
+	BOOST_REQUIRE_THROW(mgr.AddStacks(specs), ArgumentException);
+	BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(RouteConflictKeepsTheStacksBoundBeforeIt)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"));
+	AddPorts(mgr, 1);
+
+	std::vector<StackSpec> specs;
+	specs.push_back(StackSpec::Master("port0", "first", LEV_WARNING, NULL, MasterWithAddress(1)));
+	specs.push_back(StackSpec::Master("port0", "second", LEV_WARNING, NULL, MasterWithAddress(1)));
+	specs.push_back(StackSpec::Master("port0", "third", LEV_WARNING, NULL, MasterWithAddress(2)));
+	BOOST_REQUIRE_THROW(mgr.AddStacks(specs), ArgumentException);
+
+	std::vector<std::string> names = mgr.GetStackNames();
+	BOOST_REQUIRE_EQUAL(names.size(), 1);
+	BOOST_REQUIRE_EQUAL(names[0], "first");
+
+	// only the committed stack hands back its interface
+	BOOST_REQUIRE(specs[0].mpMasterCmdAcceptor != NULL);
+	BOOST_REQUIRE(specs[1].mpMasterCmdAcceptor == NULL);
+	BOOST_REQUIRE(specs[2].mpMasterCmdAcceptor == NULL);
+
+	// the unbound names and routes are free again
+	mgr.AddMaster("port0", "third", LEV_WARNING, NULL, MasterWithAddress(2));
+}
+
+BOOST_AUTO_TEST_CASE(RouteConflictAcrossSharedPortsUnbindsNothing)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"));
+	mgr.AddTCPv4SharedServer("server0", PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", 30300));
+	mgr.AddTCPv4SharedServer("server1", PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", 30300));
+
+	// the same route is free on each channel, but not on the endpoint they share
+	std::vector<StackSpec> specs;
+	specs.push_back(StackSpec::Slave("server0", "first", LEV_WARNING, NULL, SlaveWithAddress(1), boost::make_shared<DeviceTemplate>(1, 1, 1)));
+	specs.push_back(StackSpec::Slave("server1", "second", LEV_WARNING, NULL, SlaveWithAddress(1), boost::make_shared<DeviceTemplate>(1, 1, 1)));
+	BOOST_REQUIRE_THROW(mgr.AddStacks(specs), ArgumentException);
+
+	std::vector<std::string> names = mgr.GetStackNames();
+	BOOST_REQUIRE_EQUAL(names.size(), 1);
+	BOOST_REQUIRE_EQUAL(names[0], "first");
+	BOOST_REQUIRE(specs[0].mpSlaveDataObserver != NULL);
+	BOOST_REQUIRE(specs[1].mpSlaveDataObserver == NULL);
+
+	// the rejected stack was never bound, so its name is free and the first stack is intact
+	mgr.AddSlave("server1", "second", LEV_WARNING, NULL, SlaveWithAddress(2));
+	mgr.RemoveStack("first");
+	mgr.RemoveStack("second");
+	BOOST_REQUIRE(mgr.GetStackNames().empty());
+}
+
+BOOST_AUTO_TEST_CASE(DeviceTemplateDefaultNames)
+{
+	DeviceTemplate tmp(1, 0, 0, 0, 0, 0, 12);
+	BOOST_REQUIRE_EQUAL(tmp.mBinary[0].Name, "Binary0");
+	BOOST_REQUIRE_EQUAL(tmp.mSetpoints[9].Name, "Setpoint9");
+	BOOST_REQUIRE_EQUAL(tmp.mSetpoints[11].Name, "Setpoint11");
+}
+
+// Brings up the same slaves one at a time and in a single batch
+BOOST_AUTO_TEST_CASE(StartupTime)
+{
+	// a smoke-sized run unless the numbers are wanted
+#if OUTPUT_PERF_NUMBERS
+	const size_t NUM_PORTS = 50;
+	const size_t NUM_POINTS = 5000;
+#else
+	const size_t NUM_PORTS = 2;
+	const size_t NUM_POINTS = 10;
+#endif
+	const boost::uint16_t STACKS_PER_PORT = 10;
+
+	StopWatch sw;
+	boost::shared_ptr<const DeviceTemplate> pDevice = boost::make_shared<DeviceTemplate>(NUM_POINTS, NUM_POINTS, NUM_POINTS);
+	millis_t templ = sw.Elapsed();
+
+	EventLog log;
+	millis_t single = 0;
+	{
+		AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"), 4);
+		AddPorts(mgr, NUM_PORTS);
+		SlaveStackConfig cfg;
+		cfg.device = *pDevice;
+		sw.Restart();
+		for(size_t p = 0; p < NUM_PORTS; ++p) {
+			for(boost::uint16_t i = 0; i < STACKS_PER_PORT; ++i) {
+				cfg.link.LocalAddr = i;
+				std::string n = boost::lexical_cast<std::string>(p * STACKS_PER_PORT + i);
+				mgr.AddSlave("port" + boost::lexical_cast<std::string>(p), "slave" + n, LEV_WARNING, NULL, cfg);
+			}
+		}
+		single = sw.Elapsed();
+		BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), NUM_PORTS * STACKS_PER_PORT);
+	}
+
+	millis_t batch = 0;
+	{
+		AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"), 4);
+		AddPorts(mgr, NUM_PORTS);
+		sw.Restart();
+		std::vector<StackSpec> specs;
+		specs.reserve(NUM_PORTS * STACKS_PER_PORT);
+		for(size_t p = 0; p < NUM_PORTS; ++p) {
+			for(boost::uint16_t i = 0; i < STACKS_PER_PORT; ++i) {
+				std::string n = boost::lexical_cast<std::string>(p * STACKS_PER_PORT + i);
+				specs.push_back(StackSpec::Slave("port" + boost::lexical_cast<std::string>(p), "slave" + n, LEV_WARNING, NULL, SlaveWithAddress(i), pDevice));
+			}
+		}
+		mgr.AddStacks(specs);
+		batch = sw.Elapsed();
+		BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), NUM_PORTS * STACKS_PER_PORT);
+	}
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "stacks: " << NUM_PORTS * STACKS_PER_PORT << " points per type: " << NUM_POINTS << endl;
+		cout << "template ms: " << templ << endl;
+		cout << "one at a time ms: " << single << endl;
+		cout << "batch ms: " << batch << endl;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
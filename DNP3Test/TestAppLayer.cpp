@@ -19,6 +19,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/TimeSource.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 #include <APLTestTools/TestHelpers.h>
 #include <APLTestTools/BufferHelpers.h>
 
@@ -492,6 +494,33 @@ BOOST_AUTO_TEST_CASE(TestRetrieReentrancy)
 	BOOST_REQUIRE_EQUAL(t.lower.NumWrites(), 2);
 }
 
+/** Test that the latency is measured from the last retry to the first response */
+BOOST_AUTO_TEST_CASE(StatisticsCountRetriesAndResponseLatency)
+{
+	AppLayerTest t(true, 1);	// master
+	MockTimeSource clock;
+	clock.SetTime(TimeStamp_t(1000));
+	StackStatistics stats(&clock);
+	t.app.SetStatistics(&stats);
+	t.lower.ThisLayerUp(); ++t.state.NumLayerUp;
+
+	t.SendRequest(FC_READ, true, true, false, false);
+	clock.Advance(100);
+	BOOST_REQUIRE(t.mts.DispatchOne()); // timeout the response
+	BOOST_REQUIRE_EQUAL(t.lower.NumWrites(), 2);
+	clock.Advance(30);
+	t.SendUp(FC_RESPONSE, true, true, false, false, 0); ++t.state.NumFinalRsp;
+	BOOST_REQUIRE_EQUAL(t.state, t.user.mState);
+
+	StackStatisticsSnapshot s;
+	stats.Snapshot(s);
+	BOOST_REQUIRE_EQUAL(s.mAppRetries, 1);
+	BOOST_REQUIRE_EQUAL(s.mFragmentsTx, 2);
+	BOOST_REQUIRE_EQUAL(s.mFragmentsRx, 1);
+	BOOST_REQUIRE_EQUAL(s.mResponseLatency.Count(), 1);
+	BOOST_REQUIRE_EQUAL(s.mResponseLatency.Max(), 30);
+}
+
 BOOST_AUTO_TEST_CASE(LargeFrame)
 {
 	AppLayerTest t(true, 1);
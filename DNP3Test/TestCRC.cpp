@@ -20,7 +20,11 @@
 #include <boost/test/unit_test.hpp>
 #include <APLTestTools/TestHelpers.h>
 
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/RandomizedBuffer.h>
+#include <opendnp3/APL/TimingTools.h>
 #include <opendnp3/DNP3/DNPCrc.h>
+#include <opendnp3/DNP3/LinkFrame.h>
 #include <APLTestTools/BufferHelpers.h>
 
 #include <iostream>
@@ -29,10 +33,37 @@
 #include <sstream>
 
 
+#define OUTPUT_PERF_NUMBERS	(0)
+
 using namespace std;
 using namespace apl;
 using namespace apl::dnp;
 
+namespace
+{
+const CrcKernel KERNELS[] = { CK_SCALAR, CK_SLICE_8, CK_SLICE_16, CK_CLMUL };
+const char* KERNEL_NAMES[] = { "scalar", "slice-by-8", "slice-by-16", "clmul" };
+const size_t NUM_KERNELS = sizeof(KERNELS) / sizeof(CrcKernel);
+
+// restores the automatically selected kernel when a test ends
+class KernelGuard
+{
+public:
+	KernelGuard() : mKernel(DNPCrc::GetKernel()) {}
+	~KernelGuard() {
+		DNPCrc::SelectKernel(mKernel);
+	}
+private:
+	CrcKernel mKernel;
+};
+
+void FormatMaxFrame(LinkFrame& arFrame, RandomizedBuffer& arData)
+{
+	arData.Randomize();
+	arFrame.FormatUnconfirmedUserData(true, 1, 1024, arData, LS_MAX_USER_DATA_SIZE);
+}
+}
+
 
 BOOST_AUTO_TEST_SUITE(CRC)
 
@@ -43,4 +74,76 @@ BOOST_AUTO_TEST_CASE(CrcTest)
 	BOOST_REQUIRE_EQUAL(DNPCrc::CalcCrc(hs, 8), 0x21E9);
 }
 
+BOOST_AUTO_TEST_CASE(KernelsProduceSameCrc)
+{
+	RandomizedBuffer buffer(LS_MAX_FRAME_SIZE);
+
+	for(size_t i = 0; i < 100; ++i) {
+		buffer.Randomize();
+		for(size_t len = 0; len <= 40; ++len) {
+			unsigned int expected = DNPCrc::CalcCrc(buffer, len, CK_SCALAR);
+			for(size_t k = 0; k < NUM_KERNELS; ++k) {
+				if(!DNPCrc::IsSupported(KERNELS[k])) continue;
+				BOOST_REQUIRE_EQUAL(DNPCrc::CalcCrc(buffer, len, KERNELS[k]), expected);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(UnsupportedKernelThrows)
+{
+	if(DNPCrc::IsSupported(CK_CLMUL)) return;
+	BOOST_REQUIRE_THROW(DNPCrc::SelectKernel(CK_CLMUL), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(BodyValidationDetectsErrorsInAnyBlock)
+{
+	KernelGuard guard;
+	RandomizedBuffer data(LS_MAX_USER_DATA_SIZE);
+	LinkFrame frame;
+
+	for(size_t k = 0; k < NUM_KERNELS; ++k) {
+		if(!DNPCrc::IsSupported(KERNELS[k])) continue;
+		DNPCrc::SelectKernel(KERNELS[k]);
+		FormatMaxFrame(frame, data);
+
+		CopyableBuffer body(frame.GetBuffer() + LS_HEADER_SIZE, frame.GetSize() - LS_HEADER_SIZE);
+		BOOST_REQUIRE(LinkFrame::ValidateBodyCRC(body, LS_MAX_USER_DATA_SIZE));
+
+		// corrupt one byte in each block, including the partial block at the end
+		for(size_t i = 0; i < body.Size(); i += LS_DATA_PLUS_CRC_SIZE) {
+			body[i] ^= 0xFF;
+			BOOST_REQUIRE_FALSE(LinkFrame::ValidateBodyCRC(body, LS_MAX_USER_DATA_SIZE));
+			body[i] ^= 0xFF;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(KernelThroughput)
+{
+	const size_t NUM_FRAMES = 20000;
+
+	KernelGuard guard;
+	RandomizedBuffer data(LS_MAX_USER_DATA_SIZE);
+	LinkFrame frame;
+	FormatMaxFrame(frame, data);
+
+	for(size_t k = 0; k < NUM_KERNELS; ++k) {
+		if(!DNPCrc::IsSupported(KERNELS[k])) continue;
+		DNPCrc::SelectKernel(KERNELS[k]);
+
+		StopWatch sw;
+		size_t valid = 0;
+		for(size_t i = 0; i < NUM_FRAMES; ++i) {
+			if(LinkFrame::ValidateBodyCRC(frame.GetBuffer() + LS_HEADER_SIZE, LS_MAX_USER_DATA_SIZE)) ++valid;
+		}
+		BOOST_REQUIRE_EQUAL(valid, NUM_FRAMES);
+
+		if (OUTPUT_PERF_NUMBERS) {
+			double elapsed_sec = sw.Elapsed() / 1000.0;
+			cout << KERNEL_NAMES[k] << " frames/sec: " << NUM_FRAMES / elapsed_sec << endl;
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
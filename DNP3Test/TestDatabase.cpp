@@ -21,6 +21,12 @@
 
 #include "DatabaseTestObject.h"
 
+#include <opendnp3/DNP3/Objects.h>
+#include <opendnp3/DNP3/PointIndexMap.h>
+#include <opendnp3/DNP3/StaticEncodingCache.h>
+#include <opendnp3/DNP3/StaticPointStore.h>
+
+#include <algorithm>
 #include <limits>
 
 using namespace std;
@@ -193,4 +199,250 @@ BOOST_AUTO_TEST_CASE(CounterLastReportedChange)
 	TestBufferForEvent(true, Counter(0), t, t.buffer.mCounterEvents);
 }
 
+// the iterator adapter materializes the stored value, class and index
+BOOST_AUTO_TEST_CASE(StaticIteratorReadsStore)
+{
+	DatabaseTestObject t;
+	t.db.Configure(DT_ANALOG, 3, true);
+	t.db.SetClass(DT_ANALOG, 2, PC_CLASS_2);
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Analog(4.5, AQ_ONLINE), 2);
+	}
+
+	AnalogIterator itr;
+	t.db.Begin(itr);
+	BOOST_REQUIRE_EQUAL(itr->mValue.GetQuality(), AQ_ONLINE);
+	BOOST_REQUIRE_EQUAL(itr->mIndex, 0);
+
+	itr = itr + 2;
+	BOOST_REQUIRE_EQUAL(itr->mValue, Analog(4.5, AQ_ONLINE));
+	BOOST_REQUIRE_EQUAL(itr->mClass, PC_CLASS_2);
+	BOOST_REQUIRE_EQUAL(itr->mIndex, 2);
+}
+
+// binary state is kept in the quality byte and must survive going online
+BOOST_AUTO_TEST_CASE(StaticStoreKeepsBinaryState)
+{
+	StaticPointStore<Binary> store;
+	store.Resize(1);
+	store.Update(Binary(true, BQ_RESTART), 0);
+	store.SetAllQuality(BQ_ONLINE);
+
+	Binary b;
+	store.Read(0, b);
+	BOOST_REQUIRE(b.GetValue());
+	BOOST_REQUIRE_EQUAL(b.GetQuality(), BQ_ONLINE | BQ_STATE);
+}
+
+BOOST_AUTO_TEST_CASE(BatchDeadbandCheckMatchesSingle)
+{
+	StaticPointStore<Analog> store;
+	store.Resize(4);
+	for(size_t i = 0; i < 4; ++i) store.SetDeadband(i, 5);
+
+	double values[4] = { 4, -6, 5.5, Analog::MAX_VALUE };
+	boost::uint8_t exceeds[4];
+	store.CheckDeadbands(0, values, 4, exceeds);
+
+	for(size_t i = 0; i < 4; ++i) {
+		BOOST_REQUIRE_EQUAL(exceeds[i] != 0, Analog(values[i]).ShouldGenerateEvent(Analog(values[i]), 5, 0));
+	}
+	BOOST_REQUIRE_EQUAL(exceeds[0], 0);
+	BOOST_REQUIRE_EQUAL(exceeds[1], 1);
+}
+
+// Runs of consecutive indices go through CheckDeadbands, the result must match updating one point at a time
+BOOST_AUTO_TEST_CASE(BatchUpdatesReportTheSameEventsAsSingle)
+{
+	const size_t NUM = 200;
+	std::vector<size_t> idx;
+	for(size_t i = 0; i < NUM; ++i) idx.push_back(i < 150 ? i : i * 2); // a long run followed by gaps
+
+	DatabaseTestObject single;
+	DatabaseTestObject batch;
+	DatabaseTestObject* objects[] = { &single, &batch };
+	for(size_t o = 0; o < 2; ++o) {
+		objects[o]->db.Configure(DT_ANALOG, idx);
+		objects[o]->db.SetClass(DT_ANALOG, PC_CLASS_1);
+		for(size_t i = 0; i < NUM; ++i) objects[o]->db.SetDeadband(DT_ANALOG, idx[i], 5);
+	}
+
+	std::vector<Analog> values;
+	std::vector<boost::uint32_t> indices;
+	for(size_t i = 0; i < NUM; ++i) {
+		values.push_back(Analog((i % 3) * 4.0, AQ_ONLINE)); // 0, 4 and 8 from 0, only 8 exceeds the deadband
+		indices.push_back(static_cast<boost::uint32_t>(idx[(i * 7) % NUM]));
+	}
+	std::sort(indices.begin(), indices.begin() + 100); // sorted runs and scattered indices
+
+	{
+		Transaction tr(&single.db);
+		for(size_t i = 0; i < NUM; ++i) single.db.Update(values[i], indices[i]);
+	}
+	{
+		Transaction tr(&batch.db);
+		batch.db.UpdateBatch(&values[0], &indices[0], NUM);
+	}
+
+	BOOST_REQUIRE(single.buffer.mAnalogEvents.size() > 0);
+	BOOST_REQUIRE_EQUAL(batch.buffer.mAnalogEvents.size(), single.buffer.mAnalogEvents.size());
+	for(size_t i = 0; i < single.buffer.mAnalogEvents.size(); ++i) {
+		BOOST_REQUIRE_EQUAL(batch.buffer.mAnalogEvents[i].mIndex, single.buffer.mAnalogEvents[i].mIndex);
+		BOOST_REQUIRE_EQUAL(batch.buffer.mAnalogEvents[i].mValue, single.buffer.mAnalogEvents[i].mValue);
+	}
+
+	const boost::uint32_t bad[] = { 10, 11, 151 };
+	Analog vals[] = { Analog(1), Analog(2), Analog(3) };
+	Transaction tr(&batch.db);
+	BOOST_REQUIRE_THROW(batch.db.UpdateBatch(vals, bad, 3), IndexOutOfBoundsException);
+}
+
+BOOST_AUTO_TEST_CASE(StaticStoreTracksDirtyBlocks)
+{
+	StaticPointStore<Analog> store;
+	store.Resize(100);
+
+	std::vector<size_t> dirty;
+	store.TakeDirtyBlocks(dirty);
+	BOOST_REQUIRE_EQUAL(dirty.size(), store.NumBlocks()); // everything is dirty after a resize
+
+	// writing the value that is already stored doesn't dirty the block
+	Analog a; store.Read(40, a);
+	store.Update(a, 40);
+	dirty.clear(); store.TakeDirtyBlocks(dirty);
+	BOOST_REQUIRE(dirty.empty());
+
+	store.Update(Analog(3, AQ_ONLINE), 40);
+	store.Update(Analog(3, AQ_ONLINE), 99);
+	dirty.clear(); store.TakeDirtyBlocks(dirty);
+	BOOST_REQUIRE_EQUAL(dirty.size(), 2);
+	BOOST_REQUIRE_EQUAL(dirty[0], 40 / StaticPointStore<Analog>::POINTS_PER_BLOCK);
+	BOOST_REQUIRE_EQUAL(dirty[1], 99 / StaticPointStore<Analog>::POINTS_PER_BLOCK);
+}
+
+// the cached encoding is what the object would write, changes re-encode only their block
+BOOST_AUTO_TEST_CASE(StaticEncodingCacheReencodesDirtyBlocks)
+{
+	StaticPointStore<Analog> store;
+	store.Resize(100);
+	for(size_t i = 0; i < 100; ++i) store.Update(Analog(i, AQ_ONLINE), i);
+
+	StaticEncodingCache<Analog> cache;
+	const size_t SIZE = Group30Var1::Inst()->GetSize();
+	std::vector<boost::uint8_t> cached(100 * SIZE), direct(100 * SIZE);
+
+	cache.Write(store, Group30Var1::Inst(), 0, 100, &cached[0]);
+	BOOST_REQUIRE_EQUAL(cache.NumEncoded(), store.NumBlocks());
+	for(size_t i = 0; i < 100; ++i) {
+		Analog a; store.Read(i, a);
+		Group30Var1::Inst()->Write(&direct[i * SIZE], a);
+	}
+	BOOST_REQUIRE(cached == direct);
+
+	// nothing changed, a sub-range is copied out of the cache
+	cache.Write(store, Group30Var1::Inst(), 10, 5, &cached[0]);
+	BOOST_REQUIRE_EQUAL(cache.NumEncoded(), store.NumBlocks());
+	BOOST_REQUIRE_EQUAL(Group30Var1::Inst()->Read(&cached[0]), Analog(10, AQ_ONLINE));
+
+	// a change seen while writing another variation invalidates every variation
+	store.Update(Analog(1000, AQ_ONLINE), 70);
+	std::vector<boost::uint8_t> g30v3(Group30Var3::Inst()->GetSize());
+	cache.Write(store, Group30Var3::Inst(), 70, 1, &g30v3[0]);
+	BOOST_REQUIRE_EQUAL(Group30Var3::Inst()->Read(&g30v3[0]).GetValue(), 1000);
+
+	size_t encoded = cache.NumEncoded();
+	cache.Write(store, Group30Var1::Inst(), 70, 1, &cached[0]);
+	BOOST_REQUIRE_EQUAL(cache.NumEncoded(), encoded + 1);
+	BOOST_REQUIRE_EQUAL(Group30Var1::Inst()->Read(&cached[0]), Analog(1000, AQ_ONLINE));
+}
+
+BOOST_AUTO_TEST_CASE(PointIndexMapSparseLayout)
+{
+	size_t idx[] = { 0, 1, 2, 60000, 60001, 60100 };
+	PointIndexMap map;
+	map.SetSparse(std::vector<size_t>(idx, idx + 6));
+
+	BOOST_REQUIRE_FALSE(map.IsDense());
+	BOOST_REQUIRE_EQUAL(map.NumPoints(), 6);
+	BOOST_REQUIRE_EQUAL(map.MaxIndex(), 60100);
+	BOOST_REQUIRE_EQUAL(map.Runs().size(), 3);
+
+	size_t slot = 0;
+	BOOST_REQUIRE(map.FindSlot(60001, slot));
+	BOOST_REQUIRE_EQUAL(slot, 4);
+	BOOST_REQUIRE(map.FindSlot(60100, slot));
+	BOOST_REQUIRE_EQUAL(slot, 5);
+	BOOST_REQUIRE_FALSE(map.FindSlot(3, slot));
+	BOOST_REQUIRE_FALSE(map.FindSlot(60002, slot));
+	BOOST_REQUIRE_FALSE(map.FindSlot(70000, slot));
+
+	for(size_t i = 0; i < 6; ++i) BOOST_REQUIRE_EQUAL(map.IndexOf(i), idx[i]);
+
+	// runs are clipped to the requested range
+	std::vector<IndexRun> runs;
+	map.GetRuns(1, 60000, runs);
+	BOOST_REQUIRE_EQUAL(runs.size(), 2);
+	BOOST_REQUIRE_EQUAL(runs[0].mStart, 1);
+	BOOST_REQUIRE_EQUAL(runs[0].mCount, 2);
+	BOOST_REQUIRE_EQUAL(runs[0].mSlot, 1);
+	BOOST_REQUIRE_EQUAL(runs[1].mStart, 60000);
+	BOOST_REQUIRE_EQUAL(runs[1].mCount, 1);
+	BOOST_REQUIRE_EQUAL(runs[1].mSlot, 3);
+
+	runs.clear();
+	map.GetRuns(10, 59999, runs);
+	BOOST_REQUIRE(runs.empty());
+
+	// indices without gaps are stored densely
+	size_t contiguous[] = { 0, 1, 2 };
+	map.SetSparse(std::vector<size_t>(contiguous, contiguous + 3));
+	BOOST_REQUIRE(map.IsDense());
+
+	size_t unordered[] = { 0, 5, 5 };
+	BOOST_REQUIRE_THROW(map.SetSparse(std::vector<size_t>(unordered, unordered + 3)), ArgumentException);
+}
+
+// updates, classes and events use the index while the store only holds the configured points
+BOOST_AUTO_TEST_CASE(SparseDatabaseUpdates)
+{
+	size_t idx[] = { 0, 50, 60000 };
+	DatabaseTestObject t;
+	t.db.Configure(DT_ANALOG, std::vector<size_t>(idx, idx + 3), true);
+	t.db.SetClass(DT_ANALOG, 60000, PC_CLASS_2);
+
+	BOOST_REQUIRE_EQUAL(t.db.NumType(DT_ANALOG), 3);
+	BOOST_REQUIRE_EQUAL(t.db.MaxIndex(DT_ANALOG), 60000);
+	BOOST_REQUIRE_THROW(t.db.SetClass(DT_ANALOG, 1, PC_CLASS_1), Exception);
+
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Analog(7, AQ_ONLINE), 60000);
+		BOOST_REQUIRE_THROW(t.db.Update(Analog(7, AQ_ONLINE), 1), IndexOutOfBoundsException);
+	}
+
+	BOOST_REQUIRE_EQUAL(t.buffer.mAnalogEvents.size(), 1);
+	BOOST_REQUIRE_EQUAL(t.buffer.mAnalogEvents.front().mIndex, 60000);
+	BOOST_REQUIRE_EQUAL(t.buffer.mAnalogEvents.front().mClass, PC_CLASS_2);
+
+	AnalogIterator itr;
+	t.db.Begin(itr);
+	itr = itr + 2;
+	BOOST_REQUIRE_EQUAL(itr->mIndex, 60000);
+	BOOST_REQUIRE_EQUAL(itr->mValue, Analog(7, AQ_ONLINE));
+}
+
+BOOST_AUTO_TEST_CASE(EventBufferIsSizedWhenTypesAreConfigured)
+{
+	size_t idx[] = { 3, 900 };
+	DatabaseTestObject t;
+	t.db.Configure(DT_COUNTER, 5);
+	t.db.Configure(DT_ANALOG, std::vector<size_t>(idx, idx + 2));
+	t.db.Configure(DT_CONTROL_STATUS, 7);
+
+	BOOST_REQUIRE_EQUAL(t.buffer.mReserved.size(), 2);
+	BOOST_REQUIRE_EQUAL(t.buffer.mReserved[DT_COUNTER], 5);
+	BOOST_REQUIRE_EQUAL(t.buffer.mReserved[DT_ANALOG], 901);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -48,6 +48,44 @@ BOOST_AUTO_TEST_CASE(SingleIndexSorting)
 	b.Select(PC_CLASS_1);
 	BOOST_REQUIRE_EQUAL(b.Begin()->mValue.GetTime(), TimeStamp_t(2)); //prove the newest value was kept
 }
+
+BOOST_AUTO_TEST_CASE(SingleIndexOrderAfterDeselect)
+{
+	SingleEventBuffer<CounterEvent> b(10);
+
+	size_t indices[] = {5, 1, 9, 3};
+	for(size_t i = 0; i < 4; ++i) b.Update(Counter(i), (i % 2) ? PC_CLASS_2 : PC_CLASS_1, indices[i]);
+
+	BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_1), 2);
+	BOOST_REQUIRE_EQUAL(b.Deselect(), 2);
+	b.Update(Counter(7), PC_CLASS_1, 9); // replaces the existing event for index 9
+	BOOST_REQUIRE_EQUAL(b.Size(), 4);
+
+	size_t expected[] = {1, 3, 5, 9};
+	BOOST_REQUIRE_EQUAL(b.Select(PC_ALL_EVENTS), 4);
+	CounterEventIter itr = b.Begin();
+	for(size_t i = 0; i < 4; ++i, ++itr) BOOST_REQUIRE_EQUAL(itr->mIndex, expected[i]);
+}
+
+BOOST_AUTO_TEST_CASE(SingleIndexStormInArbitraryOrder)
+{
+	const size_t NUM = 10000;
+	SingleEventBuffer<CounterEvent> b(NUM);
+	b.ReserveIndices(NUM);
+	size_t capacity = b.Capacity();
+
+	// visits every index once in a scattered order
+	Counter c;
+	for(size_t i = 0; i < NUM; ++i) b.Update(c, PC_CLASS_1, (i * 7919) % NUM);
+
+	BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_1), NUM);
+	CounterEventIter itr = b.Begin();
+	for(size_t i = 0; i < NUM; ++i, ++itr) BOOST_REQUIRE_EQUAL(itr->mIndex, i);
+
+	// nothing grew while the events were buffered
+	BOOST_REQUIRE_EQUAL(b.Capacity(), capacity);
+	BOOST_REQUIRE_EQUAL(b.IndexCapacity(), NUM);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 // index is irrelevant in these tests, only insertion order matters
@@ -174,6 +212,52 @@ BOOST_AUTO_TEST_CASE(TimeBasedSorting)
 
 
 }
+
+BOOST_AUTO_TEST_CASE(DeselectRestoresInterleavedOrder)
+{
+	const size_t NUM = 10;
+	TimeOrderedEventBuffer<BinaryEvent> b(NUM);
+
+	Binary v;
+	for(size_t i = 0; i < NUM; ++i) {
+		v.SetTime(TimeStamp_t(i));
+		b.Update(v, (i % 2) ? PC_CLASS_2 : PC_CLASS_1, i);
+	}
+
+	BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_1), NUM / 2);
+	BOOST_REQUIRE_EQUAL(b.Deselect(), NUM / 2);
+
+	BOOST_REQUIRE_EQUAL(b.Select(PC_ALL_EVENTS), NUM);
+	BinaryEventIter itr = b.Begin();
+	for(size_t i = 0; i < NUM; ++i, ++itr) BOOST_REQUIRE_EQUAL(itr->mIndex, i);
+}
+
+BOOST_AUTO_TEST_CASE(EventStormReusesPreallocatedStore)
+{
+	const size_t NUM = 10000;
+	TimeOrderedEventBuffer<AnalogEvent> b(NUM);
+	size_t capacity = b.Capacity();
+	BOOST_REQUIRE(capacity > NUM);
+
+	Analog v;
+	for(size_t round = 0; round < 10; ++round) {
+		for(size_t i = 0; i < NUM; ++i) {
+			v.SetTime(TimeStamp_t(round * NUM + i));
+			b.Update(v, PC_CLASS_1, i);
+		}
+
+		// a failed response followed by a successful one
+		BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_1, NUM / 2), NUM / 2);
+		b.Deselect();
+		BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_1), NUM);
+		for(AnalogEventIter itr = b.Begin(); itr != b.Begin() + b.NumSelected(); ++itr) itr->mWritten = true;
+		BOOST_REQUIRE_EQUAL(b.ClearWrittenEvents(), NUM);
+		BOOST_REQUIRE_EQUAL(b.Size(), 0);
+	}
+
+	// the slab reserved at construction was reused for every round
+	BOOST_REQUIRE_EQUAL(b.Capacity(), capacity);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 /* vim: set ts=4 sw=4: */
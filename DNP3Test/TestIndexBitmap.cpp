@@ -0,0 +1,94 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/DNP3/IndexBitmap.h>
+
+#include <cstdlib>
+#include <set>
+
+using namespace std;
+using namespace apl;
+using namespace apl::dnp;
+
+BOOST_AUTO_TEST_SUITE(IndexBitmapSuite)
+
+BOOST_AUTO_TEST_CASE(NextFindsMembersAcrossWords)
+{
+	IndexBitmap b;
+	b.Resize(10000);
+	BOOST_REQUIRE_EQUAL(b.Next(0), IndexBitmap::NONE);
+
+	b.Set(63);
+	b.Set(64);
+	b.Set(9999);
+	BOOST_REQUIRE_EQUAL(b.Next(0), 63);
+	BOOST_REQUIRE_EQUAL(b.Next(64), 64);
+	BOOST_REQUIRE_EQUAL(b.Next(65), 9999);
+	BOOST_REQUIRE_EQUAL(b.Next(10000), IndexBitmap::NONE);
+
+	b.Clear(64);
+	BOOST_REQUIRE_EQUAL(b.Next(64), 9999);
+	b.Clear(9999);
+	BOOST_REQUIRE_EQUAL(b.Next(64), IndexBitmap::NONE);
+	BOOST_REQUIRE_EQUAL(b.Next(0), 63);
+}
+
+BOOST_AUTO_TEST_CASE(ResizeKeepsMembers)
+{
+	IndexBitmap b;
+	b.Resize(10);
+	b.Set(7);
+	b.Resize(300000);
+	BOOST_REQUIRE_EQUAL(b.Size(), 300000);
+	BOOST_REQUIRE_EQUAL(b.Next(0), 7);
+	b.Set(299999);
+	BOOST_REQUIRE_EQUAL(b.Next(8), 299999);
+}
+
+// Random sets and clears agree with a std::set
+BOOST_AUTO_TEST_CASE(ChurnMatchesSet)
+{
+	const size_t SIZE = 5000;
+	IndexBitmap b;
+	b.Resize(SIZE);
+	std::set<size_t> reference;
+
+	srand(0);
+	for(size_t i = 0; i < 20000; ++i) {
+		size_t idx = rand() % SIZE;
+		if(rand() % 2) {
+			b.Set(idx);
+			reference.insert(idx);
+		}
+		else {
+			b.Clear(idx);
+			reference.erase(idx);
+		}
+
+		size_t from = rand() % SIZE;
+		std::set<size_t>::iterator j = reference.lower_bound(from);
+		BOOST_REQUIRE_EQUAL(b.Next(from), (j == reference.end()) ? IndexBitmap::NONE : *j);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
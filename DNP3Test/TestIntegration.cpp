@@ -83,6 +83,40 @@ BOOST_AUTO_TEST_CASE(MasterToSlaveThroughput)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(StackStatisticsArePolledWhileRunning)
+{
+	EventLog log;
+
+	IntegrationTest t(log.GetLogger(FILTER_LEVEL, "test"), FILTER_LEVEL, START_PORT, 1, 10);
+
+	t.IncrementData();
+	BOOST_REQUIRE(t.WaitForSameData(20000, true));
+
+	boost::uint64_t responses = 0;
+	std::vector<std::string> stacks = t.GetManager()->GetStackNames();
+	BOOST_REQUIRE_EQUAL(stacks.size(), 2);
+
+	for(size_t i = 0; i < stacks.size(); ++i) {
+		StackStatisticsSnapshot s;
+		t.GetManager()->GetStackStatistics(stacks[i], s);
+
+		BOOST_REQUIRE(s.mFramesRx > 0);
+		BOOST_REQUIRE(s.mFramesTx > 0);
+		BOOST_REQUIRE(s.mBytesRx >= 10 * s.mFramesRx);	// every frame has a 10 byte header
+		BOOST_REQUIRE(s.mBytesTx >= 10 * s.mFramesTx);
+		BOOST_REQUIRE(s.mFragmentsRx > 0);
+		BOOST_REQUIRE(s.mFragmentsTx > 0);
+		BOOST_REQUIRE_EQUAL(s.mCrcFailures, 0);
+		responses += s.mResponseLatency.Count();
+	}
+
+	// the master has received at least the integrity poll
+	BOOST_REQUIRE(responses > 0);
+
+	StackStatisticsSnapshot s;
+	BOOST_REQUIRE_THROW(t.GetManager()->GetStackStatistics("unknown", s), ArgumentException);
+}
+
 // TODO - Factor this test into smaller tests
 BOOST_AUTO_TEST_CASE(IntegrationTestConstructionDestruction)
 {
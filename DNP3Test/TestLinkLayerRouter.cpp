@@ -19,6 +19,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/bind.hpp>
 #include <APLTestTools/TestHelpers.h>
+#include <APLTestTools/BufferHelpers.h>
 
 #include <opendnp3/APL/Exception.h>
 #include <opendnp3/APL/ToHex.h>
@@ -28,6 +29,8 @@
 #include "LinkLayerRouterTest.h"
 #include "MockFrameSink.h"
 
+#include <memory.h>
+
 using namespace apl;
 using namespace apl::dnp;
 
@@ -173,4 +176,88 @@ BOOST_AUTO_TEST_CASE(MultiContextSend)
 	t.phys.SignalSendSuccess();
 	BOOST_REQUIRE_EQUAL(t.phys.NumWrites(), 2);
 }
+
+/// Test that frames queued while a write is outstanding are sent together in one write
+BOOST_AUTO_TEST_CASE(QueuedFramesAreBatched)
+{
+	LinkLayerRouterTest t;
+	MockFrameSink mfs1;
+	MockFrameSink mfs2;
+	t.router.AddContext(&mfs1, LinkRoute(1, 1024));
+	t.router.AddContext(&mfs2, LinkRoute(1, 2048));
+	LinkFrame f1; f1.FormatAck(true, false, 1, 1024);
+	LinkFrame f2; f2.FormatAck(true, false, 1, 2048);
+	LinkFrame f3; f3.FormatLinkStatus(true, false, 1, 1024);
+	t.phys.SignalOpenSuccess();
+	t.router.Transmit(f1);
+	t.router.Transmit(f2);
+	t.router.Transmit(f3);
+	BOOST_REQUIRE_EQUAL(t.phys.NumWrites(), 1);
+	t.phys.ClearBuffer();
+	t.phys.SignalSendSuccess();
+	BOOST_REQUIRE_EQUAL(t.phys.NumWrites(), 2);
+
+	ByteStr expected(f2.GetSize() + f3.GetSize());
+	memcpy(expected, f2.GetBuffer(), f2.GetSize());
+	memcpy(expected + f2.GetSize(), f3.GetBuffer(), f3.GetSize());
+	BOOST_REQUIRE(t.phys.BufferEquals(expected, expected.Size()));
+
+	t.phys.SignalSendSuccess();
+	BOOST_REQUIRE_EQUAL(t.phys.NumWrites(), 2);
+}
+
+/// Test that a stream of frames with unknown routes is logged once per interval with a count
+BOOST_AUTO_TEST_CASE(UnknownRoutesAreRateLimited)
+{
+	LinkLayerRouterTest t;
+	MockFrameSink mfs;
+	t.router.AddContext(&mfs, LinkRoute(1, 1024));
+	t.phys.SignalOpenSuccess();
+
+	for(size_t i = 0; i < 10; ++i) t.phys.TriggerRead("05 64 05 C0 01 00 00 04 E9 21");
+	BOOST_REQUIRE_EQUAL(t.router.GetNumUnknownRoutes(), 10);
+
+	LogEntry le;
+	BOOST_REQUIRE(t.GetNextEntry(le));
+	BOOST_REQUIRE_EQUAL(le.GetErrorCode(), DLERR_UNKNOWN_ROUTE);
+	BOOST_REQUIRE_FALSE(t.GetNextEntry(le));
+
+	// the rest are summed into one warning at the end of the interval
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE(t.GetNextEntry(le));
+	BOOST_REQUIRE_EQUAL(le.GetErrorCode(), DLERR_UNKNOWN_ROUTE);
+	int count;
+	BOOST_REQUIRE(le.GetValue("COUNT", count));
+	BOOST_REQUIRE_EQUAL(count, 9);
+
+	// a quiet interval ends the suppression, so the next one is logged right away
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_FALSE(t.GetNextEntry(le));
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
+	t.phys.TriggerRead("05 64 05 C0 01 00 00 04 E9 21");
+	BOOST_REQUIRE(t.GetNextEntry(le));
+	BOOST_REQUIRE_EQUAL(le.GetErrorCode(), DLERR_UNKNOWN_ROUTE);
+}
+
+/// Test that frames are counted per route in both directions
+BOOST_AUTO_TEST_CASE(FramesAreCountedPerRoute)
+{
+	LinkLayerRouterTest t;
+	MockFrameSink mfs;
+	t.router.AddContext(&mfs, LinkRoute(1, 1024));
+	t.phys.SignalOpenSuccess();
+
+	LinkFrame f; f.FormatAck(true, false, 1024, 1);
+	t.phys.TriggerRead(toHex(f.GetBuffer(), f.GetSize()));
+	t.phys.TriggerRead(toHex(f.GetBuffer(), f.GetSize()));
+	LinkFrame tx; tx.FormatAck(true, false, 1, 1024);
+	t.router.Transmit(tx);
+
+	RouteCounters c;
+	BOOST_REQUIRE(t.router.GetRouteCounters(LinkRoute(1, 1024), c));
+	BOOST_REQUIRE_EQUAL(c.mNumRx, 2);
+	BOOST_REQUIRE_EQUAL(c.mNumTx, 1);
+	BOOST_REQUIRE_FALSE(t.router.GetRouteCounters(LinkRoute(1024, 1), c));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -19,12 +19,18 @@
 #include <boost/test/unit_test.hpp>
 #include <APLTestTools/TestHelpers.h>
 
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/TimingTools.h>
+
 
 #include "LinkReceiverTest.h"
 #include "DNPHelpers.h"
 
 using namespace apl;
 using namespace apl::dnp;
+using namespace std;
+
+#define OUTPUT_PERF_NUMBERS	(0)
 
 
 
@@ -46,6 +52,7 @@ BOOST_AUTO_TEST_CASE(HeaderCRCError)
 	t.WriteData("05 64 05 C0 01 00 00 04 E9 20");
 	BOOST_REQUIRE_EQUAL(t.mSink.mNumFrames, 0);
 	BOOST_REQUIRE_EQUAL(t.NextErrorCode(), DLERR_CRC);
+	BOOST_REQUIRE_EQUAL(t.mRx.GetNumCrcFailures(), 1);
 }
 
 BOOST_AUTO_TEST_CASE(BodyCRCError)
@@ -54,6 +61,7 @@ BOOST_AUTO_TEST_CASE(BodyCRCError)
 	t.WriteData("05 64 14 F3 01 00 00 04 0A 3B C0 C3 01 3C 02 06 3C 03 06 3C 04 06 3C 01 06 9A 11");
 	BOOST_REQUIRE_EQUAL(t.mSink.mNumFrames, 0);
 	BOOST_REQUIRE_EQUAL(t.NextErrorCode(), DLERR_CRC);
+	BOOST_REQUIRE_EQUAL(t.mRx.GetNumCrcFailures(), 1);
 }
 
 //////////////////////////////////////////
@@ -289,4 +297,31 @@ BOOST_AUTO_TEST_CASE(ManyReceives)
 		BOOST_REQUIRE(t.mSink.CheckLastWithDFC(FC_SEC_ACK, true, false, 1, 2));
 	}
 }
+// Interpret logging is typically enabled with nothing subscribed to the log,
+// so the per frame log messages should cost next to nothing
+BOOST_AUTO_TEST_CASE(InterpretLoggingUnsubscribedThroughput)
+{
+	EventLog log;
+	MockFrameSink sink;
+	LinkLayerReceiver rx(log.GetLogger(LEV_INTERPRET, "ReceiverTest"), &sink);
+
+	ByteStr data(250, 0);
+	LinkFrame f;
+	f.FormatUnconfirmedUserData(true, 1, 1024, data, data.Size());
+
+	const size_t NUM_FRAMES = 100000;
+	StopWatch sw;
+	for(size_t i = 0; i < NUM_FRAMES; ++i) {
+		memcpy(rx.WriteBuff(), f.GetBuffer(), f.GetSize());
+		rx.OnRead(f.GetSize());
+		sink.ClearBuffer();
+	}
+	BOOST_REQUIRE_EQUAL(sink.mNumFrames, NUM_FRAMES);
+
+	if (OUTPUT_PERF_NUMBERS) {
+		double elapsed_sec = sw.Elapsed() / 1000.0;
+		cout << "frames/sec: " << NUM_FRAMES / elapsed_sec << endl;
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
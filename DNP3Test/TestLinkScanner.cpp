@@ -0,0 +1,275 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/ToHex.h>
+
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/LinkScanner.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <algorithm>
+#include <map>
+
+#include "LinkLayerRouterTest.h"
+
+using namespace apl;
+using namespace apl::dnp;
+
+class MockScanObserver : public ILinkScanObserver
+{
+public:
+	MockScanObserver() : mNumComplete(0)
+	{}
+
+	void OnAddressFound(const std::string&, boost::uint16_t aAddress) {
+		mFound.push_back(aAddress);
+	}
+
+	void OnScanComplete(const std::string&, const std::vector<boost::uint16_t>&) {
+		++mNumComplete;
+	}
+
+	std::vector<boost::uint16_t> mFound;
+	size_t mNumComplete;
+};
+
+// Collects the results of scans that run on the stack manager's threads
+class WaitingScanObserver : public ILinkScanObserver
+{
+public:
+	WaitingScanObserver() : mNumComplete(0)
+	{}
+
+	void OnAddressFound(const std::string&, boost::uint16_t) {}
+
+	void OnScanComplete(const std::string& arName, const std::vector<boost::uint16_t>& arFound) {
+		CriticalSection cs(&mLock);
+		mFound[arName] = arFound;
+		++mNumComplete;
+		cs.Signal();
+	}
+
+	bool WaitForComplete(size_t aNum, millis_t aTimeout) {
+		CriticalSection cs(&mLock);
+		while(mNumComplete < aNum) {
+			if(!cs.TimedWait(aTimeout)) return false;
+		}
+		return true;
+	}
+
+	SigLock mLock;
+	std::map<std::string, std::vector<boost::uint16_t> > mFound;
+	size_t mNumComplete;
+};
+
+class LinkScannerTest : public LinkLayerRouterTest
+{
+public:
+	LinkScannerTest(const LinkScanConfig& arCfg) :
+		scanner(mLog.GetLogger(LEV_WARNING, "Scanner"), "scan", &router, &mts, arCfg, &observer)
+	{}
+
+	// completes every write the router has started
+	void FlushWrites() {
+		while(phys.IsWriting()) phys.SignalSendSuccess();
+	}
+
+	// a device at aAddress answering a probe from the scanner
+	void Answer(boost::uint16_t aAddress) {
+		LinkFrame f;
+		f.FormatAck(false, false, 1, aAddress);
+		phys.TriggerRead(toHex(f.GetBuffer(), f.GetSize()));
+	}
+
+	MockScanObserver observer;
+	LinkScanner scanner;
+};
+
+BOOST_AUTO_TEST_SUITE(LinkScannerSuite)
+
+BOOST_AUTO_TEST_CASE(ConfigIsValidated)
+{
+	LinkLayerRouterTest t;
+	Logger* pLogger = t.mLog.GetLogger(LEV_WARNING, "Scanner");
+	LinkScanConfig reversed(20, 10);
+	BOOST_REQUIRE_THROW(LinkScanner(pLogger, "scan", &t.router, &t.mts, reversed, NULL), ArgumentException);
+	LinkScanConfig empty(10, 20);
+	empty.mWindow = 0;
+	BOOST_REQUIRE_THROW(LinkScanner(pLogger, "scan", &t.router, &t.mts, empty, NULL), ArgumentException);
+}
+
+// A full window of probes is sent before any of them times out
+BOOST_AUTO_TEST_CASE(WindowOfProbesIsOutstanding)
+{
+	LinkScanConfig cfg(10, 19);
+	cfg.mWindow = 4;
+	LinkScannerTest t(cfg);
+
+	t.scanner.Start();
+	t.phys.SignalOpenSuccess();
+	t.FlushWrites();
+
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 4);
+	BOOST_REQUIRE_EQUAL(t.scanner.NumProbed(), 0);
+	BOOST_REQUIRE_FALSE(t.scanner.IsComplete());
+}
+
+// Every address that answers is reported, not just the first
+BOOST_AUTO_TEST_CASE(AllRespondersAreReported)
+{
+	LinkScanConfig cfg(10, 19);
+	cfg.mWindow = 4;
+	cfg.mNumRetry = 0;
+	LinkScannerTest t(cfg);
+
+	t.scanner.Start();
+	t.phys.SignalOpenSuccess();
+
+	t.Answer(12);
+	t.Answer(11);
+	t.Answer(14); // probed in the slot freed by 12
+	BOOST_REQUIRE_EQUAL(t.scanner.NumProbed(), 3);
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 4);
+
+	t.FlushWrites();
+	t.mts.Dispatch();
+
+	BOOST_REQUIRE(t.scanner.IsComplete());
+	BOOST_REQUIRE_EQUAL(t.scanner.NumProbed(), 10);
+	BOOST_REQUIRE_EQUAL(t.observer.mNumComplete, 1);
+	BOOST_REQUIRE_EQUAL(t.observer.mFound.size(), 3);
+	BOOST_REQUIRE_EQUAL(t.observer.mFound[0], 12);
+	BOOST_REQUIRE_EQUAL(t.observer.mFound[1], 11);
+	BOOST_REQUIRE_EQUAL(t.observer.mFound[2], 14);
+	BOOST_REQUIRE(t.scanner.IsFound(14));
+	BOOST_REQUIRE_FALSE(t.scanner.IsFound(15));
+	BOOST_REQUIRE(t.IsLogErrorFree());
+}
+
+// Each probe is retried with its own timer before moving to the next address
+BOOST_AUTO_TEST_CASE(ProbesAreRetried)
+{
+	LinkScanConfig cfg(10, 10);
+	cfg.mNumRetry = 2;
+	LinkScannerTest t(cfg);
+
+	t.scanner.Start();
+	t.phys.SignalOpenSuccess();
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.FlushWrites();
+		BOOST_REQUIRE(t.mts.DispatchOne());
+		BOOST_REQUIRE_FALSE(t.scanner.IsComplete());
+	}
+
+	t.FlushWrites();
+	t.Answer(10);
+
+	BOOST_REQUIRE(t.scanner.IsComplete());
+	BOOST_REQUIRE_EQUAL(t.observer.mFound.size(), 1);
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
+}
+
+// Link status requests work as a probe as well as reset link states
+BOOST_AUTO_TEST_CASE(RequestLinkStatusProbe)
+{
+	LinkScanConfig cfg(10, 10);
+	cfg.mProbe = LSP_REQUEST_LINK_STATUS;
+	LinkScannerTest t(cfg);
+
+	t.scanner.Start();
+	t.phys.SignalOpenSuccess();
+
+	LinkFrame expected;
+	expected.FormatRequestLinkStatus(true, 10, 1);
+	BOOST_REQUIRE(t.phys.BufferEquals(expected.GetBuffer(), expected.GetSize()));
+
+	LinkFrame f;
+	f.FormatLinkStatus(false, false, 1, 10);
+	t.phys.TriggerRead(toHex(f.GetBuffer(), f.GetSize()));
+	BOOST_REQUIRE(t.scanner.IsFound(10));
+}
+
+// Addresses already bound to a stack are skipped rather than stealing the route
+BOOST_AUTO_TEST_CASE(BoundRoutesAreSkipped)
+{
+	LinkScanConfig cfg(10, 12);
+	LinkScannerTest t(cfg);
+	LinkScanConfig other(11, 11);
+	LinkScanner stack(t.mLog.GetLogger(LEV_WARNING, "Other"), "other", &t.router, &t.mts, other, NULL);
+
+	stack.Start();
+	t.scanner.Start();
+	t.phys.SignalOpenSuccess();
+	t.FlushWrites();
+
+	BOOST_REQUIRE_EQUAL(t.scanner.NumProbed(), 1);
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 3);
+}
+
+// Several ports are scanned at once from one stack manager
+BOOST_AUTO_TEST_CASE(PortsAreScannedConcurrently)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"), 2);
+
+	const boost::uint16_t port = 30200;
+	const boost::uint16_t SLAVES[] = {5, 7, 6};
+	const char* SERVERS[] = {"server0", "server0", "server1"};
+
+	mgr.AddTCPv4Server("server0", PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", port));
+	mgr.AddTCPv4Server("server1", PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", port + 1));
+	for(size_t i = 0; i < 3; ++i) {
+		SlaveStackConfig cfg;
+		cfg.link.LocalAddr = SLAVES[i];
+		mgr.AddSlave(SERVERS[i], std::string("slave") + static_cast<char>('0' + i), LEV_WARNING, NULL, cfg);
+	}
+
+	mgr.AddTCPv4Client("client0", PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", port));
+	mgr.AddTCPv4Client("client1", PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", port + 1));
+
+	LinkScanConfig scan(0, 19);
+	scan.mWindow = 8;
+	scan.mTimeout = 500;
+	WaitingScanObserver obs;
+	mgr.AddLinkScan("client0", LEV_WARNING, scan, &obs);
+	mgr.AddLinkScan("client1", LEV_WARNING, scan, &obs);
+	BOOST_REQUIRE_THROW(mgr.AddLinkScan("client1", LEV_WARNING, scan, &obs), ArgumentException);
+
+	BOOST_REQUIRE(obs.WaitForComplete(2, 20000));
+
+	std::vector<boost::uint16_t> found0 = obs.mFound["client0"];
+	std::sort(found0.begin(), found0.end());
+	BOOST_REQUIRE_EQUAL(found0.size(), 2);
+	BOOST_REQUIRE_EQUAL(found0[0], 5);
+	BOOST_REQUIRE_EQUAL(found0[1], 7);
+	BOOST_REQUIRE_EQUAL(obs.mFound["client1"].size(), 1);
+	BOOST_REQUIRE_EQUAL(obs.mFound["client1"][0], 6);
+
+	mgr.RemoveLinkScan("client0");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -578,6 +578,51 @@ BOOST_AUTO_TEST_CASE(SolicitedMultiFragResponse)
 	BOOST_REQUIRE(t.fdo.Check(false, BQ_RESTART, 3, TimeStamp_t(0)));
 }
 
+BOOST_AUTO_TEST_CASE(FreeFormPollSplitsRequests)
+{
+	MasterConfig master_cfg;
+	master_cfg.FragSize = 16; // room for two ranged headers per request
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	TestForIntegrityPoll(t);
+
+	std::unordered_map<DataTypes, std::vector<uint32_t>, std::EnumClassHash> points;
+	points[DataTypes::DT_ANALOG] = {24, 0, 1, 2, 3, 4, 10, 11, 12, 13, 14, 20, 21, 22, 23};
+	t.master.ScheduleFreeFormPoll(points);
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 1E 01 00 00 04 1E 01 00 0A 0E");
+	t.RespondToMaster("C0 81 00 00");
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 1E 01 00 14 18");
+	t.RespondToMaster("C0 81 00 00");
+
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FreeFormPollRestartsWhenPointsChange)
+{
+	MasterConfig master_cfg;
+	master_cfg.FragSize = 16;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	TestForIntegrityPoll(t);
+
+	std::unordered_map<DataTypes, std::vector<uint32_t>, std::EnumClassHash> points;
+	points[DataTypes::DT_ANALOG] = {24, 0, 1, 2, 3, 4, 10, 11, 12, 13, 14, 20, 21, 22, 23};
+	t.master.ScheduleFreeFormPoll(points);
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 1E 01 00 00 04 1E 01 00 0A 0E");
+
+	// the new plan only has one fragment, the second request must not be sent empty
+	points[DataTypes::DT_ANALOG] = {5};
+	t.master.ScheduleFreeFormPoll(points);
+	t.RespondToMaster("C0 81 00 00");
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 1E 01 00 05 05");
+	t.RespondToMaster("C0 81 00 00");
+
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(EventPoll)
 {
 	MasterConfig master_cfg;
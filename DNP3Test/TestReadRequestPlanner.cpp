@@ -0,0 +1,163 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/ObjectReadIterator.h>
+#include <opendnp3/DNP3/ReadRequestPlanner.h>
+#include <opendnp3/APL/ToHex.h>
+
+#include <set>
+
+using namespace apl;
+using namespace apl::dnp;
+using namespace std;
+
+std::string PlanToHex(ReadRequestPlanner& arPlanner, size_t aFragment = 0, size_t aFragSize = DEFAULT_FRAG_SIZE)
+{
+	APDU frag(aFragSize);
+	frag.Set(FC_READ);
+	arPlanner.Write(frag, aFragment);
+	return toHex(frag.GetBuffer(), frag.Size(), true);
+}
+
+std::vector<boost::uint32_t> Indices(boost::uint32_t aStart, boost::uint32_t aStop, boost::uint32_t aStep = 1)
+{
+	std::vector<boost::uint32_t> ret;
+	for(boost::uint32_t i = aStart; i <= aStop; i += aStep) ret.push_back(i);
+	return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(ReadRequestPlannerSuite)
+
+BOOST_AUTO_TEST_CASE(EmptyPlanWritesNothing)
+{
+	ReadRequestPlanner p;
+	BOOST_REQUIRE(p.IsEmpty());
+	BOOST_REQUIRE_EQUAL(p.NumFragments(2046), 0);
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01");
+}
+
+BOOST_AUTO_TEST_CASE(MergesContiguousIndices)
+{
+	ReadRequestPlanner p;
+	boost::uint32_t indices[] = {14, 3, 1, 2, 2, 10, 11, 12, 13};
+	p.AddPoints(Group30Var1::Inst(), std::vector<boost::uint32_t>(indices, indices + 9));
+
+	// a list header for 1-3 would cost 7 bytes vs 5 for the range
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01 1E 01 00 0A 0E 1E 01 00 01 03");
+}
+
+BOOST_AUTO_TEST_CASE(ScatteredIndicesUseIndexPrefix)
+{
+	ReadRequestPlanner p;
+	boost::uint32_t indices[] = {200, 9, 5, 1};
+	p.AddPoints(Group1Var2::Inst(), std::vector<boost::uint32_t>(indices, indices + 4));
+
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01 01 02 17 04 01 05 09 C8");
+}
+
+BOOST_AUTO_TEST_CASE(LargeIndicesUseTwoByteQualifiers)
+{
+	ReadRequestPlanner p;
+	std::vector<boost::uint32_t> indices = Indices(300, 310);
+	indices.push_back(1000);
+	p.AddPoints(Group20Var1::Inst(), indices);
+
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01 14 01 01 2C 01 36 01 14 01 01 E8 03 E8 03");
+
+	// two scattered points make a 2 byte index list cheaper than two ranges
+	p.AddPoints(Group20Var1::Inst(), std::vector<boost::uint32_t>(1, 2000));
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01 14 01 01 2C 01 36 01 14 01 28 02 00 E8 03 D0 07");
+}
+
+BOOST_AUTO_TEST_CASE(PointsAreMergedPerObject)
+{
+	ReadRequestPlanner p;
+	p.AddPoints(Group30Var1::Inst(), Indices(0, 4));
+	p.AddPoints(Group1Var2::Inst(), Indices(0, 4));
+	p.AddPoints(Group30Var1::Inst(), Indices(5, 9));
+
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01 1E 01 00 00 09 01 02 00 00 04");
+
+	p.Clear();
+	BOOST_REQUIRE(p.IsEmpty());
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01");
+}
+
+BOOST_AUTO_TEST_CASE(ReadOfLargeRangeIsNotTruncated)
+{
+	ReadRequestPlanner p;
+	p.AddPoints(Group30Var1::Inst(), Indices(0, 2999));
+
+	BOOST_REQUIRE_EQUAL(PlanToHex(p), "C0 01 1E 01 01 00 00 B7 0B");
+}
+
+BOOST_AUTO_TEST_CASE(SplitsAcrossFragments)
+{
+	const size_t FRAG_SIZE = 64;
+	const size_t CAPACITY = FRAG_SIZE - 2;
+
+	ReadRequestPlanner p;
+	std::vector<boost::uint32_t> indices = Indices(0, 1998, 2);
+	p.AddPoints(Group30Var1::Inst(), indices);
+
+	size_t num = p.NumFragments(CAPACITY);
+	BOOST_REQUIRE(num > 1);
+
+	std::set<size_t> read;
+	for(size_t i = 0; i < num; ++i) {
+		BOOST_REQUIRE(p.GetFragmentSize(CAPACITY, i) <= CAPACITY);
+
+		APDU frag(FRAG_SIZE);
+		frag.Set(FC_READ);
+		BOOST_REQUIRE(p.Write(frag, i) > 0);
+		BOOST_REQUIRE_EQUAL(frag.Size(), p.GetFragmentSize(CAPACITY, i) + 2);
+
+		APDU copy;
+		copy.Write(frag.GetBuffer(), frag.Size());
+		copy.Interpret();
+		for(HeaderReadIterator hdr = copy.BeginRead(); !hdr.IsEnd(); ++hdr) {
+			for(ObjectReadIterator obj = hdr.BeginRead(); !obj.IsEnd(); ++obj) {
+				BOOST_REQUIRE(read.insert(obj->Index()).second);
+			}
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(read.size(), indices.size());
+	BOOST_REQUIRE_EQUAL(*read.begin(), 0);
+	BOOST_REQUIRE_EQUAL(*read.rbegin(), 1998);
+}
+
+BOOST_AUTO_TEST_CASE(PlanIsRebuiltForNewCapacity)
+{
+	ReadRequestPlanner p;
+	p.AddPoints(Group30Var1::Inst(), Indices(0, 1998, 2));
+
+	size_t small = p.NumFragments(62);
+	size_t large = p.NumFragments(2046);
+	BOOST_REQUIRE(small > large);
+	BOOST_REQUIRE_EQUAL(p.NumFragments(62), small);
+	BOOST_REQUIRE_THROW(p.NumFragments(4), ArgumentException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -19,13 +19,24 @@
 #include <boost/test/unit_test.hpp>
 #include <APLTestTools/TestHelpers.h>
 
+#include <opendnp3/APL/TimeSource.h>
+#include <opendnp3/APL/TimingTools.h>
+#include <opendnp3/APL/ToHex.h>
+#include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/ResponseLoader.h>
+#include <opendnp3/DNP3/StackStatistics.h>
+
 #include "ResponseLoaderTestObject.h"
 
+#include <vector>
+
 
 using namespace apl;
 using namespace apl::dnp;
 using namespace boost;
 
+#define OUTPUT_PERF_NUMBERS	(0)
+
 
 BOOST_AUTO_TEST_SUITE(ResponseLoaderSuite)
 BOOST_AUTO_TEST_CASE(Group1Var1)
@@ -133,5 +144,249 @@ BOOST_AUTO_TEST_CASE(Group40Var2)
 	t.CheckSetpointStatii("C0 81 00 00 28 02 00 00 01 01 04 00 01 09 00");
 }
 
+// Only events are counted and only events with time can be aged
+BOOST_AUTO_TEST_CASE(EventStatistics)
+{
+	MockTimeSource clock;
+	clock.SetTime(TimeStamp_t(1000));
+	StackStatistics stats(&clock);
+
+	ResponseLoaderTestObject t;
+	t.mpStats = &stats;
+
+	// Group2Var2 at time 400, Group2Var1, Group1Var2
+	t.Load("C0 81 00 00 02 02 17 01 05 81 90 01 00 00 00 00 02 01 17 01 06 01 01 02 00 00 00 81");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 3);
+
+	StackStatisticsSnapshot s;
+	stats.Snapshot(s);
+	BOOST_REQUIRE_EQUAL(s.mEventsRx, 2);
+	BOOST_REQUIRE_EQUAL(s.mEventAge.Count(), 1);
+	BOOST_REQUIRE_EQUAL(s.mEventAge.Max(), 600);
+}
+
 BOOST_AUTO_TEST_SUITE_END() //end suite
 
+/// Counts the points it receives without storing them
+class CountingDataObserver : public IDataObserver
+{
+public:
+	CountingDataObserver() : mNumPoints(0) {}
+
+	size_t mNumPoints;
+
+private:
+	void _Start() {}
+	void _End() {}
+
+	void _Update(const Binary&, size_t) {
+		++mNumPoints;
+	}
+	void _Update(const Analog&, size_t) {
+		++mNumPoints;
+	}
+	void _Update(const Counter&, size_t) {
+		++mNumPoints;
+	}
+	void _Update(const ControlStatus&, size_t) {
+		++mNumPoints;
+	}
+	void _Update(const SetpointStatus&, size_t) {
+		++mNumPoints;
+	}
+
+	void _UpdateBatch(const Binary*, const boost::uint32_t*, size_t aCount) {
+		mNumPoints += aCount;
+	}
+	void _UpdateBatch(const Analog*, const boost::uint32_t*, size_t aCount) {
+		mNumPoints += aCount;
+	}
+	void _UpdateBatch(const Counter*, const boost::uint32_t*, size_t aCount) {
+		mNumPoints += aCount;
+	}
+	void _UpdateBatch(const ControlStatus*, const boost::uint32_t*, size_t aCount) {
+		mNumPoints += aCount;
+	}
+	void _UpdateBatch(const SetpointStatus*, const boost::uint32_t*, size_t aCount) {
+		mNumPoints += aCount;
+	}
+};
+
+/// Builds responses shaped like the ones outstations send for integrity and event polls
+class ResponseCorpus
+{
+public:
+
+	typedef std::vector<boost::uint8_t> Response;
+
+	ResponseCorpus() : mNumPoints(0) {
+		// class 0 response: binaries, counters, analogs and setpoint status as 16-bit ranges
+		Begin();
+		Range(1, 2, 0, 63, 1);
+		Range(20, 1, 0, 31, 5);
+		Range(30, 1, 0, 127, 5);
+		Range(30, 3, 128, 159, 4);
+		Range(40, 1, 0, 7, 5);
+		End();
+
+		// class 1/2/3 events with 16-bit index prefixes
+		Begin();
+		Prefixed(2, 2, 40, 7);
+		Prefixed(32, 1, 60, 5);
+		Prefixed(22, 1, 20, 5);
+		End();
+
+		// relative time binary events behind a CTO
+		Begin();
+		Append(51); Append(1); Append(0x07); Append(1);
+		for(size_t i = 0; i < 6; ++i) Append(static_cast<boost::uint8_t>(i));
+		Prefixed(2, 3, 50, 3);
+		End();
+	}
+
+	std::vector<Response> mResponses;
+	size_t mNumPoints;
+
+private:
+
+	void Begin() {
+		mResponses.push_back(Response());
+		Append(0xC0); Append(0x81); Append(0x00); Append(0x00);
+	}
+
+	void End() {}
+
+	void Append(boost::uint8_t aByte) {
+		mResponses.back().push_back(aByte);
+	}
+
+	void Append16(size_t aValue) {
+		Append(static_cast<boost::uint8_t>(aValue & 0xFF));
+		Append(static_cast<boost::uint8_t>((aValue >> 8) & 0xFF));
+	}
+
+	// online flag followed by a value that changes with the index
+	void Object(size_t aIndex, size_t aSize) {
+		Append(0x01);
+		for(size_t i = 1; i < aSize; ++i) Append(static_cast<boost::uint8_t>(aIndex + i));
+	}
+
+	void Range(int aGrp, int aVar, size_t aStart, size_t aStop, size_t aSize) {
+		Append(aGrp); Append(aVar); Append(0x01);
+		Append16(aStart);
+		Append16(aStop);
+		for(size_t i = aStart; i <= aStop; ++i) Object(i, aSize);
+		mNumPoints += aStop - aStart + 1;
+	}
+
+	void Prefixed(int aGrp, int aVar, size_t aCount, size_t aSize) {
+		Append(aGrp); Append(aVar); Append(0x28);
+		Append16(aCount);
+		for(size_t i = 0; i < aCount; ++i) {
+			Append16(i * 3);
+			Object(i, aSize);
+		}
+		mNumPoints += aCount;
+	}
+};
+
+BOOST_AUTO_TEST_SUITE(ResponseLoaderThroughputSuite)
+
+BOOST_AUTO_TEST_CASE(CorpusIsLoaded)
+{
+	ResponseCorpus corpus;
+	ResponseLoaderTestObject t;
+	size_t total = 0;
+
+	for(size_t i = 0; i < corpus.mResponses.size(); ++i) {
+		const ResponseCorpus::Response& r = corpus.mResponses[i];
+		t.Load(toHex(&r[0], r.size(), true));
+		total += t.fdo.GetTotalCount();
+	}
+
+	// events on the same index overwrite each other in the observer
+	BOOST_REQUIRE_EQUAL(total, 264 + 40 + 60 + 20 + 50);
+	// the relative time of the last response is offset by its CTO
+	BOOST_REQUIRE(t.fdo.Check(false, BQ_ONLINE, 0, TimeStamp_t(0x050403020100LL + 0x0201)));
+}
+
+BOOST_AUTO_TEST_CASE(LentBatchesAreReusedAcrossFragments)
+{
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_INFO, "rsp");
+	VtoReader vto(pLogger);
+	CountingDataObserver obs;
+	ResponseCorpus corpus;
+	APDU frag;
+	ResponseBatches batches;
+
+	DataBatch<Binary>* pBinaries;
+	DataBatch<Analog>* pAnalogs;
+	batches.GetBatch(pBinaries);
+	batches.GetBatch(pAnalogs);
+
+	size_t binaries = 0;
+	size_t analogs = 0;
+	for(size_t pass = 0; pass < 2; ++pass) {
+		for(size_t i = 0; i < corpus.mResponses.size(); ++i) {
+			const ResponseCorpus::Response& r = corpus.mResponses[i];
+			frag.Write(&r[0], r.size());
+			frag.Interpret();
+
+			ResponseLoader rl(pLogger, &obs, &vto, NULL, &batches);
+			for(HeaderReadIterator hdr = frag.BeginRead(); !hdr.IsEnd(); ++hdr) rl.Process(hdr);
+		}
+
+		// the first pass sizes the batches to the largest header, the second reuses them
+		if(pass == 0) {
+			binaries = pBinaries->Capacity();
+			analogs = pAnalogs->Capacity();
+			BOOST_REQUIRE(binaries > 0);
+			BOOST_REQUIRE(analogs > 0);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(pBinaries->Capacity(), binaries);
+	BOOST_REQUIRE_EQUAL(pAnalogs->Capacity(), analogs);
+	BOOST_REQUIRE_EQUAL(obs.mNumPoints, 2 * corpus.mNumPoints);
+}
+
+BOOST_AUTO_TEST_CASE(ThroughputBenchmark)
+{
+#ifdef ARM
+	const size_t NUM_PASSES = 200;
+#else
+	const size_t NUM_PASSES = 5000;
+#endif
+
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_INFO, "rsp");
+	VtoReader vto(pLogger);
+	CountingDataObserver obs;
+	ResponseCorpus corpus;
+	APDU frag;
+	ResponseBatches batches;
+
+	StopWatch sw;
+	for(size_t pass = 0; pass < NUM_PASSES; ++pass) {
+		for(size_t i = 0; i < corpus.mResponses.size(); ++i) {
+			const ResponseCorpus::Response& r = corpus.mResponses[i];
+			frag.Write(&r[0], r.size());
+			frag.Interpret();
+
+			ResponseLoader rl(pLogger, &obs, &vto, NULL, &batches);
+			for(HeaderReadIterator hdr = frag.BeginRead(); !hdr.IsEnd(); ++hdr) rl.Process(hdr);
+		}
+	}
+	double elapsed_sec = sw.Elapsed() / 1000.0;
+
+	BOOST_REQUIRE_EQUAL(obs.mNumPoints, NUM_PASSES * corpus.mNumPoints);
+
+	if (OUTPUT_PERF_NUMBERS) {
+		size_t num_responses = NUM_PASSES * corpus.mResponses.size();
+		std::cout << "responses/sec: " << num_responses / elapsed_sec
+		          << " points/sec: " << obs.mNumPoints / elapsed_sec << std::endl;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
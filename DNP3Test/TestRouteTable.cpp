@@ -0,0 +1,99 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/DNP3/RouteTable.h>
+
+#include <cstdlib>
+#include <map>
+
+#include "MockFrameSink.h"
+
+using namespace std;
+using namespace apl;
+using namespace apl::dnp;
+
+BOOST_AUTO_TEST_SUITE(RouteTableSuite)
+
+BOOST_AUTO_TEST_CASE(InsertFindErase)
+{
+	RouteTable t;
+	MockFrameSink a, b;
+
+	BOOST_REQUIRE(t.Find(LinkRoute(1, 1024)) == NULL);
+	BOOST_REQUIRE(t.Insert(LinkRoute(1, 1024), &a));
+	BOOST_REQUIRE(t.Insert(LinkRoute(1024, 1), &b)); // the direction matters
+	BOOST_REQUIRE_FALSE(t.Insert(LinkRoute(1, 1024), &b));
+	BOOST_REQUIRE_EQUAL(t.Size(), 2);
+
+	BOOST_REQUIRE(t.Find(LinkRoute(1, 1024))->mpContext == &a);
+	BOOST_REQUIRE(t.Find(LinkRoute(1024, 1))->mpContext == &b);
+
+	BOOST_REQUIRE(t.Erase(LinkRoute(1, 1024)) == &a);
+	BOOST_REQUIRE(t.Erase(LinkRoute(1, 1024)) == NULL);
+	BOOST_REQUIRE(t.Find(LinkRoute(1, 1024)) == NULL);
+	BOOST_REQUIRE(t.Find(LinkRoute(1024, 1))->mpContext == &b);
+	BOOST_REQUIRE_EQUAL(t.Size(), 1);
+}
+
+// Random inserts and erases across hundreds of routes agree with a std::map
+BOOST_AUTO_TEST_CASE(ChurnMatchesMap)
+{
+	RouteTable t;
+	std::map<LinkRoute, ILinkContext*, LinkRoute::LessThan> reference;
+	MockFrameSink sinks[8];
+
+	srand(0);
+	for(size_t i = 0; i < 20000; ++i) {
+		LinkRoute route(rand() % 600, rand() % 2);
+		ILinkContext* pContext = &sinks[rand() % 8];
+		if(rand() % 3 == 0) {
+			std::map<LinkRoute, ILinkContext*, LinkRoute::LessThan>::iterator j = reference.find(route);
+			ILinkContext* pExpected = (j == reference.end()) ? NULL : j->second;
+			if(j != reference.end()) reference.erase(j);
+			BOOST_REQUIRE(t.Erase(route) == pExpected);
+		}
+		else {
+			BOOST_REQUIRE_EQUAL(t.Insert(route, pContext), reference.insert(std::make_pair(route, pContext)).second);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(t.Size(), reference.size());
+	BOOST_REQUIRE(2 * t.Size() <= t.Capacity());
+	for(boost::uint16_t r = 0; r < 600; ++r) {
+		for(boost::uint16_t l = 0; l < 2; ++l) {
+			std::map<LinkRoute, ILinkContext*, LinkRoute::LessThan>::iterator j = reference.find(LinkRoute(r, l));
+			RouteTable::Entry* pEntry = t.Find(LinkRoute(r, l));
+			if(j == reference.end()) BOOST_REQUIRE(pEntry == NULL);
+			else {
+				BOOST_REQUIRE(pEntry != NULL);
+				BOOST_REQUIRE(pEntry->mpContext == j->second);
+			}
+		}
+	}
+
+	std::vector<ILinkContext*> contexts;
+	t.GetContexts(contexts);
+	BOOST_REQUIRE_EQUAL(contexts.size(), reference.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,121 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/TimingTools.h>
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/ScanScheduler.h>
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <iostream>
+
+using namespace apl;
+using namespace apl::dnp;
+using namespace std;
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
+namespace
+{
+
+// Adds aNumChannels client ports, each with a master, that never come online
+std::vector<ScanScheduler*> AddMasters(AsyncStackManager& arMgr, size_t aNumChannels)
+{
+	std::vector<ScanScheduler*> schedulers;
+	for(size_t i = 0; i < aNumChannels; ++i) {
+		std::string port = "port" + boost::lexical_cast<std::string>(i);
+		std::string stack = "master" + boost::lexical_cast<std::string>(i);
+		arMgr.AddTCPv4Client(port, PhysLayerSettings(LEV_WARNING, 60000), TcpSettings("127.0.0.1", 20000));
+		arMgr.AddMaster(port, stack, LEV_WARNING, NULL, MasterStackConfig());
+		schedulers.push_back(arMgr.GetScanScheduler(stack));
+	}
+	return schedulers;
+}
+
+void Count(size_t* apCount)
+{
+	++(*apCount);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(ScanSchedulerSuite)
+
+BOOST_AUTO_TEST_CASE(PostedPollsComplete)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"));
+	std::vector<ScanScheduler*> schedulers = AddMasters(mgr, 1);
+
+	FreeFormPoints points;
+	points[DataTypes::DT_ANALOG] = {0, 1, 2};
+
+	std::future<void> demand = schedulers[0]->PostOnDemandPoll();
+	std::future<void> freeform = schedulers[0]->PostFreeFormPoll(points);
+
+	BOOST_REQUIRE(demand.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+	BOOST_REQUIRE(freeform.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+	size_t count = 0;
+	schedulers[0]->PostFreeFormPoll(points, boost::bind(&Count, &count));
+	schedulers[0]->PostOnDemandPoll().wait(); // posts are handled in order
+	BOOST_REQUIRE_EQUAL(count, 1);
+}
+
+// Schedules an on-demand poll on every one of 1000 channels, first by pausing
+// each channel's thread and then by posting to it
+BOOST_AUTO_TEST_CASE(PostVersusPauseThroughput)
+{
+#ifdef ARM
+	const size_t NUM_CHANNELS = 100;
+#else
+	const size_t NUM_CHANNELS = 1000;
+#endif
+
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"), 4);
+	std::vector<ScanScheduler*> schedulers = AddMasters(mgr, NUM_CHANNELS);
+
+	StopWatch sw;
+	for(size_t i = 0; i < schedulers.size(); ++i) schedulers[i]->ScheduleOnDemandPoll();
+	millis_t pause = sw.Elapsed();
+
+	std::vector< std::future<void> > results;
+	for(size_t i = 0; i < schedulers.size(); ++i) results.push_back(schedulers[i]->PostOnDemandPoll());
+	millis_t post = sw.Elapsed(false);
+	for(size_t i = 0; i < results.size(); ++i) {
+		BOOST_REQUIRE(results[i].wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+	}
+	millis_t complete = sw.Elapsed(false);
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "channels: " << NUM_CHANNELS << endl;
+		cout << "pause ms: " << pause << endl;
+		cout << "post ms: " << post << " (all complete: " << complete << ")" << endl;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
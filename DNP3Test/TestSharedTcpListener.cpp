@@ -0,0 +1,220 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+#include <APLTestTools/TestHelpers.h>
+
+#include <opendnp3/APL/FlexibleDataObserver.h>
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/Log.h>
+#include <opendnp3/APL/TimingTools.h>
+#include <opendnp3/DNP3/AsyncStackManager.h>
+#include <opendnp3/DNP3/IStackObserver.h>
+#include <opendnp3/DNP3/LinkHeader.h>
+#include <opendnp3/DNP3/LinkScanner.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <boost/asio.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <iostream>
+
+using namespace apl;
+using namespace apl::dnp;
+using namespace std;
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
+namespace
+{
+
+// Counts the masters that have come online, can be shared by stacks on different threads
+class CommsUpCounter : public IStackObserver
+{
+public:
+	CommsUpCounter() : mCount(0)
+	{}
+
+	void OnStateChange(StackStates aState) {
+		CriticalSection cs(&mLock);
+		if(aState == SS_COMMS_UP) {
+			++mCount;
+			cs.Broadcast();
+		}
+	}
+
+	bool WaitForCount(size_t aCount, millis_t aTimeout) {
+		StopWatch sw;
+		CriticalSection cs(&mLock);
+		while(mCount < aCount) {
+			millis_t remaining = aTimeout - sw.Elapsed(false);
+			if(remaining <= 0) return false;
+			cs.TimedWait(remaining);
+		}
+		return true;
+	}
+
+private:
+	SigLock mLock;
+	size_t mCount;
+};
+
+const boost::uint16_t PORT = 31000;
+
+// Adds aNum outstations on shared ports of one endpoint and a master for each of them
+void AddPairs(AsyncStackManager& arMgr, size_t aNum, IStackObserver* apObserver, IDataObserver* apPublisher)
+{
+	for(size_t i = 0; i < aNum; ++i) {
+		std::string id = boost::lexical_cast<std::string>(i);
+		boost::uint16_t outstation = static_cast<boost::uint16_t>(i + 1);
+		boost::uint16_t master = static_cast<boost::uint16_t>(i + 30000);
+
+		arMgr.AddTCPv4SharedServer("server" + id, PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", PORT));
+		SlaveStackConfig slave;
+		slave.link.LocalAddr = outstation;
+		slave.link.RemoteAddr = master;
+		arMgr.AddSlave("server" + id, "slave" + id, LEV_WARNING, NULL, slave);
+
+		arMgr.AddTCPv4Client("client" + id, PhysLayerSettings(LEV_WARNING, 1000), TcpSettings("127.0.0.1", PORT));
+		MasterStackConfig cfg;
+		cfg.link.LocalAddr = master;
+		cfg.link.RemoteAddr = outstation;
+		cfg.master.mpObserver = apObserver;
+		arMgr.AddMaster("client" + id, "master" + id, LEV_WARNING, apPublisher, cfg);
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(SharedTcpListenerSuite)
+
+BOOST_AUTO_TEST_CASE(ConnectionsAreRoutedByLinkAddress)
+{
+	EventLog log;
+	FlexibleDataObserver fdo;
+	CommsUpCounter counter;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"), 2);
+
+	// each master only comes online if its connection reaches the outstation with the matching address
+	AddPairs(mgr, 3, &counter, &fdo);
+	BOOST_REQUIRE(counter.WaitForCount(3, 10000));
+}
+
+BOOST_AUTO_TEST_CASE(PortsCanBeRemovedAndReadded)
+{
+	EventLog log;
+	FlexibleDataObserver fdo;
+	CommsUpCounter counter;
+	AsyncStackManager mgr(log.GetLogger(LEV_WARNING, "test"));
+
+	AddPairs(mgr, 1, &counter, &fdo);
+	BOOST_REQUIRE(counter.WaitForCount(1, 10000));
+
+	// removing the last shared port closes the listener, re-adding one binds it again
+	mgr.RemovePort("client0");
+	mgr.RemovePort("server0");
+	AddPairs(mgr, 1, &counter, &fdo);
+	BOOST_REQUIRE(counter.WaitForCount(2, 10000));
+}
+
+BOOST_AUTO_TEST_CASE(UnknownRouteIsClosed)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_ERROR, "test"));
+	mgr.AddTCPv4SharedServer("server", PhysLayerSettings(LEV_ERROR, 1000), TcpSettings("127.0.0.1", PORT));
+	SlaveStackConfig slave;
+	slave.link.LocalAddr = 1;
+	slave.link.RemoteAddr = 100;
+	mgr.AddSlave("server", "slave", LEV_ERROR, NULL, slave);
+
+	boost::asio::io_service service;
+	boost::asio::ip::tcp::socket socket(service);
+	socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string("127.0.0.1"), PORT));
+
+	// a request from master 101 to outstation 1, which nobody serves
+	LinkHeader header;
+	header.Set(5, 101, 1, true, false, false, FC_PRI_REQUEST_LINK_STATUS);
+	boost::uint8_t frame[LS_HEADER_SIZE];
+	header.Write(frame);
+	boost::asio::write(socket, boost::asio::buffer(frame, LS_HEADER_SIZE));
+
+	boost::system::error_code ec;
+	boost::uint8_t byte;
+	socket.read_some(boost::asio::buffer(&byte, 1), ec);
+	BOOST_REQUIRE(ec == boost::asio::error::eof || ec == boost::asio::error::connection_reset);
+}
+
+BOOST_AUTO_TEST_CASE(DuplicateRoutesOnAnEndpointAreRejected)
+{
+	EventLog log;
+	AsyncStackManager mgr(log.GetLogger(LEV_ERROR, "test"));
+	mgr.AddTCPv4SharedServer("server0", PhysLayerSettings(LEV_ERROR, 1000), TcpSettings("127.0.0.1", PORT));
+	mgr.AddTCPv4SharedServer("server1", PhysLayerSettings(LEV_ERROR, 1000), TcpSettings("127.0.0.1", PORT));
+
+	SlaveStackConfig slave;
+	slave.link.LocalAddr = 1;
+	slave.link.RemoteAddr = 100;
+	mgr.AddSlave("server0", "slave0", LEV_ERROR, NULL, slave);
+	BOOST_REQUIRE_THROW(mgr.AddSlave("server1", "slave1", LEV_ERROR, NULL, slave), ArgumentException);
+	BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), 1);
+
+	// a route held by a link scan makes the bind fail after the listener accepted the route
+	SlaveStackConfig scanned;
+	scanned.link.LocalAddr = 1;
+	scanned.link.RemoteAddr = 200;
+	LinkScanConfig scan(200, 200);
+	mgr.AddLinkScan("server1", LEV_ERROR, scan, NULL);
+	BOOST_REQUIRE_THROW(mgr.AddSlave("server1", "slave1", LEV_ERROR, NULL, scanned), ArgumentException);
+	BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), 1);
+
+	// the failed add didn't leave its route behind in the listener
+	mgr.RemoveLinkScan("server1");
+	mgr.AddSlave("server0", "slave1", LEV_ERROR, NULL, scanned);
+	BOOST_REQUIRE_EQUAL(mgr.GetStackNames().size(), 2);
+}
+
+// Connects thousands of masters to outstations that all share one listening endpoint
+BOOST_AUTO_TEST_CASE(ManyConnectionsOnOneEndpoint)
+{
+#ifdef ARM
+	const size_t NUM_PAIRS = 100;
+#else
+	const size_t NUM_PAIRS = 2000;
+#endif
+
+	EventLog log;
+	FlexibleDataObserver fdo;
+	CommsUpCounter counter;
+	AsyncStackManager mgr(log.GetLogger(LEV_ERROR, "test"), 4);
+
+	StopWatch sw;
+	AddPairs(mgr, NUM_PAIRS, &counter, &fdo);
+	millis_t added = sw.Elapsed(false);
+	BOOST_REQUIRE(counter.WaitForCount(NUM_PAIRS, 60000));
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "pairs: " << NUM_PAIRS << endl;
+		cout << "added in ms: " << added << endl;
+		cout << "all online in ms: " << sw.Elapsed(false) << endl;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -19,12 +19,16 @@
 #include <boost/test/unit_test.hpp>
 
 #include <APLTestTools/TestHelpers.h>
+#include <APLTestTools/BufferHelpers.h>
 #include <APLTestTools/MockLogSubscriber.h>
 
 #include "SlaveTestObject.h"
 
 #include <opendnp3/DNP3/APDU.h>
 #include <opendnp3/DNP3/ObjectReadIterator.h>
+#include <opendnp3/DNP3/ResponseContext.h>
+#include <opendnp3/DNP3/SlaveResponseTypes.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 #include <opendnp3/APL/TimingTools.h>
 #include <opendnp3/APL/Util.h>
 
@@ -33,6 +37,7 @@ using namespace apl;
 using namespace apl::dnp;
 using namespace boost;
 
+#define OUTPUT_PERF_NUMBERS	(0)
 
 BOOST_AUTO_TEST_SUITE(SlaveSuite)
 
@@ -111,6 +116,29 @@ BOOST_AUTO_TEST_CASE(DataPostToNonExistent)
 	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(DataPostCoalesced)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true; cfg.mCoalesceUpdates = true;
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_ANALOG, 1);
+	t.db.SetClass(DT_ANALOG, PC_CLASS_1);
+	t.slave.OnLowerLayerUp();
+
+	IDataObserver* pObs = t.slave.GetDataObserver();
+	for(int i = 1; i <= 3; ++i) {
+		Transaction tr(pObs);
+		pObs->Update(Analog(i, AQ_ONLINE), 0);
+	}
+
+	// only one notification is posted until the updates are flushed
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 1);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	// only the latest value reached the database
+	t.SendToSlave("C0 01 3C 02 06");
+	BOOST_REQUIRE_EQUAL(t.Read(), "E0 81 80 00 20 01 17 01 00 01 03 00 00 00");
+}
+
 BOOST_AUTO_TEST_CASE(UnsupportedFunction)
 {
 	SlaveConfig cfg; cfg.mDisableUnsol = true;
@@ -339,6 +367,22 @@ BOOST_AUTO_TEST_CASE(ReadClass0MultiFrag)
 	BOOST_REQUIRE_EQUAL(t.Read(), "40 81 80 00 1E 01 00 06 07 01 00 00 00 00 01 00 00 00 00");
 }
 
+// only the populated runs of a sparse database are reported, each with its own range header
+BOOST_AUTO_TEST_CASE(ReadClass0Sparse)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true;
+	SlaveTestObject t(cfg);
+	size_t idx[] = { 0, 1, 300 };
+	t.db.Configure(DT_BINARY, std::vector<size_t>(idx, idx + 3));
+	t.slave.OnLowerLayerUp();
+
+	t.SendToSlave("C0 01 3C 01 06"); // Read class 0
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 01 02 00 00 01 02 02 01 02 01 2C 01 2C 01 02");
+
+	t.SendToSlave("C0 01 01 02 00 05 06"); // Read 1/2 5-6, which aren't configured
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 04");
+}
+
 BOOST_AUTO_TEST_CASE(ReadClass1)
 {
 	SlaveConfig cfg; cfg.mDisableUnsol = true;
@@ -465,6 +509,77 @@ BOOST_AUTO_TEST_CASE(UnsolData)
 	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0); //check that no more frags are sent
 }
 
+BOOST_AUTO_TEST_CASE(UnsolDataStatistics)
+{
+	SlaveConfig cfg;
+	cfg.mUnsolMask.class1 = true; // this allows the EnableUnsol sequence to be skipped
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+
+	// the commit and the unsol are timed with the same clock
+	MockTimeSource clock;
+	clock.SetTime(TimeStamp_t(1000000));
+	StackStatistics stats(&clock);
+	t.slave.SetStatistics(&stats);
+
+	{
+		Transaction tr(t.slave.GetDataObserver());
+		t.slave.GetDataObserver()->Update(Binary(false, BQ_ONLINE), 0);
+	}
+
+	BOOST_REQUIRE(t.mts.DispatchOne()); //dispatch the data update event
+	clock.Advance(40);
+
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 02 01 17 01 00 01");
+
+	// only the unsol that carries the event is measured
+	StackStatisticsSnapshot s;
+	stats.Snapshot(s);
+	BOOST_REQUIRE_EQUAL(s.mUnsolLatency.Count(), 1);
+	BOOST_REQUIRE_EQUAL(s.mUnsolLatency.Max(), 40);
+	BOOST_REQUIRE_EQUAL(s.mEventsTx, 1);
+}
+
+BOOST_AUTO_TEST_CASE(UnsolLatencyIsDroppedWhenUnsolIsDisabled)
+{
+	SlaveConfig cfg;
+	cfg.mUnsolMask.class1 = true;
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+
+	MockTimeSource clock;
+	StackStatistics stats(&clock);
+	t.slave.SetStatistics(&stats);
+
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00"); //Null UNSOL
+
+	// the event is committed while unsol is enabled, but disabled before the pack delay expires
+	{
+		Transaction tr(t.slave.GetDataObserver());
+		t.slave.GetDataObserver()->Update(Binary(false, BQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	t.SendToSlave("C0 15 3C 02 06");
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+	t.mts.Dispatch();
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+
+	// the time spent while unsol was disabled isn't counted as latency
+	clock.Advance(5000);
+	t.SendToSlave("C0 14 3C 02 06");
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00");
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 02 01 17 01 00 01");
+
+	StackStatisticsSnapshot s;
+	stats.Snapshot(s);
+	BOOST_REQUIRE_EQUAL(s.mUnsolLatency.Count(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(UnsolDataWithZeroLenObjectGroup)
 {
 	SlaveConfig cfg;
@@ -1755,3 +1870,176 @@ BOOST_AUTO_TEST_CASE(ReadGrp40Var4)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(SlaveStaticResponseSuite)
+
+// Integrity polls of 100k analogs where 1% of the points change between polls
+BOOST_AUTO_TEST_CASE(IntegrityPollThroughput)
+{
+#ifdef ARM
+	const size_t NUM_POLLS = 10;
+#else
+	const size_t NUM_POLLS = 100;
+#endif
+	const size_t NUM_POINTS = 100000;
+	const size_t NUM_CHANGES = NUM_POINTS / 100;
+
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "slave");
+	SlaveConfig cfg;
+	SlaveResponseTypes types(cfg);
+	Database db(pLogger);
+	db.Configure(DT_ANALOG, NUM_POINTS, true);
+	ResponseContext rsp(pLogger, &db, &types, cfg.mEventMaxConfig);
+
+	HexSequence hs("C0 01 3C 01 06"); // Read class 0
+	APDU request;
+	request.Write(hs, hs.Size());
+	request.Interpret();
+
+	APDU response(cfg.mMaxFragSize);
+	size_t bytes = 0;
+
+	StopWatch sw;
+	for(size_t poll = 0; poll < NUM_POLLS; ++poll) {
+		{
+			Transaction tr(&db);
+			for(size_t i = 0; i < NUM_CHANGES; ++i) {
+				db.Update(Analog(static_cast<double>(poll + 1), AQ_ONLINE), (poll * 7919 + i * 97) % NUM_POINTS);
+			}
+		}
+
+		rsp.Configure(request);
+		while(!rsp.IsComplete()) {
+			rsp.LoadResponse(response);
+			bytes += response.Size();
+		}
+	}
+	double elapsed_sec = sw.Elapsed() / 1000.0;
+
+	BOOST_REQUIRE(bytes > NUM_POLLS * NUM_POINTS * types.mpStaticAnalog->GetSize());
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "integrity polls/sec: " << NUM_POLLS / elapsed_sec << " ms/poll: " << elapsed_sec * 1000 / NUM_POLLS << endl;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(AutoVariationNarrowsRuns)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true; cfg.mAutoVariations = true;
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 10);
+	t.db.Configure(DT_ANALOG, 11);
+	t.db.Configure(DT_COUNTER, 2);
+	t.slave.OnLowerLayerUp();
+
+	{
+		Transaction tr(&t.db);
+		for(size_t i = 0; i < 10; ++i) t.db.Update(Binary((i % 2) == 1, BQ_ONLINE), i);
+		for(size_t i = 0; i < 10; ++i) t.db.Update(Analog(static_cast<double>(i), AQ_ONLINE), i);
+		t.db.Update(Analog(100000, AQ_ONLINE), 10);
+		t.db.Update(Counter(1, CQ_ONLINE), 0);
+		t.db.Update(Counter(2, CQ_ONLINE | CQ_COMM_LOST), 1);
+	}
+
+	t.SendToSlave("C0 01 3C 01 06"); // Read class 0
+
+	// binaries are bit packed, the large analog gets its own 32 bit header because
+	// that's smaller than writing all of them as 32 bits, and one counter with flags
+	// is cheaper to carry the other one along than to split
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 81 80 00 01 01 00 00 09 AA 02 "
+	                    "1E 04 00 00 09 00 00 01 00 02 00 03 00 04 00 05 00 06 00 07 00 08 00 09 00 "
+	                    "1E 03 00 0A 0A A0 86 01 00 "
+	                    "14 02 00 00 01 01 01 00 05 02 00");
+
+	t.SendToSlave("C0 01 1E 01 06"); // an explicit variation is honored
+	BOOST_REQUIRE_EQUAL(t.Read().substr(0, 20), "C0 81 80 00 1E 01 00");
+}
+
+BOOST_AUTO_TEST_CASE(AutoVariationBinaryEventsUseCTO)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true; cfg.mAutoVariations = true;
+	cfg.mEventBinary = GrpVar(2, 2);
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 3);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+	t.slave.OnLowerLayerUp();
+
+	{
+		Transaction tr(&t.db);
+		t.db.Update(Binary(true, BQ_ONLINE), 0);
+	}
+
+	t.SendToSlave("C0 01 3C 02 06"); // a single event is cheaper with absolute time
+	BOOST_REQUIRE_EQUAL(t.Read(), "E0 81 80 00 02 02 17 01 00 81 00 00 00 00 00 00");
+
+	{
+		Transaction tr(&t.db);
+		for(size_t i = 0; i < 3; ++i) {
+			Binary b(false, BQ_ONLINE);
+			b.SetTime(1000 + i);
+			t.db.Update(b, i);
+		}
+	}
+
+	t.SendToSlave("C0 01 3C 02 06"); // three are cheaper behind a common time object
+	BOOST_REQUIRE_EQUAL(t.Read(), "E0 81 80 00 33 01 07 01 E8 03 00 00 00 00 02 03 17 03 00 01 00 00 01 01 01 00 02 01 02 00");
+}
+
+// Compares the size of integrity polls with the default and the automatic
+// variations over a synthetic device whose points are mostly online
+BOOST_AUTO_TEST_CASE(AutoVariationBytesOnWire)
+{
+	const size_t NUM_BINARIES = 1000;
+	const size_t NUM_ANALOGS = 1000;
+	const size_t NUM_COUNTERS = 500;
+
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "slave");
+	Database db(pLogger);
+	db.Configure(DT_BINARY, NUM_BINARIES);
+	db.Configure(DT_ANALOG, NUM_ANALOGS);
+	db.Configure(DT_COUNTER, NUM_COUNTERS);
+
+	{
+		Transaction tr(&db);
+		for(size_t i = 0; i < NUM_BINARIES; ++i) {
+			db.Update(Binary((i % 3) == 0, (i % 97) == 0 ? BQ_COMM_LOST : BQ_ONLINE), i);
+		}
+		for(size_t i = 0; i < NUM_ANALOGS; ++i) {
+			double value = (i % 50 == 0) ? 1.5 * i : static_cast<double>((i * 7919) % ((i < 800) ? 4000 : 400000));
+			db.Update(Analog(value, AQ_ONLINE), i);
+		}
+		for(size_t i = 0; i < NUM_COUNTERS; ++i) {
+			db.Update(Counter(static_cast<boost::uint32_t>(i * 131), CQ_ONLINE), i);
+		}
+	}
+
+	HexSequence hs("C0 01 3C 01 06"); // Read class 0
+	APDU request;
+	request.Write(hs, hs.Size());
+	request.Interpret();
+
+	size_t bytes[2];
+	for(size_t i = 0; i < 2; ++i) {
+		SlaveConfig cfg;
+		cfg.mAutoVariations = (i == 1);
+		SlaveResponseTypes types(cfg);
+		ResponseContext rsp(pLogger, &db, &types, cfg.mEventMaxConfig);
+
+		APDU response(cfg.mMaxFragSize);
+		bytes[i] = 0;
+		rsp.Configure(request);
+		while(!rsp.IsComplete()) {
+			rsp.LoadResponse(response);
+			bytes[i] += response.Size();
+		}
+	}
+
+	BOOST_REQUIRE(bytes[1] < bytes[0] / 2);
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "integrity poll bytes default: " << bytes[0] << " auto: " << bytes[1] << " reduction: " << 100.0 * (bytes[0] - bytes[1]) / bytes[0] << "%" << endl;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APL/TimeSource.h>
+#include <opendnp3/DNP3/StackStatistics.h>
+
+using namespace apl;
+using namespace apl::dnp;
+
+BOOST_AUTO_TEST_SUITE(StackStatisticsSuite)
+
+BOOST_AUTO_TEST_CASE(HistogramBucketsAreContiguous)
+{
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::LowerBound(0), 0);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::UpperBound(LatencyHistogram::NUM_BUCKETS - 1), ~static_cast<boost::uint64_t>(0));
+
+	for(size_t i = 1; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+		BOOST_REQUIRE_EQUAL(LatencyHistogram::UpperBound(i - 1) + 1, LatencyHistogram::LowerBound(i));
+		BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketOf(LatencyHistogram::LowerBound(i)), i);
+		BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketOf(LatencyHistogram::UpperBound(i)), i);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(HistogramBucketWidthIsBounded)
+{
+	for(size_t i = LatencyHistogram::SUB_BUCKETS; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+		boost::uint64_t width = LatencyHistogram::UpperBound(i) - LatencyHistogram::LowerBound(i) + 1;
+		BOOST_REQUIRE(width * LatencyHistogram::SUB_BUCKETS <= LatencyHistogram::LowerBound(i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(HistogramPercentiles)
+{
+	LatencyHistogram h;
+	for(millis_t i = 1; i <= 1000; ++i) h.Record(i);
+
+	HistogramSnapshot s;
+	h.Snapshot(s);
+
+	BOOST_REQUIRE_EQUAL(s.Count(), 1000);
+	BOOST_REQUIRE_EQUAL(s.Max(), 1000);
+	BOOST_REQUIRE_EQUAL(s.Mean(), 500.5);
+	BOOST_REQUIRE_EQUAL(s.Percentile(0), 1);
+	BOOST_REQUIRE_EQUAL(s.Percentile(100), 1000);
+
+	// accurate to the width of the bucket
+	millis_t median = s.Percentile(50);
+	BOOST_REQUIRE(median >= 500);
+	BOOST_REQUIRE(median <= 500 + 500 / 8);
+
+	millis_t p99 = s.Percentile(99);
+	BOOST_REQUIRE(p99 >= 990);
+	BOOST_REQUIRE(p99 <= 1000);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramClampsNegativeValues)
+{
+	LatencyHistogram h;
+	h.Record(-5);
+
+	HistogramSnapshot s;
+	h.Snapshot(s);
+
+	BOOST_REQUIRE_EQUAL(s.Count(), 1);
+	BOOST_REQUIRE_EQUAL(s.mCounts[0], 1);
+	BOOST_REQUIRE_EQUAL(s.Max(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(EmptySnapshot)
+{
+	StackStatistics stats;
+	StackStatisticsSnapshot s;
+	stats.Snapshot(s);
+
+	BOOST_REQUIRE_EQUAL(s.mFramesRx, 0);
+	BOOST_REQUIRE_EQUAL(s.mResponseLatency.Count(), 0);
+	BOOST_REQUIRE_EQUAL(s.mResponseLatency.Percentile(50), 0);
+	BOOST_REQUIRE_EQUAL(s.mResponseLatency.Mean(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(SnapshotCopiesCounters)
+{
+	MockTimeSource clock;
+	clock.SetTime(TimeStamp_t(1000));
+	StackStatistics stats(&clock);
+	BOOST_REQUIRE_EQUAL(stats.Now(), 1000);
+
+	stats.mBytesTx.Increment(292);
+	stats.mFramesTx.Increment();
+	stats.mEventsRx.Increment(3);
+	stats.mEventAge.Record(40);
+
+	StackStatisticsSnapshot s;
+	stats.Snapshot(s);
+
+	BOOST_REQUIRE_EQUAL(s.mBytesTx, 292);
+	BOOST_REQUIRE_EQUAL(s.mFramesTx, 1);
+	BOOST_REQUIRE_EQUAL(s.mEventsRx, 3);
+	BOOST_REQUIRE_EQUAL(s.mEventAge.Count(), 1);
+	BOOST_REQUIRE_EQUAL(s.mEventAge.Max(), 40);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
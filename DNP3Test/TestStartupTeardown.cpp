@@ -23,6 +23,7 @@
 #include "StartupTeardownTest.h"
 
 #include <boost/asio.hpp>
+#include <boost/thread.hpp>
 
 using namespace std;
 using namespace apl;
@@ -66,5 +67,49 @@ BOOST_AUTO_TEST_CASE(AutoStartAndStopWithExplicitShutdown)
 }
 
 
+BOOST_AUTO_TEST_CASE(AutoStartAndStopWithThreadPool)
+{
+	StartupTeardownTest test(LEVEL, false, 4);
+	BOOST_REQUIRE_EQUAL(test.manager.GetNumThreads(), 4);
+	Configure(test, LEVEL, NUM_STACKS, NUM_PORTS);
+	test.manager.RemovePort("port0");
+	test.manager.Shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(AutoStartAndStopWithTimerWheel)
+{
+	StartupTeardownTest test(LEVEL, false, 2, 10);
+	Configure(test, LEVEL, NUM_STACKS, NUM_PORTS);
+	test.manager.RemovePort("port0");
+	test.manager.Shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPoolRequiresOneThread)
+{
+	EventLog log;
+	BOOST_REQUIRE_THROW(AsyncStackManager(log.GetLogger(LEVEL, "mgr"), 0), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(OpenRetriesAreReportedPerPort)
+{
+	StartupTeardownTest test(LEVEL, false);
+	BOOST_REQUIRE_THROW(test.manager.GetNumOpenRetries("port0"), ArgumentException);
+
+	// nothing listens on the port, so every open fails and backs off
+	PhysLayerSettings s(LEVEL, 50);
+	s.MaxRetryTimeout = 400;
+	test.manager.AddTCPv4Client("port0", s, TcpSettings("127.0.0.1", 30000));
+	test.AddMaster("master", "port0", 1, LEVEL);
+
+	for(size_t i = 0; i < 200 && test.manager.GetNumOpenRetries("port0") < 3; ++i) {
+		boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+	}
+
+	BOOST_REQUIRE(test.manager.GetNumOpenRetries("port0") >= 3);
+	BOOST_REQUIRE(test.manager.GetOpenRetryDelay("port0") > 50);
+	BOOST_REQUIRE(test.manager.GetOpenRetryDelay("port0") <= 400);
+	BOOST_REQUIRE_THROW(test.manager.GetOpenRetryDelay("port1"), ArgumentException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -26,6 +26,7 @@
 #include <APLTestTools/BufferHelpers.h>
 #include <opendnp3/APL/ProtocolUtil.h>
 #include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/TimingTools.h>
 
 
 #include <boost/foreach.hpp>
@@ -36,7 +37,7 @@ using namespace apl;
 using namespace boost;
 using namespace apl::dnp;
 
-
+#define OUTPUT_PERF_NUMBERS	(0)
 
 BOOST_AUTO_TEST_SUITE(AsyncTransportScalability)
 
@@ -75,6 +76,54 @@ BOOST_AUTO_TEST_CASE(TestSimpleSend)
 	BOOST_REQUIRE(t.AllLayerEqual(b, b.Size()));
 }
 
+// Runs the same exchange with the pairs spread across 1, 2 and 4 io_service
+// threads to measure how the transport scales with the number of cores
+BOOST_AUTO_TEST_CASE(TestSendThreadScaling)
+{
+	LinkConfig client(true, true);
+	LinkConfig server(false, true);
+
+#ifdef WIN32
+	boost::uint32_t port = 50000;
+#else
+	boost::uint32_t port = 30000;
+#endif
+
+#ifdef ARM
+	boost::uint16_t NUM_PAIRS = 50;
+#else
+	boost::uint16_t NUM_PAIRS = 100;
+#endif
+
+	const size_t NUM_SENDS = 10;
+	const size_t NUM_THREADS[] = {1, 2, 4};
+
+	for(size_t i = 0; i < sizeof(NUM_THREADS) / sizeof(NUM_THREADS[0]); ++i) {
+
+		// each configuration listens on its own ports so that lingering sockets from the last don't interfere
+		TransportScalabilityTestObject t(client, server, port + i * NUM_PAIRS, NUM_PAIRS, LEV_INFO, false, NUM_THREADS[i]);
+
+		t.Start();
+
+		BOOST_REQUIRE(t.ProceedUntil(boost::bind(&TransportScalabilityTestObject::AllLayersUp, &t)));
+
+		ByteStr b(2048, 0);
+		StopWatch sw;
+
+		for(size_t j = 1; j <= NUM_SENDS; ++j) {
+			t.SendToAll(b, b.Size());
+			BOOST_REQUIRE(t.ProceedUntil(boost::bind(&TransportScalabilityTestObject::AllLayersSent, &t, j), 120000));
+			BOOST_REQUIRE(t.ProceedUntil(boost::bind(&TransportScalabilityTestObject::AllLayerReceived, &t, j * b.Size()), 120000));
+		}
+
+		if (OUTPUT_PERF_NUMBERS) {
+			double elapsed_sec = sw.Elapsed() / 1000.0;
+			size_t bytes = NUM_SENDS * b.Size() * NUM_PAIRS * 2;
+			cout << "threads: " << NUM_THREADS[i] << " bytes/sec: " << bytes / elapsed_sec << endl;
+		}
+	}
+}
+
 
 
 
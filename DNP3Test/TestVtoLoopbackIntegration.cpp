@@ -19,6 +19,7 @@
 
 #include <opendnp3/APL/PhysLoopback.h>
 #include <opendnp3/APL/RandomizedBuffer.h>
+#include <opendnp3/APL/TimingTools.h>
 
 #include <APLTestTools/MockPhysicalLayerMonitor.h>
 
@@ -27,6 +28,8 @@
 using namespace apl;
 using namespace apl::dnp;
 
+#define OUTPUT_PERF_NUMBERS	(0)
+
 class VtoLoopbackTestStack : public VtoIntegrationTestBase
 {
 public:
@@ -73,10 +76,17 @@ void TestLargeDataLoopback(VtoLoopbackTestStack& arTest, size_t aSizeInBytes)
 	CopyableBuffer data(aSizeInBytes);
 	for(size_t i = 0; i < data.Size(); ++i) data[i] = static_cast<boost::uint8_t>(i % (0xAA));
 
+	StopWatch sw;
 	arTest.local.ExpectData(data);
 	arTest.local.WriteData(data);
 	BOOST_REQUIRE(arTest.WaitForExpectedDataToBeReceived(60000));
 
+	if (OUTPUT_PERF_NUMBERS) {
+		double elapsed_sec = sw.Elapsed() / 1000.0;
+		std::cout << "Tunnel throughput: " << aSizeInBytes << " bytes in " << elapsed_sec << " sec, "
+		          << aSizeInBytes / elapsed_sec << " bytes/sec" << std::endl;
+	}
+
 	// this will cause an exception if we receive any more data beyond what we wrote
 	arTest.testObj.ProceedForTime(1000);
 }
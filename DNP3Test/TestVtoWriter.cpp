@@ -22,6 +22,8 @@
 #include <opendnp3/APL/Log.h>
 #include <opendnp3/DNP3/VtoWriter.h>
 
+#include <vector>
+
 using namespace std;
 using namespace apl;
 using namespace apl::dnp;
@@ -41,3 +43,78 @@ BOOST_AUTO_TEST_CASE(OnlyAcceptsMaximumSize)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(VtoByteRingSuite)
+
+BOOST_AUTO_TEST_CASE(ChunksShareTheRing)
+{
+	VtoByteRing ring(1024);
+	RandomizedBuffer data(255);
+
+	VtoData first = ring.Copy(data, 255);
+	VtoData second = ring.Copy(data, 100);
+
+	BOOST_REQUIRE_EQUAL(ring.NumBlocks(), 1);
+	BOOST_REQUIRE_EQUAL(second.mpData, first.mpData + 255);
+	BOOST_REQUIRE_EQUAL(memcmp(first.mpData, data.Buffer(), 255), 0);
+	BOOST_REQUIRE_EQUAL(memcmp(second.mpData, data.Buffer(), 100), 0);
+
+	// copies of a chunk refer to the same bytes
+	VtoData copy = first;
+	BOOST_REQUIRE_EQUAL(copy.mpData, first.mpData);
+	BOOST_REQUIRE_EQUAL(copy.GetSize(), 255);
+}
+
+BOOST_AUTO_TEST_CASE(ReleasedBlocksAreReused)
+{
+	VtoByteRing ring(1024);
+	RandomizedBuffer data(255);
+
+	for(size_t i = 0; i < 1000; ++i) {
+		VtoData chunk = ring.Copy(data, 255);
+		BOOST_REQUIRE_EQUAL(memcmp(chunk.mpData, data.Buffer(), 255), 0);
+	}
+
+	BOOST_REQUIRE_EQUAL(ring.NumBlocks(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(BlocksInFlightAreNotOverwritten)
+{
+	VtoByteRing ring(1024);
+	std::vector<VtoData> held;
+
+	for(size_t i = 0; i < 20; ++i) {
+		boost::uint8_t value[255];
+		memset(value, static_cast<int>(i), 255);
+		held.push_back(ring.Copy(value, 255));
+	}
+
+	// 4 chunks fit in each block
+	BOOST_REQUIRE_EQUAL(ring.NumBlocks(), 5);
+
+	for(size_t i = 0; i < held.size(); ++i) {
+		for(size_t j = 0; j < 255; ++j) BOOST_REQUIRE_EQUAL(held[i].mpData[j], i);
+	}
+
+	// once released the same blocks carry the next 20 chunks
+	held.clear();
+	RandomizedBuffer data(255);
+	for(size_t i = 0; i < 20; ++i) held.push_back(ring.Copy(data, 255));
+	BOOST_REQUIRE_EQUAL(ring.NumBlocks(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(ChunksOutliveTheRing)
+{
+	RandomizedBuffer data(255);
+	VtoData chunk;
+	{
+		VtoByteRing ring(1024);
+		chunk = ring.Copy(data, 255);
+		VtoData copy = chunk;
+	}
+
+	BOOST_REQUIRE_EQUAL(chunk.GetSize(), 255);
+	BOOST_REQUIRE_EQUAL(memcmp(chunk.mpData, data.Buffer(), 255), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
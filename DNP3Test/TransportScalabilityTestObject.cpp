@@ -22,6 +22,7 @@
 #include <sstream>
 
 #include <boost/asio.hpp>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 
 using namespace std;
@@ -37,13 +38,20 @@ TransportScalabilityTestObject::TransportScalabilityTestObject(
     boost::uint16_t aPortStart,
     boost::uint16_t aNumPair,
     FilterLevel aLevel,
-    bool aImmediate) :
+    bool aImmediate,
+    size_t aNumThreads) :
 
 	LogTester(aImmediate),
 	AsyncTestObjectASIO(),
 	mpLogger(mLog.GetLogger(aLevel, "test")),
 	mTimerSource(this->GetService())
 {
+	for(size_t i = 0; i < aNumThreads; ++i) {
+		ostringstream oss;
+		oss << "thread" << i;
+		mThreads.push_back(boost::shared_ptr<ServiceThread>(new ServiceThread(mpLogger->GetSubLogger(oss.str()))));
+	}
+
 	const boost::uint16_t START = aPortStart;
 	const boost::uint16_t STOP = START + aNumPair;
 
@@ -51,20 +59,83 @@ TransportScalabilityTestObject::TransportScalabilityTestObject(
 		ostringstream oss;
 		oss << "pair" << port;
 		Logger* pLogger = mpLogger->GetSubLogger(oss.str());
-		TransportStackPair* pPair = new TransportStackPair(aClientCfg, aServerCfg, pLogger, this->GetService(), &mTimerSource, port);
+		boost::asio::io_service* pService = this->GetService();
+		ITimerSource* pTimerSrc = &mTimerSource;
+		if(aNumThreads > 0) {
+			ServiceThread* pThread = mThreads[mPairs.size() % aNumThreads].get();
+			pService = pThread->mService.Get();
+			pTimerSrc = &pThread->mTimerSource;
+		}
+		TransportStackPair* pPair = new TransportStackPair(aClientCfg, aServerCfg, pLogger, pService, pTimerSrc, port);
 		mPairs.push_back(pPair);
 	}
 }
 
 TransportScalabilityTestObject::~TransportScalabilityTestObject()
 {
+	// stop the threads before the layers they drive are deleted
+	BOOST_FOREACH(boost::shared_ptr<ServiceThread> pThread, mThreads) pThread->mThread.Stop();
 	BOOST_FOREACH(TransportStackPair * pPair, mPairs) delete pPair;
 }
 
+TransportScalabilityTestObject::ServiceThread::ServiceThread(Logger* apLogger) :
+	mService(),
+	mWork(*mService.Get()),
+	mTimerSource(mService.Get()),
+	mThread(apLogger, mService.Get())
+{
+	mThread.Start();
+}
+
+static bool PairEquals(TransportStackPair* apPair, const boost::uint8_t* apData, size_t aNumBytes)
+{
+	return apPair->mServerStack.mUpper.BufferEquals(apData, aNumBytes)
+	       && apPair->mClientStack.mUpper.BufferEquals(apData, aNumBytes);
+}
+
+static bool PairReceived(TransportStackPair* apPair, size_t aNumBytes)
+{
+	return apPair->mServerStack.mUpper.Size() == aNumBytes
+	       && apPair->mClientStack.mUpper.Size() == aNumBytes;
+}
+
+static bool PairSent(TransportStackPair* apPair, size_t aNumSends)
+{
+	return apPair->mServerStack.mUpper.GetState().mSuccessCnt == aNumSends
+	       && apPair->mClientStack.mUpper.GetState().mSuccessCnt == aNumSends;
+}
+
+static bool PairSend(TransportStackPair* apPair, const boost::uint8_t* apData, size_t aNumBytes)
+{
+	apPair->mClientStack.mUpper.SendDown(apData, aNumBytes);
+	apPair->mServerStack.mUpper.SendDown(apData, aNumBytes);
+	return true;
+}
+
+static bool PairStart(TransportStackPair* apPair)
+{
+	apPair->Start();
+	return true;
+}
+
+void TransportScalabilityTestObject::Evaluate(const boost::function<bool ()>& arCheck, bool* apResult)
+{
+	*apResult = arCheck();
+}
+
+bool TransportScalabilityTestObject::Check(size_t aIndex, const boost::function<bool ()>& arCheck)
+{
+	if(mThreads.empty()) return arCheck();
+
+	bool result = false;
+	mThreads[aIndex % mThreads.size()]->mTimerSource.PostSync(boost::bind(&TransportScalabilityTestObject::Evaluate, arCheck, &result));
+	return result;
+}
+
 bool TransportScalabilityTestObject::AllLayersUp()
 {
-	BOOST_FOREACH(TransportStackPair * pPair, mPairs) {
-		if(!pPair->BothLayersUp()) return false;
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		if(!this->Check(i, boost::bind(&TransportStackPair::BothLayersUp, mPairs[i]))) return false;
 	}
 
 	return true;
@@ -72,9 +143,8 @@ bool TransportScalabilityTestObject::AllLayersUp()
 
 bool TransportScalabilityTestObject::AllLayerEqual(const boost::uint8_t* apData, size_t aNumBytes)
 {
-	BOOST_FOREACH(TransportStackPair * pPair, mPairs) {
-		if(! pPair->mServerStack.mUpper.BufferEquals(apData, aNumBytes)) return false;
-		if(! pPair->mClientStack.mUpper.BufferEquals(apData, aNumBytes)) return false;
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		if(!this->Check(i, boost::bind(&PairEquals, mPairs[i], apData, aNumBytes))) return false;
 	}
 
 	return true;
@@ -82,9 +152,17 @@ bool TransportScalabilityTestObject::AllLayerEqual(const boost::uint8_t* apData,
 
 bool TransportScalabilityTestObject::AllLayerReceived(size_t aNumBytes)
 {
-	BOOST_FOREACH(TransportStackPair * pPair, mPairs) {
-		if(pPair->mServerStack.mUpper.Size() != aNumBytes) return false;
-		if(pPair->mClientStack.mUpper.Size() != aNumBytes) return false;
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		if(!this->Check(i, boost::bind(&PairReceived, mPairs[i], aNumBytes))) return false;
+	}
+
+	return true;
+}
+
+bool TransportScalabilityTestObject::AllLayersSent(size_t aNumSends)
+{
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		if(!this->Check(i, boost::bind(&PairSent, mPairs[i], aNumSends))) return false;
 	}
 
 	return true;
@@ -92,20 +170,17 @@ bool TransportScalabilityTestObject::AllLayerReceived(size_t aNumBytes)
 
 void TransportScalabilityTestObject::SendToAll(const boost::uint8_t* apData, size_t aNumBytes)
 {
-	BOOST_FOREACH(TransportStackPair * pPair, mPairs) {
-		pPair->mClientStack.mUpper.SendDown(apData, aNumBytes);
-		pPair->mServerStack.mUpper.SendDown(apData, aNumBytes);
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		this->Check(i, boost::bind(&PairSend, mPairs[i], apData, aNumBytes));
 	}
 }
 
 void TransportScalabilityTestObject::Start()
 {
-	BOOST_FOREACH(TransportStackPair * pPair, mPairs) {
-		pPair->Start();
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		this->Check(i, boost::bind(&PairStart, mPairs[i]));
 	}
 }
 
 }
 }
-
-
@@ -22,9 +22,15 @@
 #include "TransportStackPair.h"
 #include <APLTestTools/AsyncTestObjectASIO.h>
 
+#include <opendnp3/APL/IOService.h>
+#include <opendnp3/APL/IOServiceThread.h>
 #include <opendnp3/APL/TimerSourceASIO.h>
 #include <APLTestTools/LogTester.h>
 
+#include <boost/asio.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
 namespace apl
 {
 namespace dnp
@@ -39,7 +45,8 @@ public:
 	        boost::uint16_t aPortStart,
 	        boost::uint16_t aNumPair,
 	        FilterLevel aLevel = LEV_INFO,
-	        bool aImmediate = false);
+	        bool aImmediate = false,
+	        size_t aNumThreads = 0);
 
 	~TransportScalabilityTestObject();
 
@@ -49,6 +56,7 @@ public:
 	// Test helpers
 	bool AllLayersUp();
 	bool AllLayerReceived(size_t aNumBytes);
+	bool AllLayersSent(size_t aNumSends);
 	bool AllLayerEqual(const boost::uint8_t*, size_t);
 
 	void SendToAll(const boost::uint8_t*, size_t);
@@ -57,6 +65,31 @@ public:
 	Logger* mpLogger;
 	TimerSourceASIO mTimerSource;
 	std::vector<TransportStackPair*> mPairs;
+
+private:
+
+	/**
+		With aNumThreads > 0 the pairs are spread round robin across io_services
+		that each run on a dedicated thread, instead of being driven by the test
+		thread through ProceedUntil().
+	*/
+	class ServiceThread
+	{
+	public:
+		ServiceThread(Logger* apLogger);
+
+		IOService mService;
+		boost::asio::io_service::work mWork;
+		TimerSourceASIO mTimerSource;
+		IOServiceThread mThread;
+	};
+
+	std::vector< boost::shared_ptr<ServiceThread> > mThreads;
+
+	// Evaluates a check, or performs an action, on the thread that drives pair aIndex
+	bool Check(size_t aIndex, const boost::function<bool ()>& arCheck);
+
+	static void Evaluate(const boost::function<bool ()>& arCheck, bool* apResult);
 };
 
 }
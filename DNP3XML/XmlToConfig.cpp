@@ -220,25 +220,33 @@ GrpVar XmlToConfig::Convert(const APLXML_DNP::GrpVar_t& arCfg)
 
 DeviceTemplate XmlToConfig::Convert(const APLXML_DNP::DeviceTemplate_t& arCfg, bool aStartOnline)
 {
-	size_t numBinary = CalcNumType(arCfg.BinaryData.BinaryVector);
-	size_t numAnalog = CalcNumType(arCfg.AnalogData.AnalogVector);
-	size_t numCounter = CalcNumType(arCfg.CounterData.CounterVector);
+	std::vector<size_t> binaryIdx, analogIdx, counterIdx, controlStatusIdx, setpointStatusIdx;
+
+	size_t numBinary = CalcLayout(arCfg.BinaryData.BinaryVector, binaryIdx);
+	size_t numAnalog = CalcLayout(arCfg.AnalogData.AnalogVector, analogIdx);
+	size_t numCounter = CalcLayout(arCfg.CounterData.CounterVector, counterIdx);
 	size_t numControl = CalcNumType(arCfg.ControlData.ControlVector);
 	size_t numSetpoint = CalcNumType(arCfg.SetpointData.SetpointVector);
-	size_t numControlStatus = CalcNumType(arCfg.ControlStatusData.ControlStatusVector);
-	size_t numSetpointStatus = CalcNumType(arCfg.SetpointStatusData.SetpointStatusVector);
+	size_t numControlStatus = CalcLayout(arCfg.ControlStatusData.ControlStatusVector, controlStatusIdx);
+	size_t numSetpointStatus = CalcLayout(arCfg.SetpointStatusData.SetpointStatusVector, setpointStatusIdx);
 
 	DeviceTemplate t(numBinary, numAnalog, numCounter, numControlStatus, numSetpointStatus, numControl, numSetpoint);
 
-	AddEventPoints(arCfg.BinaryData.BinaryVector, t.mBinary);
-	AddDeadbandPoints(arCfg.AnalogData.AnalogVector, t.mAnalog);
-	AddEventPoints(arCfg.CounterData.CounterVector, t.mCounter);
+	AddEventPoints(arCfg.BinaryData.BinaryVector, t.mBinary, binaryIdx);
+	AddDeadbandPoints(arCfg.AnalogData.AnalogVector, t.mAnalog, analogIdx);
+	AddEventPoints(arCfg.CounterData.CounterVector, t.mCounter, counterIdx);
 
 	AddCommandData(arCfg.ControlData.ControlVector, t.mControls);
 	AddCommandData(arCfg.SetpointData.SetpointVector, t.mSetpoints);
 
-	AddPoints(arCfg.ControlStatusData.ControlStatusVector, t.mControlStatus);
-	AddPoints(arCfg.SetpointStatusData.SetpointStatusVector, t.mSetpointStatus);
+	AddPoints(arCfg.ControlStatusData.ControlStatusVector, t.mControlStatus, controlStatusIdx);
+	AddPoints(arCfg.SetpointStatusData.SetpointStatusVector, t.mSetpointStatus, setpointStatusIdx);
+
+	t.mBinaryIndices = binaryIdx;
+	t.mAnalogIndices = analogIdx;
+	t.mCounterIndices = counterIdx;
+	t.mControlStatusIndices = controlStatusIdx;
+	t.mSetpointStatusIndices = setpointStatusIdx;
 
 	t.mStartOnline = aStartOnline;
 
@@ -24,6 +24,7 @@
 
 #include <APLXML/XMLConversion.h>
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <vector>
@@ -100,22 +101,51 @@ private:
 		else return 0;
 	}
 
+	/**
+		Lays out the points of a measurement type. When more than half of the
+		index space would be empty the ascending indices are returned through
+		arIndices and the records are stored compactly instead of by index.
+
+		@return the number of records to allocate
+	*/
+	template <typename T>
+	static size_t CalcLayout(const std::vector<T*>& arIdxVec, std::vector<size_t>& arIndices) {
+		std::set<size_t> indexSet;
+
+		for(size_t i = 0; i < arIdxVec.size(); ++i) {
+			indexSet.insert(arIdxVec[i]->Index);
+		}
+		if(indexSet.empty()) return 0;
+
+		size_t num = *indexSet.rbegin() + 1;
+		if(num <= 2 * indexSet.size()) return num;
+
+		arIndices.assign(indexSet.begin(), indexSet.end());
+		return arIndices.size();
+	}
+
+	// @return the position of the record for an index in a layout from CalcLayout()
+	static size_t PositionOf(const std::vector<size_t>& arIndices, size_t aIndex) {
+		if(arIndices.empty()) return aIndex;
+		return std::lower_bound(arIndices.begin(), arIndices.end(), aIndex) - arIndices.begin();
+	}
+
 	template <class T>
-	static void AddPoints(const std::vector<T*>& arXML, std::vector<PointRecord>& arVec) {
+	static void AddPoints(const std::vector<T*>& arXML, std::vector<PointRecord>& arVec, const std::vector<size_t>& arIndices) {
 		for(size_t i = 0; i < arXML.size(); ++i)
-			arVec[arXML[i]->Index] = PointRecord(arXML[i]->Name);
+			arVec[PositionOf(arIndices, arXML[i]->Index)] = PointRecord(arXML[i]->Name);
 	}
 
 	template <class T>
-	static void AddEventPoints(const std::vector<T*>& arXML, std::vector<EventPointRecord>& arVec) {
+	static void AddEventPoints(const std::vector<T*>& arXML, std::vector<EventPointRecord>& arVec, const std::vector<size_t>& arIndices) {
 		for(size_t i = 0; i < arXML.size(); ++i)
-			arVec[arXML[i]->Index] = EventPointRecord(arXML[i]->Name, IntToPointClass(arXML[i]->ClassGroup));
+			arVec[PositionOf(arIndices, arXML[i]->Index)] = EventPointRecord(arXML[i]->Name, IntToPointClass(arXML[i]->ClassGroup));
 	}
 
 	template <class T>
-	static void AddDeadbandPoints(const std::vector<T*>& arXML, std::vector<DeadbandPointRecord>& arVec) {
+	static void AddDeadbandPoints(const std::vector<T*>& arXML, std::vector<DeadbandPointRecord>& arVec, const std::vector<size_t>& arIndices) {
 		for(size_t i = 0; i < arXML.size(); ++i)
-			arVec[arXML[i]->Index] = DeadbandPointRecord(arXML[i]->Name, IntToPointClass(arXML[i]->ClassGroup), arXML[i]->Deadband);
+			arVec[PositionOf(arIndices, arXML[i]->Index)] = DeadbandPointRecord(arXML[i]->Name, IntToPointClass(arXML[i]->ClassGroup), arXML[i]->Deadband);
 	}
 
 	template <class T>
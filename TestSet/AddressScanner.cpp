@@ -1,7 +1,8 @@
+//
 // Licensed to Green Energy Corp (www.greenenergycorp.com) under one
 // or more contributor license agreements. See the NOTICE file
 // distributed with this work for additional information
-// regarding copyright ownership.  Green Energy Corp licenses this file
+// regarding copyright ownership.  Green Enery Corp licenses this file
 // to you under the Apache License, Version 2.0 (the
 // "License"); you may not use this file except in compliance
 // with the License.  You may obtain a copy of the License at
@@ -15,88 +16,77 @@
 // specific language governing permissions and limitations
 // under the License.
 //
-
 #include "AddressScanner.h"
 
 #include <opendnp3/APL/Logger.h>
 #include <APLXML/XMLConversion.h>
+#include <DNP3XML/XmlToConfig.h>
 #include <XMLBindings/APLXML_MTS.h>
 
-#include <boost/bind.hpp>
+using namespace APLXML_Base;
 
 namespace apl
 {
 namespace dnp
 {
 
-AddressScanner::AddressScanner(Logger* apLogger, const APLXML_MTS::MasterTestSet_t& cfg, boost::uint16_t start, boost::uint16_t stop) :
-	Loggable(apLogger),
-	mService(),
-	manager(apLogger, mService.Get(), &cfg.PhysicalLayerList, xml::Convert(cfg.Log.Filter)),
-	mTimerSrc(mService.Get()),
-	mThread(apLogger->GetSubLogger("ioservice"), mService.Get()),
-	mRouter(apLogger, "addr_scan", manager.AcquireLayer(cfg.PhysicalLayer), &mTimerSrc, 1000),
-	mpTimer(NULL),
-	mMasterAddr(cfg.Master.Stack.LinkLayer.LocalAddress),
-	mScanTimeout(cfg.Master.Stack.LinkLayer.AckTimeoutMS),
-	mCurrent(start),
-	mStop(stop)
-{
-	LinkRoute route(cfg.Master.Stack.LinkLayer.RemoteAddress, cfg.Master.Stack.LinkLayer.LocalAddress);
-	mRouter.AddContext(this, route);
-}
-
-void AddressScanner::OnLowerLayerUp()
+template <class T>
+void AppendNames(const std::vector<T*>& arLayers, std::vector<std::string>& arNames)
 {
-	this->NextFrame();
+	for(size_t i = 0; i < arLayers.size(); ++i) arNames.push_back(arLayers[i]->Name);
 }
 
-void AddressScanner::OnLowerLayerDown()
+AddressScanner::AddressScanner(Logger* apLogger, const APLXML_MTS::MasterTestSet_t& cfg, const LinkScanConfig& arScan, bool aAllPorts) :
+	Loggable(apLogger),
+	mMgr(apLogger->GetSubLogger("manager")),
+	mScan(arScan),
+	mLevel(xml::Convert(cfg.Log.Filter)),
+	mNumComplete(0)
 {
+	XmlToConfig::Configure(cfg.PhysicalLayerList, mLevel, mMgr);
+
+	if(aAllPorts) {
+		const PhysicalLayerList_t& l = cfg.PhysicalLayerList;
+		AppendNames(l.TCPv4ClientVector, mPorts);
+		AppendNames(l.TCPv4ServerVector, mPorts);
+		AppendNames(l.TCPv6ClientVector, mPorts);
+		AppendNames(l.TCPv6ServerVector, mPorts);
+		AppendNames(l.UDPv4ClientVector, mPorts);
+		AppendNames(l.UDPv4ServerVector, mPorts);
+		AppendNames(l.UDPv6ClientVector, mPorts);
+		AppendNames(l.UDPv6ServerVector, mPorts);
+		AppendNames(l.SerialVector, mPorts);
+	}
+	else mPorts.push_back(cfg.PhysicalLayer);
 
+	mScan.mLocalAddr = cfg.Master.Stack.LinkLayer.LocalAddress;
 }
 
-void AddressScanner::OnTimeout()
+void AddressScanner::OnAddressFound(const std::string& arName, boost::uint16_t aAddress)
 {
-	LOG_BLOCK(LEV_INFO, "Scan timed out for address: " << mFrame.GetDest());
-	mpTimer = NULL;
-	this->NextFrame();
+	LOG_BLOCK(LEV_EVENT, "Received answer on " << arName << " from address: " << aAddress);
 }
 
-void AddressScanner::NextFrame()
+void AddressScanner::OnScanComplete(const std::string& arName, const std::vector<boost::uint16_t>& arFound)
 {
-	if(mCurrent >= mStop) mRouter.Shutdown();
-	else {
-		mpTimer = mTimerSrc.Start(mScanTimeout, boost::bind(&AddressScanner::OnTimeout, this));
-		mFrame.FormatResetLinkStates(true, mCurrent, mMasterAddr);
-		++mCurrent;
-		mRouter.Transmit(mFrame);
-	}
+	LOG_BLOCK(LEV_INFO, "Scan of " << arName << " complete, " << arFound.size() << " device(s) found");
+	CriticalSection cs(&mLock);
+	++mNumComplete;
+	cs.Signal();
 }
 
-void AddressScanner::Ack(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc)
+void AddressScanner::Run()
 {
-	LOG_BLOCK(LEV_EVENT, "Received acknowledgement from address: " << aSrc);
-	mRouter.Shutdown();
-	if(mpTimer != NULL) mpTimer->Cancel();
-}
-
-void AddressScanner::Nack(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc) {}
-void AddressScanner::LinkStatus(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc) {}
-void AddressScanner::NotSupported (bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc) {}
+	LOG_BLOCK(LEV_INFO, "Scanning " << mPorts.size() << " port(s) from " << mScan.mStart << " to " << mScan.mStop);
 
-void AddressScanner::TestLinkStatus(bool aIsMaster, bool aFcb, boost::uint16_t aDest, boost::uint16_t aSrc) {}
-void AddressScanner::ResetLinkStates(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc) {}
-void AddressScanner::RequestLinkStatus(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc) {}
-void AddressScanner::ConfirmedUserData(bool aIsMaster, bool aFcb, boost::uint16_t aDest, boost::uint16_t aSrc, const boost::uint8_t* apData, size_t aDataLength) {}
-void AddressScanner::UnconfirmedUserData(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc, const boost::uint8_t* apData, size_t aDataLength) {}
+	for(size_t i = 0; i < mPorts.size(); ++i) mMgr.AddLinkScan(mPorts[i], mLevel, mScan, this);
 
-void AddressScanner::Run()
-{
-	mRouter.Start();
+	{
+		CriticalSection cs(&mLock);
+		while(mNumComplete < mPorts.size()) cs.Wait();
+	}
 
-	LOG_BLOCK(LEV_INFO, "Scanning from " << mCurrent << " to " << mStop);
-	mThread.Run();
+	mMgr.Shutdown();
 	LOG_BLOCK(LEV_INFO, "Scan complete...");
 }
 
@@ -86,15 +86,19 @@ void RunStack(const std::string& arConfigFile)
 	stack.Run();
 }
 
-void Scan(const std::string& arConfigFile, boost::uint16_t start, boost::uint16_t stop)
+void Scan(const std::string& arConfigFile, const LinkScanConfig& arScan, bool aAllPorts)
 {
-	if(stop < start) throw ArgumentException(LOCATION, "Start must be < stop");
+	if(arScan.mStop < arScan.mStart) throw ArgumentException(LOCATION, "Start must be < stop");
 
 	EventLog elog;
 	elog.AddLogSubscriber(apl::LogToStdio::Inst());
 	APLXML_MTS::MasterTestSet_t cfg;
 	loadXmlInto(arConfigFile, &cfg);
-	AddressScanner scanner(elog.GetLogger(xml::Convert(cfg.Log.Filter), "Scanner"), cfg, start, stop);
+
+	LinkScanConfig scan(arScan);
+	scan.mTimeout = cfg.Master.Stack.LinkLayer.AckTimeoutMS;
+
+	AddressScanner scanner(elog.GetLogger(xml::Convert(cfg.Log.Filter), "Scanner"), cfg, scan, aAllPorts);
 	scanner.Run();
 }
 
@@ -111,7 +115,11 @@ int main(int argc, char* argv[])
 	("gen_on_no_exist,E", "Generate the specified config file automatically if it doesn't exist")
 	("slave,S", "Use slave test set")
 	("scan_start,A", po::value<boost::uint16_t>(), "Start address for a link layer address scan")
-	("scan_stop,B", po::value<boost::uint16_t>(), "Stop address for a link layer address scan");
+	("scan_stop,B", po::value<boost::uint16_t>(), "Stop address for a link layer address scan")
+	("scan_window,W", po::value<size_t>(), "Number of addresses probed at once during a scan")
+	("scan_retry,R", po::value<size_t>(), "Number of times an unanswered scan probe is repeated")
+	("scan_status,L", "Probe with request link status instead of reset link states")
+	("scan_all,P", "Scan every physical layer in the config instead of just the master's");
 
 	po::variables_map vm;
 	try {
@@ -144,10 +152,12 @@ int main(int argc, char* argv[])
 	try {
 
 		if(vm.count("scan_start") > 0 && vm.count("scan_stop")) {
-			boost::uint16_t start = vm["scan_start"].as<boost::uint16_t>();
-			boost::uint16_t stop = vm["scan_stop"].as<boost::uint16_t>();
+			LinkScanConfig scan(vm["scan_start"].as<boost::uint16_t>(), vm["scan_stop"].as<boost::uint16_t>());
+			if(vm.count("scan_window")) scan.mWindow = vm["scan_window"].as<size_t>();
+			if(vm.count("scan_retry")) scan.mNumRetry = vm["scan_retry"].as<size_t>();
+			if(vm.count("scan_status")) scan.mProbe = LSP_REQUEST_LINK_STATUS;
 
-			Scan(xmlFilename, start, stop);
+			Scan(xmlFilename, scan, vm.count("scan_all") > 0);
 		}
 		else {
 			if ( vm.count("slave") ) {
@@ -0,0 +1,170 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/APL/AsyncLogDispatcher.h>
+#include <opendnp3/APL/Logger.h>
+
+namespace apl
+{
+
+AsyncLogDispatcher::AsyncLogDispatcher(size_t aMaxQueued, Logger* apLogger) :
+	mMaxQueued(aMaxQueued),
+	mNumDropped(0),
+	mDelivering(false),
+	mpLogger(apLogger),
+	mLastDepth(-1),
+	mLastDropped(-1),
+	mThread(this)
+{
+	mThread.Start();
+}
+
+AsyncLogDispatcher::~AsyncLogDispatcher()
+{
+	// the thread drains whatever is still queued before it exits
+	mThread.RequestStop();
+	mThread.WaitForStop();
+}
+
+void AsyncLogDispatcher::AddLogSubscriber(ILogBase* apSubscriber)
+{
+	CriticalSection cs(&mSubscriberLock);
+	mSubscribers.insert(apSubscriber);
+}
+
+void AsyncLogDispatcher::RemoveLogSubscriber(ILogBase* apSubscriber)
+{
+	CriticalSection cs(&mSubscriberLock);
+	mSubscribers.erase(apSubscriber);
+}
+
+void AsyncLogDispatcher::Flush()
+{
+	CriticalSection cs(&mLock);
+	while(mQueue.size() > 0 || mDelivering) cs.Wait();
+}
+
+size_t AsyncLogDispatcher::GetQueueDepth()
+{
+	CriticalSection cs(&mLock);
+	return mQueue.size();
+}
+
+size_t AsyncLogDispatcher::GetNumDropped()
+{
+	CriticalSection cs(&mLock);
+	return mNumDropped;
+}
+
+void AsyncLogDispatcher::Log(const LogEntry& arEntry)
+{
+	Record r;
+	r.mEntry = arEntry;
+	this->Push(r);
+}
+
+void AsyncLogDispatcher::SetVar(const std::string& aSource, const std::string& aVarName, int aValue)
+{
+	Record r;
+	r.mIsVar = true;
+	r.mSource = aSource;
+	r.mVarName = aVarName;
+	r.mValue = aValue;
+	this->Push(r);
+}
+
+void AsyncLogDispatcher::Push(const Record& arRecord)
+{
+	CriticalSection cs(&mLock);
+	if(mQueue.size() >= mMaxQueued) {
+		++mNumDropped;
+		return;
+	}
+	mQueue.push_back(arRecord);
+	// Flush() waits on the same condition, so wake everyone
+	if(mQueue.size() == 1) cs.Broadcast();
+}
+
+void AsyncLogDispatcher::SignalStop()
+{
+	CriticalSection cs(&mLock);
+	cs.Broadcast();
+}
+
+void AsyncLogDispatcher::Run()
+{
+	RecordQueue batch;
+
+	while(true) {
+		size_t depth = 0;
+		{
+			CriticalSection cs(&mLock);
+			while(mQueue.size() == 0 && !this->IsExitRequested()) cs.Wait();
+			if(mQueue.size() == 0) return; // stop requested and fully drained
+
+			// take the whole queue in one go, producers continue with an empty one
+			depth = mQueue.size();
+			batch.swap(mQueue);
+			mDelivering = true;
+		}
+
+		this->Deliver(batch);
+		batch.clear();
+
+		{
+			CriticalSection cs(&mLock);
+			mDelivering = false;
+			cs.Broadcast();
+		}
+
+		this->Publish(depth);
+	}
+}
+
+void AsyncLogDispatcher::Deliver(const RecordQueue& arBatch)
+{
+	CriticalSection cs(&mSubscriberLock);
+	for(RecordQueue::const_iterator i = arBatch.begin(); i != arBatch.end(); ++i) {
+		for(std::set<ILogBase*>::iterator j = mSubscribers.begin(); j != mSubscribers.end(); ++j) {
+			if(i->mIsVar) (*j)->SetVar(i->mSource, i->mVarName, i->mValue);
+			else (*j)->Log(i->mEntry);
+		}
+	}
+}
+
+void AsyncLogDispatcher::Publish(size_t aDepth)
+{
+	if(mpLogger == NULL) return;
+
+	// only publish changes, the updates are queued here too and would otherwise never settle
+	int depth = static_cast<int>(aDepth);
+	int dropped = static_cast<int>(this->GetNumDropped());
+
+	if(depth != mLastDepth) {
+		mLastDepth = depth;
+		LogVariable(mpLogger, "LogQueueDepth").Set(depth);
+	}
+	if(dropped != mLastDropped) {
+		mLastDropped = dropped;
+		LogVariable(mpLogger, "LogDropped").Set(dropped);
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,112 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __ASYNC_LOG_DISPATCHER_H_
+#define __ASYNC_LOG_DISPATCHER_H_
+
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/LogBase.h>
+#include <opendnp3/APL/Thread.h>
+#include <opendnp3/APL/Uncopyable.h>
+
+#include <deque>
+#include <set>
+#include <string>
+
+namespace apl
+{
+
+class Logger;
+
+/**
+Log subscriber that moves the delivery of log entries off of the threads that produce them.
+
+Log() and SetVar() only append to a bounded queue under a short lock, so a
+slow backend (console, disk) can no longer stall the protocol stack. A
+dedicated thread drains the queue in batches and hands the entries to the
+subscribers added to the dispatcher. When the queue is full new entries are
+dropped and counted.
+
+If a logger is supplied, the queue depth observed at the start of each batch
+and the number of dropped entries are published as the log variables
+"LogQueueDepth" and "LogDropped".
+*/
+class AsyncLogDispatcher : public ILogBase, private Threadable, private Uncopyable
+{
+public:
+
+	AsyncLogDispatcher(size_t aMaxQueued = 10000, Logger* apLogger = NULL);
+	~AsyncLogDispatcher();
+
+	/// Subscribers are only ever called from the dispatcher thread
+	void AddLogSubscriber(ILogBase* apSubscriber);
+
+	/// Once this returns the subscriber will not be called again
+	void RemoveLogSubscriber(ILogBase* apSubscriber);
+
+	/// Blocks until everything that was queued before the call has been delivered
+	void Flush();
+
+	size_t GetQueueDepth();
+	size_t GetNumDropped();
+
+	/* Implement ILogBase - these may be called from any thread */
+	void Log(const LogEntry& arEntry);
+	void SetVar(const std::string& aSource, const std::string& aVarName, int aValue);
+
+private:
+
+	struct Record {
+		Record() : mIsVar(false), mValue(0) {}
+
+		bool mIsVar;
+		LogEntry mEntry;
+		std::string mSource;
+		std::string mVarName;
+		int mValue;
+	};
+
+	typedef std::deque<Record> RecordQueue;
+
+	void Push(const Record& arRecord);
+	void Deliver(const RecordQueue& arBatch);
+	void Publish(size_t aDepth);
+
+	/* Implement Threadable */
+	void Run();
+	void SignalStop();
+
+	SigLock mLock;
+	RecordQueue mQueue;
+	size_t mMaxQueued;
+	size_t mNumDropped;
+	bool mDelivering;
+
+	SigLock mSubscriberLock;
+	std::set<ILogBase*> mSubscribers;
+
+	Logger* mpLogger;
+	int mLastDepth;
+	int mLastDropped;
+
+	Thread mThread;
+};
+
+}
+
+#endif
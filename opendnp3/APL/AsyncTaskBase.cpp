@@ -42,7 +42,10 @@ AsyncTaskBase::AsyncTaskBase(int aPriority,
 	mpGroup(apGroup),
 	mNextRunTime(arInitialTime),
 	M_INITIAL_TIME(arInitialTime),
-	mFlags(0)
+	mFlags(0),
+	mSequence(0),
+	mpHeap(NULL),
+	mHeapIndex(0)
 {
 
 }
@@ -62,12 +65,14 @@ void AsyncTaskBase::Enable()
 void AsyncTaskBase::SilentEnable()
 {
 	mIsEnabled = true;
+	mpGroup->Requeue(this);
 }
 
 void AsyncTaskBase::SilentDisable()
 {
 	this->Reset();
 	mIsEnabled = false;
+	mpGroup->Requeue(this);
 }
 
 void AsyncTaskBase::Dispatch()
@@ -78,6 +83,7 @@ void AsyncTaskBase::Dispatch()
 	mIsRunning = true;
 	mIsComplete = false;
 	mIsExpired = false;
+	mpGroup->Requeue(this);
 	mHandler(this);
 }
 
@@ -102,6 +108,15 @@ bool AsyncTaskBase::IsDependency(const AsyncTaskBase* apTask) const
 	return false;
 }
 
+bool AsyncTaskBase::IsBlocked() const
+{
+	BOOST_FOREACH(const AsyncTaskBase * p, mDependencies) {
+		if(!p->IsComplete() || p->IsBlocked()) return true;
+	}
+
+	return false;
+}
+
 void AsyncTaskBase::OnComplete(bool aSuccess)
 {
 	if(!mIsRunning) {
@@ -110,6 +125,7 @@ void AsyncTaskBase::OnComplete(bool aSuccess)
 	mIsRunning = false;
 
 	this->_OnComplete(aSuccess);
+	mpGroup->Requeue(this);
 
 	mpGroup->OnCompletion();
 }
@@ -119,6 +135,7 @@ void AsyncTaskBase::Reset()
 	mIsComplete = mIsExpired = mIsRunning = false;
 	mNextRunTime = M_INITIAL_TIME;
 	this->_Reset();
+	mpGroup->Requeue(this);
 }
 
 void AsyncTaskBase::UpdateTime(const boost::posix_time::ptime& arTime)
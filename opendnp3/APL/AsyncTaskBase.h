@@ -30,6 +30,7 @@ namespace apl
 {
 
 class AsyncTaskGroup;
+class AsyncTaskHeap;
 
 /**
  * Asynchronous task. Task execution order is controlled by the period, retry,
@@ -39,6 +40,7 @@ class AsyncTaskGroup;
 class AsyncTaskBase : public ITask, private Uncopyable
 {
 	friend class AsyncTaskGroup;
+	friend class AsyncTaskHeap;
 	friend class AsyncTaskScheduler;
 
 public:
@@ -52,6 +54,9 @@ public:
 	void AddDependency(const AsyncTaskBase* apTask);
 	bool IsDependency(const AsyncTaskBase*) const;
 
+	// @return true if any direct or indirect dependency is incomplete
+	bool IsBlocked() const;
+
 	void SetFlags(int aFlags) {
 		mFlags = aFlags;
 	}
@@ -145,6 +150,12 @@ protected:
 	boost::posix_time::ptime mNextRunTime;	// next execution time for the task
 	const boost::posix_time::ptime M_INITIAL_TIME;
 	int mFlags;
+
+private:
+
+	size_t mSequence;						// order in which the task was added, breaks remaining ties
+	AsyncTaskHeap* mpHeap;					// group queue the task is in, NULL if none
+	size_t mHeapIndex;						// position in mpHeap
 };
 
 }
@@ -38,7 +38,12 @@ AsyncTaskGroup::AsyncTaskGroup(ITimerSource* apTimerSrc, ITimeSource* apTimeSrc)
 	mShutdown(false),
 	mpTimerSrc(apTimerSrc),
 	mpTimeSrc(apTimeSrc),
-	mpTimer(NULL)
+	mpTimer(NULL),
+	mPending(&AsyncTaskGroup::RunsEarlier),
+	mReady(&AsyncTaskGroup::RunsFirst),
+	mpRunning(NULL),
+	mLastUpdate(min_date_time),
+	mNextSequence(0)
 {
 
 }
@@ -60,6 +65,7 @@ AsyncTaskBase* AsyncTaskGroup::Add(millis_t aPeriod, millis_t aRetryDelay, int a
 	else
 		pTask = new AsyncTaskNonPeriodic(aRetryDelay, aPriority, arCallback, this, arName);
 
+	pTask->mSequence = mNextSequence++;
 	mTaskVec.push_back(pTask);
 	return pTask;
 }
@@ -79,6 +85,7 @@ void AsyncTaskGroup::ResetTasks(int aMask)
 AsyncTaskContinuous* AsyncTaskGroup::AddContinuous(int aPriority, const TaskHandler& arCallback, const std::string& arName)
 {
 	AsyncTaskContinuous* pTask = new AsyncTaskContinuous(aPriority, arCallback, this, arName);
+	pTask->mSequence = mNextSequence++;
 	mTaskVec.push_back(pTask);
 	return pTask;
 }
@@ -87,6 +94,8 @@ void AsyncTaskGroup::Remove(AsyncTaskBase* apTask)
 {
 	for(TaskVec::iterator i = mTaskVec.begin(); i != mTaskVec.end(); ++i) {
 		if(*i == apTask) {
+			this->Unqueue(apTask);
+			if(mpRunning == apTask) mpRunning = NULL;
 			delete *i;
 			mTaskVec.erase(i);
 			return;
@@ -140,33 +149,40 @@ void AsyncTaskGroup::Disable(int aMask)
 AsyncTaskBase* AsyncTaskGroup::GetNext(const boost::posix_time::ptime& arTime)
 {
 	this->Update(arTime);
-	TaskVec::iterator max = max_element(mTaskVec.begin(), mTaskVec.end(), AsyncTaskBase::LessThanGroupLevel);
 
+	// due tasks waiting on an incomplete dependency are set aside while looking for one that can run
 	AsyncTaskBase* pRet = NULL;
-	if(max != mTaskVec.end()) {
-		AsyncTaskBase* p = *max;
-		if(!p->IsRunning() && p->IsEnabled()) pRet = p;
+	while(!mReady.Empty()) {
+		if(!mReady.Top()->IsBlocked()) {
+			pRet = mReady.Top();
+			break;
+		}
+		mBlocked.push_back(mReady.Pop());
+	}
+
+	BOOST_FOREACH(AsyncTaskBase * p, mBlocked) {
+		mReady.Push(p);
 	}
+	mBlocked.clear();
 
 	return pRet;
 }
 
 void AsyncTaskGroup::CheckState()
 {
-	if(!mShutdown) {
-		ptime now = GetUTC();
-		AsyncTaskBase* pTask = GetNext(now);
+	// only one task runs at a time
+	if(mShutdown || this->IsTaskRunning()) return;
 
-		if(pTask == NULL) return;
-		if(pTask->NextRunTime() == max_date_time) return;
+	ptime now = GetUTC();
+	AsyncTaskBase* pTask = GetNext(now);
 
-		if(pTask->NextRunTime() <= now) {
-			mIsRunning = true;
-			pTask->Dispatch();
-		}
-		else {
-			this->RestartTimer(pTask->NextRunTime());
-		}
+	if(pTask != NULL) {
+		mIsRunning = true;
+		mpRunning = pTask;
+		pTask->Dispatch();
+	}
+	else if(!mPending.Empty() && mPending.Top()->NextRunTime() != max_date_time) {
+		this->RestartTimer(mPending.Top()->NextRunTime());
 	}
 }
 
@@ -184,18 +200,68 @@ boost::posix_time::ptime AsyncTaskGroup::GetUTC() const
 
 void AsyncTaskGroup::Update(const boost::posix_time::ptime& arTime)
 {
-	BOOST_FOREACH(AsyncTaskBase * p, mTaskVec) {
+	// if the clock went backwards, tasks that were due may not be anymore
+	if(arTime < mLastUpdate) {
+		while(!mReady.Empty()) {
+			AsyncTaskBase* p = mReady.Pop();
+			p->UpdateTime(arTime);
+			mPending.Push(p);
+		}
+	}
+	mLastUpdate = arTime;
+
+	while(!mPending.Empty() && mPending.Top()->NextRunTime() <= arTime) {
+		AsyncTaskBase* p = mPending.Pop();
 		p->UpdateTime(arTime);
+		mReady.Push(p);
+	}
+}
+
+void AsyncTaskGroup::Requeue(AsyncTaskBase* apTask)
+{
+	if(!apTask->IsEnabled() || apTask->IsRunning()) {
+		this->Unqueue(apTask);
+	}
+	else if(mPending.Contains(apTask)) {
+		mPending.Update(apTask);
+	}
+	else {
+		// due tasks are moved back to the ready heap by the next Update()
+		if(mReady.Contains(apTask)) mReady.Erase(apTask);
+		mPending.Push(apTask);
 	}
 }
 
+void AsyncTaskGroup::Unqueue(AsyncTaskBase* apTask)
+{
+	if(mPending.Contains(apTask)) mPending.Erase(apTask);
+	else if(mReady.Contains(apTask)) mReady.Erase(apTask);
+}
+
+bool AsyncTaskGroup::IsTaskRunning() const
+{
+	return mpRunning != NULL && mpRunning->IsRunning();
+}
+
+bool AsyncTaskGroup::RunsEarlier(const AsyncTaskBase* l, const AsyncTaskBase* r)
+{
+	if(l->NextRunTime() != r->NextRunTime()) return l->NextRunTime() < r->NextRunTime();
+	return l->mSequence < r->mSequence;
+}
+
+bool AsyncTaskGroup::RunsFirst(const AsyncTaskBase* l, const AsyncTaskBase* r)
+{
+	if(l->Priority() != r->Priority()) return l->Priority() > r->Priority();
+	return l->mSequence < r->mSequence;
+}
+
 void AsyncTaskGroup::RestartTimer(const boost::posix_time::ptime& arTime)
 {
-	if(mpTimer != NULL) {
-		if(mpTimer->ExpiresAt() != arTime) {
-			mpTimer->Cancel();
-			mpTimer = NULL;
-		}
+	// a timer that expires early only causes the state to be checked again,
+	// so it is only replaced when the deadline moves earlier
+	if(mpTimer != NULL && mpTimer->ExpiresAt() > arTime) {
+		mpTimer->Cancel();
+		mpTimer = NULL;
 	}
 
 	if(mpTimer == NULL)
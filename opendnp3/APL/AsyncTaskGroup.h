@@ -19,6 +19,7 @@
 #ifndef __ASYNC_TASK_GROUP_H_
 #define __ASYNC_TASK_GROUP_H_
 
+#include <opendnp3/APL/AsyncTaskHeap.h>
 #include <opendnp3/APL/AsyncTaskInterfaces.h>
 #include <opendnp3/APL/Types.h>
 #include <opendnp3/APL/Uncopyable.h>
@@ -41,6 +42,11 @@ class ITimer;
 
 /**
  A collection of related tasks with optional dependencies
+
+ Enabled tasks that aren't running are kept in one of two heaps. Tasks that
+ are not yet due wait in a heap ordered by next run time, and are moved to a
+ heap ordered by priority once their time comes, so choosing the next task
+ and the next timer deadline don't have to look at every task in the group.
 */
 class AsyncTaskGroup : private Uncopyable
 {
@@ -84,6 +90,14 @@ private:
 	void Update(const boost::posix_time::ptime& arTime);
 	AsyncTaskBase* GetNext(const boost::posix_time::ptime& arTime);
 
+	// Moves a task to the right queue after its state or run time has changed
+	void Requeue(AsyncTaskBase* apTask);
+	void Unqueue(AsyncTaskBase* apTask);
+	bool IsTaskRunning() const;
+
+	static bool RunsEarlier(const AsyncTaskBase* l, const AsyncTaskBase* r);
+	static bool RunsFirst(const AsyncTaskBase* l, const AsyncTaskBase* r);
+
 	bool mIsRunning;
 	bool mShutdown;
 	ITimerSource* mpTimerSrc;
@@ -94,6 +108,13 @@ private:
 
 	typedef std::vector< AsyncTaskBase* > TaskVec;
 	TaskVec mTaskVec;
+
+	AsyncTaskHeap mPending;		// enabled tasks that aren't due, earliest first
+	AsyncTaskHeap mReady;		// enabled tasks that are due, highest priority first
+	TaskVec mBlocked;			// scratch space for due tasks waiting on a dependency
+	AsyncTaskBase* mpRunning;	// last task dispatched
+	boost::posix_time::ptime mLastUpdate;
+	size_t mNextSequence;
 };
 
 }
@@ -0,0 +1,111 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/APL/AsyncTaskBase.h>
+#include <opendnp3/APL/AsyncTaskHeap.h>
+
+#include <assert.h>
+
+namespace apl
+{
+
+AsyncTaskHeap::AsyncTaskHeap(Order aOrder) :
+	mOrder(aOrder)
+{}
+
+bool AsyncTaskHeap::Contains(const AsyncTaskBase* apTask) const
+{
+	return apTask->mpHeap == this;
+}
+
+void AsyncTaskHeap::Push(AsyncTaskBase* apTask)
+{
+	assert(apTask->mpHeap == NULL);
+	apTask->mpHeap = this;
+	mTasks.push_back(apTask);
+	this->Place(apTask, mTasks.size() - 1);
+	this->SiftUp(mTasks.size() - 1);
+}
+
+AsyncTaskBase* AsyncTaskHeap::Pop()
+{
+	AsyncTaskBase* pTask = mTasks.front();
+	this->Erase(pTask);
+	return pTask;
+}
+
+void AsyncTaskHeap::Erase(AsyncTaskBase* apTask)
+{
+	assert(apTask->mpHeap == this);
+	size_t i = apTask->mHeapIndex;
+	AsyncTaskBase* pLast = mTasks.back();
+	mTasks.pop_back();
+
+	apTask->mpHeap = NULL;
+
+	if(pLast != apTask) {
+		// the last task fills the hole and may need to move either way
+		this->Place(pLast, i);
+		this->Update(pLast);
+	}
+}
+
+void AsyncTaskHeap::Update(AsyncTaskBase* apTask)
+{
+	assert(apTask->mpHeap == this);
+	size_t i = apTask->mHeapIndex;
+	this->SiftUp(i);
+	if(apTask->mHeapIndex == i) this->SiftDown(i);
+}
+
+void AsyncTaskHeap::Place(AsyncTaskBase* apTask, size_t aIndex)
+{
+	mTasks[aIndex] = apTask;
+	apTask->mHeapIndex = aIndex;
+}
+
+void AsyncTaskHeap::SiftUp(size_t aIndex)
+{
+	AsyncTaskBase* pTask = mTasks[aIndex];
+	while(aIndex > 0) {
+		size_t parent = (aIndex - 1) / 2;
+		if(!mOrder(pTask, mTasks[parent])) break;
+		this->Place(mTasks[parent], aIndex);
+		aIndex = parent;
+	}
+	this->Place(pTask, aIndex);
+}
+
+void AsyncTaskHeap::SiftDown(size_t aIndex)
+{
+	AsyncTaskBase* pTask = mTasks[aIndex];
+	size_t size = mTasks.size();
+	for(;;) {
+		size_t child = 2 * aIndex + 1;
+		if(child >= size) break;
+		if(child + 1 < size && mOrder(mTasks[child + 1], mTasks[child])) ++child;
+		if(!mOrder(mTasks[child], pTask)) break;
+		this->Place(mTasks[child], aIndex);
+		aIndex = child;
+	}
+	this->Place(pTask, aIndex);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,77 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __ASYNC_TASK_HEAP_H_
+#define __ASYNC_TASK_HEAP_H_
+
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+
+class AsyncTaskBase;
+
+/**
+ * Binary heap of tasks that supports removing or repositioning any task in
+ * O(log n). Each task records its position in the heap it belongs to, so a
+ * task can be a member of at most one heap at a time.
+ */
+class AsyncTaskHeap
+{
+public:
+
+	// returns true if the first task should come out of the heap before the second
+	typedef bool (*Order)(const AsyncTaskBase*, const AsyncTaskBase*);
+
+	AsyncTaskHeap(Order aOrder);
+
+	bool Empty() const {
+		return mTasks.empty();
+	}
+
+	size_t Size() const {
+		return mTasks.size();
+	}
+
+	AsyncTaskBase* Top() const {
+		return mTasks.front();
+	}
+
+	bool Contains(const AsyncTaskBase* apTask) const;
+
+	void Push(AsyncTaskBase* apTask);
+	AsyncTaskBase* Pop();
+	void Erase(AsyncTaskBase* apTask);
+
+	/// Restores the heap order after the key of a member task has changed, either way
+	void Update(AsyncTaskBase* apTask);
+
+private:
+
+	void Place(AsyncTaskBase* apTask, size_t aIndex);
+	void SiftUp(size_t aIndex);
+	void SiftDown(size_t aIndex);
+
+	Order mOrder;
+	std::vector<AsyncTaskBase*> mTasks;
+};
+
+}
+
+#endif
@@ -47,9 +47,14 @@ AsyncTaskScheduler::~AsyncTaskScheduler()
 }
 
 AsyncTaskGroup* AsyncTaskScheduler::CreateNewGroup()
+{
+	return this->CreateNewGroup(mpTimerSrc);
+}
+
+AsyncTaskGroup* AsyncTaskScheduler::CreateNewGroup(ITimerSource* apTimerSrc)
 {
 	CriticalSection cs(&mLock);
-	AsyncTaskGroup* pGroup = new AsyncTaskGroup(mpTimerSrc, mpTimeSrc);
+	AsyncTaskGroup* pGroup = new AsyncTaskGroup(apTimerSrc, mpTimeSrc);
 	mGroupSet.insert(pGroup);
 	return pGroup;
 }
@@ -45,6 +45,9 @@ public:
 	~AsyncTaskScheduler();
 
 	AsyncTaskGroup* CreateNewGroup();
+
+	// Creates a group whose tasks are timed and executed on a different timer source
+	AsyncTaskGroup* CreateNewGroup(ITimerSource* apTimerSrc);
 	void ReleaseGroup(AsyncTaskGroup*);
 
 private:
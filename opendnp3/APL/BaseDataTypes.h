@@ -166,6 +166,8 @@ class BoolDataPoint : public DataPoint
 {
 public:
 
+	typedef bool Type;
+
 	bool GetValue() const;
 	void SetValue(bool aValue);
 
@@ -18,6 +18,21 @@
 //
 #include <opendnp3/APL/CRC.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define APL_CRC_CLMUL
+#define APL_CRC_CLMUL_TARGET __attribute__((target("sse2,pclmul")))
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define APL_CRC_CLMUL
+#define APL_CRC_CLMUL_TARGET
+#include <intrin.h>
+#include <wmmintrin.h>
+#endif
+
+#include <assert.h>
+
 namespace apl
 {
 unsigned int CRC::CalcCRC(const boost::uint8_t* aInput, size_t aLength, const unsigned int* apTable, unsigned int aStart, bool aInvert)
@@ -49,4 +64,140 @@ void CRC::PrecomputeCRC(unsigned int* apTable, unsigned int aPolynomial)
 		apTable[i] = CRC;
 	}
 }
+
+void CRC::PrecomputeSlices(boost::uint16_t* apSlices, size_t aNumSlices, const unsigned int* apTable)
+{
+	for(size_t i = 0; i < 256; ++i) apSlices[i] = static_cast<boost::uint16_t>(apTable[i]);
+
+	for(size_t k = 1; k < aNumSlices; ++k) {
+		const boost::uint16_t* pLast = apSlices + (k - 1) * 256;
+		boost::uint16_t* pSlice = apSlices + k * 256;
+		for(size_t i = 0; i < 256; ++i) {
+			pSlice[i] = static_cast<boost::uint16_t>(apTable[pLast[i] & 0xFF] ^ (pLast[i] >> 8));
+		}
+	}
+}
+
+unsigned int CRC::CalcCRCSlice8(const boost::uint8_t* aInput, size_t aLength, const boost::uint16_t* apSlices, unsigned int aStart, bool aInvert)
+{
+	const boost::uint16_t* s = apSlices;
+	unsigned int CRC = aStart;
+
+	while(aLength >= 8) {
+		CRC ^= aInput[0] | (aInput[1] << 8);
+		CRC = s[7 * 256 + (CRC & 0xFF)] ^ s[6 * 256 + (CRC >> 8)] ^
+		      s[5 * 256 + aInput[2]] ^ s[4 * 256 + aInput[3]] ^
+		      s[3 * 256 + aInput[4]] ^ s[2 * 256 + aInput[5]] ^
+		      s[1 * 256 + aInput[6]] ^ s[aInput[7]];
+		aInput += 8;
+		aLength -= 8;
+	}
+
+	for(size_t i = 0; i < aLength; ++i) {
+		CRC = s[(CRC ^ aInput[i]) & 0xFF] ^ (CRC >> 8);
+	}
+
+	if(aInvert) CRC = (~CRC) & 0xFFFF;
+
+	return CRC;
+}
+
+unsigned int CRC::CalcCRCSlice16(const boost::uint8_t* aInput, size_t aLength, const boost::uint16_t* apSlices, unsigned int aStart, bool aInvert)
+{
+	const boost::uint16_t* s = apSlices;
+	unsigned int CRC = aStart;
+
+	while(aLength >= 16) {
+		CRC ^= aInput[0] | (aInput[1] << 8);
+		CRC = s[15 * 256 + (CRC & 0xFF)] ^ s[14 * 256 + (CRC >> 8)] ^
+		      s[13 * 256 + aInput[2]] ^ s[12 * 256 + aInput[3]] ^
+		      s[11 * 256 + aInput[4]] ^ s[10 * 256 + aInput[5]] ^
+		      s[9 * 256 + aInput[6]] ^ s[8 * 256 + aInput[7]] ^
+		      s[7 * 256 + aInput[8]] ^ s[6 * 256 + aInput[9]] ^
+		      s[5 * 256 + aInput[10]] ^ s[4 * 256 + aInput[11]] ^
+		      s[3 * 256 + aInput[12]] ^ s[2 * 256 + aInput[13]] ^
+		      s[1 * 256 + aInput[14]] ^ s[aInput[15]];
+		aInput += 16;
+		aLength -= 16;
+	}
+
+	return CalcCRCSlice8(aInput, aLength, apSlices, CRC, aInvert);
+}
+
+boost::uint64_t CRC::CalcFoldConstant(unsigned int aPolynomial)
+{
+	// convert the reflected polynomial back to normal bit order
+	unsigned int normal = 0;
+	for(size_t i = 0; i < 16; ++i) {
+		if(aPolynomial & (1 << i)) normal |= (1 << (15 - i));
+	}
+
+	// x^63 mod P
+	unsigned int rem = 1;
+	for(size_t i = 0; i < 63; ++i) {
+		rem <<= 1;
+		if(rem & 0x10000) rem ^= (0x10000 | normal);
+	}
+
+	// reflected 64-bit form, bit i is the coefficient of x^(63-i)
+	boost::uint64_t ret = 0;
+	for(size_t i = 0; i < 16; ++i) {
+		if(rem & (1 << i)) ret |= (static_cast<boost::uint64_t>(1) << (63 - i));
+	}
+	return ret;
+}
+
+#ifdef APL_CRC_CLMUL
+
+/*
+	With the block loaded little endian, bit i of the 128-bit register is the coefficient of x^(127-i).
+	Multiplying the low (high order) half by x^63 mod P lands the product, which carries an implicit
+	extra factor of x, congruent to H * x^64 in the same bit ordering. Two folds leave a 64-bit value
+	congruent to the block, whose CRC is then the CRC of 8 bytes.
+*/
+APL_CRC_CLMUL_TARGET
+static void FoldBlockClmul(const boost::uint8_t* aInput, boost::uint64_t aFoldConstant, boost::uint8_t* apOut)
+{
+	__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aInput));
+	__m128i k = _mm_set_epi32(0, 0, static_cast<int>(aFoldConstant >> 32), static_cast<int>(aFoldConstant & 0xFFFFFFFF));
+	__m128i folded = _mm_xor_si128(_mm_clmulepi64_si128(data, k, 0x00), _mm_slli_si128(_mm_srli_si128(data, 8), 8));
+	folded = _mm_xor_si128(_mm_clmulepi64_si128(folded, k, 0x00), folded);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(apOut), folded);
+}
+
+unsigned int CRC::CalcCRCBlockClmul(const boost::uint8_t* aInput, boost::uint64_t aFoldConstant, const boost::uint16_t* apSlices)
+{
+	boost::uint8_t folded[16];
+	FoldBlockClmul(aInput, aFoldConstant, folded);
+	return CalcCRCSlice8(folded + 8, 8, apSlices, 0, false);
+}
+
+bool CRC::HasCarrylessMultiply()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 1)) != 0;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+	return (ecx & (1 << 1)) != 0;
+#endif
+}
+
+#else
+
+unsigned int CRC::CalcCRCBlockClmul(const boost::uint8_t* aInput, boost::uint64_t, const boost::uint16_t* apSlices)
+{
+	assert(false); // callers must check HasCarrylessMultiply() first
+	return CalcCRCSlice8(aInput, 16, apSlices, 0, false);
+}
+
+bool CRC::HasCarrylessMultiply()
+{
+	return false;
+}
+
+#endif
+
 }
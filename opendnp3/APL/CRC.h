@@ -26,11 +26,39 @@
 namespace apl
 {
 
+/**
+	Generic reflected CRC routines. The byte-wise CalcCRC is the reference
+	implementation, the sliced variants process 8 or 16 bytes per iteration
+	using a set of tables built by PrecomputeSlices. The carry-less multiply
+	variant folds a 16 byte block into 8 bytes and is only usable on x86
+	processors that report PCLMULQDQ (see HasCarrylessMultiply).
+*/
 class CRC
 {
 public:
 	static unsigned int CalcCRC(const boost::uint8_t* aInput, size_t aLength, const unsigned int* apTable, unsigned int aStart, bool aInvert);
 	static void PrecomputeCRC(unsigned int* apTable, unsigned int aPolynomial);
+
+	/** Builds aNumSlices tables of 256 entries each from a table generated by PrecomputeCRC.
+		Slice k gives the contribution of a byte followed by k zero bytes. */
+	static void PrecomputeSlices(boost::uint16_t* apSlices, size_t aNumSlices, const unsigned int* apTable);
+
+	/// Slice-by-8 implementation of a 16-bit reflected CRC, apSlices must hold at least 8 slices
+	static unsigned int CalcCRCSlice8(const boost::uint8_t* aInput, size_t aLength, const boost::uint16_t* apSlices, unsigned int aStart, bool aInvert);
+
+	/// Slice-by-16 implementation of a 16-bit reflected CRC, apSlices must hold 16 slices
+	static unsigned int CalcCRCSlice16(const boost::uint8_t* aInput, size_t aLength, const boost::uint16_t* apSlices, unsigned int aStart, bool aInvert);
+
+	/** Computes the (uninverted, zero start) CRC of exactly 16 bytes using PCLMULQDQ.
+		@param aFoldConstant Reflected 64-bit representation of x^63 mod P, see CalcFoldConstant
+		@param apSlices Slice tables (at least 8) used to reduce the folded 64-bit remainder */
+	static unsigned int CalcCRCBlockClmul(const boost::uint8_t* aInput, boost::uint64_t aFoldConstant, const boost::uint16_t* apSlices);
+
+	/// Calculates the folding constant used by CalcCRCBlockClmul for a reflected 16-bit polynomial
+	static boost::uint64_t CalcFoldConstant(unsigned int aPolynomial);
+
+	/// True if the processor supports the carry-less multiply instruction (CPUID.01H:ECX.PCLMULQDQ)
+	static bool HasCarrylessMultiply();
 };
 
 }
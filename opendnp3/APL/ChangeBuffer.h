@@ -19,32 +19,56 @@
 #ifndef __CHANGE_BUFFER_H_
 #define __CHANGE_BUFFER_H_
 
+#include <opendnp3/APL/CoalescingTable.h>
+#include <opendnp3/APL/DataBatch.h>
 #include <opendnp3/APL/DataInterfaces.h>
 #include <opendnp3/APL/DataTypes.h>
 #include <opendnp3/APL/INotifier.h>
 #include <opendnp3/APL/SubjectBase.h>
-#include <opendnp3/APL/TimingTools.h>
-
-#include <queue>
+#include <opendnp3/APL/TimeSource.h>
 
 namespace apl
 {
 
 /** Moves measurement data across thread boundaries.
+
+	By default every update is queued and replayed in order by FlushUpdates,
+	which hands each type to the observer as a single batch.
+	In coalescing mode only the latest value of each index is kept between
+	flushes, which bounds memory and flush time for high rate producers at
+	the cost of dropping intermediate values (and therefore their events).
+
+	Observers are notified once per flush: after a notification has been
+	issued, further transactions do not notify again until FlushUpdates
+	has been called. The time of the notifying commit is kept, so the
+	consumer can tell how long the oldest change of a flush has waited.
+	Commits are stamped with the system time unless the consumer supplies
+	the clock it measures against.
 */
 template <class LockType>
 class ChangeBuffer : public IDataObserver, public SubjectBase<NullLock>
 {
 
-	typedef std::deque< Change<Binary> > BinaryQueue;
-	typedef std::deque< Change<Analog> > AnalogQueue;
-	typedef std::deque< Change<Counter> > CounterQueue;
-	typedef std::deque< Change<ControlStatus> > ControlStatusQueue;
-	typedef std::deque< Change<SetpointStatus> > SetpointStatusQueue;
+	typedef DataBatch<Binary> BinaryQueue;
+	typedef DataBatch<Analog> AnalogQueue;
+	typedef DataBatch<Counter> CounterQueue;
+	typedef DataBatch<ControlStatus> ControlStatusQueue;
+	typedef DataBatch<SetpointStatus> SetpointStatusQueue;
 
 public:
 
-	ChangeBuffer() : mMidFlush(false) {}
+	ChangeBuffer(bool aCoalesce = false) :
+		mCoalesce(aCoalesce),
+		mMidFlush(false),
+		mNotifyPending(false),
+		mCommitTime(0),
+		mFlushedCommitTime(0),
+		mpTimeSource(TimeSource::Inst())
+	{}
+
+	bool IsCoalescing() const {
+		return mCoalesce;
+	}
 
 	void _Start() {
 		mLock.Lock();
@@ -56,30 +80,50 @@ public:
 			mMidFlush = false;
 		}
 
-		bool notify = this->HasChanges();
+		bool notify = !mNotifyPending && this->HasChanges();
+		if(notify) {
+			mNotifyPending = true;
+			mCommitTime = mpTimeSource->GetTimeStampUTC();
+		}
 		mLock.Unlock();
 		if(notify) this->NotifyAll();
 	}
 
 	void _Update(const Binary& arPoint, size_t aIndex) {
-		mBinaryQueue.push_back(Change<Binary>(arPoint, aIndex));
+		if(mCoalesce) mBinaryTable.Update(arPoint, aIndex);
+		else mBinaryQueue.Add(arPoint, aIndex);
 	}
 	void _Update(const Analog& arPoint, size_t aIndex) {
-		mAnalogQueue.push_back(Change<Analog>(arPoint, aIndex));
+		if(mCoalesce) mAnalogTable.Update(arPoint, aIndex);
+		else mAnalogQueue.Add(arPoint, aIndex);
 	}
 	void _Update(const Counter& arPoint, size_t aIndex) {
-		mCounterQueue.push_back(Change<Counter>(arPoint, aIndex));
+		if(mCoalesce) mCounterTable.Update(arPoint, aIndex);
+		else mCounterQueue.Add(arPoint, aIndex);
 	}
 	void _Update(const ControlStatus& arPoint, size_t aIndex) {
-		mControlStatusQueue.push_back(Change<ControlStatus>(arPoint, aIndex));
+		if(mCoalesce) mControlStatusTable.Update(arPoint, aIndex);
+		else mControlStatusQueue.Add(arPoint, aIndex);
 	}
 	void _Update(const SetpointStatus& arPoint, size_t aIndex) {
-		mSetpointStatusQueue.push_back(Change<SetpointStatus>(arPoint, aIndex));
+		if(mCoalesce) mSetpointStatusTable.Update(arPoint, aIndex);
+		else mSetpointStatusQueue.Add(arPoint, aIndex);
 	}
 
 
 	size_t FlushUpdates(apl::IDataObserver* apObserver, bool aClear = true);
 
+	/// Time at which the oldest change of the last flush that had changes was committed
+	TimeStamp_t GetFlushedCommitTime() const {
+		return mFlushedCommitTime;
+	}
+
+	/// Sets the clock commits are stamped with, NULL for system time
+	void SetTimeSource(ITimeSource* apTimeSource) {
+		Transaction tr(this);
+		mpTimeSource = (apTimeSource == NULL) ? TimeSource::Inst() : apTimeSource;
+	}
+
 	void Clear() {
 		assert(this->InProgress());
 		_Clear();
@@ -88,31 +132,49 @@ public:
 private:
 
 	void _Clear() {
-		mBinaryQueue.clear();
-		mAnalogQueue.clear();
-		mCounterQueue.clear();
-		mControlStatusQueue.clear();
-		mSetpointStatusQueue.clear();
+		mBinaryQueue.Clear();
+		mAnalogQueue.Clear();
+		mCounterQueue.Clear();
+		mControlStatusQueue.Clear();
+		mSetpointStatusQueue.Clear();
+		mBinaryTable.Clear();
+		mAnalogTable.Clear();
+		mCounterTable.Clear();
+		mControlStatusTable.Clear();
+		mSetpointStatusTable.Clear();
 	}
 
 	bool HasChanges() {
-		return mBinaryQueue.size() > 0 ||
-		       mAnalogQueue.size() > 0 ||
-		       mCounterQueue.size() > 0 ||
-		       mControlStatusQueue.size() > 0 ||
-		       mSetpointStatusQueue.size() > 0;
+		return mBinaryQueue.Size() > 0 ||
+		       mAnalogQueue.Size() > 0 ||
+		       mCounterQueue.Size() > 0 ||
+		       mControlStatusQueue.Size() > 0 ||
+		       mSetpointStatusQueue.Size() > 0 ||
+		       mBinaryTable.Size() > 0 ||
+		       mAnalogTable.Size() > 0 ||
+		       mCounterTable.Size() > 0 ||
+		       mControlStatusTable.Size() > 0 ||
+		       mSetpointStatusTable.Size() > 0;
 	}
 
-	template<class T>
-	size_t FlushUpdates(const T& arContainer, IDataObserver* apObserver);
-
+	const bool mCoalesce;
 	bool mMidFlush;
+	bool mNotifyPending;	// a notification has been issued that hasn't been followed by a flush
+	TimeStamp_t mCommitTime;	// time of the commit that issued the pending notification
+	TimeStamp_t mFlushedCommitTime;
+	ITimeSource* mpTimeSource;
 	BinaryQueue mBinaryQueue;
 	AnalogQueue mAnalogQueue;
 	CounterQueue mCounterQueue;
 	ControlStatusQueue mControlStatusQueue;
 	SetpointStatusQueue mSetpointStatusQueue;
 
+	CoalescingTable<Binary> mBinaryTable;
+	CoalescingTable<Analog> mAnalogTable;
+	CoalescingTable<Counter> mCounterTable;
+	CoalescingTable<ControlStatus> mControlStatusTable;
+	CoalescingTable<SetpointStatus> mSetpointStatusTable;
+
 	LockType mLock;
 };
 
@@ -121,16 +183,23 @@ size_t ChangeBuffer<LockType>::FlushUpdates(apl::IDataObserver* apObserver, bool
 {
 	Transaction tr(this);
 	size_t count = 0;
+	mNotifyPending = false;	// changes committed from here on need a new notification
 	if(!this->HasChanges()) return count;
+	mFlushedCommitTime = mCommitTime;
 
 	{
 		Transaction t(apObserver);
 		mMidFlush = true;	// Will clear on transaction end if an observer call blows up
-		count += this->FlushUpdates(mBinaryQueue, apObserver);
-		count += this->FlushUpdates(mAnalogQueue, apObserver);
-		count += this->FlushUpdates(mCounterQueue, apObserver);
-		count += this->FlushUpdates(mControlStatusQueue, apObserver);
-		count += this->FlushUpdates(mSetpointStatusQueue, apObserver);
+		count += mBinaryQueue.Flush(apObserver);
+		count += mAnalogQueue.Flush(apObserver);
+		count += mCounterQueue.Flush(apObserver);
+		count += mControlStatusQueue.Flush(apObserver);
+		count += mSetpointStatusQueue.Flush(apObserver);
+		count += mBinaryTable.Flush(apObserver);
+		count += mAnalogTable.Flush(apObserver);
+		count += mCounterTable.Flush(apObserver);
+		count += mControlStatusTable.Flush(apObserver);
+		count += mSetpointStatusTable.Flush(apObserver);
 		mMidFlush = false;
 	}
 
@@ -139,18 +208,6 @@ size_t ChangeBuffer<LockType>::FlushUpdates(apl::IDataObserver* apObserver, bool
 	return count;
 }
 
-template <class LockType>
-template <class T>
-size_t ChangeBuffer<LockType>::FlushUpdates(const T& arContainer, IDataObserver* apObserver)
-{
-	size_t count = 0;
-	for(typename T::const_iterator i = arContainer.begin(); i != arContainer.end(); ++i) {
-		apObserver->Update(i->mValue, i->mIndex);
-		++count;
-	}
-	return count;
-}
-
 }
 
 #endif
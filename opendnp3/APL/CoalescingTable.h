@@ -0,0 +1,83 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __COALESCING_TABLE_H_
+#define __COALESCING_TABLE_H_
+
+#include <opendnp3/APL/DataBatch.h>
+
+#include <vector>
+
+namespace apl
+{
+
+/**
+	Per-index "latest value wins" table of pending changes.
+
+	Repeated updates to the same index between flushes overwrite each other,
+	so the memory used and the work done by a flush are bounded by the number
+	of points rather than by the update rate. Changes are flushed in the order
+	in which each index was first changed. The tables grow to the highest
+	index seen and are never shrunk, so a steady state does not allocate.
+*/
+template <class T>
+class CoalescingTable
+{
+public:
+
+	void Update(const T& arValue, size_t aIndex) {
+		if(aIndex >= mValues.size()) {
+			mValues.resize(aIndex + 1);
+			mPending.resize(aIndex + 1, false);
+		}
+		if(!mPending[aIndex]) {
+			mPending[aIndex] = true;
+			mOrder.push_back(aIndex);
+		}
+		mValues[aIndex] = arValue;
+	}
+
+	size_t Size() const {
+		return mOrder.size();
+	}
+
+	/// Gathers the pending changes into a batch and passes it to the observer
+	size_t Flush(IDataObserver* apObserver) {
+		mBatch.Clear();
+		mBatch.Reserve(mOrder.size());
+		for(size_t i = 0; i < mOrder.size(); ++i) mBatch.Add(mValues[mOrder[i]], mOrder[i]);
+		return mBatch.Flush(apObserver);
+	}
+
+	void Clear() {
+		for(size_t i = 0; i < mOrder.size(); ++i) mPending[mOrder[i]] = false;
+		mOrder.clear();
+		mBatch.Clear();
+	}
+
+private:
+
+	std::vector<T> mValues;
+	std::vector<bool> mPending;
+	std::vector<size_t> mOrder;
+	DataBatch<T> mBatch;
+};
+
+}
+
+#endif
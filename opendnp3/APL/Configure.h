@@ -39,6 +39,12 @@
 //if defined, the location is information is compiled into the build for each log call.
 #define APL_COMPILE_LOG_LOCATION
 
+//Log blocks for levels more verbose than this are compiled out entirely, e.g.
+//-DAPL_MIN_LOG_LEVEL=LEV_INFO removes the LEV_INTERPRET, LEV_COMM and LEV_DEBUG blocks
+#ifndef APL_MIN_LOG_LEVEL
+#define APL_MIN_LOG_LEVEL LEV_DEBUG
+#endif
+
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
 
@@ -0,0 +1,80 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __DATA_BATCH_H_
+#define __DATA_BATCH_H_
+
+#include <opendnp3/APL/DataInterfaces.h>
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+
+namespace apl
+{
+
+/**
+	Collects changes of a single type as parallel arrays of values and
+	indices so they can be pushed to an IDataObserver with one UpdateBatch
+	call. Clearing keeps the capacity, so a batch that is reused does not
+	allocate in the steady state.
+*/
+template <class T>
+class DataBatch
+{
+public:
+
+	void Add(const T& arValue, size_t aIndex) {
+		mValues.push_back(arValue);
+		mIndices.push_back(static_cast<boost::uint32_t>(aIndex));
+	}
+
+	void Reserve(size_t aCount) {
+		mValues.reserve(aCount);
+		mIndices.reserve(aCount);
+	}
+
+	size_t Size() const {
+		return mValues.size();
+	}
+
+	/// @return the number of changes the batch holds before it has to allocate
+	size_t Capacity() const {
+		return mValues.capacity();
+	}
+
+	/// Passes the batch to the observer, which must have a transaction started
+	size_t Flush(IDataObserver* apObserver) const {
+		if(mValues.size() > 0) apObserver->UpdateBatch(&mValues[0], &mIndices[0], mValues.size());
+		return mValues.size();
+	}
+
+	void Clear() {
+		mValues.clear();
+		mIndices.clear();
+	}
+
+private:
+
+	std::vector<T> mValues;
+	std::vector<boost::uint32_t> mIndices;
+};
+
+}
+
+#endif
@@ -22,6 +22,8 @@
 #include <opendnp3/APL/DataTypes.h>
 #include <opendnp3/APL/ITransactable.h>
 
+#include <boost/cstdint.hpp>
+
 namespace apl
 {
 /**
@@ -31,6 +33,11 @@ namespace apl
    to publish it to the communication stack. That data needs to be strongly typed
    and passed by index. As with all ITransactables it should be used with the
    exception safe Transaction object.
+
+   The UpdateBatch functions push a run of changes in one call, where
+   apValues[i] is the new value of index apIndices[i]. Observers that can
+   handle a batch more efficiently than point by point override
+   _UpdateBatch, the default implementation calls _Update for each point.
 */
 class IDataObserver : public ITransactable
 {
@@ -46,6 +53,12 @@ public:
 	void Update(const ControlStatus&, size_t aIndex);	//!< push a change to the owner of the database, must have transaction started
 	void Update(const SetpointStatus&, size_t aIndex);	//!< push a change to the owner of the database, must have transaction started
 
+	void UpdateBatch(const Binary* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void UpdateBatch(const Analog* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void UpdateBatch(const Counter* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void UpdateBatch(const ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void UpdateBatch(const SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount);
+
 protected:
 
 	//concrete class will implement these
@@ -55,7 +68,28 @@ protected:
 	virtual void _Update(const ControlStatus& arPoint, size_t) = 0;
 	virtual void _Update(const SetpointStatus& arPoint, size_t) = 0;
 
+	virtual void _UpdateBatch(const Binary* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		this->UpdateEach(apValues, apIndices, aCount);
+	}
+	virtual void _UpdateBatch(const Analog* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		this->UpdateEach(apValues, apIndices, aCount);
+	}
+	virtual void _UpdateBatch(const Counter* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		this->UpdateEach(apValues, apIndices, aCount);
+	}
+	virtual void _UpdateBatch(const ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		this->UpdateEach(apValues, apIndices, aCount);
+	}
+	virtual void _UpdateBatch(const SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		this->UpdateEach(apValues, apIndices, aCount);
+	}
 
+private:
+
+	template <class T>
+	void UpdateEach(const T* apValues, const boost::uint32_t* apIndices, size_t aCount) {
+		for(size_t i = 0; i < aCount; ++i) this->_Update(apValues[i], apIndices[i]);
+	}
 };
 
 //Inline the simple public interface functions
@@ -85,6 +119,32 @@ inline void IDataObserver::Update(const SetpointStatus& arPoint, size_t aIndex)
 	this->_Update(arPoint, aIndex);
 }
 
+inline void IDataObserver::UpdateBatch(const Binary* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	assert(this->InProgress());
+	this->_UpdateBatch(apValues, apIndices, aCount);
+}
+inline void IDataObserver::UpdateBatch(const Analog* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	assert(this->InProgress());
+	this->_UpdateBatch(apValues, apIndices, aCount);
+}
+inline void IDataObserver::UpdateBatch(const Counter* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	assert(this->InProgress());
+	this->_UpdateBatch(apValues, apIndices, aCount);
+}
+inline void IDataObserver::UpdateBatch(const ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	assert(this->InProgress());
+	this->_UpdateBatch(apValues, apIndices, aCount);
+}
+inline void IDataObserver::UpdateBatch(const SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	assert(this->InProgress());
+	this->_UpdateBatch(apValues, apIndices, aCount);
+}
+
 
 }
 
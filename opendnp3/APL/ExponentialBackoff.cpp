@@ -0,0 +1,61 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/APL/ExponentialBackoff.h>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Util.h>
+
+namespace apl
+{
+
+ExponentialBackoff::ExponentialBackoff(millis_t aMinDelay, millis_t aMaxDelay, double aJitter, boost::uint32_t aSeed) :
+	mMinDelay(aMinDelay),
+	mMaxDelay(Max<millis_t>(aMinDelay, aMaxDelay)),
+	mJitter(aJitter),
+	mCurrent(aMinDelay),
+	mNumRetries(0),
+	mRandom(aSeed)
+{
+	if(aMinDelay < 0) throw ArgumentException(LOCATION, "Delay must be non-negative");
+	if(aJitter < 0.0 || aJitter > 1.0) throw ArgumentException(LOCATION, "Jitter must be in [0, 1]");
+}
+
+millis_t ExponentialBackoff::Next()
+{
+	millis_t delay = mCurrent;
+
+	if(mJitter > 0.0 && delay > 0) {
+		// uniform in [0, 1)
+		double fraction = static_cast<double>(mRandom()) / (static_cast<double>(mRandom.max()) + 1.0);
+		delay -= static_cast<millis_t>(delay * mJitter * fraction);
+	}
+
+	mCurrent = (mCurrent > mMaxDelay / 2) ? mMaxDelay : 2 * mCurrent;
+	++mNumRetries;
+
+	return delay;
+}
+
+void ExponentialBackoff::Reset()
+{
+	mCurrent = mMinDelay;
+	mNumRetries = 0;
+}
+
+}
@@ -0,0 +1,89 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __EXPONENTIAL_BACKOFF_H_
+#define __EXPONENTIAL_BACKOFF_H_
+
+#include <opendnp3/APL/Types.h>
+
+#include <boost/random/mersenne_twister.hpp>
+
+#include <stddef.h>
+
+namespace apl
+{
+
+/**
+	Computes the delays between successive retries of a failing operation.
+
+	The first retry waits the minimum delay and every retry after that waits
+	twice as long as the one before, up to the maximum. Each delay is shortened
+	by a random fraction of up to aJitter of itself, so that many channels that
+	failed at the same time don't all retry in lockstep.
+*/
+class ExponentialBackoff
+{
+public:
+
+	/**
+		@param aMinDelay Delay before the first retry
+		@param aMaxDelay Cap on the delay, a value below aMinDelay disables the backoff
+		@param aJitter Fraction of each delay that is randomized, in [0, 1]
+		@param aSeed Seed of the jitter, each instance should use its own
+		@throw ArgumentException if aMinDelay is negative or aJitter is out of range
+	*/
+	ExponentialBackoff(millis_t aMinDelay, millis_t aMaxDelay = 0, double aJitter = 0.0, boost::uint32_t aSeed = 0);
+
+	/// @return the delay before the next retry, the delay after that is doubled
+	millis_t Next();
+
+	/// Starts over at the minimum delay, called when the operation succeeds
+	void Reset();
+
+	/// @return the delay, without jitter, that the next retry will be based on
+	millis_t GetCurrentDelay() const {
+		return mCurrent;
+	}
+
+	/// @return the number of retries since the last Reset()
+	size_t GetNumRetries() const {
+		return mNumRetries;
+	}
+
+	millis_t GetMinDelay() const {
+		return mMinDelay;
+	}
+
+	millis_t GetMaxDelay() const {
+		return mMaxDelay;
+	}
+
+private:
+
+	millis_t mMinDelay;
+	millis_t mMaxDelay;
+	double mJitter;
+
+	millis_t mCurrent;
+	size_t mNumRetries;
+	boost::mt19937 mRandom;
+};
+
+}
+
+#endif
@@ -25,6 +25,17 @@ namespace apl
 
 class IHandlerAsync;
 
+/**
+ * A contiguous region of memory that is part of a gathered write
+ */
+struct WriteSegment {
+	WriteSegment() : mpData(NULL), mLength(0) {}
+	WriteSegment(const boost::uint8_t* apData, size_t aLength) : mpData(apData), mLength(aLength) {}
+
+	const boost::uint8_t* mpData;
+	size_t mLength;
+};
+
 class IPhysicalLayerState
 {
 
@@ -103,6 +114,22 @@ public:
 	 */
 	virtual void AsyncWrite(const boost::uint8_t* apBuffer, size_t aLength) = 0;
 
+	/**
+	 * Starts a send operation that writes several buffers back-to-back
+	 * as if they were one contiguous buffer.
+	 *
+	 * Callback is a single IHandlerAsync::OnSendSuccess after ALL of
+	 * the segments have been written, or a failure will result in the
+	 * layer closing.
+	 *
+	 * @param apSegments	Array of segments to write in order. The
+	 * 						array and the buffers it refers to must
+	 * 						remain available until the write callback
+	 * 						or close occurs.
+	 * @param aNumSegments	Number of entries in apSegments
+	 */
+	virtual void AsyncWriteGather(const WriteSegment* apSegments, size_t aNumSegments) = 0;
+
 	/**
 	 * Starts a read operation.
 	 *
@@ -22,6 +22,14 @@
 
 #include <string>
 
+namespace boost
+{
+namespace asio
+{
+class io_service;
+}
+}
+
 namespace apl
 {
 class IPhysicalLayerAsync;
@@ -32,6 +40,15 @@ public:
 	virtual ~IPhysicalLayerSource() {}
 
 	virtual IPhysicalLayerAsync* AcquireLayer(const std::string& arName) = 0;
+
+	/**
+		Acquires a layer that, if it is created on demand, is driven by apService
+		instead of the source's default io_service. Sources that don't create
+		layers on demand ignore the service.
+	*/
+	virtual IPhysicalLayerAsync* AcquireLayer(const std::string& arName, boost::asio::io_service* /*apService*/) {
+		return this->AcquireLayer(arName);
+	}
 	virtual void ReleaseLayer(const std::string& arName) = 0;
 };
 }
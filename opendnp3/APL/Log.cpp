@@ -30,6 +30,10 @@ using namespace std;
 namespace apl
 {
 
+EventLog::EventLog() :
+	mNumCatchAllSubscribers(0)
+{}
+
 EventLog::~EventLog()
 {
 	for(LoggerMap::iterator i = mLogMap.begin(); i != mLogMap.end(); i++) {
@@ -109,13 +113,29 @@ void EventLog :: AddLogSubscriber(ILogBase* apSubscriber, int aErrorCode)
 		mSubscribers.insert(SubscriberMap::value_type(apSubscriber, set));
 		this->AddLogSubscriber(apSubscriber, aErrorCode);
 	}
-	else i->second.insert(aErrorCode);
+	else {
+		i->second.insert(aErrorCode);
+		this->UpdateSubscribedCodes();
+	}
 }
 
 void EventLog :: RemoveLogSubscriber(ILogBase* apBase)
 {
 	SubscriberMap::iterator i = mSubscribers.find(apBase);
-	if(i != mSubscribers.end()) mSubscribers.erase(i);
+	if(i != mSubscribers.end()) {
+		mSubscribers.erase(i);
+		this->UpdateSubscribedCodes();
+	}
+}
+
+void EventLog :: UpdateSubscribedCodes()
+{
+	mNumCatchAllSubscribers = 0;
+	mSubscribedCodes.clear();
+	for(SubscriberMap::iterator i = mSubscribers.begin(); i != mSubscribers.end(); ++i) {
+		if(this->SetContains(i->second, -1)) ++mNumCatchAllSubscribers;
+		mSubscribedCodes.insert(i->second.begin(), i->second.end());
+	}
 }
 
 }
@@ -39,7 +39,7 @@ class EventLog : public ILogBase, private Uncopyable
 public:
 
 	/** Immediate printing to minimize effect of debugging output on execution timing. */
-	//EventLog();
+	EventLog();
 	virtual ~EventLog();
 
 	Logger* GetLogger( FilterLevel aFilter, const std::string& aLoggerID );
@@ -61,6 +61,14 @@ public:
 	*/
 	void RemoveLogSubscriber(ILogBase* apBase);
 
+	/**
+	* @return True if an entry with this error code would reach at least one
+	* subscriber. Lets loggers skip formatting messages that nobody consumes.
+	*/
+	bool IsConsumed(int aErrorCode) const {
+		return mNumCatchAllSubscribers > 0 || (aErrorCode != -1 && mSubscribedCodes.find(aErrorCode) != mSubscribedCodes.end());
+	}
+
 	//implement the log function from ILogBase
 	void Log( const LogEntry& arEntry );
 	void SetVar(const std::string& aSource, const std::string& aVarName, int aValue);
@@ -68,6 +76,7 @@ public:
 private:
 
 	bool SetContains(const std::set<int>& arSet, int aValue);
+	void UpdateSubscribedCodes();
 
 	SigLock mLock;
 
@@ -77,6 +86,10 @@ private:
 	typedef std::map<ILogBase*, std::set<int> > SubscriberMap;
 	SubscriberMap mSubscribers;
 
+	// summary of mSubscribers for IsConsumed()
+	size_t mNumCatchAllSubscribers;
+	std::set<int> mSubscribedCodes;
+
 };
 
 
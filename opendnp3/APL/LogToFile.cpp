@@ -23,8 +23,8 @@
 namespace apl
 {
 
-LogToFile :: LogToFile(EventLog* apLog, const std::string aFileName, const bool aOverwriteFile)
-	: LogEntryCircularBuffer(1000), mpThread(NULL), mpLog(apLog), mFileName(aFileName), mOverwriteFile(aOverwriteFile)
+LogToFile :: LogToFile(EventLog* apLog, const std::string aFileName, const bool aOverwriteFile, millis_t aFlushPeriod)
+	: LogEntryCircularBuffer(1000), mpThread(NULL), mpLog(apLog), mFileName(aFileName), mOverwriteFile(aOverwriteFile), mFlushPeriod(aFlushPeriod)
 {
 	if(aFileName == "-" || aFileName == "") {
 		mpLog = NULL;
@@ -76,7 +76,7 @@ void LogToFile :: PushItemsToFile()
 		mOverwriteFile = false;
 
 		LogEntry le;
-		while(ReadLog(le)) file << le.LogString() << std::endl;
+		while(ReadLog(le)) file << le.LogString() << '\n';
 
 		file << std::flush;
 		if(file.bad()) std::cerr << "Failure during writing log file: " << file.rdstate() << std::endl;
@@ -91,6 +91,7 @@ void LogToFile :: Run()
 {
 	while(!this->IsExitRequested()) {
 		this->BlockUntilEntry();
+		if(mFlushPeriod > 0 && !this->IsExitRequested()) Thread::SleepFor(mFlushPeriod);
 		this->PushItemsToFile();
 	}
 }
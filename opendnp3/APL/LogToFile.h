@@ -33,11 +33,14 @@ namespace apl
 {
 
 /** Logging backend that uses a buffer and thread to do a non-blocking writeof all the log entries to a text file.
+
+	If aFlushPeriod is non-zero the writer waits that long after the first new
+	entry before opening the file, so bursts of entries are written together.
 */
 class LogToFile: public LogEntryCircularBuffer, public Threadable
 {
 public:
-	LogToFile(EventLog* apLog, const std::string aFileName, const bool aOverwriteFile = false);
+	LogToFile(EventLog* apLog, const std::string aFileName, const bool aOverwriteFile = false, millis_t aFlushPeriod = 0);
 	~LogToFile();
 	void Run();
 
@@ -51,6 +54,7 @@ private:
 	EventLog* mpLog;
 	std::string mFileName;
 	bool mOverwriteFile;
+	millis_t mFlushPeriod;
 };
 
 }
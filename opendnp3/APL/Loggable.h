@@ -45,9 +45,14 @@ protected:
 
 #define LOGGER_BLOCK(logger, severity, string) ERROR_LOGGER_BLOCK(logger, severity, string, -1)
 
+//true if blocks of this level are compiled in, see APL_MIN_LOG_LEVEL. For
+//constant levels the compiler removes the whole block when this is false.
+#define APL_LOG_LEVEL_COMPILED(severity) ((severity) <= APL_MIN_LOG_LEVEL)
+
+//the message is only formatted if the level is enabled and someone subscribes to it
 #ifndef APL_LOGALL
 #define ERROR_LOGGER_BLOCK(logger, severity, string, code)\
-	if(logger->IsEnabled(severity)){\
+	if(APL_LOG_LEVEL_COMPILED(severity) && logger->IsConsumed(severity, code)){\
 		std::ostringstream somecrazyname_oss;\
 		somecrazyname_oss << string;\
 		logger->Log(severity, LOCATION, somecrazyname_oss.str(), code);\
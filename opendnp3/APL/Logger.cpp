@@ -36,6 +36,11 @@ Logger::Logger(EventLog* apLog, FilterLevel aFilter, const std::string& aName)
 	this->SetFilterLevel(aFilter);
 }
 
+bool Logger::IsConsumed(FilterLevel aFilter, int aErrorCode)
+{
+	return this->IsEnabled(aFilter) && mpLog->IsConsumed(aErrorCode);
+}
+
 void Logger::SetFilterLevel(FilterLevel aFilter)
 {
 	mLevel = LogTypes::FilterLevelToMask(aFilter);
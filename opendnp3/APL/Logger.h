@@ -55,6 +55,8 @@ public:
 	inline bool IsEnabled(FilterLevel aFilter) {
 		return (mLevel & aFilter) != 0;
 	}
+	// True if the level is enabled and a subscriber will receive the entry, i.e. it is worth formatting
+	bool IsConsumed(FilterLevel aFilter, int aErrorCode = -1);
 	inline void SetFilters(int aLevel) {
 		mLevel = aLevel;
 	}
@@ -85,6 +85,27 @@ void MultiplexingDataObserver :: _Update(const SetpointStatus& arPoint, size_t a
 	PassThrough<SetpointStatus>(arPoint, aIndex);
 }
 
+void MultiplexingDataObserver :: _UpdateBatch(const Binary* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	PassThroughBatch<Binary>(apValues, apIndices, aCount);
+}
+void MultiplexingDataObserver :: _UpdateBatch(const Analog* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	PassThroughBatch<Analog>(apValues, apIndices, aCount);
+}
+void MultiplexingDataObserver :: _UpdateBatch(const Counter* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	PassThroughBatch<Counter>(apValues, apIndices, aCount);
+}
+void MultiplexingDataObserver :: _UpdateBatch(const ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	PassThroughBatch<ControlStatus>(apValues, apIndices, aCount);
+}
+void MultiplexingDataObserver :: _UpdateBatch(const SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	PassThroughBatch<SetpointStatus>(apValues, apIndices, aCount);
+}
+
 template <typename T>
 void MultiplexingDataObserver :: PassThrough(const T& arPoint, size_t aIndex)
 {
@@ -96,4 +117,15 @@ void MultiplexingDataObserver :: PassThrough(const T& arPoint, size_t aIndex)
 	}
 }
 
+template <typename T>
+void MultiplexingDataObserver :: PassThroughBatch(const T* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	std::vector<IDataObserver*>::iterator iter = mObservers.begin();
+
+	while(iter != mObservers.end()) {
+		(*iter)->UpdateBatch(apValues, apIndices, aCount);
+		++iter;
+	}
+}
+
 }
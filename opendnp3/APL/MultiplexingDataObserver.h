@@ -56,8 +56,17 @@ private:
 	void _Update(const ControlStatus& arPoint, size_t aIndex);
 	void _Update(const SetpointStatus& arPoint, size_t aIndex);
 
+	void _UpdateBatch(const Binary* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const Analog* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const Counter* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount);
+
 	template <typename T>
 	void PassThrough(const T& arPoint, size_t aIndex);
+
+	template <typename T>
+	void PassThroughBatch(const T* apValues, const boost::uint32_t* apIndices, size_t aCount);
 };
 
 }
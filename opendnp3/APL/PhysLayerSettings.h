@@ -29,17 +29,23 @@ class IPhysicalLayerObserver;
 
 struct PhysLayerSettings {
 public:
-	PhysLayerSettings() : LogLevel(LEV_INFO), RetryTimeout(5000), mpObserver(NULL) {}
+	PhysLayerSettings() : LogLevel(LEV_INFO), RetryTimeout(5000), MaxRetryTimeout(0), RetryJitter(0.0), mpObserver(NULL) {}
 
 
 	PhysLayerSettings(FilterLevel aLevel, millis_t aRetryTimeout, IPhysicalLayerObserver* apObserver = NULL) :
 		LogLevel(aLevel),
 		RetryTimeout(aRetryTimeout),
+		MaxRetryTimeout(0),
+		RetryJitter(0.0),
 		mpObserver(apObserver)
 	{}
 
 	FilterLevel LogLevel;
 	millis_t RetryTimeout;
+	// the retry timeout doubles after every failed open up to this value, less than RetryTimeout disables the backoff
+	millis_t MaxRetryTimeout;
+	// fraction of each retry timeout that is randomized to spread out channels that fail together, in [0, 1]
+	double RetryJitter;
 	IPhysicalLayerObserver* mpObserver;
 };
 
@@ -21,6 +21,7 @@
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/APL/PhysicalLayerAsyncBase.h>
 
+#include <memory.h>
 #include <sstream>
 
 using namespace std;
@@ -177,6 +178,21 @@ void PhysicalLayerAsyncBase::AsyncWrite(const boost::uint8_t* apBuff, size_t aNu
 	else throw InvalidStateException(LOCATION, "AsyncWrite: " + this->ConvertStateToString());
 }
 
+void PhysicalLayerAsyncBase::AsyncWriteGather(const WriteSegment* apSegments, size_t aNumSegments)
+{
+	size_t num_bytes = 0;
+	for(size_t i = 0; i < aNumSegments; ++i) num_bytes += apSegments[i].mLength;
+
+	if(num_bytes < 1) throw ArgumentException(LOCATION, "segments must contain > 0 bytes");
+
+	if(mState.CanWrite()) {
+		mState.mWriting = true;
+		if(aNumSegments == 1) this->DoAsyncWrite(apSegments[0].mpData, num_bytes);
+		else this->DoAsyncWriteGather(apSegments, aNumSegments, num_bytes);
+	}
+	else throw InvalidStateException(LOCATION, "AsyncWriteGather: " + this->ConvertStateToString());
+}
+
 void PhysicalLayerAsyncBase::AsyncRead(boost::uint8_t* apBuff, size_t aMaxBytes)
 {
 	if(aMaxBytes < 1) throw ArgumentException(LOCATION, "aMaxBytes must be > 0");
@@ -188,6 +204,17 @@ void PhysicalLayerAsyncBase::AsyncRead(boost::uint8_t* apBuff, size_t aMaxBytes)
 	else throw InvalidStateException(LOCATION, "AsyncRead: " + this->ConvertStateToString());
 }
 
+void PhysicalLayerAsyncBase::DoAsyncWriteGather(const WriteSegment* apSegments, size_t aNumSegments, size_t aNumBytes)
+{
+	mGatherBuffer.resize(aNumBytes);
+	size_t pos = 0;
+	for(size_t i = 0; i < aNumSegments; ++i) {
+		if(apSegments[i].mLength > 0) memcpy(&mGatherBuffer[pos], apSegments[i].mpData, apSegments[i].mLength);
+		pos += apSegments[i].mLength;
+	}
+	this->DoAsyncWrite(&mGatherBuffer[0], aNumBytes);
+}
+
 ///////////////////////////////////////
 // Internal events
 ///////////////////////////////////////
@@ -24,6 +24,8 @@
 
 #include <boost/system/error_code.hpp>
 
+#include <vector>
+
 namespace apl
 {
 
@@ -112,6 +114,7 @@ public:
 	void AsyncOpen();
 	void AsyncClose();
 	void AsyncWrite(const boost::uint8_t*, size_t);
+	void AsyncWriteGather(const WriteSegment*, size_t);
 	void AsyncRead(boost::uint8_t*, size_t);
 
 	// Not an event delegated to the states
@@ -127,6 +130,9 @@ public:
 	virtual void DoAsyncRead(boost::uint8_t*, size_t) = 0;
 	virtual void DoAsyncWrite(const boost::uint8_t*, size_t) = 0;
 
+	// Layers that support scatter-gather IO override this, by default the segments are coalesced into one buffer
+	virtual void DoAsyncWriteGather(const WriteSegment*, size_t aNumSegments, size_t aNumBytes);
+
 	// These can be optionally overriden to do something more interesting, i.e. specific logging
 	virtual void DoOpenCallback() {}
 	virtual void DoOpenSuccess() {}
@@ -157,6 +163,8 @@ protected:
 private:
 
 	void StartClose();
+
+	std::vector<boost::uint8_t> mGatherBuffer;
 };
 
 inline void PhysicalLayerAsyncBase::SetHandler(IHandlerAsync* apHandler)
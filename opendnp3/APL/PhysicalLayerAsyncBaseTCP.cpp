@@ -35,6 +35,30 @@ using namespace std;
 namespace apl
 {
 
+namespace
+{
+// Refers to a range of the layer's gather buffers so that the write operation doesn't copy them
+class ConstBufferRange
+{
+public:
+	typedef const_buffer value_type;
+	typedef const const_buffer* const_iterator;
+
+	ConstBufferRange(const_iterator aBegin, const_iterator aEnd) : mBegin(aBegin), mEnd(aEnd) {}
+
+	const_iterator begin() const {
+		return mBegin;
+	}
+	const_iterator end() const {
+		return mEnd;
+	}
+
+private:
+	const_iterator mBegin;
+	const_iterator mEnd;
+};
+}
+
 PhysicalLayerAsyncBaseTCP::PhysicalLayerAsyncBaseTCP(Logger* apLogger, boost::asio::io_service* apIOService) :
 	PhysicalLayerAsyncASIO(apLogger, apIOService),
 	mSocket(*apIOService)
@@ -69,6 +93,19 @@ void PhysicalLayerAsyncBaseTCP::DoAsyncWrite(const boost::uint8_t* apBuffer, siz
 	                        aNumBytes));
 }
 
+void PhysicalLayerAsyncBaseTCP::DoAsyncWriteGather(const WriteSegment* apSegments, size_t aNumSegments, size_t aNumBytes)
+{
+	mGatherBuffers.clear();
+	for(size_t i = 0; i < aNumSegments; ++i) mGatherBuffers.push_back(buffer(apSegments[i].mpData, apSegments[i].mLength));
+
+	const const_buffer* pBegin = &mGatherBuffers[0];
+	async_write(mSocket, ConstBufferRange(pBegin, pBegin + mGatherBuffers.size()),
+	            boost::bind(&PhysicalLayerAsyncBaseTCP::OnWriteCallback,
+	                        this,
+	                        boost::asio::placeholders::error,
+	                        aNumBytes));
+}
+
 void PhysicalLayerAsyncBaseTCP::DoOpenFailure()
 {
 	LOG_BLOCK(LEV_DEBUG, "Failed socket open, closing socket");
@@ -24,6 +24,7 @@
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <memory>
+#include <vector>
 
 namespace apl
 {
@@ -42,6 +43,7 @@ public:
 	void DoClose();
 	void DoAsyncRead(boost::uint8_t*, size_t);
 	void DoAsyncWrite(const boost::uint8_t*, size_t);
+	void DoAsyncWriteGather(const WriteSegment*, size_t aNumSegments, size_t aNumBytes);
 	void DoOpenFailure();
 
 protected:
@@ -54,6 +56,9 @@ protected:
 private:
 	void ShutdownSocket();
 
+	// asio views of the segments of the current gathered write, reused between writes
+	std::vector<boost::asio::const_buffer> mGatherBuffers;
+
 };
 }
 
@@ -0,0 +1,144 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/PhysicalLayerAsyncSharedTCPServer.h>
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+using namespace boost;
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace apl
+{
+
+PhysicalLayerAsyncSharedTCPServer::PhysicalLayerAsyncSharedTCPServer(Logger* apLogger, boost::asio::io_service* apIOService, const TcpSettings& arSettings)
+	: PhysicalLayerAsyncBaseTCP(apLogger, apIOService)
+	, mWaiting(false)
+	, mPrefixPos(0)
+	, mSettings(arSettings)
+{
+
+}
+
+void PhysicalLayerAsyncSharedTCPServer::Adopt(ip::tcp::socket::native_handle_type aSocket, const ip::tcp::endpoint& arRemote, const std::vector<boost::uint8_t>& arPrefix)
+{
+	mpService->post(boost::bind(&PhysicalLayerAsyncSharedTCPServer::OnAdopt, this, aSocket, arRemote, arPrefix));
+}
+
+void PhysicalLayerAsyncSharedTCPServer::OnAdopt(ip::tcp::socket::native_handle_type aSocket, const ip::tcp::endpoint& arRemote, const std::vector<boost::uint8_t>& arPrefix)
+{
+	error_code ec;
+
+	if(!mWaiting) {
+		LOG_BLOCK(LEV_WARNING, "Rejecting connection from " << arRemote << ", layer is not waiting for a connection");
+		CloseNative(aSocket);
+		return;
+	}
+
+	// on success the handle belongs to the layer's socket, otherwise we still own it
+	mSocket.assign(arRemote.protocol(), aSocket, ec);
+	if(ec) {
+		LOG_BLOCK(LEV_WARNING, "Unable to adopt connection from " << arRemote << ": " << ec.message());
+		CloseNative(aSocket);
+		return;
+	}
+
+	mWaiting = false;
+	mRemoteEndpoint = arRemote;
+	mPrefix = arPrefix;
+	mPrefixPos = 0;
+	this->OnOpenCallback(ec);
+}
+
+void PhysicalLayerAsyncSharedTCPServer::CloseNative(ip::tcp::socket::native_handle_type aSocket)
+{
+#ifdef WIN32
+	::closesocket(aSocket);
+#else
+	::close(aSocket);
+#endif
+}
+
+void PhysicalLayerAsyncSharedTCPServer::DoOpen()
+{
+	mWaiting = true;
+}
+
+void PhysicalLayerAsyncSharedTCPServer::DoOpeningClose()
+{
+	// there's no outstanding operation to cancel, complete the open ourselves
+	mWaiting = false;
+	mpService->post(boost::bind(&PhysicalLayerAsyncSharedTCPServer::OnOpenCallback, this, error_code(error::operation_aborted)));
+}
+
+void PhysicalLayerAsyncSharedTCPServer::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, "Adopted connection from: " << mRemoteEndpoint);
+	if (mSettings.mUseKeepAlives) {
+		boost::asio::socket_base::keep_alive option(true);
+		mSocket.set_option(option);
+		LOG_BLOCK(LEV_DEBUG, "Enabled keepalives on the socket connection to " << mRemoteEndpoint);
+	}
+
+	if (mSettings.mSendBufferSize > 0) {
+		boost::asio::socket_base::send_buffer_size option(mSettings.mSendBufferSize);
+		mSocket.set_option(option);
+		mSocket.get_option(option);
+		LOG_BLOCK(LEV_DEBUG, "Set send buffer size to " << option.value());
+	}
+
+	if (mSettings.mRecvBufferSize > 0) {
+		boost::asio::socket_base::receive_buffer_size option(mSettings.mRecvBufferSize);
+		mSocket.set_option(option);
+		mSocket.get_option(option);
+		LOG_BLOCK(LEV_DEBUG, "Set receive buffer size to " << option.value());
+	}
+}
+
+void PhysicalLayerAsyncSharedTCPServer::DoClose()
+{
+	mPrefix.clear();
+	mPrefixPos = 0;
+	PhysicalLayerAsyncBaseTCP::DoClose();
+}
+
+void PhysicalLayerAsyncSharedTCPServer::DoAsyncRead(boost::uint8_t* apBuffer, size_t aMaxBytes)
+{
+	if(mPrefixPos < mPrefix.size()) {
+		size_t num = std::min(aMaxBytes, mPrefix.size() - mPrefixPos);
+		memcpy(apBuffer, &mPrefix[mPrefixPos], num);
+		mPrefixPos += num;
+		mpService->post(boost::bind(&PhysicalLayerAsyncSharedTCPServer::OnReadCallback, this, error_code(), apBuffer, num));
+	}
+	else PhysicalLayerAsyncBaseTCP::DoAsyncRead(apBuffer, aMaxBytes);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
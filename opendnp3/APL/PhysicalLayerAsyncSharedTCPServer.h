@@ -0,0 +1,82 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_SHARED_TCP_SERVER_H_
+#define __PHYSICAL_LAYER_ASYNC_SHARED_TCP_SERVER_H_
+
+#include <opendnp3/APL/PhysicalLayerAsyncBaseTCP.h>
+#include <opendnp3/APL/TcpSettings.h>
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include <vector>
+
+namespace apl
+{
+
+/**
+	Server side TCP layer that doesn't listen on its own. Connections are
+	accepted by a listener shared with other layers, which hands each
+	connection to the layer that it belongs to through Adopt().
+
+	Opening the layer only makes it eligible to adopt a connection. Any bytes
+	the listener consumed to classify the connection are replayed ahead of
+	the socket's data.
+*/
+class PhysicalLayerAsyncSharedTCPServer : public PhysicalLayerAsyncBaseTCP
+{
+public:
+	PhysicalLayerAsyncSharedTCPServer(Logger*, boost::asio::io_service* apIOService, const TcpSettings& arSettings);
+
+	/**
+		Hands a connected socket to the layer. Thread safe, the socket is
+		taken over from the io_service driving the layer. If the layer isn't
+		waiting for a connection by then, the socket is closed.
+
+		@param aSocket - Native handle the layer takes ownership of
+		@param arRemote - Endpoint of the peer
+		@param arPrefix - Bytes that were already read from the socket
+	*/
+	void Adopt(boost::asio::ip::tcp::socket::native_handle_type aSocket, const boost::asio::ip::tcp::endpoint& arRemote, const std::vector<boost::uint8_t>& arPrefix);
+
+	/* Implement the remaining actions */
+	void DoOpen();
+	void DoOpeningClose();
+	void DoOpenSuccess();
+	void DoClose();
+	void DoAsyncRead(boost::uint8_t*, size_t);
+
+private:
+
+	void OnAdopt(boost::asio::ip::tcp::socket::native_handle_type aSocket, const boost::asio::ip::tcp::endpoint& arRemote, const std::vector<boost::uint8_t>& arPrefix);
+
+	// closes a handle that was never assigned to an asio socket
+	static void CloseNative(boost::asio::ip::tcp::socket::native_handle_type aSocket);
+
+	bool mWaiting;
+
+	boost::asio::ip::tcp::endpoint mRemoteEndpoint;
+	std::vector<boost::uint8_t> mPrefix;
+	size_t mPrefixPos;
+
+	TcpSettings mSettings;
+};
+
+}
+
+#endif
@@ -32,35 +32,112 @@ using namespace std;
 namespace apl
 {
 
-PhysicalLayerAsyncTCPClient::PhysicalLayerAsyncTCPClient(Logger* apLogger, boost::asio::io_service* apIOService, const boost::asio::ip::tcp::endpoint& arEndpoint, const TcpSettings& arSettings)
+PhysicalLayerAsyncTCPClient::PhysicalLayerAsyncTCPClient(Logger* apLogger, boost::asio::io_service* apIOService, const boost::asio::ip::tcp::endpoint& arEndpoint, const TcpSettings& arSettings, ITimeSource* apTimeSrc)
 	: PhysicalLayerAsyncBaseTCP(apLogger, apIOService)
 	, mRemoteEndpoint(arEndpoint)
 	, mSettings(arSettings)
+	, mpTimeSrc(apTimeSrc)
+	, mAsioResolver(*apIOService)
+	, mResolver(boost::bind(&PhysicalLayerAsyncTCPClient::AsyncResolve, this, _1, _2))
+	, mResolving(false)
+	, mResolveCanceled(false)
+	, mCacheValid(false)
+	, mCacheExpiration(0)
 {}
 
 /* Implement the actions */
 void PhysicalLayerAsyncTCPClient::DoOpen()
 {
-	/* Re-resolve the remote address each time just in case DNS shifts things on us */
+	/* Literal addresses never need a lookup */
 	boost::system::error_code ec;
-	boost::asio::ip::address addr = ResolveAddress(mSettings.mAddress, ec);
-	if (ec) {
-		OnOpenCallback(ec);
+	boost::asio::ip::address addr = boost::asio::ip::address::from_string(mSettings.mAddress, ec);
+	if (!ec) {
+		this->Connect(addr);
+		return;
 	}
-	else {
-		mRemoteEndpoint.address(addr);
-		mSocket.async_connect(mRemoteEndpoint,
-	                      	  boost::bind(&PhysicalLayerAsyncTCPClient::OnOpenCallback,
-	                      			  	  this,
-	                      			  	  boost::asio::placeholders::error));
+
+	/* Otherwise re-resolve the remote address each time the cached result expires, just in case DNS shifts things on us */
+	if (mCacheValid && mpTimeSrc->GetTimeStampUTC() < mCacheExpiration) {
+		LOG_BLOCK(LEV_DEBUG, "using cached lookup of '" << mSettings.mAddress << "'");
+		if (mCachedError) {
+			// keep the failure asynchronous just like a real lookup
+			mpService->post(boost::bind(&PhysicalLayerAsyncTCPClient::OnOpenCallback, this, mCachedError));
+		}
+		else this->Connect(mCachedAddress);
+		return;
 	}
+
+	LOG_BLOCK(LEV_DEBUG, "attempting to resolve address '" << mSettings.mAddress << "'");
+	mResolving = true;
+	mResolveCanceled = false;
+	mResolver(mSettings.mAddress, boost::bind(&PhysicalLayerAsyncTCPClient::OnResolve, this, _1, _2));
 }
 
 void PhysicalLayerAsyncTCPClient::DoOpeningClose()
 {
+	if (mResolving) {
+		mResolveCanceled = true;
+		mAsioResolver.cancel();
+	}
 	this->CloseSocket();
 }
 
+void PhysicalLayerAsyncTCPClient::AsyncResolve(const std::string& arHost, const ResolveHandler& arHandler)
+{
+	ip::tcp::resolver::query query(arHost, "");
+	mAsioResolver.async_resolve(query, boost::bind(&PhysicalLayerAsyncTCPClient::OnAsyncResolve,
+	                            this,
+	                            boost::asio::placeholders::error,
+	                            boost::asio::placeholders::iterator,
+	                            arHandler));
+}
+
+void PhysicalLayerAsyncTCPClient::OnAsyncResolve(const boost::system::error_code& ec, ip::tcp::resolver::iterator aIter, ResolveHandler aHandler)
+{
+	if (ec) aHandler(ec, ip::address());
+	else if (aIter == ip::tcp::resolver::iterator()) aHandler(boost::asio::error::host_not_found, ip::address());
+	else aHandler(ec, aIter->endpoint().address());
+}
+
+void PhysicalLayerAsyncTCPClient::OnResolve(const boost::system::error_code& ec, const boost::asio::ip::address& arAddress)
+{
+	mResolving = false;
+
+	if (mResolveCanceled) {
+		this->OnOpenCallback(boost::asio::error::operation_aborted);
+		return;
+	}
+
+	millis_t ttl = ec ? mSettings.mResolveFailureTTL : mSettings.mResolveCacheTTL;
+	mCacheValid = ttl > 0;
+	if (mCacheValid) {
+		mCachedError = ec;
+		mCachedAddress = arAddress;
+		mCacheExpiration = mpTimeSrc->GetTimeStampUTC() + ttl;
+	}
+
+	if (ec) {
+		LOG_BLOCK(LEV_DEBUG, "unable to resolve address '" << mSettings.mAddress << "'");
+		this->OnOpenCallback(ec);
+	}
+	else {
+		LOG_BLOCK(LEV_DEBUG, "address '" << mSettings.mAddress << "' resolved to " << arAddress.to_string());
+		this->Connect(arAddress);
+	}
+}
+
+void PhysicalLayerAsyncTCPClient::Connect(const boost::asio::ip::address& arAddress)
+{
+	if (arAddress.is_v6() && arAddress.to_v6().is_link_local())
+		LOG_BLOCK(LEV_DEBUG, "IPv6 link local address found");
+
+	mRemoteEndpoint.address(arAddress);
+	mSocket.async_connect(mRemoteEndpoint,
+	                      boost::bind(&PhysicalLayerAsyncTCPClient::OnOpenCallback,
+	                                  this,
+	                                  boost::asio::placeholders::error));
+}
+
 void PhysicalLayerAsyncTCPClient::DoOpenSuccess()
 {
 	LOG_BLOCK(LEV_INFO, "Connected to: " << mRemoteEndpoint);
@@ -21,16 +21,35 @@
 
 #include <opendnp3/APL/PhysicalLayerAsyncBaseTCP.h>
 #include <opendnp3/APL/TcpSettings.h>
+#include <opendnp3/APL/TimeSource.h>
 
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/function.hpp>
 
 namespace apl
 {
 
+/**
+TCP client that resolves host names asynchronously on its io_service before
+connecting. Results can be cached between opens, successes for
+TcpSettings::mResolveCacheTTL and failures for TcpSettings::mResolveFailureTTL,
+so that reconnect loops don't hit DNS on every retry.
+*/
 class PhysicalLayerAsyncTCPClient : public PhysicalLayerAsyncBaseTCP
 {
 public:
-	PhysicalLayerAsyncTCPClient(Logger* apLogger, boost::asio::io_service* apIOService, const boost::asio::ip::tcp::endpoint& arEndpoint, const TcpSettings& arSettings);
+
+	typedef boost::function<void (const boost::system::error_code&, const boost::asio::ip::address&)> ResolveHandler;
+
+	/// Starts a lookup of a host name, the handler must be invoked exactly once from the io_service
+	typedef boost::function<void (const std::string&, const ResolveHandler&)> Resolver;
+
+	PhysicalLayerAsyncTCPClient(Logger* apLogger, boost::asio::io_service* apIOService, const boost::asio::ip::tcp::endpoint& arEndpoint, const TcpSettings& arSettings, ITimeSource* apTimeSrc = TimeSource::Inst());
+
+	/// Replaces the default asio resolver, used to stub out DNS in tests
+	void SetResolver(const Resolver& arResolver) {
+		mResolver = arResolver;
+	}
 
 	/* Implement the remaining actions */
 	void DoOpen();
@@ -38,8 +57,27 @@ public:
 	void DoOpenSuccess();
 
 private:
+
+	void AsyncResolve(const std::string& arHost, const ResolveHandler& arHandler);
+	void OnAsyncResolve(const boost::system::error_code& ec, boost::asio::ip::tcp::resolver::iterator aIter, ResolveHandler aHandler);
+
+	void OnResolve(const boost::system::error_code& ec, const boost::asio::ip::address& arAddress);
+	void Connect(const boost::asio::ip::address& arAddress);
+
 	boost::asio::ip::tcp::endpoint mRemoteEndpoint;
 	TcpSettings mSettings;
+	ITimeSource* mpTimeSrc;
+
+	boost::asio::ip::tcp::resolver mAsioResolver;
+	Resolver mResolver;
+	bool mResolving;
+	bool mResolveCanceled;
+
+	// result of the last lookup, valid until mCacheExpiration
+	bool mCacheValid;
+	boost::system::error_code mCachedError;
+	boost::asio::ip::address mCachedAddress;
+	TimeStamp_t mCacheExpiration;
 };
 
 }
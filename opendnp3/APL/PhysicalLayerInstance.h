@@ -46,6 +46,12 @@ public:
 
 	IPhysicalLayerAsync* GetLayer(Logger*, boost::asio::io_service*);
 
+	// True if the layer was supplied already constructed, in which case it is
+	// driven by whatever io_service it was constructed with
+	bool IsExternal() const {
+		return !mOwnsLayer;
+	}
+
 	void Release();
 
 private:
@@ -59,6 +59,12 @@ void PhysicalLayerManager ::AddPhysicalLayer(const std::string& arName, PhysLaye
 	this->AddLayer(arName, s, pli);
 }
 
+void PhysicalLayerManager ::AddPhysicalLayerFactory(const std::string& arName, PhysLayerSettings s, IPhysicalLayerAsyncFactory aFactory)
+{
+	PhysLayerInstance pli(aFactory);
+	this->AddLayer(arName, s, pli);
+}
+
 void PhysicalLayerManager ::AddTCPv4Client(const std::string& arName, PhysLayerSettings s, TcpSettings aTcp)
 {
 	IPhysicalLayerAsyncFactory fac = PhysicalLayerFactory::GetTCPv4ClientAsync(aTcp);
@@ -50,6 +50,9 @@ public:
 	void AddSerial(const std::string& arName, PhysLayerSettings, SerialSettings);
 	void AddPhysicalLayer(const std::string& arName, PhysLayerSettings, IPhysicalLayerAsync*);
 
+	// Adds a layer that is built by the factory when it is acquired, on the io_service it is acquired with
+	void AddPhysicalLayerFactory(const std::string& arName, PhysLayerSettings, IPhysicalLayerAsyncFactory);
+
 	// Removes a physical layer and deletes it if the manager has ownership.
 	void Remove(const std::string& arName);
 };
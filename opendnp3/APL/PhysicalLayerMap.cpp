@@ -44,7 +44,18 @@ PhysLayerSettings PhysicalLayerMap ::GetSettings(const std::string& arName)
 	return _GetSettings(arName);
 }
 
+bool PhysicalLayerMap::IsExternalLayer(const std::string& arName)
+{
+	CriticalSection cs(&mLock);
+	return _GetInstance(arName)->IsExternal();
+}
+
 IPhysicalLayerAsync* PhysicalLayerMap::AcquireLayer(const std::string& arName)
+{
+	return this->AcquireLayer(arName, mpService);
+}
+
+IPhysicalLayerAsync* PhysicalLayerMap::AcquireLayer(const std::string& arName, boost::asio::io_service* apService)
 {
 	CriticalSection cs(&mLock);
 	PhysLayerSettings s = this->_GetSettings(arName);
@@ -53,7 +64,7 @@ IPhysicalLayerAsync* PhysicalLayerMap::AcquireLayer(const std::string& arName)
 	if(i != mAcquiredMap.end()) throw ArgumentException("Layer with name has already been acquired: " + arName);
 	else {
 		mAcquiredMap[arName] = true;
-		IPhysicalLayerAsync* pLayer = pInstance->GetLayer(this->MakeLogger(arName, s.LogLevel), mpService);
+		IPhysicalLayerAsync* pLayer = pInstance->GetLayer(this->MakeLogger(arName, s.LogLevel), apService);
 		LOG_BLOCK(LEV_DEBUG, "Physical layer acquired: " << arName);
 		return pLayer;
 	}
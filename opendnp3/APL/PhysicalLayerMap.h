@@ -38,8 +38,10 @@ public:
 	virtual ~PhysicalLayerMap();
 
 	IPhysicalLayerAsync* AcquireLayer(const std::string& arName);
+	IPhysicalLayerAsync* AcquireLayer(const std::string& arName, boost::asio::io_service* apService);
 	void ReleaseLayer(const std::string& arName);
 	PhysLayerSettings GetSettings(const std::string& arName);
+	bool IsExternalLayer(const std::string& arName);
 
 protected:
 
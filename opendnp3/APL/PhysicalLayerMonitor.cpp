@@ -20,6 +20,8 @@
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/APL/PhysicalLayerMonitor.h>
 #include <opendnp3/APL/PhysicalLayerMonitorStates.h>
+#include <opendnp3/APL/TimingTools.h>
+#include <opendnp3/APL/TokenBucket.h>
 
 #include <assert.h>
 #include <boost/bind.hpp>
@@ -34,9 +36,11 @@ PhysicalLayerMonitor::PhysicalLayerMonitor(Logger* apLogger, IPhysicalLayerAsync
 	mpPhys(apPhys),
 	mpTimerSrc(apTimerSrc),
 	mpOpenTimer(NULL),
+	mpOpenLimiter(NULL),
 	mpState(MonitorStateInit::Inst()),
 	mFinalShutdown(false),
-	M_OPEN_RETRY(aOpenRetry)
+	M_OPEN_RETRY(aOpenRetry),
+	mBackoff(aOpenRetry)
 {
 	assert(apPhys != NULL);
 	assert(apTimerSrc != NULL);
@@ -53,6 +57,33 @@ PhysicalLayerState PhysicalLayerMonitor::GetState()
 
 /* ------ Public functions ----- */
 
+void PhysicalLayerMonitor::SetOpenBackoff(millis_t aMaxOpenRetry, double aJitter)
+{
+	// every monitor gets its own seed so that the jitter decorrelates them
+	boost::uint32_t seed = static_cast<boost::uint32_t>(reinterpret_cast<size_t>(this)) ^ static_cast<boost::uint32_t>(TimeStamp::GetTimeStamp());
+
+	CriticalSection cs(&mLock);
+	mBackoff = ExponentialBackoff(M_OPEN_RETRY, aMaxOpenRetry, aJitter, seed);
+}
+
+void PhysicalLayerMonitor::SetOpenLimiter(TokenBucket* apLimiter)
+{
+	assert(mpOpenTimer == NULL);
+	mpOpenLimiter = apLimiter;
+}
+
+size_t PhysicalLayerMonitor::GetNumOpenRetries()
+{
+	CriticalSection cs(&mLock);
+	return mBackoff.GetNumRetries();
+}
+
+millis_t PhysicalLayerMonitor::GetOpenRetryDelay()
+{
+	CriticalSection cs(&mLock);
+	return mBackoff.GetCurrentDelay();
+}
+
 void PhysicalLayerMonitor::AddObserver(IPhysicalLayerObserver* apObserver)
 {
 	assert(apObserver != NULL);
@@ -137,6 +168,7 @@ void PhysicalLayerMonitor::OnOpenTimerExpiration()
 	LOG_BLOCK(LEV_DEBUG, "OnOpenTimerExpiration()");
 	assert(mpOpenTimer != NULL);
 	mpOpenTimer = NULL;
+	if(mpOpenLimiter) mpOpenLimiter->Release();
 	mpState->OnOpenTimeout(this);
 }
 
@@ -158,6 +190,10 @@ void PhysicalLayerMonitor::_OnReadWriteFailure()
 void PhysicalLayerMonitor::_OnLowerLayerUp()
 {
 	LOG_BLOCK(LEV_DEBUG, "_OnLowerLayerUp");
+	{
+		CriticalSection cs(&mLock);
+		mBackoff.Reset();
+	}
 	mpState->OnLayerOpen(this);
 	this->OnPhysicalLayerOpenSuccessCallback();
 }
@@ -174,7 +210,16 @@ void PhysicalLayerMonitor::_OnLowerLayerDown()
 void PhysicalLayerMonitor::StartOpenTimer()
 {
 	assert(mpOpenTimer == NULL);
-	mpOpenTimer = mpTimerSrc->Start(M_OPEN_RETRY, boost::bind(&PhysicalLayerMonitor::OnOpenTimerExpiration, this));
+
+	millis_t delay;
+	{
+		CriticalSection cs(&mLock);
+		delay = mBackoff.Next();
+	}
+	if(mpOpenLimiter) delay = mpOpenLimiter->Reserve(delay);
+
+	LOG_BLOCK(LEV_DEBUG, "Retrying open in " << delay << " ms");
+	mpOpenTimer = mpTimerSrc->Start(delay, boost::bind(&PhysicalLayerMonitor::OnOpenTimerExpiration, this));
 }
 
 void PhysicalLayerMonitor::CancelOpenTimer()
@@ -182,6 +227,7 @@ void PhysicalLayerMonitor::CancelOpenTimer()
 	assert(mpOpenTimer != NULL);
 	mpOpenTimer->Cancel();
 	mpOpenTimer = NULL;
+	if(mpOpenLimiter) mpOpenLimiter->Release();
 }
 
 /* ------- Internal helper functions ------- */
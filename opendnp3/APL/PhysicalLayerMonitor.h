@@ -19,6 +19,7 @@
 #ifndef __PHYSICAL_LAYER_MONITOR_H_
 #define __PHYSICAL_LAYER_MONITOR_H_
 
+#include <opendnp3/APL/ExponentialBackoff.h>
 #include <opendnp3/APL/IHandlerAsync.h>
 #include <opendnp3/APL/IPhysicalLayerObserver.h>
 #include <opendnp3/APL/ITimerSource.h>
@@ -32,6 +33,7 @@ namespace apl
 class IPhysicalLayerAsync;
 class IMonitorState;
 class IPhysicalLayerObserver;
+class TokenBucket;
 
 /** Manages the lifecycle of a physical layer
   */
@@ -60,6 +62,22 @@ public:
 
 	PhysicalLayerState GetState();
 
+	/** Backs off exponentially between open retries, should be called before Start()
+		@param aMaxOpenRetry Cap on the retry delay, the delay doubles from the open retry up to this value
+		@param aJitter Fraction of each retry delay that is randomized, in [0, 1]
+		@throw ArgumentException if aJitter is out of range
+	*/
+	void SetOpenBackoff(millis_t aMaxOpenRetry, double aJitter);
+
+	/** Schedules the open retries through a limiter shared with other monitors, should be called before Start() */
+	void SetOpenLimiter(TokenBucket* apLimiter);
+
+	/** @return the number of open retries since the layer was last open */
+	size_t GetNumOpenRetries();
+
+	/** @return the delay, before jitter, that the next open retry is based on */
+	millis_t GetOpenRetryDelay();
+
 	/** Add an observer to the set of state callbacks */
 	void AddObserver(IPhysicalLayerObserver* apObserver);
 
@@ -84,12 +102,18 @@ protected:
 	/// Begins the open timer
 	void StartOpenTimer();
 
+	/// Timer source the monitor was created with
+	ITimerSource* GetTimerSource() {
+		return mpTimerSrc;
+	}
+
 	IPhysicalLayerAsync* mpPhys;
 
 private:
 
 	ITimerSource* mpTimerSrc;
 	ITimer* mpOpenTimer;
+	TokenBucket* mpOpenLimiter;
 	IMonitorState* mpState;
 	bool mFinalShutdown;
 
@@ -110,6 +134,7 @@ private:
 
 	SigLock mLock;
 	const millis_t M_OPEN_RETRY;
+	ExponentialBackoff mBackoff;
 
 	// Implement from IHandlerAsync - Try to reconnect using a timer
 	void _OnOpenFailure();
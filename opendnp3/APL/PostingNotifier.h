@@ -25,6 +25,12 @@
 namespace apl
 {
 
+/**
+	Notifier that posts its handler to a timer source, so the handler executes
+	on the thread driving that timer source no matter which thread calls
+	Notify(). Stacks hand out notifiers bound to the timer source of their
+	port, which keeps notifications on the thread that owns the port.
+*/
 class PostingNotifier : public INotifier
 {
 public:
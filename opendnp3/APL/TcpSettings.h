@@ -19,6 +19,8 @@
 #ifndef __TCP_SETTINGS_H_
 #define __TCP_SETTINGS_H_
 
+#include <opendnp3/APL/Types.h>
+
 #include <string>
 #include <boost/cstdint.hpp>
 
@@ -31,7 +33,9 @@ struct TcpSettings {
 		mPort(0),
 		mUseKeepAlives(false),
 		mSendBufferSize(0),
-		mRecvBufferSize(0)
+		mRecvBufferSize(0),
+		mResolveCacheTTL(0),
+		mResolveFailureTTL(0)
 	{
 	}
 
@@ -40,7 +44,9 @@ struct TcpSettings {
 		mPort(aPort),
 		mUseKeepAlives(false),
 		mSendBufferSize(0),
-		mRecvBufferSize(0)
+		mRecvBufferSize(0),
+		mResolveCacheTTL(0),
+		mResolveFailureTTL(0)
 	{
 	}
 
@@ -49,7 +55,9 @@ struct TcpSettings {
 			mPort(aPort),
 			mUseKeepAlives(useKeepAlives),
 			mSendBufferSize(0),
-			mRecvBufferSize(0)
+			mRecvBufferSize(0),
+			mResolveCacheTTL(0),
+			mResolveFailureTTL(0)
 	{
 	}
 
@@ -58,6 +66,8 @@ struct TcpSettings {
 	bool mUseKeepAlives;
 	size_t mSendBufferSize; // 0 indicates to use system default
 	size_t mRecvBufferSize; // 0 indicates to use system default
+	millis_t mResolveCacheTTL; // Client only, how long a resolved host name is reused, 0 disables caching
+	millis_t mResolveFailureTTL; // Client only, how long a failed lookup is reused before retrying, 0 disables caching
 };
 
 }
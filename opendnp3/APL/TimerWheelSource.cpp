@@ -0,0 +1,369 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+
+#include <opendnp3/APL/AsyncResult.h>
+#include <opendnp3/APL/TimerWheelSource.h>
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+
+using namespace boost::posix_time;
+
+namespace apl
+{
+
+TimerWheelSource::TimerWheelSource(boost::asio::io_service* apService, millis_t aTickMs, size_t aMaxIdle) :
+	mpService(apService),
+	mTimer(*apService),
+	mTickUs(aTickMs * 1000),
+	mStart(boost::asio::deadline_timer::traits_type::now()),
+	mCurrentTick(0),
+	mArmed(false),
+	mArmedTick(0),
+	mNumActive(0),
+	mpIdle(NULL),
+	mMaxIdle(aMaxIdle),
+	mNumIdle(0),
+	mMinIdle(0),
+	mNextReclaim(SLOTS)
+{
+	if(aTickMs <= 0) throw ArgumentException(LOCATION, "Tick must be positive");
+
+	for(size_t i = 0; i < LEVELS; ++i) {
+		for(size_t j = 0; j < SLOTS; ++j) Clear(&mSlots[i][j]);
+	}
+	Clear(&mExpired);
+}
+
+TimerWheelSource::~TimerWheelSource()
+{
+	mTimer.cancel();
+
+	for(size_t i = 0; i < LEVELS; ++i) {
+		for(size_t j = 0; j < SLOTS; ++j) {
+			while(!IsEmpty(&mSlots[i][j])) {
+				Timer* pTimer = static_cast<Timer*>(mSlots[i][j].mpNext);
+				Unlink(pTimer);
+				delete pTimer;
+			}
+		}
+	}
+	while(!IsEmpty(&mExpired)) {
+		Timer* pTimer = static_cast<Timer*>(mExpired.mpNext);
+		Unlink(pTimer);
+		delete pTimer;
+	}
+	while(mpIdle != NULL) {
+		Timer* pTimer = mpIdle;
+		mpIdle = static_cast<Timer*>(pTimer->mpNext);
+		delete pTimer;
+	}
+}
+
+ITimer* TimerWheelSource::Start(millis_t aDelay, const FunctionVoidZero& arCallback)
+{
+	return this->Start(boost::asio::deadline_timer::traits_type::now() + milliseconds(aDelay), arCallback);
+}
+
+ITimer* TimerWheelSource::Start(const ptime& arTime, const FunctionVoidZero& arCallback)
+{
+	// an empty wheel may have stopped turning, catch it up before using it as the insertion base
+	if(mNumActive == 0) mCurrentTick = std::max(mCurrentTick, this->NowTick());
+
+	Timer* pTimer = this->Allocate();
+	pTimer->mExpiration = arTime;
+	pTimer->mTick = this->TickOf(arTime);
+	pTimer->mCallback = arCallback;
+	pTimer->mActive = true;
+	++mNumActive;
+
+	this->Insert(pTimer);
+
+	// wake up for the new timer if it is due before the next cascade
+	boost::int64_t cascade = (mCurrentTick | MASK) + 1;
+	this->Arm(std::min(std::max(pTimer->mTick, mCurrentTick), cascade));
+
+	return pTimer;
+}
+
+void TimerWheelSource::Post(const FunctionVoidZero& arHandler)
+{
+	mpService->post(arHandler);
+}
+
+void TimerWheelSource::PostSync(const FunctionVoidZero& arHandler)
+{
+	AsyncResult ar;
+	this->Post(boost::bind(&TimerWheelSource::SafeExecute, arHandler, &ar));
+	ar.Wait();
+}
+
+void TimerWheelSource::SafeExecute(const FunctionVoidZero& arFunc, AsyncResult* apResult)
+{
+	try {
+		arFunc();
+		apResult->Success();
+	}
+	catch(const Exception& ex) {
+		apResult->Failure(boost::bind(&TimerWheelSource::Rethrow, ex));
+	}
+}
+
+void TimerWheelSource::Rethrow(const Exception& arException)
+{
+	throw arException;
+}
+
+void TimerWheelSource::Clear(Link* apList)
+{
+	apList->mpPrev = apList;
+	apList->mpNext = apList;
+}
+
+bool TimerWheelSource::IsEmpty(const Link* apList)
+{
+	return apList->mpNext == apList;
+}
+
+void TimerWheelSource::PushBack(Link* apList, Link* apLink)
+{
+	apLink->mpNext = apList;
+	apLink->mpPrev = apList->mpPrev;
+	apList->mpPrev->mpNext = apLink;
+	apList->mpPrev = apLink;
+}
+
+void TimerWheelSource::Unlink(Link* apLink)
+{
+	apLink->mpPrev->mpNext = apLink->mpNext;
+	apLink->mpNext->mpPrev = apLink->mpPrev;
+	apLink->mpPrev = apLink->mpNext = NULL;
+}
+
+void TimerWheelSource::Splice(Link* apTo, Link* apFrom)
+{
+	if(IsEmpty(apFrom)) return;
+	apFrom->mpNext->mpPrev = apTo->mpPrev;
+	apTo->mpPrev->mpNext = apFrom->mpNext;
+	apFrom->mpPrev->mpNext = apTo;
+	apTo->mpPrev = apFrom->mpPrev;
+	Clear(apFrom);
+}
+
+boost::int64_t TimerWheelSource::TickOf(const ptime& arTime) const
+{
+	if(arTime <= mStart) return 0;
+	boost::int64_t us = (arTime - mStart).total_microseconds();
+	return (us + mTickUs - 1) / mTickUs; // round up so that timers never expire early
+}
+
+ptime TimerWheelSource::TimeOf(boost::int64_t aTick) const
+{
+	return mStart + microseconds(aTick * mTickUs);
+}
+
+boost::int64_t TimerWheelSource::NowTick() const
+{
+	ptime now = boost::asio::deadline_timer::traits_type::now();
+	if(now <= mStart) return 0;
+	return (now - mStart).total_microseconds() / mTickUs;
+}
+
+TimerWheelSource::Timer* TimerWheelSource::Allocate()
+{
+	if(mpIdle == NULL) return new Timer(this);
+
+	Timer* pTimer = mpIdle;
+	mpIdle = static_cast<Timer*>(pTimer->mpNext);
+	pTimer->mpNext = NULL;
+	--mNumIdle;
+	mMinIdle = std::min(mMinIdle, mNumIdle);
+	return pTimer;
+}
+
+void TimerWheelSource::Release(Timer* apTimer)
+{
+	apTimer->mCallback.clear(); // release anything bound into the callback
+
+	if(mNumIdle >= mMaxIdle) {
+		delete apTimer;
+		return;
+	}
+
+	apTimer->mpNext = mpIdle;
+	mpIdle = apTimer;
+	++mNumIdle;
+}
+
+void TimerWheelSource::Reclaim()
+{
+	// timers that sat idle for the whole period weren't needed, free them
+	for(; mMinIdle > 0 && mpIdle != NULL; --mMinIdle) {
+		Timer* pTimer = mpIdle;
+		mpIdle = static_cast<Timer*>(pTimer->mpNext);
+		delete pTimer;
+		--mNumIdle;
+	}
+	mMinIdle = mNumIdle;
+}
+
+void TimerWheelSource::Insert(Timer* apTimer)
+{
+	boost::int64_t delta = apTimer->mTick - mCurrentTick;
+
+	if(delta < 0) {
+		// already due, run it on the next tick
+		PushBack(&mSlots[0][mCurrentTick & MASK], apTimer);
+		return;
+	}
+
+	// timers beyond the span of the wheel wait in the last slot of the top level and are re-inserted when it cascades
+	const boost::int64_t span = boost::int64_t(1) << (BITS * LEVELS);
+	boost::int64_t tick = (delta < span) ? apTimer->mTick : mCurrentTick + span - 1;
+
+	size_t level = 0;
+	while(level < LEVELS - 1 && delta >= (boost::int64_t(1) << (BITS * (level + 1)))) ++level;
+
+	PushBack(&mSlots[level][(tick >> (BITS * level)) & MASK], apTimer);
+}
+
+void TimerWheelSource::Cancel(Timer* apTimer)
+{
+	if(!apTimer->mActive) return;
+
+	Unlink(apTimer);
+	apTimer->mActive = false;
+	this->Release(apTimer);
+
+	if(--mNumActive == 0 && mArmed) {
+		// let the io_service run out of work, just like an idle TimerSourceASIO
+		mTimer.cancel();
+		mArmed = false;
+	}
+}
+
+void TimerWheelSource::Cascade(size_t aLevel, size_t aIndex)
+{
+	Link list;
+	Clear(&list);
+	Splice(&list, &mSlots[aLevel][aIndex]);
+
+	while(!IsEmpty(&list)) {
+		Timer* pTimer = static_cast<Timer*>(list.mpNext);
+		Unlink(pTimer);
+		this->Insert(pTimer);
+	}
+}
+
+void TimerWheelSource::Advance(boost::int64_t aNowTick)
+{
+	// finish any timers left over by a callback that threw
+	while(!IsEmpty(&mExpired)) this->Fire(static_cast<Timer*>(mExpired.mpNext));
+
+	while(mCurrentTick <= aNowTick) {
+
+		if(mNumActive == 0) {
+			// nothing to expire, jump straight to the present
+			mCurrentTick = aNowTick + 1;
+			break;
+		}
+
+		size_t index = static_cast<size_t>(mCurrentTick & MASK);
+
+		if(index == 0) {
+			for(size_t level = 1; level < LEVELS; ++level) {
+				size_t i = static_cast<size_t>((mCurrentTick >> (BITS * level)) & MASK);
+				this->Cascade(level, i);
+				if(i != 0) break;
+			}
+		}
+
+		Splice(&mExpired, &mSlots[0][index]);
+		++mCurrentTick;
+
+		while(!IsEmpty(&mExpired)) this->Fire(static_cast<Timer*>(mExpired.mpNext));
+	}
+
+	if(mCurrentTick >= mNextReclaim) {
+		this->Reclaim();
+		mNextReclaim = mCurrentTick + SLOTS;
+	}
+}
+
+void TimerWheelSource::Fire(Timer* apTimer)
+{
+	FunctionVoidZero callback;
+	callback.swap(apTimer->mCallback);
+
+	Unlink(apTimer);
+	apTimer->mActive = false;
+	--mNumActive;
+	this->Release(apTimer);
+
+	callback();
+}
+
+boost::int64_t TimerWheelSource::NextWakeTick() const
+{
+	// timers left over by a callback that threw are overdue
+	if(!IsEmpty(&mExpired)) return mCurrentTick;
+
+	// the next occupied slot of the lowest level, or the next cascade
+	for(boost::int64_t tick = mCurrentTick; ; ++tick) {
+		if(!IsEmpty(&mSlots[0][tick & MASK])) return tick;
+		if(((tick + 1) & MASK) == 0) return tick + 1;
+	}
+}
+
+void TimerWheelSource::Arm(boost::int64_t aTick)
+{
+	if(mArmed && aTick >= mArmedTick) return;
+
+	// replacing the expiration aborts any wait that is outstanding
+	mTimer.expires_at(this->TimeOf(aTick));
+	mTimer.async_wait(boost::bind(&TimerWheelSource::OnTick, this, boost::asio::placeholders::error));
+	mArmed = true;
+	mArmedTick = aTick;
+}
+
+void TimerWheelSource::Rearm()
+{
+	if(mNumActive > 0) this->Arm(this->NextWakeTick());
+}
+
+void TimerWheelSource::OnTick(const boost::system::error_code& ec)
+{
+	if(ec) return;
+
+	mArmed = false;
+
+	try {
+		this->Advance(this->NowTick());
+	}
+	catch(...) {
+		// keep the wheel turning for the timers that remain
+		this->Rearm();
+		throw;
+	}
+
+	this->Rearm();
+}
+
+}
@@ -0,0 +1,174 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __TIMER_WHEEL_SOURCE_H_
+#define __TIMER_WHEEL_SOURCE_H_
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/ITimerSource.h>
+
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace apl
+{
+
+class AsyncResult;
+
+/**
+ * ITimerSource that multiplexes all of its timers onto a single ASIO timer
+ * using a hierarchical timing wheel.
+ *
+ * Expiration times are rounded up to a whole number of ticks. Each level of
+ * the wheel has 256 slots, a timer is linked into the slot of the lowest
+ * level whose span covers it and is cascaded down a level as the wheel
+ * turns. Slots are intrusive doubly linked lists so starting and canceling
+ * a timer are O(1) and never touch the io_service. The ASIO timer is only
+ * armed for the next occupied tick of the lowest level (or the next cascade)
+ * and only while timers are outstanding, so like TimerSourceASIO the source
+ * keeps the io_service from running out of work exactly when a timer is
+ * pending.
+ *
+ * Timers are recycled through an idle list that holds at most aMaxIdle
+ * entries. Once per revolution of the lowest level, idle timers that were
+ * not needed during the last revolution are freed, so a burst of timers
+ * doesn't pin its memory forever.
+ *
+ * Like TimerSourceASIO, Start and Cancel must be called from the thread
+ * running the io_service (or before it runs), Post and PostSync are thread safe.
+ */
+class TimerWheelSource : public ITimerSource, private boost::noncopyable
+{
+	class Timer;
+
+public:
+
+	/**
+		@param apService - io_service that drives the wheel
+		@param aTickMs - resolution of the wheel in milliseconds
+		@param aMaxIdle - maximum number of idle timers that are kept for reuse
+		@throw ArgumentException if aTickMs is not positive
+	*/
+	TimerWheelSource(boost::asio::io_service* apService, millis_t aTickMs = 10, size_t aMaxIdle = 1024);
+	~TimerWheelSource();
+
+	ITimer* Start(millis_t, const FunctionVoidZero&);
+	ITimer* Start(const boost::posix_time::ptime&, const FunctionVoidZero&);
+	void Post(const FunctionVoidZero&);
+	void PostSync(const FunctionVoidZero&);
+
+	/// Number of timers that are waiting to expire
+	size_t NumActive() const {
+		return mNumActive;
+	}
+
+	/// Number of timers that are allocated but not in use
+	size_t NumIdle() const {
+		return mNumIdle;
+	}
+
+private:
+
+	static const size_t BITS = 8;
+	static const size_t SLOTS = 1 << BITS;
+	static const boost::int64_t MASK = SLOTS - 1;
+	static const size_t LEVELS = 4;
+
+	struct Link {
+		Link* mpPrev;
+		Link* mpNext;
+	};
+
+	class Timer : public ITimer, public Link
+	{
+		friend class TimerWheelSource;
+
+	public:
+
+		Timer(TimerWheelSource* apSource) : mpSource(apSource), mTick(0), mActive(false)
+		{}
+
+		void Cancel() {
+			mpSource->Cancel(this);
+		}
+
+		boost::posix_time::ptime ExpiresAt() {
+			return mExpiration;
+		}
+
+	private:
+
+		TimerWheelSource* mpSource;
+		boost::posix_time::ptime mExpiration;
+		boost::int64_t mTick;
+		bool mActive;
+		FunctionVoidZero mCallback;
+	};
+
+	static void SafeExecute(const FunctionVoidZero&, AsyncResult* apResult);
+	static void Rethrow(const Exception& arException);
+
+	static void Clear(Link* apList);
+	static bool IsEmpty(const Link* apList);
+	static void PushBack(Link* apList, Link* apLink);
+	static void Unlink(Link* apLink);
+	static void Splice(Link* apTo, Link* apFrom);
+
+	boost::int64_t TickOf(const boost::posix_time::ptime&) const;
+	boost::posix_time::ptime TimeOf(boost::int64_t aTick) const;
+	boost::int64_t NowTick() const;
+
+	Timer* Allocate();
+	void Release(Timer*);
+	void Reclaim();
+
+	void Insert(Timer*);
+	void Cancel(Timer*);
+	void Cascade(size_t aLevel, size_t aIndex);
+	void Advance(boost::int64_t aNowTick);
+	void Fire(Timer*);
+
+	boost::int64_t NextWakeTick() const;
+	void Arm(boost::int64_t aTick);
+	void Rearm();
+	void OnTick(const boost::system::error_code&);
+
+	boost::asio::io_service* mpService;
+	boost::asio::deadline_timer mTimer;
+
+	const boost::int64_t mTickUs;
+	const boost::posix_time::ptime mStart;
+	boost::int64_t mCurrentTick;	// next tick to be processed
+
+	bool mArmed;
+	boost::int64_t mArmedTick;
+
+	Link mSlots[LEVELS][SLOTS];
+	Link mExpired;					// timers that are due but whose callbacks haven't run yet
+	size_t mNumActive;
+
+	Timer* mpIdle;					// singly linked through mpNext
+	const size_t mMaxIdle;
+	size_t mNumIdle;
+	size_t mMinIdle;				// low water mark of the idle list since the last reclaim
+	boost::int64_t mNextReclaim;
+};
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/APL/TokenBucket.h>
+
+#include <opendnp3/APL/Exception.h>
+
+#include <assert.h>
+
+namespace apl
+{
+
+TokenBucket::TokenBucket(double aRatePerSecond, size_t aBurst, ITimeManager* apTime) :
+	mpTime(apTime == NULL ? &mSystemTime : apTime),
+	mInterval(0.0),
+	mBurstWindow(0.0),
+	mNextToken(0.0),
+	mNumPending(0),
+	mNumDelayed(0)
+{
+	Validate(aRatePerSecond, aBurst);
+	this->Configure(aRatePerSecond, aBurst);
+}
+
+void TokenBucket::Validate(double aRatePerSecond, size_t aBurst)
+{
+	if(aRatePerSecond < 0.0) throw ArgumentException(LOCATION, "Rate must be non-negative");
+	if(aBurst == 0) throw ArgumentException(LOCATION, "Burst must be at least 1");
+}
+
+void TokenBucket::Configure(double aRatePerSecond, size_t aBurst)
+{
+	Validate(aRatePerSecond, aBurst);
+	CriticalSection cs(&mLock);
+	mInterval = (aRatePerSecond > 0.0) ? 1000.0 / aRatePerSecond : 0.0;
+	mBurstWindow = (aBurst - 1) * mInterval;
+}
+
+millis_t TokenBucket::Reserve(millis_t aDelay)
+{
+	CriticalSection cs(&mLock);
+	++mNumPending;
+
+	if(mInterval == 0.0) return aDelay;
+
+	double now = static_cast<double>(mpTime->GetTime());
+	double wanted = now + aDelay;
+
+	// the token is available once the schedule is no more than a burst ahead of the start time
+	double start = wanted;
+	if(mNextToken - mBurstWindow > start) start = mNextToken - mBurstWindow;
+	mNextToken = ((mNextToken > wanted) ? mNextToken : wanted) + mInterval;
+
+	if(start > wanted) {
+		++mNumDelayed;
+		return static_cast<millis_t>(start - now + 0.5);
+	}
+	return aDelay;
+}
+
+void TokenBucket::Release()
+{
+	CriticalSection cs(&mLock);
+	assert(mNumPending > 0);
+	--mNumPending;
+}
+
+size_t TokenBucket::NumPending()
+{
+	CriticalSection cs(&mLock);
+	return mNumPending;
+}
+
+size_t TokenBucket::NumDelayed()
+{
+	CriticalSection cs(&mLock);
+	return mNumDelayed;
+}
+
+}
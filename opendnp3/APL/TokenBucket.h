@@ -0,0 +1,94 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __TOKEN_BUCKET_H_
+#define __TOKEN_BUCKET_H_
+
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/TimeSource.h>
+
+#include <stddef.h>
+
+namespace apl
+{
+
+/**
+	Thread-safe token bucket that spaces out operations shared by many users,
+	e.g. the open attempts of every channel in a process.
+
+	Tokens are added at a fixed rate and up to aBurst of them accumulate, so a
+	burst of that many operations can start at once and everything after that
+	is spread out at the rate. Callers don't block, they reserve the first
+	token that is available at or after the time they want to go and wait for
+	it with a timer. Every Reserve() must be matched by a Release() when the
+	operation starts or is abandoned, which lets the bucket report how many
+	operations are pending.
+
+	A rate of 0 disables the limit, reservations are then granted as requested.
+*/
+class TokenBucket
+{
+public:
+
+	/**
+		@param aRatePerSecond Tokens added per second, 0 for no limit
+		@param aBurst Maximum number of tokens that can accumulate, at least 1
+		@param apTime Clock used to schedule the tokens, defaults to system time
+		@throw ArgumentException if the rate is negative or the burst is 0
+	*/
+	TokenBucket(double aRatePerSecond = 0.0, size_t aBurst = 1, ITimeManager* apTime = NULL);
+
+	/// Changes the rate and burst, affects reservations made from now on
+	void Configure(double aRatePerSecond, size_t aBurst);
+
+	/**
+		Reserves a token for an operation that wants to start aDelay from now
+		@return the delay until the reserved token is available, never less than aDelay
+	*/
+	millis_t Reserve(millis_t aDelay);
+
+	/// Returns a reservation once the operation has started or was abandoned
+	void Release();
+
+	/// @return the number of reservations that haven't been released
+	size_t NumPending();
+
+	/// @return the number of reservations that had to wait longer than requested
+	size_t NumDelayed();
+
+private:
+
+	TokenBucket(const TokenBucket&);
+	TokenBucket& operator=(const TokenBucket&);
+
+	static void Validate(double aRatePerSecond, size_t aBurst);
+
+	SigLock mLock;
+	TimeSourceSystemOffset mSystemTime;
+	ITimeManager* mpTime;
+
+	double mInterval;		// milliseconds between tokens, 0 if unlimited
+	double mBurstWindow;	// how far the schedule may run ahead of now
+	double mNextToken;		// time at which the bucket is empty again
+	size_t mNumPending;
+	size_t mNumDelayed;
+};
+
+}
+
+#endif
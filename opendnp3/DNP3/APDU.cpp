@@ -390,13 +390,16 @@ ObjectWriteIterator APDU::WriteContiguous(const FixedObject* apObj, size_t aStar
 	IObjectHeader* pHdr = this->GetObjectHeader(aCode);
 	if(pHdr->GetSize() > this->Remainder()) return ObjectWriteIterator();
 
-	size_t maxObjects = (this->Remainder() - pHdr->GetSize()) / apObj->GetSize();
+	//do we write all the objects or the max in the space
+	size_t requested = aStop - aStart + 1;
+
+	//requests like READ carry no object data, so any range fits behind the header
+	bool has_data = APDU::HasData(this->GetFunction());
+	size_t maxObjects = has_data ? (this->Remainder() - pHdr->GetSize()) / apObj->GetSize() : requested;
 
 	//No point in writing a header if it can't hold an object
 	if(maxObjects == 0) return ObjectWriteIterator();
 
-	//do we write all the objects or the max in the space
-	size_t requested = aStop - aStart + 1;
 	size_t count = (requested < maxObjects) ? requested : maxObjects;
 	size_t stop = aStart + count - 1;
 
@@ -407,7 +410,6 @@ ObjectWriteIterator APDU::WriteContiguous(const FixedObject* apObj, size_t aStar
 	this->WriteContiguousHeader(pHdr, pHeaderPos, aStart, stop);
 
 	mFragmentSize += pHdr->GetSize();
-	bool has_data = APDU::HasData(this->GetFunction());
 	size_t obj_size = has_data ? apObj->GetSize() : 0;
 	mFragmentSize += count * obj_size;
 
@@ -84,6 +84,7 @@ void ACS_Base::ProcessResponse(AppLayerChannel* c, APDU& arAPDU, bool aExpectFIR
 	if(acf.SEQ == c->Sequence()) {
 		if(acf.FIR == aExpectFIR) {
 			c->CancelTimer();
+			if(aExpectFIR) c->RecordResponseLatency();
 
 			if(acf.FIN) {
 				c->ChangeState(ACS_Idle::Inst());
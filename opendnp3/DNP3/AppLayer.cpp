@@ -20,6 +20,7 @@
 #include <opendnp3/APL/ITimerSource.h>
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/DNP3/AppLayer.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
 using namespace std;
 
@@ -36,6 +37,7 @@ AppLayer::AppLayer(apl::Logger* apLogger, ITimerSource* apTimerSrc, AppConfig aA
 	mSending(false),
 	mConfirmSending(false),
 	mpUser(NULL),
+	mpStats(NULL),
 	mSolicited(apLogger->GetSubLogger("sol"), this, apTimerSrc, aAppCfg.RspTimeout),
 	mUnsolicited(apLogger->GetSubLogger("unsol"), this, apTimerSrc, aAppCfg.RspTimeout),
 	mNumRetry(aAppCfg.NumRetry)
@@ -102,6 +104,8 @@ void AppLayer::_OnReceive(const boost::uint8_t* apBuffer, size_t aSize)
 	if(!this->IsLowerLayerUp())
 		throw InvalidStateException(LOCATION, "LowerLaterDown");
 
+	if(mpStats) mpStats->mFragmentsRx.Increment();
+
 	try {
 		mIncoming.Write(apBuffer, aSize);
 		mIncoming.Interpret();
@@ -302,6 +306,7 @@ void AppLayer::CheckForSend()
 		mSending = true;
 		const APDU* pAPDU = mSendQueue.front();
 		LOG_BLOCK(LEV_INTERPRET, "=> AL " << pAPDU->ToString());
+		if(mpStats) mpStats->mFragmentsTx.Increment();
 		mpLowerLayer->Send(pAPDU->GetBuffer(), pAPDU->Size());
 	}
 }
@@ -40,6 +40,7 @@ namespace dnp
 {
 
 class AppTransactionStateBase;
+class StackStatistics;
 
 /**
 Implements the sequencing/confirm/response logic for the DNP3 application layer.
@@ -58,6 +59,11 @@ public:
 
 	void SetUser(IAppUser*);
 
+	// Counts fragments, retries and response latency into a statistics block, NULL to stop counting
+	void SetStatistics(StackStatistics* apStats) {
+		mpStats = apStats;
+	}
+
 	/////////////////////////////////
 	// Implement IAppLayer
 	/////////////////////////////////
@@ -108,6 +114,7 @@ private:
 	SendQueue mSendQueue;				// Buffer of send operations
 
 	IAppUser* mpUser;				// Interface for dispatching callbacks
+	StackStatistics* mpStats;		// Optional performance counters
 
 	SolicitedChannel mSolicited;			// Channel used for solicited communications
 	UnsolicitedChannel mUnsolicited;		// Channel used for unsolicited communications
@@ -21,6 +21,7 @@
 #include <opendnp3/DNP3/AppChannelStates.h>
 #include <opendnp3/DNP3/AppLayer.h>
 #include <opendnp3/DNP3/AppLayerChannel.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
 #include <boost/bind.hpp>
 
@@ -33,6 +34,7 @@ AppLayerChannel::AppLayerChannel(const std::string& arName, Logger* apLogger, Ap
 	Loggable(apLogger),
 	mpAppLayer(apAppLayer),
 	mpSendAPDU(NULL),
+	mSendTime(0),
 	mNumRetry(0),
 	mpTimerSrc(apTimerSrc),
 	mpTimer(NULL),
@@ -91,6 +93,7 @@ void AppLayerChannel::CancelRetries()
 
 void AppLayerChannel::QueueSend(APDU& arAPDU)
 {
+	if(mpAppLayer->mpStats) mSendTime = mpAppLayer->mpStats->Now();
 	mpAppLayer->QueueFrame(arAPDU);
 }
 
@@ -100,6 +103,10 @@ bool AppLayerChannel::Retry(ACS_Base* apState)
 		--mNumRetry;
 		LOG_BLOCK(LEV_INFO, "App layer retry, " << mNumRetry << " remaining");
 		this->ChangeState(apState);
+		if(mpAppLayer->mpStats) {
+			mpAppLayer->mpStats->mAppRetries.Increment();
+			mSendTime = mpAppLayer->mpStats->Now();
+		}
 		mpAppLayer->QueueFrame(*mpSendAPDU);
 		return true;
 	}
@@ -118,6 +125,12 @@ void AppLayerChannel::DoFinalResponse(APDU& arAPDU)
 	mpAppLayer->mpUser->OnFinalResponse(arAPDU);
 }
 
+void AppLayerChannel::RecordResponseLatency()
+{
+	StackStatistics* pStats = mpAppLayer->mpStats;
+	if(pStats) pStats->mResponseLatency.Record(pStats->Now() - mSendTime);
+}
+
 void AppLayerChannel::StartTimer()
 {
 	if(mpTimer != NULL) throw InvalidStateException(LOCATION, "");
@@ -99,6 +99,9 @@ protected:
 
 	void StartTimer();
 	void CancelTimer();
+
+	// Records the time since the request was last sent, called when its first response arrives
+	void RecordResponseLatency();
 	Logger* GetLogger() {
 		return mpLogger;
 	}
@@ -116,6 +119,7 @@ private:
 	void Timeout();
 
 	APDU* mpSendAPDU;
+	TimeStamp_t mSendTime;	// time at which mpSendAPDU was last queued, only kept when counting statistics
 	size_t mNumRetry;
 	ITimerSource* mpTimerSrc;
 	ITimer* mpTimer;
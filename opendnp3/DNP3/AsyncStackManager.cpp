@@ -22,12 +22,16 @@
 #include <opendnp3/APL/GetKeys.h>
 #include <opendnp3/APL/IPhysicalLayerAsync.h>
 #include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/PhysicalLayerAsyncSharedTCPServer.h>
 #include <opendnp3/APL/SuspendTimerSource.h>
 #include <opendnp3/APL/TimerSourceASIO.h>
+#include <opendnp3/APL/TimerWheelSource.h>
 #include <opendnp3/DNP3/AsyncStackManager.h>
 #include <opendnp3/DNP3/DeviceTemplate.h>
 #include <opendnp3/DNP3/LinkChannel.h>
+#include <opendnp3/DNP3/LinkScanner.h>
 #include <opendnp3/DNP3/MasterStack.h>
+#include <opendnp3/DNP3/SharedTcpListener.h>
 #include <opendnp3/DNP3/SlaveStack.h>
 #include <opendnp3/DNP3/VtoConfig.h>
 #include <opendnp3/DNP3/VtoRouter.h>
@@ -37,6 +41,8 @@
 #include <boost/foreach.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <iostream>
+#include <set>
+#include <sstream>
 
 using namespace std;
 
@@ -45,21 +51,79 @@ namespace apl
 namespace dnp
 {
 
-AsyncStackManager::AsyncStackManager(Logger* apLogger) :
-	Loggable(apLogger),
+namespace
+{
+
+IPhysicalLayerAsync* CreateSharedServer(SharedTcpListener* apListener, const std::string& arName, TcpSettings aTcp, Logger* apLogger, boost::asio::io_service* apService)
+{
+	PhysicalLayerAsyncSharedTCPServer* pLayer = new PhysicalLayerAsyncSharedTCPServer(apLogger, apService, aTcp);
+	apListener->AddLayer(arName, pLayer);
+	return pLayer;
+}
+
+}
+
+AsyncStackManager::ServiceThread::ServiceThread(AsyncStackManager* apManager, millis_t aTimerWheelTick) :
+	mNumChannels(0),
+	mpManager(apManager),
 	mService(),
-	mTimerSrc(mService.Get()),
-	mSuspendTimerSource(&mTimerSrc),
-	mMgr(apLogger->GetSubLogger("channels", LEV_WARNING), mService.Get()),
-	mScheduler(&mTimerSrc),
-	mVtoManager(apLogger->GetSubLogger("vto"), &mTimerSrc, &mMgr),
+	mpTimerSrc(CreateTimerSource(mService.Get(), aTimerWheelTick)),
+	mSuspendTimerSource(mpTimerSrc.get()),
 	mThread(this),
-	mpInfiniteTimer(mTimerSrc.StartInfinite()),
-	mIsShutdown(false)
+	mpInfiniteTimer(mpTimerSrc->StartInfinite())
+{
+
+}
+
+ITimerSource* AsyncStackManager::ServiceThread::CreateTimerSource(boost::asio::io_service* apService, millis_t aTimerWheelTick)
+{
+	if(aTimerWheelTick < 0) throw ArgumentException(LOCATION, "Timer wheel tick can't be negative");
+
+	if(aTimerWheelTick == 0) return new TimerSourceASIO(apService);
+	else return new TimerWheelSource(apService, aTimerWheelTick);
+}
+
+void AsyncStackManager::ServiceThread::Start()
 {
 	mThread.Start();
 }
 
+void AsyncStackManager::ServiceThread::Stop()
+{
+	// if we've cleaned up correctly, canceling the infinite timer will cause the thread to stop executing
+	mpInfiniteTimer->Cancel();
+	mThread.WaitForStop();
+}
+
+void AsyncStackManager::ServiceThread::Run()
+{
+	mpManager->Run(mService.Get());
+}
+
+AsyncStackManager::ServicePool AsyncStackManager::CreatePool(AsyncStackManager* apManager, size_t aNumThreads, millis_t aTimerWheelTick)
+{
+	if(aNumThreads == 0) throw ArgumentException(LOCATION, "At least one thread is required");
+
+	ServicePool pool;
+	for(size_t i = 0; i < aNumThreads; ++i) {
+		pool.push_back(boost::shared_ptr<ServiceThread>(new ServiceThread(apManager, aTimerWheelTick)));
+	}
+	return pool;
+}
+
+AsyncStackManager::AsyncStackManager(Logger* apLogger, size_t aNumThreads, millis_t aTimerWheelTick) :
+	Loggable(apLogger),
+	mPool(CreatePool(this, aNumThreads, aTimerWheelTick)),
+	mMgr(apLogger->GetSubLogger("channels", LEV_WARNING), mPool[0]->GetService()),
+	mScheduler(mPool[0]->GetTimerSource()),
+	mVtoManager(apLogger->GetSubLogger("vto"), mPool[0]->GetTimerSource(), &mMgr),
+	mIsShutdown(false)
+{
+	BOOST_FOREACH(boost::shared_ptr<ServiceThread> pThread, mPool) {
+		pThread->Start();
+	}
+}
+
 AsyncStackManager::~AsyncStackManager()
 {
 	/*
@@ -76,6 +140,13 @@ Stack* AsyncStackManager::GetStack(const std::string& arStackName)
 	return StackRecord(i->second).stack;
 }
 
+void AsyncStackManager::GetStackStatistics(const std::string& arStackName, StackStatisticsSnapshot& arSnapshot)
+{
+	StackRecord rec = this->GetStackRecordByName(arStackName);
+	rec.stack->mStatistics.Snapshot(arSnapshot);
+	arSnapshot.mCrcFailures = rec.channel->GetNumCrcFailures();
+}
+
 std::vector<std::string> AsyncStackManager::GetStackNames()
 {
 
@@ -109,6 +180,38 @@ void AsyncStackManager::AddTCPv4Server(const std::string& arName, PhysLayerSetti
 	mMgr.AddTCPv4Server(arName, aSettings, aTcp);
 }
 
+void AsyncStackManager::AddTCPv4SharedServer(const std::string& arName, PhysLayerSettings aSettings, TcpSettings aTcp)
+{
+	this->ThrowIfAlreadyShutdown();
+
+	std::ostringstream oss;
+	oss << aTcp.mAddress << ":" << aTcp.mPort;
+	std::string endpoint = oss.str();
+
+	ListenerMap::iterator i = mListeners.find(endpoint);
+	bool created = (i == mListeners.end());
+	SharedTcpListener* pListener = created ? new SharedTcpListener(mpLogger->GetSubLogger(endpoint), aTcp) : i->second;
+
+	try {
+		if(created) {
+			BOOST_FOREACH(boost::shared_ptr<ServiceThread> pThread, mPool) {
+				pListener->AddService(pThread->GetService());
+			}
+		}
+		mMgr.AddPhysicalLayerFactory(arName, aSettings, boost::bind(&CreateSharedServer, pListener, arName, aTcp, _1, _2));
+	}
+	catch(...) {
+		if(created) {
+			pListener->Stop();
+			delete pListener;
+		}
+		throw;
+	}
+
+	mListeners[endpoint] = pListener;
+	mSharedPorts[arName] = endpoint;
+}
+
 void AsyncStackManager::AddTCPv6Client(const std::string& arName, PhysLayerSettings aSettings, TcpSettings aTcp)
 {
 	this->ThrowIfAlreadyShutdown();
@@ -176,10 +279,10 @@ ICommandAcceptor* AsyncStackManager::AddMaster( const std::string& arPortName, c
 	Logger* pLogger = mpLogger->GetSubLogger(arStackName, aLevel);
 	pLogger->SetVarName(arStackName);
 
-	MasterStack* pMaster = new MasterStack(pLogger, &mTimerSrc, apPublisher, pChannel->GetGroup(), arCfg);
+	MasterStack* pMaster = new MasterStack(pLogger, this->GetThread(pChannel)->GetTimerSource(), apPublisher, pChannel->GetGroup(), arCfg);
 	LinkRoute route(arCfg.link.RemoteAddr, arCfg.link.LocalAddr);
 
-	this->AddStackToChannel(arStackName, pMaster, pChannel, route);
+	this->AddStackToChannel(arStackName, pMaster, pChannel, route, arPortName);
 
 	// add any vto routers we've configured
 	BOOST_FOREACH(VtoRouterConfig s, arCfg.vto.mRouterConfigs) {
@@ -197,10 +300,10 @@ IDataObserver* AsyncStackManager::AddSlave( const std::string& arPortName, const
 	Logger* pLogger = mpLogger->GetSubLogger(arStackName, aLevel);
 	pLogger->SetVarName(arStackName);
 
-	SlaveStack* pSlave = new SlaveStack(pLogger, &mTimerSrc, apCmdAcceptor, arCfg);
+	SlaveStack* pSlave = new SlaveStack(pLogger, this->GetThread(pChannel)->GetTimerSource(), apCmdAcceptor, arCfg);
 
 	LinkRoute route(arCfg.link.RemoteAddr, arCfg.link.LocalAddr);
-	this->AddStackToChannel(arStackName, pSlave, pChannel, route);
+	this->AddStackToChannel(arStackName, pSlave, pChannel, route, arPortName);
 
 	// add any vto routers we've configured
 	BOOST_FOREACH(VtoRouterConfig s, arCfg.vto.mRouterConfigs) {
@@ -210,13 +313,110 @@ IDataObserver* AsyncStackManager::AddSlave( const std::string& arPortName, const
 	return pSlave->mSlave.GetDataObserver();
 }
 
+void AsyncStackManager::AddStacks(std::vector<StackSpec>& arSpecs)
+{
+	this->ThrowIfAlreadyShutdown();
+
+	// validate the whole batch before anything is constructed
+	std::set<std::string> names;
+	std::vector<LinkChannel*> channels;
+	channels.reserve(arSpecs.size());
+	BOOST_FOREACH(const StackSpec& s, arSpecs) {
+		if(mStackMap.find(s.mStackName) != mStackMap.end() || !names.insert(s.mStackName).second) {
+			throw ArgumentException(LOCATION, "Stack already exists: " + s.mStackName);
+		}
+		channels.push_back(this->GetOrCreateChannel(s.mPortName));
+	}
+
+	std::vector<Stack*> stacks(arSpecs.size(), NULL);
+	std::vector<LinkRoute> routes(arSpecs.size());
+	std::vector<bool> committed(arSpecs.size(), false);
+
+	typedef std::map< ServiceThread*, std::vector<size_t> > ThreadToSpecMap;
+	ThreadToSpecMap byThread;
+	for(size_t i = 0; i < arSpecs.size(); ++i) byThread[this->GetThread(channels[i])].push_back(i);
+
+	try {
+		// construction doesn't touch the io_services, so the stacks are built while they keep running
+		for(size_t i = 0; i < arSpecs.size(); ++i) {
+			stacks[i] = this->CreateStack(arSpecs[i], channels[i], routes[i]);
+		}
+
+		BOOST_FOREACH(ThreadToSpecMap::value_type& t, byThread) {
+			// one pause of the thread binds all of its stacks
+			Transaction tr(t.first->GetSuspendTimerSource());
+			BOOST_FOREACH(size_t i, t.second) {
+				const StackSpec& s = arSpecs[i];
+
+				// routes are unique across every port on a shared endpoint, so the listener is checked
+				// before the bind and a stack is never left bound when the batch fails
+				SharedTcpListener* pListener = this->GetSharedListener(s.mPortName);
+				if(pListener != NULL) pListener->AddRoute(routes[i], s.mPortName);
+				try {
+					channels[i]->BindStackToChannel(s.mStackName, stacks[i], routes[i]);
+				}
+				catch(const Exception&) {
+					if(pListener != NULL) pListener->RemoveRoute(routes[i]);
+					throw;
+				}
+
+				mStackMap[s.mStackName] = StackRecord(stacks[i], channels[i], routes[i], s.mPortName);
+				stacks[i] = NULL;
+				committed[i] = true;
+			}
+		}
+	}
+	catch(const Exception&) {
+		// stacks that were never bound have not run and can be deleted right away
+		for(size_t i = 0; i < stacks.size(); ++i) {
+			if(committed[i]) continue;
+			if(stacks[i] != NULL) {
+				Transaction tr(this->GetThread(channels[i])->GetSuspendTimerSource());
+				delete stacks[i];
+			}
+			// the interfaces of a deleted stack must not be handed back to the caller
+			arSpecs[i].mpMasterCmdAcceptor = NULL;
+			arSpecs[i].mpSlaveDataObserver = NULL;
+		}
+		throw;
+	}
+
+	BOOST_FOREACH(const StackSpec& s, arSpecs) {
+		const VtoConfig& vto = s.mIsMaster ? s.mMaster.vto : s.mSlave.vto;
+		BOOST_FOREACH(VtoRouterConfig c, vto.mRouterConfigs) {
+			this->StartVtoRouter(c.mPhysicalLayerName, s.mStackName, c.mSettings);
+		}
+	}
+}
+
+Stack* AsyncStackManager::CreateStack(StackSpec& arSpec, LinkChannel* apChannel, LinkRoute& arRoute)
+{
+	Logger* pLogger = mpLogger->GetSubLogger(arSpec.mStackName, arSpec.mLevel);
+	pLogger->SetVarName(arSpec.mStackName);
+	ITimerSource* pTimerSrc = this->GetThread(apChannel)->GetTimerSource();
+
+	if(arSpec.mIsMaster) {
+		MasterStack* pMaster = new MasterStack(pLogger, pTimerSrc, arSpec.mpPublisher, apChannel->GetGroup(), arSpec.mMaster);
+		arRoute = LinkRoute(arSpec.mMaster.link.RemoteAddr, arSpec.mMaster.link.LocalAddr);
+		arSpec.mpMasterCmdAcceptor = pMaster->mMaster.GetCmdAcceptor();
+		return pMaster;
+	}
+	else {
+		SlaveStack* pSlave = new SlaveStack(pLogger, pTimerSrc, arSpec.mpCmdAcceptor, arSpec.mSlave, arSpec.GetDevice());
+		arRoute = LinkRoute(arSpec.mSlave.link.RemoteAddr, arSpec.mSlave.link.LocalAddr);
+		arSpec.mpSlaveDataObserver = pSlave->mSlave.GetDataObserver();
+		return pSlave;
+	}
+}
+
 void AsyncStackManager::StartVtoRouter(const std::string& arPortName,
                                        const std::string& arStackName, const VtoRouterSettings& arSettings)
 {
 	this->ThrowIfAlreadyShutdown();
 	StackRecord rec = this->GetStackRecordByName(arStackName);
-	VtoRouter* pRouter = mVtoManager.StartRouter(arPortName, arSettings, rec.stack->GetVtoWriter(),
-	    rec.stack->GetVtoReader());
+	ServiceThread* pThread = this->GetThread(rec.channel);
+	mVtoManager.StartRouter(arPortName, arSettings, rec.stack->GetVtoWriter(),
+	    rec.stack->GetVtoReader(), pThread->GetTimerSource(), pThread->GetService());
 }
 
 void AsyncStackManager::StopVtoRouter(const std::string& arStackName, boost::uint8_t aVtoChannelId)
@@ -239,18 +439,54 @@ IVtoWriter* AsyncStackManager::GetVtoWriter(const std::string& arStackName)
 	return this->GetStackRecordByName(arStackName).stack->GetVtoWriter();
 }
 
+void AsyncStackManager::AddLinkScan(const std::string& arPortName, FilterLevel aLevel, const LinkScanConfig& arCfg, ILinkScanObserver* apObserver)
+{
+	this->ThrowIfAlreadyShutdown();
+	if(mScanners.find(arPortName) != mScanners.end()) throw ArgumentException(LOCATION, "Port is already being scanned: " + arPortName);
+
+	LinkChannel* pChannel = this->GetOrCreateChannel(arPortName);
+	ServiceThread* pThread = this->GetThread(pChannel);
+	Logger* pLogger = mpLogger->GetSubLogger(arPortName + "-scan", aLevel);
+
+	std::auto_ptr<LinkScanner> pScanner(new LinkScanner(pLogger, arPortName, pChannel->GetRouter(), pThread->GetTimerSource(), arCfg, apObserver));
+
+	{
+		Transaction tr(pThread->GetSuspendTimerSource()); // need to pause execution so that this action is safe
+		pScanner->Start();
+	}
+
+	mScanners[arPortName] = pScanner.release();
+}
+
+void AsyncStackManager::RemoveLinkScan(const std::string& arPortName)
+{
+	this->ThrowIfAlreadyShutdown();
+	ScannerMap::iterator i = mScanners.find(arPortName);
+	if(i == mScanners.end()) return;
+
+	std::auto_ptr<LinkScanner> pScanner(i->second);
+	mScanners.erase(i);
+
+	Transaction tr(this->GetThread(this->GetChannelOrExcept(arPortName))->GetSuspendTimerSource());
+	pScanner->Stop();
+}
+
 // Remove a port and all associated stacks
 void AsyncStackManager::RemovePort(const std::string& arPortName)
 {
 	this->ThrowIfAlreadyShutdown();
+	this->RemoveLinkScan(arPortName);
 	LinkChannel* pChannel = this->GetChannelMaybeNull(arPortName);
+	ServiceThread* pThread = NULL;
 	if(pChannel != NULL) { // the channel is in use
 		std::auto_ptr<LinkChannel> autoDeleteChannel(pChannel); //will delete at end of function
 		mChannelNameToChannel.erase(arPortName);
 
+		pThread = this->GetThread(pChannel);
+
 		{
 			// Tell the channel to shut down permanently
-			Transaction tr(&mSuspendTimerSource);
+			Transaction tr(pThread->GetSuspendTimerSource());
 			pChannel->GetGroup()->Shutdown(); // no more task callbacks
 			pChannel->BeginShutdown();
 		}
@@ -261,8 +497,13 @@ void AsyncStackManager::RemovePort(const std::string& arPortName)
 			this->RemoveStack(s);
 		}
 		this->mScheduler.ReleaseGroup(pChannel->GetGroup());
+
+		mChannelToThread.erase(pChannel);
+		pThread->DetachChannel();
 	}
 
+	this->ReleaseSharedPort(arPortName, pThread);
+
 	// remove the physical layer from the list
 	mMgr.Remove(arPortName);
 }
@@ -297,11 +538,11 @@ void AsyncStackManager::Shutdown()
 			LOG_BLOCK(LEV_DEBUG, "Done removing Port: " << s);
 		}
 
-		// if we've cleaned up correctly, canceling the infinite timer will cause the thread to stop executing
-		mpInfiniteTimer->Cancel();
-		LOG_BLOCK(LEV_DEBUG, "Joining on io_service thread");
-		mThread.WaitForStop();
-		LOG_BLOCK(LEV_DEBUG, "Join complete on io_service thread");
+		LOG_BLOCK(LEV_DEBUG, "Joining on io_service threads");
+		BOOST_FOREACH(boost::shared_ptr<ServiceThread> pThread, mPool) {
+			pThread->Stop();
+		}
+		LOG_BLOCK(LEV_DEBUG, "Join complete on io_service threads");
 
 		mIsShutdown = true;
 	}
@@ -325,30 +566,54 @@ LinkChannel* AsyncStackManager::CreateChannel(const std::string& arName)
 	if(GetChannelMaybeNull(arName) != NULL) throw ArgumentException(LOCATION, "Channel already exists with name: " + arName);
 
 	PhysLayerSettings s = mMgr.GetSettings(arName);
-	IPhysicalLayerAsync* pPhys = mMgr.AcquireLayer(arName);
+	ServiceThread* pThread = this->SelectThread(arName);
+	IPhysicalLayerAsync* pPhys = mMgr.AcquireLayer(arName, pThread->GetService());
 	Logger* pChannelLogger = mpLogger->GetSubLogger(arName, s.LogLevel);
 	pChannelLogger->SetVarName(arName);
-	AsyncTaskGroup* pGroup = mScheduler.CreateNewGroup();
+	AsyncTaskGroup* pGroup = mScheduler.CreateNewGroup(pThread->GetTimerSource());
 
-	LinkChannel* pChannel = new LinkChannel(pChannelLogger, arName, &mTimerSrc, pPhys, pGroup, s.RetryTimeout);
+	LinkChannel* pChannel = new LinkChannel(pChannelLogger, arName, pThread->GetTimerSource(), pPhys, pGroup, s.RetryTimeout);
+	pChannel->SetOpenBackoff(s.MaxRetryTimeout, s.RetryJitter);
+	pChannel->SetOpenLimiter(&mOpenLimiter);
 	if(s.mpObserver) pChannel->AddPhysicalLayerObserver(s.mpObserver);
 	mChannelNameToChannel[arName] = pChannel;
+	mChannelToThread[pChannel] = pThread;
+	pThread->AttachChannel();
 	return pChannel;
 }
 
+AsyncStackManager::ServiceThread* AsyncStackManager::GetThread(LinkChannel* apChannel)
+{
+	ChannelToThreadMap::iterator i = mChannelToThread.find(apChannel);
+	assert(i != mChannelToThread.end());
+	return i->second;
+}
+
+AsyncStackManager::ServiceThread* AsyncStackManager::SelectThread(const std::string& arPortName)
+{
+	// custom layers are already bound to the io_service they were constructed with
+	if(mMgr.IsExternalLayer(arPortName)) return mPool[0].get();
+
+	ServiceThread* pThread = mPool[0].get();
+	BOOST_FOREACH(boost::shared_ptr<ServiceThread> p, mPool) {
+		if(p->GetNumChannels() < pThread->GetNumChannels()) pThread = p.get();
+	}
+	return pThread;
+}
+
 LinkChannel* AsyncStackManager::GetChannelMaybeNull(const std::string& arName)
 {
 	ChannelToChannelMap::iterator i = mChannelNameToChannel.find(arName);
 	return (i == mChannelNameToChannel.end()) ? NULL : i->second;
 }
 
-void AsyncStackManager::Run()
+void AsyncStackManager::Run(boost::asio::io_service* apService)
 {
 	size_t num = 0;
 
 	do {
 		try {
-			num = mService.Get()->run();
+			num = apService->run();
 		}
 		catch (boost::gregorian::bad_day_of_month& ex)
 		{
@@ -371,7 +636,7 @@ void AsyncStackManager::Run()
 	}
 	while(num > 0);
 
-	mService.Get()->reset();
+	apService->reset();
 }
 
 Stack* AsyncStackManager::SeverStackFromChannel(const std::string& arStackName)
@@ -382,9 +647,13 @@ Stack* AsyncStackManager::SeverStackFromChannel(const std::string& arStackName)
 	StackRecord rec = i->second;
 	mStackMap.erase(i);
 
+	// stop routing new connections to the stack
+	SharedTcpListener* pListener = this->GetSharedListener(rec.port);
+	if(pListener != NULL) pListener->RemoveRoute(rec.route);
+
 	LOG_BLOCK(LEV_DEBUG, "Begin severing stack: " << arStackName);
 	{
-		Transaction tr(&mSuspendTimerSource); //need to pause execution so that this action is safe
+		Transaction tr(this->GetThread(rec.channel)->GetSuspendTimerSource()); //need to pause execution so that this action is safe
 		rec.channel->RemoveStackFromChannel(arStackName);
 	}
 	LOG_BLOCK(LEV_DEBUG, "Done severing stack: " << arStackName);
@@ -392,15 +661,78 @@ Stack* AsyncStackManager::SeverStackFromChannel(const std::string& arStackName)
 	return rec.stack;
 }
 
-void AsyncStackManager::AddStackToChannel(const std::string& arStackName, Stack* apStack, LinkChannel* apChannel, const LinkRoute& arRoute)
+void AsyncStackManager::AddStackToChannel(const std::string& arStackName, Stack* apStack, LinkChannel* apChannel, const LinkRoute& arRoute, const std::string& arPortName)
 {
-	{
+	ServiceThread* pThread = this->GetThread(apChannel);
+	SharedTcpListener* pListener = this->GetSharedListener(arPortName);
+	bool routed = false;
+
+	try {
+		// routes are unique across every port on a shared endpoint, so the listener is checked first
+		if(pListener != NULL) {
+			pListener->AddRoute(arRoute, arPortName);
+			routed = true;
+		}
+
 		// when binding the stack to the router, we need to pause excution
-		Transaction tr(&mSuspendTimerSource);
+		Transaction tr(pThread->GetSuspendTimerSource());
 		apChannel->BindStackToChannel(arStackName, apStack, arRoute);
 	}
+	catch(const Exception&) {
+		if(routed) pListener->RemoveRoute(arRoute);
+
+		// the stack's timers belong to the thread, so it is deleted while the thread is paused
+		Transaction tr(pThread->GetSuspendTimerSource());
+		delete apStack;
+		throw;
+	}
+
+	mStackMap[arStackName] = StackRecord(apStack, apChannel, arRoute, arPortName);
+}
+
+SharedTcpListener* AsyncStackManager::GetSharedListener(const std::string& arPortName)
+{
+	SharedPortMap::iterator i = mSharedPorts.find(arPortName);
+	return (i == mSharedPorts.end()) ? NULL : mListeners[i->second];
+}
 
-	mStackMap[arStackName] = StackRecord(apStack, apChannel);
+void AsyncStackManager::ReleaseSharedPort(const std::string& arPortName, ServiceThread* apThread)
+{
+	SharedPortMap::iterator i = mSharedPorts.find(arPortName);
+	if(i == mSharedPorts.end()) return;
+
+	std::string endpoint = i->second;
+	mSharedPorts.erase(i);
+
+	SharedTcpListener* pListener = mListeners[endpoint];
+	pListener->RemoveLayer(arPortName);
+
+	// a connection may have been handed to the layer just before it was removed, let it be rejected before the layer is deleted
+	if(apThread != NULL) apThread->GetTimerSource()->Sync();
+
+	BOOST_FOREACH(SharedPortMap::value_type v, mSharedPorts) {
+		if(v.second == endpoint) return;
+	}
+
+	// that was the last port on the endpoint
+	pListener->Stop();
+	delete pListener;
+	mListeners.erase(endpoint);
+}
+
+void AsyncStackManager::SetOpenRateLimit(double aOpensPerSecond, size_t aBurst)
+{
+	mOpenLimiter.Configure(aOpensPerSecond, aBurst);
+}
+
+size_t AsyncStackManager::GetNumOpenRetries(const std::string& arPortName)
+{
+	return this->GetChannelOrExcept(arPortName)->GetNumOpenRetries();
+}
+
+millis_t AsyncStackManager::GetOpenRetryDelay(const std::string& arPortName)
+{
+	return this->GetChannelOrExcept(arPortName)->GetOpenRetryDelay();
 }
 
 ScanScheduler* AsyncStackManager::GetScanScheduler(const std::string& arStackName)
@@ -417,7 +749,7 @@ void AsyncStackManager::UpdateIntegrityRate(const std::string& arStackName, uint
 	StackRecord record = this->GetStackRecordByName(arStackName);
 	MasterStack* pMasterStack = dynamic_cast<MasterStack *>(record.stack);
 	if (NULL != pMasterStack) {
-		Transaction tr(&mSuspendTimerSource); // need to pause execution so that this action is safe
+		Transaction tr(this->GetThread(record.channel)->GetSuspendTimerSource()); // need to pause execution so that this action is safe
 		pMasterStack->mMaster.UpdateIntegrityPollRate(integrityRate);
 	}
 	return;
@@ -32,14 +32,20 @@
 #include <opendnp3/APL/Threadable.h>
 #include <opendnp3/APL/TimerSourceASIO.h>
 #include <opendnp3/APL/TcpSettings.h>
+#include <opendnp3/APL/TokenBucket.h>
 #include <opendnp3/APL/UdpSettings.h>
 #include <opendnp3/DNP3/ScanScheduler.h>
 #include <opendnp3/DNP3/LinkRoute.h>
+#include <opendnp3/DNP3/StackSpec.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 #include <opendnp3/DNP3/VtoDataInterface.h>
 #include <opendnp3/DNP3/VtoRouterManager.h>
 
 
+#include <boost/shared_ptr.hpp>
+#include <assert.h>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace apl
@@ -55,10 +61,14 @@ namespace apl
 namespace dnp
 {
 
+class ILinkScanObserver;
 class LinkChannel;
+class LinkScanner;
+class SharedTcpListener;
 class Stack;
 struct VtoRouterSettings;
 
+struct LinkScanConfig;
 struct SlaveStackConfig;
 struct MasterStackConfig;
 
@@ -67,14 +77,25 @@ struct MasterStackConfig;
 	starting/stopping master/slave protocol stacks. Any method may be
 	called while the system is running.  Methods should only be called
 	from a single thread at at a time.
+
+	The stacks are driven by a pool of threads that each run their own
+	io_service. Every port is pinned to one thread of the pool along with
+	its router, stacks, timers and VTO routers, so everything on a port is
+	still executed in order while separate ports run in parallel. Ports
+	are assigned to the thread with the fewest ports.
 */
-class AsyncStackManager : private Threadable, private Loggable
+class AsyncStackManager : private Loggable
 {
 public:
 	/**
 		@param apLogger - Logger to use for all other loggers
+		@param aNumThreads - Number of threads driving the ports, at least 1
+		@param aTimerWheelTick - If non-zero, the timers of each thread are multiplexed
+								 onto a TimerWheelSource with this resolution in milliseconds
+								 instead of using one ASIO timer per timer
+		@throw ArgumentException	if aNumThreads is 0 or aTimerWheelTick is negative
 	*/
-	AsyncStackManager(Logger* apLogger);
+	AsyncStackManager(Logger* apLogger, size_t aNumThreads = 1, millis_t aTimerWheelTick = 0);
 	~AsyncStackManager();
 
 	// All the io_service marshalling now occurs here. It's now safe to add/remove while the manager is running.
@@ -87,6 +108,17 @@ public:
 	void AddTCPServer(const std::string& arName, PhysLayerSettings, TcpSettings);
 	void AddTCPv4Server(const std::string& arName, PhysLayerSettings, TcpSettings);
 
+	/**
+		Adds a TCPv4 server port that shares its listening endpoint with every other
+		shared server port on the same address and port. Each connection is attached
+		to the port that has a stack whose route matches the first link frame received,
+		so one endpoint can serve any number of masters. Every thread of the pool
+		accepts on the endpoint where the platform supports SO_REUSEPORT.
+
+		@throw ArgumentException if the port already exists
+	*/
+	void AddTCPv4SharedServer(const std::string& arName, PhysLayerSettings, TcpSettings);
+
 	// Adds a TCPv6Client port, excepts if the port already exists
 	void AddTCPv6Client(const std::string& arName, PhysLayerSettings, TcpSettings);
 
@@ -166,6 +198,25 @@ public:
 	                        ICommandAcceptor* apCmdAcceptor,
 	                        const SlaveStackConfig&);
 
+	/**
+		Adds a batch of master and slave stacks. Equivalent to calling
+		AddMaster() or AddSlave() for every spec, but the stacks are
+		constructed before the io_services are paused and all the stacks
+		on a thread are bound to their ports in one pause, so bringing up
+		thousands of stacks doesn't cost one round trip per stack.
+
+		@param arSpecs				Stacks to add. On return the
+									mpMasterCmdAcceptor or
+									mpSlaveDataObserver of each spec
+									is set.
+
+		@throw ArgumentException	if a port doesn't exist, a stack name
+									is used twice or already exists, or a
+									route is already in use. Stacks bound
+									before the failure remain added.
+	*/
+	void AddStacks(std::vector<StackSpec>& arSpecs);
+
 	/**
 		Starts the VtoRouter for the specified port and stack.
 		A VtoRouter acts as a conduit, where the VTO stream is funneled
@@ -223,6 +274,28 @@ public:
 	*/
 	IVtoWriter* GetVtoWriter(const std::string& arStackName);
 
+	/**
+		Starts scanning a port for devices that answer at the link layer.
+		A window of addresses is probed at once, so scanning a range takes
+		roughly (range / window) timeouts instead of one timeout per address.
+		Addresses already bound to a stack on the port are skipped. Any
+		number of ports can be scanned concurrently.
+
+		@param arPortName			Unique name of the port to scan
+		@param aLevel				Log filter level to use
+		@param arCfg				Address range, window and probe settings
+		@param apObserver			Told about every address that answers and
+									when the scan completes. The callbacks come
+									from the thread driving the port.
+
+		@throw ArgumentException	if arPortName doesn't exist, is already being
+									scanned, or arCfg is invalid
+	*/
+	void AddLinkScan(const std::string& arPortName, FilterLevel aLevel, const LinkScanConfig& arCfg, ILinkScanObserver* apObserver);
+
+	// Synchronously stop and remove the scan on a port, does nothing if there isn't one
+	void RemoveLinkScan(const std::string& arPortName);
+
 	// Synchronously remove a port and all associated stacks
 	void RemovePort(const std::string& arPortName);
 
@@ -238,6 +311,19 @@ public:
 	// @return a vector of all the port names
 	std::vector<std::string> GetPortNames();
 
+	/**
+		Takes a snapshot of the performance counters and latency histograms of
+		a stack. The counters are read while the stack keeps running, so this
+		can be polled at any rate without stopping the io_service.
+
+		@param arStackName Unique name of the stack
+		@param arSnapshot Receives the statistics, CRC failures are counted for the
+						  port since a corrupted frame can't be attributed to a stack
+
+		@throw ArgumentException if arStackName doesn't exist
+	*/
+	void GetStackStatistics(const std::string& arStackName, StackStatisticsSnapshot& arSnapshot);
+
 	/**
 	* Synchronously stops all running stacks and ports. Permanently
 	* stops the running background thread.
@@ -247,12 +333,53 @@ public:
 	/**
 	* The underlying io_service object that drives the stack. This is exposed
 	* so that applications can write single-threaded applications using
-	* the same asynchronous machinery if desired.
+	* the same asynchronous machinery if desired. With more than one thread
+	* this is the io_service of the first thread, which also drives any
+	* ports added with AddPhysicalLayer().
 	*/
 	boost::asio::io_service* GetIOService() {
-		return mService.Get();
+		return mPool[0]->GetService();
+	}
+
+	// @return the number of threads driving the ports
+	size_t GetNumThreads() {
+		return mPool.size();
+	}
+
+	/**
+		Limits the rate at which the channels of this manager retry opening
+		their ports, so that a large number of channels that lose their
+		connections at the same time don't reconnect all at once. Applies to
+		every retry scheduled from now on.
+
+		@param aOpensPerSecond	Open retries allowed per second, 0 for no limit
+		@param aBurst			Number of retries that may start at once
+
+		@throw ArgumentException if aOpensPerSecond is negative or aBurst is 0
+	*/
+	void SetOpenRateLimit(double aOpensPerSecond, size_t aBurst);
+
+	// @return the number of open retries that are waiting for their timer
+	size_t GetNumPendingOpens() {
+		return mOpenLimiter.NumPending();
 	}
 
+	/**
+		@param arPortName Unique name of the port
+		@return the number of consecutive failed opens of the port, reset when it opens
+
+		@throw ArgumentException if no stack has been added to the port
+	*/
+	size_t GetNumOpenRetries(const std::string& arPortName);
+
+	/**
+		@param arPortName Unique name of the port
+		@return the delay before the next open retry of the port in milliseconds
+
+		@throw ArgumentException if no stack has been added to the port
+	*/
+	millis_t GetOpenRetryDelay(const std::string& arPortName);
+
 	/**
 	  Retrieves stack specific ScanScheduler object
 
@@ -271,25 +398,96 @@ public:
 
 private:
 
-	// Implement IThreadable
-	void Run();
+	/**
+		One thread of the pool and the io_service it runs. An infinite timer
+		keeps the service from running out of work until Stop() is called.
+	*/
+	class ServiceThread : private Threadable
+	{
+	public:
+		ServiceThread(AsyncStackManager* apManager, millis_t aTimerWheelTick);
+
+		void Start();
+		void Stop();
+
+		boost::asio::io_service* GetService() {
+			return mService.Get();
+		}
+		ITimerSource* GetTimerSource() {
+			return mpTimerSrc.get();
+		}
+		SuspendTimerSource* GetSuspendTimerSource() {
+			return &mSuspendTimerSource;
+		}
+
+		/// Counts a channel that runs on this thread, threads are picked by their load
+		void AttachChannel() {
+			++mNumChannels;
+		}
+		void DetachChannel() {
+			assert(mNumChannels > 0);
+			--mNumChannels;
+		}
+		size_t GetNumChannels() const {
+			return mNumChannels;
+		}
+
+	private:
+
+		// Implement IThreadable
+		void Run();
+
+		static ITimerSource* CreateTimerSource(boost::asio::io_service* apService, millis_t aTimerWheelTick);
+
+		size_t mNumChannels;
+		AsyncStackManager* mpManager;
+		IOService mService;
+		std::auto_ptr<ITimerSource> mpTimerSrc;
+		SuspendTimerSource mSuspendTimerSource;
+		Thread mThread;
+		ITimer* mpInfiniteTimer;
+	};
+
+	// destroyed last, the io_services must outlive all of the objects that use them
+	typedef std::vector< boost::shared_ptr<ServiceThread> > ServicePool;
+	ServicePool mPool;
+
+	// shared by the channels, must outlive them
+	TokenBucket mOpenLimiter;
+
+	static ServicePool CreatePool(AsyncStackManager* apManager, size_t aNumThreads, millis_t aTimerWheelTick);
+
+	// Runs an io_service until it is out of work
+	void Run(boost::asio::io_service* apService);
 
 	void OnPreStackDeletion(Stack* apStack);
 
 	// Remove and close a stack, but delegate responsibility for deletion
 	Stack* SeverStackFromChannel(const std::string& arStackName);
 
-	// Add a stack from to a specified channel
-	void AddStackToChannel(const std::string& arStackName, Stack* apStack, LinkChannel* apChannel, const LinkRoute& arRoute);
+	// Add a stack to a specified channel, the stack is deleted if it can't be added
+	void AddStackToChannel(const std::string& arStackName, Stack* apStack, LinkChannel* apChannel, const LinkRoute& arRoute, const std::string& arPortName);
+
+	// Constructs the stack described by a spec without binding it to its channel
+	Stack* CreateStack(StackSpec& arSpec, LinkChannel* apChannel, LinkRoute& arRoute);
+
+	// Listeners of the shared server ports, keyed by endpoint
+	typedef std::map<std::string, SharedTcpListener*> ListenerMap;
+	ListenerMap mListeners;
+
+	// Maps the name of a shared server port to its endpoint
+	typedef std::map<std::string, std::string> SharedPortMap;
+	SharedPortMap mSharedPorts;
+
+	SharedTcpListener* GetSharedListener(const std::string& arPortName);
+	void ReleaseSharedPort(const std::string& arPortName, ServiceThread* apThread);
+
+	typedef std::map<std::string, LinkScanner*> ScannerMap;
+	ScannerMap mScanners;	// link address scans, keyed by port name
 
-	IOService mService;
-	TimerSourceASIO mTimerSrc;
-	SuspendTimerSource mSuspendTimerSource;
 	PhysicalLayerManager mMgr;
 	AsyncTaskScheduler mScheduler;
 	VtoRouterManager mVtoManager;
-	Thread mThread;
-	ITimer* mpInfiniteTimer;
 	bool mIsShutdown;
 
 	void ThrowIfAlreadyShutdown();
@@ -299,12 +497,14 @@ private:
 			stack(NULL), channel(NULL)
 		{}
 
-		StackRecord(Stack* apStack, LinkChannel* apChannel) :
-			stack(apStack), channel(apChannel)
+		StackRecord(Stack* apStack, LinkChannel* apChannel, const LinkRoute& arRoute, const std::string& arPortName) :
+			stack(apStack), channel(apChannel), route(arRoute), port(arPortName)
 		{}
 
 		Stack* stack;
 		LinkChannel* channel;
+		LinkRoute route;
+		std::string port;
 	};
 
 	typedef std::map<std::string, StackRecord> StackMap; // maps a stack name the stack and it's channel
@@ -318,6 +518,12 @@ private:
 	LinkChannel* GetChannelMaybeNull(const std::string& arName);
 	LinkChannel* CreateChannel(const std::string& arName);
 
+	typedef std::map<LinkChannel*, ServiceThread*> ChannelToThreadMap;
+	ChannelToThreadMap mChannelToThread;	// maps a channel to the thread that drives it
+
+	ServiceThread* GetThread(LinkChannel* apChannel);
+	ServiceThread* SelectThread(const std::string& arPortName);
+
 	StackRecord GetStackRecordByName(const std::string& arName);
 
 };
@@ -0,0 +1,118 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/AutoVariation.h>
+
+#include <opendnp3/APL/QualityMasks.h>
+#include <opendnp3/DNP3/Objects.h>
+
+#include <math.h>
+
+namespace apl
+{
+namespace dnp
+{
+
+boost::uint8_t AutoVariation::Classify(bool, boost::uint8_t aQuality)
+{
+	// the state lives in the quality byte, it's the only thing Group1Var1 carries
+	return ((aQuality & ~BQ_STATE) == BQ_ONLINE) ? AR_NOMINAL : AR_FLAGS;
+}
+
+boost::uint8_t AutoVariation::Classify(double aValue, boost::uint8_t aQuality)
+{
+	boost::uint8_t req = (aQuality == AQ_ONLINE) ? AR_NOMINAL : AR_FLAGS;
+
+	// fractions, NaN and anything past 32 bits are left to the configured variation
+	if(aValue != floor(aValue) || aValue < -2147483648.0 || aValue > 2147483647.0) req |= AR_WIDE;
+	else if(aValue < -32768.0 || aValue > 32767.0) req |= AR_32_BIT;
+
+	return req;
+}
+
+boost::uint8_t AutoVariation::Classify(boost::uint32_t aValue, boost::uint8_t aQuality)
+{
+	boost::uint8_t req = (aQuality == CQ_ONLINE) ? AR_NOMINAL : AR_FLAGS;
+	if(aValue > 0xFFFF) req |= AR_32_BIT;
+	return req;
+}
+
+StreamObject<Binary>* AutoVariation::Select(StreamObject<Binary>* apDefault, boost::uint8_t aReq)
+{
+	return (aReq == AR_NOMINAL) ? NULL : apDefault;
+}
+
+StreamObject<Analog>* AutoVariation::Select(StreamObject<Analog>* apDefault, boost::uint8_t aReq)
+{
+	if(aReq & AR_WIDE) return apDefault;
+
+	switch(aReq) {
+	case(AR_NOMINAL): return Smaller<Analog>(Group30Var4::Inst(), apDefault);
+	case(AR_FLAGS): return Smaller<Analog>(Group30Var2::Inst(), apDefault);
+	case(AR_32_BIT): return Smaller<Analog>(Group30Var3::Inst(), apDefault);
+	default: return Smaller<Analog>(Group30Var1::Inst(), apDefault);
+	}
+}
+
+StreamObject<Counter>* AutoVariation::Select(StreamObject<Counter>* apDefault, boost::uint8_t aReq)
+{
+	switch(aReq & (AR_FLAGS | AR_32_BIT)) {
+	case(AR_NOMINAL): return Smaller<Counter>(Group20Var6::Inst(), apDefault);
+	case(AR_FLAGS): return Smaller<Counter>(Group20Var2::Inst(), apDefault);
+	case(AR_32_BIT): return Smaller<Counter>(Group20Var5::Inst(), apDefault);
+	default: return Smaller<Counter>(Group20Var1::Inst(), apDefault);
+	}
+}
+
+size_t AutoVariation::BytesOf(const AutoSegment& arSegment, size_t aStart, const size_t* apBits)
+{
+	// group, variation, qualifier and a start/stop pair sized like APDU::GetContiguousQualifier
+	size_t stop = aStart + arSegment.mOffset + arSegment.mCount - 1;
+	size_t width = (stop <= 0xFF) ? 1 : ((stop <= 0xFFFF) ? 2 : 4);
+	return 3 + 2 * width + (arSegment.mCount * apBits[arSegment.mReq] + 7) / 8;
+}
+
+void AutoVariation::Segment(const boost::uint8_t* apReqs, size_t aCount, size_t aStart, const size_t* apBits, std::vector<AutoSegment>& arSegments)
+{
+	if(aCount == 0) return;
+
+	AutoSegment current(0, 1, apReqs[0]);
+	size_t i = 1;
+
+	while(i < aCount) {
+		// the next stretch of points with the same requirement
+		AutoSegment next(i, 1, apReqs[i]);
+		for(++i; i < aCount && apReqs[i] == next.mReq; ++i) ++next.mCount;
+
+		AutoSegment merged(current.mOffset, current.mCount + next.mCount, current.mReq | next.mReq);
+		if(BytesOf(merged, aStart, apBits) <= BytesOf(current, aStart, apBits) + BytesOf(next, aStart, apBits)) {
+			current = merged;
+		}
+		else {
+			arSegments.push_back(current);
+			current = next;
+		}
+	}
+
+	arSegments.push_back(current);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
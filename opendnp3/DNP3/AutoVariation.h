@@ -0,0 +1,123 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __AUTO_VARIATION_H_
+#define __AUTO_VARIATION_H_
+
+#include <opendnp3/APL/DataTypes.h>
+#include <opendnp3/DNP3/ObjectInterfaces.h>
+
+#include <boost/cstdint.hpp>
+
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+ * What a static point needs from the variation it is written with. The
+ * requirements of several points combine with bitwise OR, so the combined
+ * requirement of a segment selects a variation able to represent all of
+ * its points.
+ */
+enum AutoRequirement {
+	AR_NOMINAL = 0,		//!< online with no other flags, fits in 16 bits
+	AR_FLAGS = 0x01,	//!< the quality has to be reported
+	AR_32_BIT = 0x02,	//!< the value needs 32 bits
+	AR_WIDE = 0x04,		//!< only the configured variation can represent the value
+	AR_NUM = 0x08
+};
+
+/// Consecutive points of a run that are written with the same object
+struct AutoSegment {
+	AutoSegment(size_t aOffset = 0, size_t aCount = 0, boost::uint8_t aReq = AR_NOMINAL) :
+		mOffset(aOffset), mCount(aCount), mReq(aReq)
+	{}
+
+	size_t mOffset;			// offset of the first point from the start of the run
+	size_t mCount;
+	boost::uint8_t mReq;	// combined requirement of the points
+};
+
+/**
+ * Picks the smallest variations for static responses when the master asks
+ * for the default variation (class 0 or variation 0).
+ *
+ * Runs of online binaries are bit packed with Group1Var1, and analogs and
+ * counters drop their flags and/or use 16 bit values where every point of a
+ * segment allows it. A variation is only used instead of the configured one
+ * if it is smaller, so a response never grows.
+ */
+class AutoVariation
+{
+public:
+
+	static boost::uint8_t Classify(bool aValue, boost::uint8_t aQuality);			// binary
+	static boost::uint8_t Classify(double aValue, boost::uint8_t aQuality);			// analog
+	static boost::uint8_t Classify(boost::uint32_t aValue, boost::uint8_t aQuality);	// counter
+
+	/// @return the object to write a segment with, NULL for the Group1Var1 bitfield
+	static StreamObject<Binary>* Select(StreamObject<Binary>* apDefault, boost::uint8_t aReq);
+	static StreamObject<Analog>* Select(StreamObject<Analog>* apDefault, boost::uint8_t aReq);
+	static StreamObject<Counter>* Select(StreamObject<Counter>* apDefault, boost::uint8_t aReq);
+
+	/* Control and setpoint statuses always use the configured variation */
+
+	static StreamObject<ControlStatus>* Select(StreamObject<ControlStatus>* apDefault, boost::uint8_t) {
+		return apDefault;
+	}
+	static StreamObject<SetpointStatus>* Select(StreamObject<SetpointStatus>* apDefault, boost::uint8_t) {
+		return apDefault;
+	}
+
+	/// Fills apBits[AR_NUM] with the number of bits a point takes for each requirement
+	template <class T>
+	static void GetBitsPerPoint(StreamObject<T>* apDefault, size_t* apBits) {
+		for(size_t i = 0; i < AR_NUM; ++i) {
+			StreamObject<T>* pObj = Select(apDefault, static_cast<boost::uint8_t>(i));
+			apBits[i] = (pObj == NULL) ? 1 : 8 * pObj->GetSize();
+		}
+	}
+
+	/**
+	 * Splits the run of aCount points whose first index is aStart into
+	 * segments. Neighbouring segments are merged greedily whenever one header
+	 * with the combined variation is no larger than two headers.
+	 */
+	static void Segment(const boost::uint8_t* apReqs, size_t aCount, size_t aStart, const size_t* apBits, std::vector<AutoSegment>& arSegments);
+
+private:
+
+	// the cheaper of a candidate and the configured object
+	template <class T>
+	static StreamObject<T>* Smaller(StreamObject<T>* apCandidate, StreamObject<T>* apDefault) {
+		return (apCandidate->GetSize() < apDefault->GetSize()) ? apCandidate : apDefault;
+	}
+
+	static size_t BytesOf(const AutoSegment& arSegment, size_t aStart, const size_t* apBits);
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
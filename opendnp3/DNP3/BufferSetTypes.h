@@ -19,6 +19,8 @@
 #ifndef __BUFFER_SET_TYPES_H_
 #define __BUFFER_SET_TYPES_H_
 
+#include <opendnp3/DNP3/EventStore.h>
+
 #include <iostream>
 #include <limits>
 #include <map>
@@ -31,6 +33,9 @@ namespace dnp
 {
 
 // C++ doesn't allow templated typedefs, but this technique simulates this behavior
+//
+// The containers are preallocated event stores (see EventStore.h) rather than
+// std::set, so that buffering an event doesn't allocate a tree node.
 
 // Set that forces data exclusivity by index
 template <class T>
@@ -41,7 +46,7 @@ struct IndexSet {
 			return a.mIndex < b.mIndex;
 		}
 	};
-	typedef std::set< T, LessThanByIndex > Type;
+	typedef IndexedEventStore< T, LessThanByIndex > Type;
 };
 
 //  Multiset that orders data by order by timestamp, multi-entries allowed
@@ -53,7 +58,7 @@ struct TimeMultiSet {
 		}
 	};
 
-	typedef std::multiset<T, LessThanByTime > Type;
+	typedef OrderedEventStore<T, LessThanByTime > Type;
 };
 
 /** Sorts events by the order in which they are inserted.
@@ -67,7 +72,7 @@ struct InsertionOrderSet {
 		}
 	};
 
-	typedef std::set<T, InsertionOrder > Type;
+	typedef OrderedEventStore<T, InsertionOrder > Type;
 };
 
 
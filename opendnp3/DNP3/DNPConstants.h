@@ -107,7 +107,7 @@ enum DNPErrorCodes {
 	DLERR_UNEXPECTED_FCB,	//  FCB set unexpectedly
 
 	// Data Link Layer
-	DLERR_UNKNOWN_ROUTE,	// carries 2 pieces of meta-data: SRC<uint16_t> and DEST<uint16_t>
+	DLERR_UNKNOWN_ROUTE,	// carries SOURCE and DESTINATION of the last frame and the COUNT of frames since the last warning
 	DLERR_UNKNOWN_DESTINATION,
 	DLERR_UNKNOWN_SOURCE,
 	DLERR_CONFIRM_NOT_RECEIVED,
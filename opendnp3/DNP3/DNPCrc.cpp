@@ -18,8 +18,10 @@
 //
 
 #include <opendnp3/APL/CRC.h>
+#include <opendnp3/APL/Exception.h>
 #include <opendnp3/APL/PackingUnpacking.h>
 #include <opendnp3/DNP3/DNPCrc.h>
+#include <opendnp3/DNP3/LinkLayerConstants.h>
 
 namespace apl
 {
@@ -27,13 +29,32 @@ namespace dnp
 {
 
 unsigned int DNPCrc::mpCrcTable[256];
+boost::uint16_t DNPCrc::mpSliceTables[16 * 256];
+boost::uint64_t DNPCrc::mFoldConstant = 0;
+CrcKernel DNPCrc::mKernel = CK_SCALAR;
 
 //initialize the table
 bool DNPCrc::mIsInitialized = DNPCrc::InitCrcTable();
 
 unsigned int DNPCrc::CalcCrc(const boost::uint8_t* aInput, size_t aLength)
 {
-	return CRC::CalcCRC(aInput, aLength, mpCrcTable, 0x0000, true);
+	return CalcCrc(aInput, aLength, mKernel);
+}
+
+unsigned int DNPCrc::CalcCrc(const boost::uint8_t* aInput, size_t aLength, CrcKernel aKernel)
+{
+	switch(aKernel) {
+	case(CK_SLICE_8):
+		return CRC::CalcCRCSlice8(aInput, aLength, mpSliceTables, 0x0000, true);
+	case(CK_SLICE_16):
+		return CRC::CalcCRCSlice16(aInput, aLength, mpSliceTables, 0x0000, true);
+	case(CK_CLMUL):
+		// only full data blocks are folded, headers and partial blocks use the tables
+		if(aLength == LS_DATA_BLOCK_SIZE) return (~CRC::CalcCRCBlockClmul(aInput, mFoldConstant, mpSliceTables)) & 0xFFFF;
+		else return CRC::CalcCRCSlice8(aInput, aLength, mpSliceTables, 0x0000, true);
+	default:
+		return CRC::CalcCRC(aInput, aLength, mpCrcTable, 0x0000, true);
+	}
 }
 
 void DNPCrc::AddCrc(boost::uint8_t* aInput, size_t aLength)
@@ -49,9 +70,34 @@ bool DNPCrc::IsCorrectCRC(const boost::uint8_t* aInput, size_t aLength)
 	return CalcCrc(aInput, aLength) == UInt16LE::Read(aInput + aLength);
 }
 
+bool DNPCrc::IsCorrectBodyCRC(const boost::uint8_t* apBody, size_t aLength)
+{
+	while(aLength > 0) {
+		size_t num = (aLength < LS_DATA_BLOCK_SIZE) ? aLength : static_cast<size_t>(LS_DATA_BLOCK_SIZE);
+		if(CalcCrc(apBody, num, mKernel) != UInt16LE::Read(apBody + num)) return false;
+		apBody += (num + LS_CRC_SIZE);
+		aLength -= num;
+	}
+	return true;
+}
+
+bool DNPCrc::IsSupported(CrcKernel aKernel)
+{
+	return (aKernel != CK_CLMUL) || CRC::HasCarrylessMultiply();
+}
+
+void DNPCrc::SelectKernel(CrcKernel aKernel)
+{
+	if(!IsSupported(aKernel)) throw ArgumentException(LOCATION, "CRC kernel not supported by this processor");
+	mKernel = aKernel;
+}
+
 bool DNPCrc::InitCrcTable()
 {
 	CRC::PrecomputeCRC(mpCrcTable, 0xA6BC);
+	CRC::PrecomputeSlices(mpSliceTables, 16, mpCrcTable);
+	mFoldConstant = CRC::CalcFoldConstant(0xA6BC);
+	mKernel = CRC::HasCarrylessMultiply() ? CK_CLMUL : CK_SLICE_16;
 	return true;
 }
 
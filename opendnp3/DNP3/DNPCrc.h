@@ -28,6 +28,14 @@ namespace apl
 namespace dnp
 {
 
+/// The CRC implementations that DNPCrc can dispatch to
+enum CrcKernel {
+	CK_SCALAR,		//!< byte-wise table lookup
+	CK_SLICE_8,		//!< slice-by-8 table lookup
+	CK_SLICE_16,	//!< slice-by-16 table lookup
+	CK_CLMUL		//!< carry-less multiply folding of 16 byte blocks, x86 only
+};
+
 class DNPCrc
 {
 public:
@@ -38,6 +46,27 @@ public:
 
 	static bool IsCorrectCRC(const boost::uint8_t* aInput, size_t aLength);
 
+	/** Validates every block CRC of a link frame body in one call
+		@param apBody Start of the body, i.e. the first byte after the 10 byte header
+		@param aLength Number of user data bytes in the body, excluding CRCs
+		@return True if every block CRC is correct */
+	static bool IsCorrectBodyCRC(const boost::uint8_t* apBody, size_t aLength);
+
+	/// Calculates the CRC using a specific kernel, used to compare implementations
+	static unsigned int CalcCrc(const boost::uint8_t* aInput, size_t aLength, CrcKernel aKernel);
+
+	/// @return True if the kernel can run on this processor
+	static bool IsSupported(CrcKernel aKernel);
+
+	/** Overrides the kernel chosen at startup. The fastest supported kernel is selected
+		automatically, so this is only needed for benchmarking.
+		@throw ArgumentException if the kernel is not supported on this processor */
+	static void SelectKernel(CrcKernel aKernel);
+
+	static CrcKernel GetKernel() {
+		return mKernel;
+	}
+
 private:
 
 	static bool mIsInitialized;
@@ -45,6 +74,10 @@ private:
 	static bool InitCrcTable();
 
 	static unsigned int mpCrcTable[256]; //Precomputed CRC lookup table
+	static boost::uint16_t mpSliceTables[16 * 256]; //Slice-by-N tables derived from mpCrcTable
+	static boost::uint64_t mFoldConstant; //x^63 mod P for the carry-less multiply kernel
+
+	static CrcKernel mKernel;
 
 };
 
@@ -22,6 +22,7 @@
 #include <opendnp3/APL/DataTypes.h>
 #include <opendnp3/APL/Types.h>
 #include <opendnp3/DNP3/PointClass.h>
+#include <opendnp3/DNP3/StaticPointStore.h>
 #include <opendnp3/DNP3/VtoData.h>
 
 #include <vector>
@@ -79,9 +80,12 @@ struct PointInfo : public PointInfoBase<T> {
 	size_t mSequence;
 };
 
+/**
+ * Iterator over the static values of the measurement type of DataInfoType
+ */
 template <class DataInfoType>
 struct StaticIter {
-	typedef typename std::vector< DataInfoType >::const_iterator Type;
+	typedef typename StaticPointStore<typename DataInfoType::MeasType>::const_iterator Type;
 };
 
 typedef PointInfo<apl::Binary>					BinaryInfo;
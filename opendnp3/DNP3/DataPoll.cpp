@@ -36,7 +36,8 @@ namespace dnp
 DataPoll::DataPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader) :
 	MasterTaskBase(apLogger),
 	mpObs(apObs),
-	mpVtoReader(apVtoReader)
+	mpVtoReader(apVtoReader),
+	mpStats(NULL)
 {}
 
 TaskResult DataPoll::_OnPartialResponse(const APDU& f)
@@ -53,7 +54,7 @@ TaskResult DataPoll::_OnFinalResponse(const APDU& f)
 
 void DataPoll::ReadData(const APDU& f)
 {
-	ResponseLoader loader(mpLogger, mpObs, mpVtoReader);
+	ResponseLoader loader(mpLogger, mpObs, mpVtoReader, mpStats, &mBatches);
 	HeaderReadIterator hdr = f.BeginRead();
 	for ( ; !hdr.IsEnd(); ++hdr) {
 		loader.Process(hdr);
@@ -93,28 +94,50 @@ void ClassPoll::ConfigureRequest(APDU& arAPDU)
 /* Free-Form Poll */
 
 FreeFormPoll::FreeFormPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader) :
-	ClassPoll(apLogger, apObs, apVtoReader) //,
-	//ClassPoll::mClassMask(PC_INVALID)
+	ClassPoll(apLogger, apObs, apVtoReader),
+	mFragment(0),
+	mNumFragments(0),
+	mPlanChanged(false)
 {}
 
-void FreeFormPoll::SetDataPoints(std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> pnts)
+void FreeFormPoll::SetDataPoints(const std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash>& pnts)
 {
 	std::lock_guard<std::mutex> guard{ffInputPoints_mutex_};
-	ffInputPoints.clear();
-	ffInputPoints = pnts;
+	mPlanner.Clear();
+
+	// a poll that is in progress restarts with the new plan once the current request completes
+	mPlanChanged = true;
+
+	for (const auto& element : pnts) {
+		switch (element.first) {
+		case apl::DataTypes::DT_ANALOG:
+			mPlanner.AddPoints(Group30Var1::Inst(), element.second);
+			break;
+		case apl::DataTypes::DT_BINARY:
+			mPlanner.AddPoints(Group1Var2::Inst(), element.second);
+			break;
+		case apl::DataTypes::DT_COUNTER:
+			mPlanner.AddPoints(Group20Var1::Inst(), element.second);
+			break;
+		case apl::DataTypes::DT_CONTROL_STATUS:
+			mPlanner.AddPoints(Group10Var2::Inst(), element.second);
+			break;
+		case apl::DataTypes::DT_SETPOINT_STATUS:
+			mPlanner.AddPoints(Group40Var1::Inst(), element.second);
+			break;
+		default:
+			break;
+		}
+	}
 }
 
-//TODO kept this code for Index based writing in future
-//void FreeFormPoll::WriteIndexed(const SizeByVariationObject* apObj, std::vector<uint32_t> element, APDU& arAPDU)
-//{
-	//Use Group30Var1* pObj = Group30Var1::Inst(); in calling method for analog points
-	/*IndexedWriteIterator i = arAPDU.WriteIndexed(apObj, element.size(), QC_1B_CNT_1B_INDEX);
-	for (int ind=0; ind<element.size(); i++) {
-		i.SetIndex(size_t(element.at(ind)));
-		++i;
-	}*/
-//}
-
+void FreeFormPoll::Init()
+{
+	std::lock_guard<std::mutex> guard{ffInputPoints_mutex_};
+	mFragment = 0;
+	mNumFragments = 0;
+	mPlanChanged = false;
+}
 
 void FreeFormPoll::ConfigureRequest(APDU& arAPDU)
 {
@@ -127,45 +150,27 @@ void FreeFormPoll::ConfigureRequest(APDU& arAPDU)
 	arAPDU.Set(FC_READ);
 	std::lock_guard<std::mutex> guard{ffInputPoints_mutex_};
 
-	if ((this->GetClassMask() & PC_CLASS_0) && ffInputPoints.size() > 0) {
-
-		for (std::pair<apl::DataTypes, std::vector<uint32_t>> element : ffInputPoints)
-		{
-			if (element.second.size() <= 0)
-				continue; //should not come here
-			if (element.first == apl::DataTypes::DT_ANALOG) {
-				for (int ind=0; ind<element.second.size(); ++ind) {
-					size_t index = element.second.at(ind);
-					ObjectWriteIterator i = arAPDU.WriteContiguous(Group30Var1::Inst(), index, index, QC_1B_START_STOP );
-				}
-			}
-			if (element.first == apl::DataTypes::DT_BINARY) {
-				for (int ind=0; ind<element.second.size(); ++ind) {
-					size_t index = element.second.at(ind);
-					ObjectWriteIterator i = arAPDU.WriteContiguous(Group1Var2::Inst(), index, index, QC_1B_START_STOP );
-				}
-			}
-			if (element.first == apl::DataTypes::DT_COUNTER) {
-				for (int ind=0; ind<element.second.size(); ++ind) {
-					size_t index = element.second.at(ind);
-					ObjectWriteIterator i = arAPDU.WriteContiguous(Group20Var1::Inst(), index, index, QC_1B_START_STOP );
-				}
-			}
-			if (element.first == apl::DataTypes::DT_CONTROL_STATUS) {
-				for (int ind=0; ind<element.second.size(); ++ind) {
-					size_t index = element.second.at(ind);
-					ObjectWriteIterator i = arAPDU.WriteContiguous(Group10Var2::Inst(), index, index, QC_1B_START_STOP );
-				}
-			}
-			if (element.first == apl::DataTypes::DT_SETPOINT_STATUS) {
-				for (int ind=0; ind<element.second.size(); ++ind) {
-					size_t index = element.second.at(ind);
-					ObjectWriteIterator i = arAPDU.WriteContiguous(Group40Var1::Inst(), index, index, QC_1B_START_STOP );
-				}
-			}
+	if ((this->GetClassMask() & PC_CLASS_0) && !mPlanner.IsEmpty()) {
+		mNumFragments = mPlanner.NumFragments(arAPDU.MaxSize() - arAPDU.Size());
+		if (mFragment >= mNumFragments) mFragment = 0;
+		mPlanner.Write(arAPDU, mFragment);
+	}
+}
 
-		}
+TaskResult FreeFormPoll::_OnFinalResponse(const APDU& f)
+{
+	this->ReadData(f);
+
+	std::lock_guard<std::mutex> guard{ffInputPoints_mutex_};
+	if (mPlanChanged) {
+		mPlanChanged = false;
+		mFragment = 0;
+		return TR_CONTINUE;
 	}
+
+	// the points didn't fit in one request, ask for the next fragment
+	if (++mFragment < mNumFragments) return TR_CONTINUE;
+	return TR_SUCCESS;
 }
 
 }
@@ -20,6 +20,8 @@
 #define __DATA_POLL_H_
 
 #include <opendnp3/DNP3/MasterTaskBase.h>
+#include <opendnp3/DNP3/ReadRequestPlanner.h>
+#include <opendnp3/DNP3/ResponseLoader.h>
 #include <opendnp3/DNP3/VtoReader.h>
 #include <opendnp3/APL/Loggable.h>
 #include <unordered_map>
@@ -35,6 +37,8 @@ namespace apl
 namespace dnp
 {
 
+class StackStatistics;
+
 /**
  * Base class for all data acquistion polls
  */
@@ -44,10 +48,17 @@ public:
 
 	DataPoll(Logger*, IDataObserver*, VtoReader*);
 
-private:
+	// Counts the received events and records their age, NULL to stop counting
+	void SetStatistics(StackStatistics* apStats) {
+		mpStats = apStats;
+	}
+
+protected:
 
 	void ReadData(const APDU&);
 
+private:
+
 	//Implement MasterTaskBase
 	TaskResult _OnPartialResponse(const APDU&);
 	TaskResult _OnFinalResponse(const APDU&);
@@ -56,6 +67,10 @@ private:
 
 	VtoReader* mpVtoReader;
 
+	StackStatistics* mpStats;
+
+	ResponseBatches mBatches;
+
 };
 
 /** Task that acquires class data from the outstation
@@ -80,20 +95,34 @@ private:
 
 };
 
+/** Task that reads an arbitrary set of static points from the outstation
+
+	The points are coalesced into ranges by a ReadRequestPlanner. If they
+	don't fit in a single request the poll is issued as several requests,
+	one fragment at a time.
+*/
 class FreeFormPoll : public ClassPoll
 {
 public:
 
 	FreeFormPoll(Logger*, IDataObserver*, VtoReader*);
+	void Init();
 	void ConfigureRequest(APDU& arAPDU);
 	std::string Name() const {
 		return "Free-Form Poll";
 	}
-	void SetDataPoints(std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> pnts);
+	void SetDataPoints(const std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash>& pnts);
 
 private:
+
+	TaskResult _OnFinalResponse(const APDU&);
+
 	std::mutex ffInputPoints_mutex_;
-	std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> ffInputPoints;
+	ReadRequestPlanner mPlanner;
+
+	size_t mFragment;		// request fragment currently being read
+	size_t mNumFragments;	// number of request fragments in the current poll
+	bool mPlanChanged;		// the points were changed while the poll was in progress
 
 };
 
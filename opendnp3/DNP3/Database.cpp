@@ -46,36 +46,46 @@ void Database::Configure(DataTypes aType, size_t aNumPoints, bool aStartOnline)
 {
 	switch(aType) {
 	case(DT_BINARY):
-		this->mBinaryVec.resize(aNumPoints);
-		this->AssignIndices(mBinaryVec);
-		if ( aStartOnline )
-			this->SetAllOnline(mBinaryVec);
+		this->Configure(mBinaries, aNumPoints, aStartOnline);
 		break;
 	case(DT_ANALOG):
-		this->mAnalogVec.resize(aNumPoints);
-		this->AssignIndices(mAnalogVec);
-		if ( aStartOnline )
-			this->SetAllOnline(mAnalogVec);
+		this->Configure(mAnalogs, aNumPoints, aStartOnline);
 		break;
 	case(DT_COUNTER):
-		this->mCounterVec.resize(aNumPoints);
-		this->AssignIndices(mCounterVec);
-		if ( aStartOnline )
-			this->SetAllOnline(mCounterVec);
+		this->Configure(mCounters, aNumPoints, aStartOnline);
 		break;
 	case(DT_CONTROL_STATUS):
-		this->mControlStatusVec.resize(aNumPoints);
-		this->AssignIndices(mControlStatusVec);
-		if ( aStartOnline )
-			this->SetAllOnline(mControlStatusVec);
+		this->Configure(mControlStatii, aNumPoints, aStartOnline);
 		break;
 	case(DT_SETPOINT_STATUS):
-		this->mSetpointStatusVec.resize(aNumPoints);
-		this->AssignIndices(mSetpointStatusVec);
-		if ( aStartOnline )
-			this->SetAllOnline(mSetpointStatusVec);
+		this->Configure(mSetpointStatii, aNumPoints, aStartOnline);
 		break;
 	}
+
+	this->ReserveEventIndices(aType);
+}
+
+void Database::Configure(DataTypes aType, const std::vector<size_t>& arIndices, bool aStartOnline)
+{
+	switch(aType) {
+	case(DT_BINARY):
+		this->Configure(mBinaries, arIndices, aStartOnline);
+		break;
+	case(DT_ANALOG):
+		this->Configure(mAnalogs, arIndices, aStartOnline);
+		break;
+	case(DT_COUNTER):
+		this->Configure(mCounters, arIndices, aStartOnline);
+		break;
+	case(DT_CONTROL_STATUS):
+		this->Configure(mControlStatii, arIndices, aStartOnline);
+		break;
+	case(DT_SETPOINT_STATUS):
+		this->Configure(mSetpointStatii, arIndices, aStartOnline);
+		break;
+	}
+
+	this->ReserveEventIndices(aType);
 }
 
 void Database::Configure(const DeviceTemplate& arTmp)
@@ -87,24 +97,22 @@ void Database::Configure(const DeviceTemplate& arTmp)
 	size_t numSetpointStatus = arTmp.mSetpointStatus.size();
 
 	//configure the database for these objects
-	this->Configure(DT_BINARY, numBinary, arTmp.mStartOnline);
-	this->Configure(DT_ANALOG, numAnalog, arTmp.mStartOnline);
-	this->Configure(DT_COUNTER, numCounter, arTmp.mStartOnline);
-	this->Configure(DT_CONTROL_STATUS, numControlStatus, arTmp.mStartOnline);
-	this->Configure(DT_SETPOINT_STATUS, numSetpointStatus, arTmp.mStartOnline);
-
-	for(size_t i = 0; i < arTmp.mBinary.size(); ++i) {
-		this->SetClass(DT_BINARY, i, arTmp.mBinary[i].EventClass);
-	}
+	this->Configure(mBinaries, numBinary, arTmp.mBinaryIndices, arTmp.mStartOnline);
+	this->Configure(mAnalogs, numAnalog, arTmp.mAnalogIndices, arTmp.mStartOnline);
+	this->Configure(mCounters, numCounter, arTmp.mCounterIndices, arTmp.mStartOnline);
+	this->Configure(mControlStatii, numControlStatus, arTmp.mControlStatusIndices, arTmp.mStartOnline);
+	this->Configure(mSetpointStatii, numSetpointStatus, arTmp.mSetpointStatusIndices, arTmp.mStartOnline);
 
-	for(size_t i = 0; i < arTmp.mCounter.size(); ++i) {
-		this->SetClass(DT_COUNTER, i, arTmp.mCounter[i].EventClass);
-	}
+	this->ReserveEventIndices(DT_BINARY);
+	this->ReserveEventIndices(DT_ANALOG);
+	this->ReserveEventIndices(DT_COUNTER);
 
-	for(size_t i = 0; i < arTmp.mAnalog.size(); ++i) {
-		this->SetClass(DT_ANALOG, i, arTmp.mAnalog[i].EventClass);
-		this->SetDeadband(DT_ANALOG, i, arTmp.mAnalog[i].Deadband);
-	}
+	// the stores were just sized to the template with one slot per record, so the records are copied without per point checks
+	this->ConfigureClasses(mBinaries, arTmp.mBinary);
+	this->ConfigureClasses(mCounters, arTmp.mCounter);
+	this->ConfigureClasses(mAnalogs, arTmp.mAnalog);
+
+	for(size_t i = 0; i < numAnalog; ++i) mAnalogs.SetDeadband(i, arTmp.mAnalog[i].Deadband);
 
 	/*for(size_t i=0; i<arTmp.mControlStatus.size(); ++i)
 	{ this->SetClass(DT_CONTROL_STATUS, i, arTmp.mControlStatus[i].EventClass); }
@@ -117,23 +125,22 @@ void Database::SetClass(DataTypes aType, PointClass aClass)
 {
 	switch(aType) {
 	case(DT_BINARY):
-		for(size_t i = 0; i < mBinaryVec.size(); ++i) mBinaryVec[i].mClass = aClass;
+		this->SetAllClasses(mBinaries, aClass);
 		break;
 	case(DT_ANALOG):
-		for(size_t i = 0; i < mAnalogVec.size(); ++i) mAnalogVec[i].mClass = aClass;
+		this->SetAllClasses(mAnalogs, aClass);
 		break;
 	case(DT_COUNTER):
-		for(size_t i = 0; i < mCounterVec.size(); ++i) mCounterVec[i].mClass = aClass;
+		this->SetAllClasses(mCounters, aClass);
 		break;
 	case(DT_CONTROL_STATUS):
-		for(size_t i = 0; i < mControlStatusVec.size(); ++i) mControlStatusVec[i].mClass = aClass;
+		this->SetAllClasses(mControlStatii, aClass);
 		break;
 	case(DT_SETPOINT_STATUS):
-		for(size_t i = 0; i < mSetpointStatusVec.size(); ++i) mSetpointStatusVec[i].mClass = aClass;
+		this->SetAllClasses(mSetpointStatii, aClass);
 		break;
 	default:
 		throw ArgumentException(LOCATION, "Class cannot be assigned for this type");
-		break;
 	}
 }
 
@@ -141,24 +148,19 @@ void Database::SetClass(apl::DataTypes aType, size_t aIndex, PointClass aClass)
 {
 	switch(aType) {
 	case(DT_BINARY):
-		if(aIndex >= mBinaryVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mBinaryVec[aIndex].mClass = aClass;
+		this->SetPointClass(mBinaries, aIndex, aClass);
 		break;
 	case(DT_ANALOG):
-		if(aIndex >= mAnalogVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mAnalogVec[aIndex].mClass = aClass;
+		this->SetPointClass(mAnalogs, aIndex, aClass);
 		break;
 	case(DT_COUNTER):
-		if(aIndex >= mCounterVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mCounterVec[aIndex].mClass = aClass;
+		this->SetPointClass(mCounters, aIndex, aClass);
 		break;
 	case(DT_CONTROL_STATUS):
-		if(aIndex >= mControlStatusVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mControlStatusVec[aIndex].mClass = aClass;
+		this->SetPointClass(mControlStatii, aIndex, aClass);
 		break;
 	case(DT_SETPOINT_STATUS):
-		if(aIndex >= mSetpointStatusVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mSetpointStatusVec[aIndex].mClass = aClass;
+		this->SetPointClass(mSetpointStatii, aIndex, aClass);
 		break;
 	default:
 		throw ArgumentException(LOCATION, "Class cannot be assigned for this type");
@@ -169,12 +171,10 @@ void Database::SetDeadband(apl::DataTypes aType, size_t aIndex, double aDeadband
 {
 	switch(aType) {
 	case(DT_ANALOG):
-		if(aIndex >= mAnalogVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mAnalogVec[aIndex].mDeadband = aDeadband;
+		mAnalogs.SetDeadband(SlotOf(mAnalogs, aIndex), aDeadband);
 		break;
 	case(DT_COUNTER):
-		if(aIndex >= mCounterVec.size()) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
-		mCounterVec[aIndex].mDeadband = aDeadband;
+		mCounters.SetDeadband(SlotOf(mCounters, aIndex), aDeadband);
 		break;
 	default:
 		throw ArgumentException(LOCATION, "Deadband cannot be assigned for this type");
@@ -186,6 +186,19 @@ void Database::SetEventBuffer(IEventBuffer* apEventBuffer)
 	assert(apEventBuffer != NULL);
 	assert(mpEventBuffer == NULL);
 	mpEventBuffer = apEventBuffer;
+
+	this->ReserveEventIndices(DT_BINARY);
+	this->ReserveEventIndices(DT_ANALOG);
+	this->ReserveEventIndices(DT_COUNTER);
+}
+
+void Database::ReserveEventIndices(DataTypes aType)
+{
+	// control and setpoint status never generate events
+	if(aType == DT_CONTROL_STATUS || aType == DT_SETPOINT_STATUS) return;
+
+	const PointIndexMap& indices = this->GetIndices(aType);
+	if(mpEventBuffer != NULL && indices.NumPoints() > 0) mpEventBuffer->ReserveIndices(aType, indices.MaxIndex() + 1);
 }
 
 ////////////////////////////////////////////////////
@@ -194,41 +207,74 @@ void Database::SetEventBuffer(IEventBuffer* apEventBuffer)
 
 void Database::_Update(const apl::Binary& arPoint, size_t aIndex)
 {
-	if(UpdateValue<apl::Binary>(mBinaryVec, arPoint, aIndex)) {
+	size_t slot;
+	if(UpdateValue<apl::Binary>(mBinaries, arPoint, aIndex, slot)) {
 		LOG_BLOCK(LEV_DEBUG, "Binary Change: " << arPoint.ToString() << " Index: " << aIndex);
-		BinaryInfo& v = mBinaryVec[aIndex];
-		if(mpEventBuffer) mpEventBuffer->Update(v.mValue, v.mClass, aIndex);
+		if(mpEventBuffer) mpEventBuffer->Update(arPoint, mBinaries.GetClass(slot), aIndex);
 	}
 }
 
 void Database::_Update(const apl::Analog& arPoint, size_t aIndex)
 {
-	if(UpdateValue<apl::Analog>(mAnalogVec, arPoint, aIndex)) {
-		LOG_BLOCK(LEV_DEBUG, "Analog Change: " << arPoint.ToString() << " Index: " << aIndex);
-		mAnalogVec[aIndex].mLastEventValue = mAnalogVec[aIndex].mValue.GetValue();
-		AnalogInfo& v = mAnalogVec[aIndex];
-		if(mpEventBuffer) mpEventBuffer->Update(v.mValue, v.mClass, aIndex);
-	}
+	size_t slot;
+	if(UpdateValue<apl::Analog>(mAnalogs, arPoint, aIndex, slot)) this->ReportChange(arPoint, slot, aIndex);
 }
 
 void Database::_Update(const apl::Counter& arPoint, size_t aIndex)
 {
-	if(UpdateValue<apl::Counter>(mCounterVec, arPoint, aIndex)) {
-		LOG_BLOCK(LEV_DEBUG, "Counter Change: " << arPoint.ToString() << " Index: " << aIndex);
-		mCounterVec[aIndex].mLastEventValue = mCounterVec[aIndex].mValue.GetValue();
-		CounterInfo& v = mCounterVec[aIndex];
-		if(mpEventBuffer) mpEventBuffer->Update(v.mValue, v.mClass, aIndex);
-	}
+	size_t slot;
+	if(UpdateValue<apl::Counter>(mCounters, arPoint, aIndex, slot)) this->ReportChange(arPoint, slot, aIndex);
+}
+
+void Database::ReportChange(const apl::Analog& arPoint, size_t aSlot, size_t aIndex)
+{
+	LOG_BLOCK(LEV_DEBUG, "Analog Change: " << arPoint.ToString() << " Index: " << aIndex);
+	mAnalogs.SetReported(aSlot);
+	if(mpEventBuffer) mpEventBuffer->Update(arPoint, mAnalogs.GetClass(aSlot), aIndex);
+}
+
+void Database::ReportChange(const apl::Counter& arPoint, size_t aSlot, size_t aIndex)
+{
+	LOG_BLOCK(LEV_DEBUG, "Counter Change: " << arPoint.ToString() << " Index: " << aIndex);
+	mCounters.SetReported(aSlot);
+	if(mpEventBuffer) mpEventBuffer->Update(arPoint, mCounters.GetClass(aSlot), aIndex);
 }
 
 void Database::_Update(const apl::ControlStatus& arPoint, size_t aIndex)
 {
-	UpdateValue<apl::ControlStatus>(mControlStatusVec, arPoint, aIndex);
+	size_t slot;
+	UpdateValue<apl::ControlStatus>(mControlStatii, arPoint, aIndex, slot);
 }
 
 void Database::_Update(const apl::SetpointStatus& arPoint, size_t aIndex)
 {
-	UpdateValue<apl::SetpointStatus>(mSetpointStatusVec, arPoint, aIndex);
+	size_t slot;
+	UpdateValue<apl::SetpointStatus>(mSetpointStatii, arPoint, aIndex, slot);
+}
+
+void Database::_UpdateBatch(const apl::Binary* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	this->UpdateEach(apValues, apIndices, aCount);
+}
+
+void Database::_UpdateBatch(const apl::Analog* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	this->UpdateRuns(mAnalogs, apValues, apIndices, aCount);
+}
+
+void Database::_UpdateBatch(const apl::Counter* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	this->UpdateRuns(mCounters, apValues, apIndices, aCount);
+}
+
+void Database::_UpdateBatch(const apl::ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	this->UpdateEach(apValues, apIndices, aCount);
+}
+
+void Database::_UpdateBatch(const apl::SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	this->UpdateEach(apValues, apIndices, aCount);
 }
 
 ////////////////////////////////////////////////////
@@ -237,24 +283,42 @@ void Database::_Update(const apl::SetpointStatus& arPoint, size_t aIndex)
 
 size_t Database::MaxIndex(DataTypes aType)
 {
-	size_t num = NumType(aType);
-	if(num == 0) throw ArgumentException(LOCATION, "No points for datatype");
-	else return (num - 1);
+	const PointIndexMap& indices = this->GetIndices(aType);
+	if(indices.NumPoints() == 0) throw ArgumentException(LOCATION, "No points for datatype");
+	else return indices.MaxIndex();
+}
+
+const PointIndexMap& Database::GetIndices(DataTypes aType)
+{
+	switch(aType) {
+	case(DT_BINARY):
+		return mBinaries.Indices();
+	case(DT_ANALOG):
+		return mAnalogs.Indices();
+	case(DT_COUNTER):
+		return mCounters.Indices();
+	case(DT_CONTROL_STATUS):
+		return mControlStatii.Indices();
+	case(DT_SETPOINT_STATUS):
+		return mSetpointStatii.Indices();
+	}
+
+	throw ArgumentException(LOCATION, "Unknown datatype");
 }
 
 size_t Database::NumType(DataTypes aType)
 {
 	switch(aType) {
 	case(DT_BINARY):
-		return mBinaryVec.size();
+		return mBinaries.Size();
 	case(DT_ANALOG):
-		return mAnalogVec.size();
+		return mAnalogs.Size();
 	case(DT_COUNTER):
-		return mCounterVec.size();
+		return mCounters.Size();
 	case(DT_CONTROL_STATUS):
-		return mControlStatusVec.size();
+		return mControlStatii.Size();
 	case(DT_SETPOINT_STATUS):
-		return mSetpointStatusVec.size();
+		return mSetpointStatii.Size();
 	}
 
 	return 0;
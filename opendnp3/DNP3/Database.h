@@ -24,7 +24,10 @@
 #include <opendnp3/APL/Loggable.h>
 #include <opendnp3/DNP3/DNPConstants.h>
 #include <opendnp3/DNP3/DatabaseInterfaces.h>
+#include <opendnp3/DNP3/StaticEncodingCache.h>
+#include <opendnp3/DNP3/StaticPointStore.h>
 
+#include <assert.h>
 #include <iostream>
 #include <limits>
 #include <set>
@@ -65,8 +68,19 @@ public:
 	void Configure(const DeviceTemplate& arTmp);
 	void Configure(apl::DataTypes aType, size_t aNumPoints, bool aStartOnline = false);
 
+	/**
+	 * Configures a type with only the listed indices. Storage, integrity responses
+	 * and lookups scale with the number of points rather than the highest index.
+	 * @throw ArgumentException if the indices aren't strictly ascending
+	 */
+	void Configure(apl::DataTypes aType, const std::vector<size_t>& arIndices, bool aStartOnline = false);
+
+	// @return the number of configured points of a type
 	size_t NumType(apl::DataTypes aType);
+	// @return the highest configured index of a type
 	size_t MaxIndex(DataTypes aType);
+	// @return the layout of the indices of a type
+	const PointIndexMap& GetIndices(DataTypes aType);
 	void SetDeadband(apl::DataTypes, size_t aIndex, double aDeadband);
 	void SetClass(apl::DataTypes aType, size_t aIndex, PointClass aClass);
 	void SetClass(apl::DataTypes aType, PointClass aClass); //set classes for all indices
@@ -76,19 +90,70 @@ public:
 	/* Functions for obtaining iterators */
 
 	void Begin(BinaryIterator& arIter)		{
-		arIter = mBinaryVec.begin();
+		arIter = mBinaries.Begin();
 	}
 	void Begin(AnalogIterator& arIter)		{
-		arIter = mAnalogVec.begin();
+		arIter = mAnalogs.Begin();
 	}
 	void Begin(CounterIterator& arIter)		{
-		arIter = mCounterVec.begin();
+		arIter = mCounters.Begin();
 	}
 	void Begin(ControlIterator& arIter)		{
-		arIter = mControlStatusVec.begin();
+		arIter = mControlStatii.Begin();
 	}
 	void Begin(SetpointIterator& arIter)	{
-		arIter = mSetpointStatusVec.begin();
+		arIter = mSetpointStatii.Begin();
+	}
+
+	/* Functions for reading the raw static values */
+
+	void GetStore(const StaticPointStore<apl::Binary>*& arpStore) const		{
+		arpStore = &mBinaries;
+	}
+	void GetStore(const StaticPointStore<apl::Analog>*& arpStore) const		{
+		arpStore = &mAnalogs;
+	}
+	void GetStore(const StaticPointStore<apl::Counter>*& arpStore) const		{
+		arpStore = &mCounters;
+	}
+	void GetStore(const StaticPointStore<apl::ControlStatus>*& arpStore) const	{
+		arpStore = &mControlStatii;
+	}
+	void GetStore(const StaticPointStore<apl::SetpointStatus>*& arpStore) const	{
+		arpStore = &mSetpointStatii;
+	}
+
+	/* Functions for writing static responses */
+
+	/**
+	 * Writes the encoding of aCount points starting at slot aStart with apObj
+	 * to apPos. Encodings are cached and only the blocks of points that changed
+	 * since the last write are re-encoded. The points must be part of a single
+	 * run of the type's PointIndexMap to be contiguous in the response.
+	 */
+	void WriteStatic(const StreamObject<apl::Binary>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos) {
+		mBinaryCache.Write(mBinaries, apObj, aStart, aCount, apPos);
+	}
+	void WriteStatic(const StreamObject<apl::Analog>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos) {
+		mAnalogCache.Write(mAnalogs, apObj, aStart, aCount, apPos);
+	}
+	void WriteStatic(const StreamObject<apl::Counter>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos) {
+		mCounterCache.Write(mCounters, apObj, aStart, aCount, apPos);
+	}
+	void WriteStatic(const StreamObject<apl::ControlStatus>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos) {
+		mControlStatusCache.Write(mControlStatii, apObj, aStart, aCount, apPos);
+	}
+	void WriteStatic(const StreamObject<apl::SetpointStatus>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos) {
+		mSetpointStatusCache.Write(mSetpointStatii, apObj, aStart, aCount, apPos);
+	}
+
+	/// Packs the states of aCount binaries starting at slot aStart into the zeroed bitfield at apPos
+	void WriteStaticBits(size_t aStart, size_t aCount, boost::uint8_t* apPos) const {
+		// the state of a binary is kept as a bit of its quality
+		const boost::uint8_t* pQualities = mBinaries.Qualities() + aStart;
+		for(size_t i = 0; i < aCount; ++i) {
+			if(pQualities[i] & BQ_STATE) BitfieldObject::StaticWrite(apPos, 0, i, true);
+		}
 	}
 
 
@@ -105,27 +170,74 @@ private:
 	void _Update(const apl::ControlStatus& arPoint, size_t);
 	void _Update(const apl::SetpointStatus& arPoint, size_t);
 
+	// batches are applied without dispatching each point through the vtable
+	void _UpdateBatch(const apl::Binary* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const apl::Analog* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const apl::Counter* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const apl::ControlStatus* apValues, const boost::uint32_t* apIndices, size_t aCount);
+	void _UpdateBatch(const apl::SetpointStatus* apValues, const boost::uint32_t* apIndices, size_t aCount);
+
+	template<typename T>
+	void UpdateEach(const T* apValues, const boost::uint32_t* apIndices, size_t aCount);
+
+	// the most consecutive points whose deadbands are checked in one pass
+	static const size_t DEADBAND_RUN = 64;
+
+	/*
+	 * Splits a batch into runs of consecutive indices, which are in
+	 * consecutive slots, and checks the deadbands of each run in one pass
+	 * with StaticPointStore::CheckDeadbands before storing the values.
+	 */
+	template<typename T>
+	void UpdateRuns(StaticPointStore<T>& arStore, const T* apValues, const boost::uint32_t* apIndices, size_t aCount);
+
+	// forwards a change that should be reported to the event buffer
+	void ReportChange(const apl::Analog& arPoint, size_t aSlot, size_t aIndex);
+	void ReportChange(const apl::Counter& arPoint, size_t aSlot, size_t aIndex);
+
+	// sizes the event buffer for the indices of a type that generates events
+	void ReserveEventIndices(apl::DataTypes aType);
+
 	template<typename T>
-	void AssignIndices( std::vector< PointInfo<T> >& arVector );
+	void Configure(StaticPointStore<T>& arStore, size_t aNumPoints, bool aStartOnline);
 
 	template<typename T>
-	void SetAllOnline( std::vector< PointInfo<T> >& arVector );
+	void Configure(StaticPointStore<T>& arStore, const std::vector<size_t>& arIndices, bool aStartOnline);
 
 	template<typename T>
-	bool UpdateValue(std::vector< PointInfo<T> >& arVec, const T& arValue, size_t aIndex);
+	void Configure(StaticPointStore<T>& arStore, size_t aNumPoints, const std::vector<size_t>& arIndices, bool aStartOnline);
 
+	// @return the slot of the point through arSlot
 	template<typename T>
-	void PerformRead(std::vector< PointInfo<T> >& arVec, T& arValue, size_t aIndex);
+	bool UpdateValue(StaticPointStore<T>& arStore, const T& arValue, size_t aIndex, size_t& arSlot);
+
+	template<typename T>
+	void SetPointClass(StaticPointStore<T>& arStore, size_t aIndex, PointClass aClass);
+
+	template<typename T>
+	void SetAllClasses(StaticPointStore<T>& arStore, PointClass aClass);
+
+	template<typename T>
+	static size_t SlotOf(const StaticPointStore<T>& arStore, size_t aIndex);
+
+	template<typename T, typename Record>
+	void ConfigureClasses(StaticPointStore<T>& arStore, const std::vector<Record>& arRecords);
 
 	/////////////////////////////////////////
 	//	Static data
 	/////////////////////////////////////////
 
-	std::vector< PointInfo<apl::Binary> > mBinaryVec;
-	std::vector< PointInfo<apl::Analog> > mAnalogVec;
-	std::vector< PointInfo<apl::Counter> > mCounterVec;
-	std::vector< PointInfo<apl::ControlStatus> > mControlStatusVec;
-	std::vector< PointInfo<apl::SetpointStatus> > mSetpointStatusVec;
+	StaticPointStore<apl::Binary> mBinaries;
+	StaticPointStore<apl::Analog> mAnalogs;
+	StaticPointStore<apl::Counter> mCounters;
+	StaticPointStore<apl::ControlStatus> mControlStatii;
+	StaticPointStore<apl::SetpointStatus> mSetpointStatii;
+
+	StaticEncodingCache<apl::Binary> mBinaryCache;
+	StaticEncodingCache<apl::Analog> mAnalogCache;
+	StaticEncodingCache<apl::Counter> mCounterCache;
+	StaticEncodingCache<apl::ControlStatus> mControlStatusCache;
+	StaticEncodingCache<apl::SetpointStatus> mSetpointStatusCache;
 
 	IEventBuffer* mpEventBuffer;
 
@@ -146,38 +258,93 @@ size_t Database::CalcNumType(const std::vector<T*>& arIdxVec)
 }
 
 template<typename T>
-inline void Database::SetAllOnline( std::vector< PointInfo<T> >& arVector )
+void Database::Configure(StaticPointStore<T>& arStore, size_t aNumPoints, bool aStartOnline)
 {
-	for(size_t i = 0; i < arVector.size(); i++) {
-		arVector[i].mValue.SetQuality(T::ONLINE);
-	}
+	arStore.Resize(aNumPoints);
+	if(aStartOnline) arStore.SetAllQuality(T::ONLINE);
 }
 
 template<typename T>
-inline void Database::AssignIndices( std::vector< PointInfo<T> >& arVector )
+void Database::Configure(StaticPointStore<T>& arStore, const std::vector<size_t>& arIndices, bool aStartOnline)
 {
-	for(size_t i = 0; i < arVector.size(); i++) {
-		arVector[i].mIndex = i;
-	}
+	arStore.Configure(arIndices);
+	if(aStartOnline) arStore.SetAllQuality(T::ONLINE);
 }
 
 template<typename T>
-bool Database::UpdateValue(std::vector< PointInfo<T> >& arVec, const T& arValue, size_t aIndex)
+void Database::Configure(StaticPointStore<T>& arStore, size_t aNumPoints, const std::vector<size_t>& arIndices, bool aStartOnline)
 {
-	if(aIndex >= arVec.size()) throw apl::IndexOutOfBoundsException(LOCATION);
+	if(arIndices.empty()) this->Configure(arStore, aNumPoints, aStartOnline);
+	else if(arIndices.size() != aNumPoints) throw ArgumentException(LOCATION, "Template must list one index per point");
+	else this->Configure(arStore, arIndices, aStartOnline);
+}
 
-	T& value = arVec[aIndex].mValue;
+template<typename T>
+void Database::UpdateEach(const T* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	for(size_t i = 0; i < aCount; ++i) this->Database::_Update(apValues[i], apIndices[i]);
+}
 
-	if(value.ShouldGenerateEvent(arValue, arVec[aIndex].mDeadband, arVec[aIndex].mLastEventValue)) {
-		value = arValue;
-		return ((arVec[aIndex].mClass & PC_ALL_EVENTS) != 0);
-	}
-	else {
-		value = arValue;
-		return false;
+template<typename T>
+void Database::UpdateRuns(StaticPointStore<T>& arStore, const T* apValues, const boost::uint32_t* apIndices, size_t aCount)
+{
+	typename StaticPointStore<T>::ValueType values[DEADBAND_RUN];
+	boost::uint8_t exceeds[DEADBAND_RUN];
+
+	size_t i = 0;
+	while(i < aCount) {
+		size_t start;
+		if(!arStore.FindSlot(apIndices[i], start)) throw apl::IndexOutOfBoundsException(LOCATION);
+
+		size_t num = 1;
+		size_t slot;
+		while(num < DEADBAND_RUN && (i + num) < aCount && apIndices[i + num] == apIndices[i] + num && arStore.FindSlot(apIndices[i + num], slot)) ++num;
+
+		for(size_t j = 0; j < num; ++j) values[j] = apValues[i + j].GetValue();
+		arStore.CheckDeadbands(start, values, num, exceeds);
+
+		for(size_t j = 0; j < num; ++j) {
+			if(arStore.Update(apValues[i + j], start + j, exceeds[j] != 0)) this->ReportChange(apValues[i + j], start + j, apIndices[i + j]);
+		}
+
+		i += num;
 	}
 }
 
+template<typename T>
+bool Database::UpdateValue(StaticPointStore<T>& arStore, const T& arValue, size_t aIndex, size_t& arSlot)
+{
+	if(!arStore.FindSlot(aIndex, arSlot)) throw apl::IndexOutOfBoundsException(LOCATION);
+	return arStore.Update(arValue, arSlot);
+}
+
+template<typename T>
+void Database::SetPointClass(StaticPointStore<T>& arStore, size_t aIndex, PointClass aClass)
+{
+	arStore.SetClass(SlotOf(arStore, aIndex), aClass);
+}
+
+template<typename T>
+void Database::SetAllClasses(StaticPointStore<T>& arStore, PointClass aClass)
+{
+	for(size_t i = 0; i < arStore.Size(); ++i) arStore.SetClass(i, aClass);
+}
+
+template<typename T>
+size_t Database::SlotOf(const StaticPointStore<T>& arStore, size_t aIndex)
+{
+	size_t slot;
+	if(!arStore.FindSlot(aIndex, slot)) throw Exception(LOCATION, "", ERR_INDEX_OUT_OF_BOUNDS);
+	return slot;
+}
+
+template<typename T, typename Record>
+void Database::ConfigureClasses(StaticPointStore<T>& arStore, const std::vector<Record>& arRecords)
+{
+	assert(arRecords.size() <= arStore.Size());
+	for(size_t i = 0; i < arRecords.size(); ++i) arStore.SetClass(i, arRecords[i].EventClass);
+}
+
 }
 }
 
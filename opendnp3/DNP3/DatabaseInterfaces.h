@@ -45,6 +45,15 @@ public:
 
 	virtual size_t NumVtoEventsAvailable() = 0;
 
+	/**
+	 * Called when the database configures a type, so that event storage
+	 * keyed by index can be sized before any events arrive.
+	 *
+	 * @param aType			the type that was configured
+	 * @param aNumIndices	one more than the highest index of the type
+	 */
+	virtual void ReserveIndices(apl::DataTypes aType, size_t aNumIndices) = 0;
+
 };
 
 }
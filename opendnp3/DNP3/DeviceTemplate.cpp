@@ -41,14 +41,30 @@ DeviceTemplate::DeviceTemplate(size_t aNumBinary,
 	this->mSetpoints.resize(aNumSetpoints); this->InitNames("Setpoint", mSetpoints);
 }
 
+void DeviceTemplate::AssignIndexedName(std::string& arDest, const std::string& arPrefix, size_t aIndex)
+{
+	char digits[24];
+	char* pEnd = digits + sizeof(digits);
+	char* pBegin = pEnd;
+	do {
+		*--pBegin = static_cast<char>('0' + aIndex % 10);
+		aIndex /= 10;
+	}
+	while(aIndex > 0);
+
+	arDest.reserve(arPrefix.size() + (pEnd - pBegin));
+	arDest.assign(arPrefix);
+	arDest.append(pBegin, pEnd);
+}
+
 void DeviceTemplate::Publish(IDataObserver* apObs)
 {
 	Transaction tr(apObs);
-	InitObserver<Binary>(apObs, mBinary.size());
-	InitObserver<Analog>(apObs, mAnalog.size());
-	InitObserver<Counter>(apObs, mCounter.size());
-	InitObserver<ControlStatus>(apObs, mControlStatus.size());
-	InitObserver<SetpointStatus>(apObs, mSetpointStatus.size());
+	InitObserver<Binary>(apObs, mBinary.size(), mBinaryIndices);
+	InitObserver<Analog>(apObs, mAnalog.size(), mAnalogIndices);
+	InitObserver<Counter>(apObs, mCounter.size(), mCounterIndices);
+	InitObserver<ControlStatus>(apObs, mControlStatus.size(), mControlStatusIndices);
+	InitObserver<SetpointStatus>(apObs, mSetpointStatus.size(), mSetpointStatusIndices);
 }
 
 }
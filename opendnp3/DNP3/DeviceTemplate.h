@@ -35,7 +35,9 @@ namespace dnp
 	2) how controls are handled
 
 	The indices of the points are implicit based on their
-	position within the vectors below.
+	position within the vectors below, unless the indices of a
+	measurement type are listed explicitly for a device whose
+	points are not numbered 0 to N-1.
 */
 struct DeviceTemplate {
 	DeviceTemplate(size_t aNumBinary = 0,
@@ -57,6 +59,14 @@ struct DeviceTemplate {
 	std::vector<ControlRecord> mControls;		// list of binary output properties
 	std::vector<ControlRecord> mSetpoints;		// list of analog output properties
 
+	// Optional strictly ascending indices of the measurements, one per record above.
+	// Left empty, the records are numbered 0 to N-1.
+	std::vector<size_t> mBinaryIndices;
+	std::vector<size_t> mCounterIndices;
+	std::vector<size_t> mAnalogIndices;
+	std::vector<size_t> mControlStatusIndices;
+	std::vector<size_t> mSetpointStatusIndices;
+
 	bool mStartOnline;
 
 
@@ -66,23 +76,22 @@ struct DeviceTemplate {
 private:
 
 	template <class T>
-	static void InitObserver(IDataObserver* apObs, size_t aNum) {
+	static void InitObserver(IDataObserver* apObs, size_t aNum, const std::vector<size_t>& arIndices) {
 		for(size_t i = 0; i < aNum; ++i) {
 			T val;
-			apObs->Update(val, i);
+			apObs->Update(val, arIndices.empty() ? i : arIndices[i]);
 		}
 	}
 
 	// Helper function for setting up default names
 	template <class T>
 	void InitNames(const std::string& arName, std::vector<T>& arVec) {
-		for(size_t i = 0; i < arVec.size(); ++i) {
-			std::ostringstream oss;
-			oss << arName << i;
-			arVec[i].Name = oss.str();
-		}
+		for(size_t i = 0; i < arVec.size(); ++i) AssignIndexedName(arVec[i].Name, arName, i);
 	}
 
+	// Sets arDest to arPrefix followed by aIndex in decimal, cheaper than a stream for large templates
+	static void AssignIndexedName(std::string& arDest, const std::string& arPrefix, size_t aIndex);
+
 };
 
 }
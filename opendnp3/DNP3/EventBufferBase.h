@@ -20,6 +20,7 @@
 #define __EVENT_BUFFER_BASE_H_
 
 #include <opendnp3/DNP3/ClassCounter.h>
+#include <opendnp3/DNP3/EventStore.h>
 #include <opendnp3/DNP3/EventTypes.h>
 
 namespace apl
@@ -143,6 +144,14 @@ public:
 		return M_MAX_EVENTS - this->Size();
 	}
 
+	/**
+	 * @return the number of events the store can hold before it has to
+	 * allocate
+	 */
+	size_t Capacity() {
+		return mEventSet.Capacity();
+	}
+
 	/**
 	 * Returns a flag to indicate whether the buffer has been overflown.
 	 *
@@ -201,7 +210,11 @@ EventBufferBase <EventType, SetType> :: EventBufferBase(size_t aMaxEvents) :
 	M_MAX_EVENTS(aMaxEvents),
 	mSequence(0),
 	mIsOverflown(false)
-{}
+{
+	// Update inserts before dropping the oldest event on overflow, hence the extra slot
+	ReserveEvents(mEventSet, aMaxEvents + 1);
+	mSelectedEvents.reserve(aMaxEvents);
+}
 
 template <class EventType, class SetType>
 void EventBufferBase<EventType, SetType> :: Update(const typename EventType::MeasType& arVal, PointClass aClass, size_t aIndex)
@@ -44,6 +44,15 @@ public:
 
 	SingleEventBuffer(size_t aMaxEvents);
 
+	/// Sizes the index lookup so that events for indices below aNumIndices never allocate
+	void ReserveIndices(size_t aNumIndices) {
+		this->mEventSet.ReserveIndices(aNumIndices);
+	}
+
+	size_t IndexCapacity() {
+		return this->mEventSet.IndexCapacity();
+	}
+
 	void _Update(const EventType& arEvent);
 };
 
@@ -87,8 +96,7 @@ void SingleEventBuffer<EventType> :: _Update(const EventType& arEvent)
 
 	if(i != this->mEventSet.end() ) {
 		if(arEvent.mValue.GetTime() >= i->mValue.GetTime()) {
-			this->mEventSet.erase(i);
-			this->mEventSet.insert(arEvent); //new event
+			this->mEventSet.replace(i, arEvent); //same index, so the order is unchanged
 		}
 	}
 	else {
@@ -0,0 +1,365 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __EVENT_STORE_H_
+#define __EVENT_STORE_H_
+
+#include <opendnp3/DNP3/IndexBitmap.h>
+
+#include <boost/cstdint.hpp>
+
+#include <assert.h>
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+ * Ordered container for buffered events that replaces the node based
+ * std::set / std::multiset used by the event buffers.
+ *
+ * Events live in a contiguous slab of nodes that are linked into an
+ * intrusive doubly linked list in Order. Unused nodes sit on a free list, so
+ * once the slab has been reserved inserting and erasing never allocate.
+ *
+ * Inserts are placed after any equivalent elements, like std::multiset. The
+ * position is found by walking back from the tail, which is O(1) for events
+ * that arrive in order, or forward from the previous insert, which makes
+ * re-inserting an ascending run of events (EventBufferBase::Deselect) linear
+ * in the size of the store instead of quadratic.
+ *
+ * Iterators remain valid until the element they refer to is erased.
+ */
+template <class T, class Order>
+class OrderedEventStore
+{
+protected:
+
+	typedef boost::uint32_t slot_t;
+	static const slot_t NIL = 0xFFFFFFFF;
+
+private:
+
+	struct Node {
+		T mValue;
+		slot_t mPrev;
+		slot_t mNext;
+	};
+
+public:
+
+	class iterator
+	{
+		friend class OrderedEventStore<T, Order>;
+
+	public:
+		iterator() : mpStore(NULL), mSlot(NIL) {}
+
+		const T& operator*() const {
+			return mpStore->mNodes[mSlot].mValue;
+		}
+		const T* operator->() const {
+			return &mpStore->mNodes[mSlot].mValue;
+		}
+		iterator& operator++() {
+			mSlot = mpStore->mNodes[mSlot].mNext;
+			return *this;
+		}
+		iterator operator++(int) {
+			iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+		bool operator==(const iterator& arRHS) const {
+			return mSlot == arRHS.mSlot;
+		}
+		bool operator!=(const iterator& arRHS) const {
+			return mSlot != arRHS.mSlot;
+		}
+
+	private:
+		iterator(const OrderedEventStore<T, Order>* apStore, slot_t aSlot) : mpStore(apStore), mSlot(aSlot) {}
+
+		const OrderedEventStore<T, Order>* mpStore;
+		slot_t mSlot;
+	};
+
+	typedef iterator const_iterator;
+
+	OrderedEventStore() : mHead(NIL), mTail(NIL), mFree(NIL), mHint(NIL), mSize(0)
+	{}
+
+	/// Grows the slab so that aCapacity elements can be stored without allocating
+	void Reserve(size_t aCapacity);
+
+	size_t Capacity() const {
+		return mNodes.size();
+	}
+
+	size_t size() const {
+		return mSize;
+	}
+
+	bool empty() const {
+		return mSize == 0;
+	}
+
+	iterator begin() const {
+		return iterator(this, mHead);
+	}
+
+	iterator end() const {
+		return iterator(this, NIL);
+	}
+
+	iterator insert(const T& arValue);
+
+	void erase(iterator aItr);
+
+	/// Overwrites an element in place, the new value must not change its position in Order
+	void replace(iterator aItr, const T& arValue) {
+		mNodes[aItr.mSlot].mValue = arValue;
+	}
+
+	void clear();
+
+protected:
+
+	slot_t SlotOf(iterator aItr) const {
+		return aItr.mSlot;
+	}
+
+	iterator ItrOf(slot_t aSlot) const {
+		return iterator(this, aSlot);
+	}
+
+	/// Links a value in front of the element in aNext, NIL appends it
+	iterator InsertBefore(const T& arValue, slot_t aNext);
+
+private:
+
+	slot_t Allocate();
+	void LinkBefore(slot_t aSlot, slot_t aNext);
+
+	Order mOrder;
+	std::vector<Node> mNodes;
+	slot_t mHead;
+	slot_t mTail;
+	slot_t mFree;
+	slot_t mHint;
+	size_t mSize;
+};
+
+/**
+ * OrderedEventStore that additionally allows events to be looked up by index
+ * in O(1) through a flat index -> slot table. Used by SingleEventBuffer
+ * where at most one event per index can be buffered.
+ *
+ * Events arrive in any index order, so rather than walking the list an
+ * insert finds the next buffered index in a bitmap and links in front of it.
+ */
+template <class T, class Order>
+class IndexedEventStore : public OrderedEventStore<T, Order>
+{
+	typedef OrderedEventStore<T, Order> Base;
+	typedef typename Base::slot_t slot_t;
+	static const slot_t NIL = 0xFFFFFFFF;
+
+public:
+
+	typedef typename Base::iterator iterator;
+
+	/// Grows the index table so that indices below aNumIndices never cause an allocation
+	void ReserveIndices(size_t aNumIndices) {
+		if(aNumIndices > mIndexTable.size()) mIndexTable.resize(aNumIndices, static_cast<slot_t>(NIL));
+		mBuffered.Resize(aNumIndices);
+	}
+
+	size_t IndexCapacity() const {
+		return mIndexTable.size();
+	}
+
+	iterator find(const T& arValue) const {
+		if(arValue.mIndex >= mIndexTable.size()) return this->end();
+		return this->ItrOf(mIndexTable[arValue.mIndex]);
+	}
+
+	iterator insert(const T& arValue) {
+		// grow geometrically so that unseen indices are amortized O(1)
+		if(arValue.mIndex >= mIndexTable.size()) this->ReserveIndices(2 * arValue.mIndex + 1);
+		assert(mIndexTable[arValue.mIndex] == NIL);
+
+		size_t next = mBuffered.Next(arValue.mIndex + 1);
+		iterator i = this->InsertBefore(arValue, (next == IndexBitmap::NONE) ? NIL : mIndexTable[next]);
+		mIndexTable[arValue.mIndex] = this->SlotOf(i);
+		mBuffered.Set(arValue.mIndex);
+		return i;
+	}
+
+	void erase(iterator aItr) {
+		mIndexTable[aItr->mIndex] = NIL;
+		mBuffered.Clear(aItr->mIndex);
+		Base::erase(aItr);
+	}
+
+	void clear() {
+		for(iterator i = this->begin(); i != this->end(); ++i) {
+			mIndexTable[i->mIndex] = NIL;
+			mBuffered.Clear(i->mIndex);
+		}
+		Base::clear();
+	}
+
+private:
+
+	std::vector<slot_t> mIndexTable;
+	IndexBitmap mBuffered;		// the indices that currently have an event
+};
+
+/**
+ * Reserves space in an event container. Containers other than the event
+ * stores (e.g. std::set) allocate per element and ignore the call.
+ */
+template <class SetType>
+void ReserveEvents(SetType&, size_t)
+{}
+
+template <class T, class Order>
+void ReserveEvents(OrderedEventStore<T, Order>& arStore, size_t aCapacity)
+{
+	arStore.Reserve(aCapacity);
+}
+
+template <class T, class Order>
+void ReserveEvents(IndexedEventStore<T, Order>& arStore, size_t aCapacity)
+{
+	arStore.Reserve(aCapacity);
+}
+
+template <class T, class Order>
+void OrderedEventStore<T, Order> :: Reserve(size_t aCapacity)
+{
+	size_t old = mNodes.size();
+	if(aCapacity <= old) return;
+
+	assert(aCapacity < NIL);
+	mNodes.resize(aCapacity);
+
+	// push the new nodes onto the free list so that the lowest slots are used first
+	for(size_t i = aCapacity; i > old; --i) {
+		mNodes[i - 1].mNext = mFree;
+		mFree = static_cast<slot_t>(i - 1);
+	}
+}
+
+template <class T, class Order>
+typename OrderedEventStore<T, Order>::slot_t OrderedEventStore<T, Order> :: Allocate()
+{
+	// only reached if more events are returned to the store than were reserved
+	if(mFree == NIL) this->Reserve(mNodes.empty() ? 16 : 2 * mNodes.size());
+
+	slot_t slot = mFree;
+	mFree = mNodes[slot].mNext;
+	return slot;
+}
+
+template <class T, class Order>
+void OrderedEventStore<T, Order> :: LinkBefore(slot_t aSlot, slot_t aNext)
+{
+	Node& n = mNodes[aSlot];
+	n.mNext = aNext;
+	n.mPrev = (aNext == NIL) ? mTail : mNodes[aNext].mPrev;
+
+	if(n.mPrev == NIL) mHead = aSlot;
+	else mNodes[n.mPrev].mNext = aSlot;
+
+	if(aNext == NIL) mTail = aSlot;
+	else mNodes[aNext].mPrev = aSlot;
+}
+
+template <class T, class Order>
+typename OrderedEventStore<T, Order>::iterator OrderedEventStore<T, Order> :: insert(const T& arValue)
+{
+	slot_t next = NIL; // insert before this node, NIL == append
+
+	if(mTail != NIL && mOrder(arValue, mNodes[mTail].mValue)) {
+		if(mHint != NIL && !mOrder(arValue, mNodes[mHint].mValue)) {
+			// walk forward from the last insert to the first greater element
+			next = mNodes[mHint].mNext;
+			while(next != NIL && !mOrder(arValue, mNodes[next].mValue)) next = mNodes[next].mNext;
+		}
+		else {
+			// walk back from the tail to the last element that is not greater
+			next = mTail;
+			slot_t prev = mNodes[mTail].mPrev;
+			while(prev != NIL && mOrder(arValue, mNodes[prev].mValue)) {
+				next = prev;
+				prev = mNodes[prev].mPrev;
+			}
+		}
+	}
+
+	return this->InsertBefore(arValue, next);
+}
+
+template <class T, class Order>
+typename OrderedEventStore<T, Order>::iterator OrderedEventStore<T, Order> :: InsertBefore(const T& arValue, slot_t aNext)
+{
+	slot_t slot = this->Allocate();
+	mNodes[slot].mValue = arValue;
+
+	this->LinkBefore(slot, aNext);
+	mHint = slot;
+	++mSize;
+
+	return iterator(this, slot);
+}
+
+template <class T, class Order>
+void OrderedEventStore<T, Order> :: erase(iterator aItr)
+{
+	slot_t slot = aItr.mSlot;
+	Node& n = mNodes[slot];
+
+	if(n.mPrev == NIL) mHead = n.mNext;
+	else mNodes[n.mPrev].mNext = n.mNext;
+
+	if(n.mNext == NIL) mTail = n.mPrev;
+	else mNodes[n.mNext].mPrev = n.mPrev;
+
+	if(mHint == slot) mHint = NIL;
+
+	n.mValue = T(); // release any resources held by the value
+	n.mNext = mFree;
+	mFree = slot;
+	--mSize;
+}
+
+template <class T, class Order>
+void OrderedEventStore<T, Order> :: clear()
+{
+	while(mHead != NIL) this->erase(this->begin());
+}
+
+}
+} //end NS
+
+#endif
@@ -0,0 +1,128 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/IndexBitmap.h>
+
+#include <assert.h>
+
+namespace apl
+{
+namespace dnp
+{
+
+const size_t IndexBitmap::NONE = static_cast<size_t>(-1);
+
+static const boost::uint64_t ONE = 1;
+
+void IndexBitmap::Resize(size_t aSize)
+{
+	if(aSize <= mSize) return;
+
+	mSize = aSize;
+	if(mLevels.empty()) mLevels.resize(1);
+	mLevels[0].resize((aSize + 63) / 64, 0);
+	this->Rebuild();
+}
+
+void IndexBitmap::Rebuild()
+{
+	size_t num = 1;
+	for(size_t words = mLevels[0].size(); words > 1; words = (words + 63) / 64) ++num;
+	mLevels.resize(num);
+
+	// recompute the summary levels from the level below them
+	for(size_t level = 1; level < num; ++level) {
+		const std::vector<boost::uint64_t>& below = mLevels[level - 1];
+		std::vector<boost::uint64_t>& above = mLevels[level];
+		above.assign((below.size() + 63) / 64, 0);
+		for(size_t i = 0; i < below.size(); ++i) {
+			if(below[i] != 0) above[i / 64] |= ONE << (i % 64);
+		}
+	}
+}
+
+void IndexBitmap::Set(size_t aIndex)
+{
+	assert(aIndex < mSize);
+	for(size_t level = 0; level < mLevels.size(); ++level) {
+		mLevels[level][aIndex / 64] |= ONE << (aIndex % 64);
+		aIndex /= 64;
+	}
+}
+
+void IndexBitmap::Clear(size_t aIndex)
+{
+	assert(aIndex < mSize);
+	for(size_t level = 0; level < mLevels.size(); ++level) {
+		boost::uint64_t& word = mLevels[level][aIndex / 64];
+		word &= ~(ONE << (aIndex % 64));
+		if(word != 0) break; // the levels above still see a member in this word
+		aIndex /= 64;
+	}
+}
+
+size_t IndexBitmap::Next(size_t aIndex) const
+{
+	// climb until a word has a member at or above the position
+	size_t level = 0;
+	size_t pos = aIndex;
+	for(;;) {
+		if(level == mLevels.size()) return NONE;
+		size_t word = pos / 64;
+		if(word >= mLevels[level].size()) return NONE;
+		boost::uint64_t bits = mLevels[level][word] & (~static_cast<boost::uint64_t>(0) << (pos % 64));
+		if(bits != 0) {
+			pos = word * 64 + LowestBit(bits);
+			break;
+		}
+		pos = word + 1;
+		++level;
+	}
+
+	// then descend through the lowest member of each word
+	while(level > 0) {
+		--level;
+		pos = pos * 64 + LowestBit(mLevels[level][pos]);
+	}
+
+	return pos;
+}
+
+size_t IndexBitmap::LowestBit(boost::uint64_t aWord)
+{
+	// de Bruijn multiplication, isolating the lowest bit gives a unique top 6 bits
+	static const unsigned char POSITION[64] = {
+		0,  1, 48,  2, 57, 49, 28,  3,
+		61, 58, 50, 42, 38, 29, 17,  4,
+		62, 55, 59, 36, 53, 51, 43, 22,
+		45, 39, 33, 30, 24, 18, 12,  5,
+		63, 47, 56, 27, 60, 41, 37, 16,
+		54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10,
+		25, 14, 19,  9, 13,  8,  7,  6
+	};
+
+	assert(aWord != 0);
+	boost::uint64_t lowest = aWord & (~aWord + 1);
+	return POSITION[(lowest * 0x03f79d71b4cb0a89ULL) >> 58];
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
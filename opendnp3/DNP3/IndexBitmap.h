@@ -0,0 +1,78 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __INDEX_BITMAP_H_
+#define __INDEX_BITMAP_H_
+
+#include <boost/cstdint.hpp>
+
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+ * Set of indices below a fixed size kept as a hierarchy of 64 bit words,
+ * where every bit of a level records whether the matching word of the
+ * level below has any bits set. Adding, removing and finding the next
+ * member at or above an index each touch one word per level, so they are
+ * O(log64 n) and never allocate once the bitmap has been sized.
+ */
+class IndexBitmap
+{
+public:
+
+	static const size_t NONE;
+
+	IndexBitmap() : mSize(0) {}
+
+	/// Grows the bitmap to hold indices below aSize, existing members are kept
+	void Resize(size_t aSize);
+
+	size_t Size() const {
+		return mSize;
+	}
+
+	void Set(size_t aIndex);
+
+	void Clear(size_t aIndex);
+
+	/// @return the lowest member >= aIndex, or NONE
+	size_t Next(size_t aIndex) const;
+
+private:
+
+	static size_t LowestBit(boost::uint64_t aWord);
+
+	void Rebuild();
+
+	size_t mSize;
+
+	// mLevels[0] holds one bit per index, the last level is a single word
+	std::vector< std::vector<boost::uint64_t> > mLevels;
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
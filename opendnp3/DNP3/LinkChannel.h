@@ -22,6 +22,7 @@
 #include <opendnp3/APL/Lock.h>
 #include <opendnp3/DNP3/LinkLayerRouter.h>
 
+#include <map>
 #include <vector>
 
 namespace apl
@@ -64,6 +65,18 @@ public:
 		this->AddObserver(apObserver);
 	}
 
+	// reconnect policy and its state
+	using LinkLayerRouter::SetOpenBackoff;
+	using LinkLayerRouter::SetOpenLimiter;
+	using LinkLayerRouter::GetNumOpenRetries;
+	using LinkLayerRouter::GetOpenRetryDelay;
+	using LinkLayerRouter::GetNumCrcFailures;
+
+	// the router, for contexts that aren't stacks like the link scanner
+	LinkLayerRouter* GetRouter() {
+		return this;
+	}
+
 	AsyncTaskGroup* GetGroup() {
 		return mpTaskGroup;
 	}
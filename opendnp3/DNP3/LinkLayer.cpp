@@ -23,6 +23,7 @@
 #include <opendnp3/DNP3/LinkLayer.h>
 #include <opendnp3/DNP3/PriLinkLayerStates.h>
 #include <opendnp3/DNP3/SecLinkLayerStates.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
 #include <assert.h>
 #include <boost/bind.hpp>
@@ -45,6 +46,7 @@ LinkLayer::LinkLayer(apl::Logger* apLogger, ITimerSource* apTimerSrc, const Link
 	mNextWriteFCB(false),
 	mIsOnline(false),
 	mpRouter(NULL),
+	mpStats(NULL),
 	mpPriState(PLLS_SecNotReset::Inst()),
 	mpSecState(SLLS_NotReset::Inst())
 {}
@@ -65,7 +67,7 @@ void LinkLayer::ChangeState(SecStateBase* apState)
 	mpSecState = apState;
 }
 
-bool LinkLayer::Validate(bool aIsMaster, boost::uint16_t aSrc, boost::uint16_t aDest)
+bool LinkLayer::Validate(bool aIsMaster, boost::uint16_t aSrc, boost::uint16_t aDest, size_t aDataLength)
 {
 	if(!mIsOnline)
 		throw InvalidStateException(LOCATION, "LowerLayerDown");
@@ -87,6 +89,11 @@ bool LinkLayer::Validate(bool aIsMaster, boost::uint16_t aSrc, boost::uint16_t a
 		return false;
 	}
 
+	if(mpStats) {
+		mpStats->mFramesRx.Increment();
+		mpStats->mBytesRx.Increment(LinkFrame::CalcFrameSize(aDataLength));
+	}
+
 	return true;
 }
 
@@ -117,6 +124,10 @@ void LinkLayer::OnLowerLayerDown()
 
 void LinkLayer::Transmit(const LinkFrame& arFrame)
 {
+	if(mpStats) {
+		mpStats->mFramesTx.Increment();
+		mpStats->mBytesTx.Increment(arFrame.GetSize());
+	}
 	mpRouter->Transmit(arFrame);
 }
 
@@ -173,6 +184,7 @@ bool LinkLayer::Retry()
 {
 	if(mRetryRemaining > 0) {
 		--mRetryRemaining;
+		if(mpStats) mpStats->mLinkRetries.Increment();
 		return true;
 	}
 	else return false;
@@ -226,13 +238,13 @@ void LinkLayer::RequestLinkStatus(bool aIsMaster, boost::uint16_t aDest, boost::
 
 void LinkLayer::ConfirmedUserData(bool aIsMaster, bool aFcb, boost::uint16_t aDest, boost::uint16_t aSrc, const boost::uint8_t* apData, size_t aDataLength)
 {
-	if(this->Validate(aIsMaster, aSrc, aDest))
+	if(this->Validate(aIsMaster, aSrc, aDest, aDataLength))
 		mpSecState->ConfirmedUserData(this, aFcb, apData, aDataLength);
 }
 
 void LinkLayer::UnconfirmedUserData(bool aIsMaster, boost::uint16_t aDest, boost::uint16_t aSrc, const boost::uint8_t* apData, size_t aDataLength)
 {
-	if(this->Validate(aIsMaster, aSrc, aDest))
+	if(this->Validate(aIsMaster, aSrc, aDest, aDataLength))
 		mpSecState->UnconfirmedUserData(this, apData, aDataLength);
 }
 
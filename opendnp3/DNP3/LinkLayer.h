@@ -34,6 +34,7 @@ namespace dnp
 
 class ILinkRouter;
 class PriStateBase;
+class StackStatistics;
 class SecStateBase;
 
 //	@section desc Implements the contextual state of DNP3 Data Link Layer
@@ -45,6 +46,11 @@ public:
 
 	void SetRouter(ILinkRouter*);
 
+	// Counts frames, bytes and retries into a statistics block, NULL to stop counting
+	void SetStatistics(StackStatistics* apStats) {
+		mpStats = apStats;
+	}
+
 	// ILinkContext interface
 	void OnLowerLayerUp();
 	void OnLowerLayerDown();
@@ -139,7 +145,7 @@ private:
 	bool mNextWriteFCB;
 	bool mIsOnline;
 
-	bool Validate(bool aIsMaster, boost::uint16_t aSrc, boost::uint16_t aDest);
+	bool Validate(bool aIsMaster, boost::uint16_t aSrc, boost::uint16_t aDest, size_t aDataLength = 0);
 
 	/* Events - NVII delegates from ILayerDown and Events produced internally */
 	void _Send(const boost::uint8_t*, size_t);
@@ -149,6 +155,7 @@ private:
 	}
 
 	ILinkRouter* mpRouter;
+	StackStatistics* mpStats;
 	PriStateBase* mpPriState;
 	SecStateBase* mpSecState;
 };
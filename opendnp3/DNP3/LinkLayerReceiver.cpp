@@ -115,6 +115,7 @@ bool LinkLayerReceiver::ValidateBody()
 	if(LinkFrame::ValidateBodyCRC(mBuffer.ReadBuff() + LS_HEADER_SIZE, len)) return true;
 	else {
 		mCrcFailures.Increment();
+		mCrcCount.Increment();
 		ERROR_BLOCK(LEV_ERROR, "CRC failure in body", DLERR_CRC);
 		return false;
 	}
@@ -125,6 +126,7 @@ bool LinkLayerReceiver::ValidateHeader()
 	//first thing to do is check the CRC
 	if(!DNPCrc::IsCorrectCRC(mBuffer.ReadBuff(), LI_CRC)) {
 		mCrcFailures.Increment();
+		mCrcCount.Increment();
 		ERROR_BLOCK(LEV_ERROR, "CRC failure in header", DLERR_CRC);
 		return false;
 	}
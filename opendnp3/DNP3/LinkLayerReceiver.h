@@ -25,6 +25,7 @@
 #include <opendnp3/DNP3/DNPConstants.h>
 #include <opendnp3/DNP3/LinkFrame.h>
 #include <opendnp3/DNP3/LinkHeader.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
 namespace apl
 {
@@ -70,6 +71,11 @@ public:
 
 	//size_t NumReadBytes() const { return mBuffer.NumReadBytes(); }
 
+	/// Number of frames dropped for a bad CRC, safe to call from any thread
+	boost::uint64_t GetNumCrcFailures() const {
+		return mCrcCount.Get();
+	}
+
 
 private:
 
@@ -106,6 +112,7 @@ private:
 	boost::uint8_t mpUserData[LS_MAX_USER_DATA_SIZE];
 	ShiftableBuffer mBuffer; //Buffer used to cache frames data as it arrives
 	LogCounter mCrcFailures;
+	StatCounter mCrcCount;
 };
 
 }
@@ -18,13 +18,14 @@
 //
 #include <opendnp3/APL/Exception.h>
 #include <opendnp3/APL/IPhysicalLayerAsync.h>
+#include <opendnp3/APL/ITimerSource.h>
 #include <opendnp3/APL/Logger.h>
 #include <opendnp3/DNP3/ILinkContext.h>
 #include <opendnp3/DNP3/LinkFrame.h>
 #include <opendnp3/DNP3/LinkLayerRouter.h>
 
 #include <sstream>
-#include <boost/foreach.hpp>
+#include <boost/bind.hpp>
 
 using namespace std;
 
@@ -37,29 +38,29 @@ LinkLayerRouter::LinkLayerRouter(apl::Logger* apLogger, const std::string& arNam
 	Loggable(apLogger),
 	PhysicalLayerMonitor(apLogger, apPhys, apTimerSrc, aOpenRetry),
 	mName(arName),
+	mpUnknownRouteTimer(NULL),
+	mNumSuppressed(0),
 	mReceiver(apLogger, this),
 	mTransmitting(false)
-{}
+{
+	mWriteSegments.reserve(MAX_FRAMES_PER_WRITE);
+}
 
 void LinkLayerRouter::AddContext(ILinkContext* apContext, const LinkRoute& arRoute)
 {
 	assert(apContext != NULL);
 
-	if(mAddressMap.find(arRoute) != mAddressMap.end()) {
+	if(mRoutes.Find(arRoute) != NULL) {
 		ostringstream oss;
 		oss << "Route already in use: " << arRoute;
 		throw ArgumentException(LOCATION, oss.str());
 	}
 
-	BOOST_FOREACH(AddressMap::value_type v, mAddressMap) {
-		if(apContext == v.second) {
-			ostringstream oss;
-			oss << "Context already is bound to route:  " << v.first;
-			throw ArgumentException(LOCATION, oss.str());
-		}
+	if(!mContexts.insert(apContext).second) {
+		throw ArgumentException(LOCATION, "Context is already bound to a route");
 	}
 
-	mAddressMap[arRoute] = apContext;
+	mRoutes.Insert(arRoute, apContext);
 	if(this->GetState() == PLS_OPEN) apContext->OnLowerLayerUp();
 
 	this->Start();
@@ -67,48 +68,80 @@ void LinkLayerRouter::AddContext(ILinkContext* apContext, const LinkRoute& arRou
 
 void LinkLayerRouter::RemoveContext(const LinkRoute& arRoute)
 {
-	AddressMap::iterator i = mAddressMap.find(arRoute);
-	if(i == mAddressMap.end()) throw ArgumentException(LOCATION, "LinkRoute not bound: " + arRoute.ToString());
-	else {
+	ILinkContext* pContext = mRoutes.Erase(arRoute);
+	if(pContext == NULL) throw ArgumentException(LOCATION, "LinkRoute not bound: " + arRoute.ToString());
 
-		ILinkContext* pContext = i->second;
-		mAddressMap.erase(i);
+	mContexts.erase(pContext);
 
-		if(this->GetState() == PLS_OPEN) pContext->OnLowerLayerDown();
+	if(this->GetState() == PLS_OPEN) pContext->OnLowerLayerDown();
 
-		// if no stacks are bound, suspend the router
-		if(mAddressMap.size() == 0) {
-			this->Suspend();
-		}
+	// if no stacks are bound, suspend the router
+	if(mRoutes.Size() == 0) {
+		this->Suspend();
 	}
-
-
 }
 
-ILinkContext* LinkLayerRouter::GetContext(const LinkRoute& arRoute)
+bool LinkLayerRouter::GetRouteCounters(const LinkRoute& arRoute, RouteCounters& arCounters)
 {
-	AddressMap::iterator i = mAddressMap.find(arRoute);
-	return (i == mAddressMap.end()) ? NULL : i->second;
+	RouteTable::Entry* pEntry = mRoutes.Find(arRoute);
+	if(pEntry == NULL) return false;
+	arCounters = pEntry->mCounters;
+	return true;
 }
 
-
 ILinkContext* LinkLayerRouter::GetDestination(boost::uint16_t aDest, boost::uint16_t aSrc)
 {
 	LinkRoute route(aSrc, aDest);
 
-	ILinkContext* pDest = GetContext(route);
+	RouteTable::Entry* pEntry = mRoutes.Find(route);
+	if(pEntry == NULL) {
+		this->OnUnknownRoute(route);
+		return NULL;
+	}
+
+	++pEntry->mCounters.mNumRx;
+	return pEntry->mpContext;
+}
 
-	if(pDest == NULL && mpLogger->IsEnabled(LEV_WARNING)) {
+void LinkLayerRouter::OnUnknownRoute(const LinkRoute& arRoute)
+{
+	mUnknownRouteCount.Increment();
+	mLastUnknownRoute = arRoute;
+
+	// a noisy line can carry nothing but unknown routes, so only the first one in an interval is logged
+	if(mpUnknownRouteTimer != NULL) ++mNumSuppressed;
+	else {
+		mNumSuppressed = 1;
+		this->LogUnknownRoutes();
+		mpUnknownRouteTimer = this->GetTimerSource()->Start(UNKNOWN_ROUTE_LOG_INTERVAL, boost::bind(&LinkLayerRouter::OnUnknownRouteTimeout, this));
+	}
+}
+
+void LinkLayerRouter::OnUnknownRouteTimeout()
+{
+	mpUnknownRouteTimer = NULL;
+
+	// keep suppressing for another interval if anything arrived during this one
+	if(mNumSuppressed > 0) {
+		this->LogUnknownRoutes();
+		mpUnknownRouteTimer = this->GetTimerSource()->Start(UNKNOWN_ROUTE_LOG_INTERVAL, boost::bind(&LinkLayerRouter::OnUnknownRouteTimeout, this));
+	}
+}
+
+void LinkLayerRouter::LogUnknownRoutes()
+{
+	if(mpLogger->IsConsumed(LEV_WARNING, DLERR_UNKNOWN_ROUTE)) {
 		std::ostringstream oss;
-		oss << "Frame w/ unknown route: " << route;
+		oss << "Frame w/ unknown route: " << mLastUnknownRoute;
+		if(mNumSuppressed > 1) oss << " (" << mNumSuppressed << " frames w/ unknown routes since the last warning)";
 		LogEntry le(LEV_WARNING, mpLogger->GetName(), LOCATION, oss.str(), DLERR_UNKNOWN_ROUTE);
-		le.AddValue("SOURCE", aSrc);
-		le.AddValue("DESTINATION", aDest);
+		le.AddValue("SOURCE", mLastUnknownRoute.remote);
+		le.AddValue("DESTINATION", mLastUnknownRoute.local);
 		le.AddValue("PHYS_LAYER_NAME", mName);
+		le.AddValue("COUNT", static_cast<int>(mNumSuppressed));
 		mpLogger->Log(le);
 	}
-
-	return pDest;
+	mNumSuppressed = 0;
 }
 
 //////////////////////////////////////////////////////
@@ -174,11 +207,13 @@ void LinkLayerRouter::_OnReceive(const boost::uint8_t*, size_t aNumBytes)
 void LinkLayerRouter::Transmit(const LinkFrame& arFrame)
 {
 	LinkRoute lr(arFrame.GetDest(), arFrame.GetSrc());
+	RouteTable::Entry* pEntry = mRoutes.Find(lr);
 
-	if (this->GetContext(lr)) {
+	if (pEntry) {
 		if (!this->IsLowerLayerUp()) {
 			throw InvalidStateException(LOCATION, "LowerLayerDown");
 		}
+		++pEntry->mCounters.mNumTx;
 		this->mTransmitQueue.push_back(arFrame);
 		this->CheckForSend();
 	}
@@ -191,20 +226,19 @@ void LinkLayerRouter::Transmit(const LinkFrame& arFrame)
 
 void LinkLayerRouter::_OnSendSuccess()
 {
-	assert(mTransmitQueue.size() > 0);
+	assert(mTransmitQueue.size() >= mWriteSegments.size());
 	assert(mTransmitting);
-	const LinkFrame& f = mTransmitQueue.front();
-	LinkRoute lr(f.GetDest(), f.GetSrc());
-	ILinkContext* pContext = this->GetContext(lr);
-	assert(pContext != NULL);
+	// the context that queued a frame may have been removed while it was written, e.g. a link scan probe
+	for(size_t i = 0; i < mWriteSegments.size(); ++i) mTransmitQueue.pop_front();
+	mWriteSegments.clear();
 	mTransmitting = false;
-	mTransmitQueue.pop_front();
 	this->CheckForSend();
 }
 
 void LinkLayerRouter::_OnSendFailure()
 {
 	LOG_BLOCK(LEV_ERROR, "Unexpected _OnSendFailure");
+	mWriteSegments.clear();
 	mTransmitting = false;
 	this->CheckForSend();
 }
@@ -213,9 +247,16 @@ void LinkLayerRouter::CheckForSend()
 {
 	if(mTransmitQueue.size() > 0 && !mTransmitting && mpPhys->CanWrite()) {
 		mTransmitting = true;
-		const LinkFrame& f = mTransmitQueue.front();
-		LOG_BLOCK(LEV_INTERPRET, "~> " << f.ToString());
-		mpPhys->AsyncWrite(f.GetBuffer(), f.GetSize());
+
+		// Frames that queued up while the last write was outstanding go out together. The deque
+		// doesn't move its elements on push_back/pop_front so the segments stay valid until the callback.
+		size_t num = mTransmitQueue.size() < MAX_FRAMES_PER_WRITE ? mTransmitQueue.size() : MAX_FRAMES_PER_WRITE;
+		for(size_t i = 0; i < num; ++i) {
+			const LinkFrame& f = mTransmitQueue[i];
+			LOG_BLOCK(LEV_INTERPRET, "~> " << f.ToString());
+			mWriteSegments.push_back(WriteSegment(f.GetBuffer(), f.GetSize()));
+		}
+		mpPhys->AsyncWriteGather(&mWriteSegments[0], mWriteSegments.size());
 	}
 }
 
@@ -224,18 +265,27 @@ void LinkLayerRouter::OnPhysicalLayerOpenSuccessCallback()
 	if(mpPhys->CanRead())
 		mpPhys->AsyncRead(mReceiver.WriteBuff(), mReceiver.NumWriteBytes());
 
-	BOOST_FOREACH(AddressMap::value_type p, mAddressMap) {
-		p.second->OnLowerLayerUp();
-	}
+	mCallbackContexts.clear();
+	mRoutes.GetContexts(mCallbackContexts);
+	for(size_t i = 0; i < mCallbackContexts.size(); ++i) mCallbackContexts[i]->OnLowerLayerUp();
 }
 
 void LinkLayerRouter::OnPhysicalLayerCloseCallback()
 {
 	mTransmitting = false;
+	mWriteSegments.clear();
 	mTransmitQueue.erase(mTransmitQueue.begin(), mTransmitQueue.end());
-	for(AddressMap::iterator i = mAddressMap.begin(); i != mAddressMap.end(); ++i) {
-		i->second->OnLowerLayerDown();
+
+	// nothing more can arrive, so report what was suppressed now rather than leave a timer running
+	if(mpUnknownRouteTimer != NULL) {
+		mpUnknownRouteTimer->Cancel();
+		mpUnknownRouteTimer = NULL;
+		if(mNumSuppressed > 0) this->LogUnknownRoutes();
 	}
+
+	mCallbackContexts.clear();
+	mRoutes.GetContexts(mCallbackContexts);
+	for(size_t i = 0; i < mCallbackContexts.size(); ++i) mCallbackContexts[i]->OnLowerLayerDown();
 }
 
 }
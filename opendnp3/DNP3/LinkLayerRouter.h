@@ -19,18 +19,23 @@
 #ifndef __LINK_LAYER_ROUTER_H_
 #define __LINK_LAYER_ROUTER_H_
 
+#include <opendnp3/APL/IPhysicalLayerAsync.h>
 #include <opendnp3/APL/PhysicalLayerMonitor.h>
 #include <opendnp3/DNP3/IFrameSink.h>
 #include <opendnp3/DNP3/ILinkRouter.h>
 #include <opendnp3/DNP3/LinkLayerReceiver.h>
 #include <opendnp3/DNP3/LinkRoute.h>
+#include <opendnp3/DNP3/RouteTable.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
-#include <map>
 #include <queue>
+#include <set>
+#include <vector>
 
 namespace apl
 {
 class IPhysicalLayerAsync;
+class ITimer;
 }
 
 namespace apl
@@ -60,6 +65,26 @@ public:
 	// This is safe to do at runtime, so long as the request happens from the io_service thread.
 	void RemoveContext(const LinkRoute& arRoute);
 
+	/// Number of frames received on the channel that failed a CRC check, safe to call from any thread
+	boost::uint64_t GetNumCrcFailures() const {
+		return mReceiver.GetNumCrcFailures();
+	}
+
+	/// Number of frames received for routes that aren't bound, safe to call from any thread
+	boost::uint64_t GetNumUnknownRoutes() const {
+		return mUnknownRouteCount.Get();
+	}
+
+	/**
+	 * Frames received and sent on a route since it was bound. Must be called
+	 * from the thread of the router or while that thread is paused.
+	 * @return false if the route isn't bound
+	 */
+	bool GetRouteCounters(const LinkRoute& arRoute, RouteCounters& arCounters);
+
+	/// Frames w/ unknown routes that arrive within this long of a warning are summed into the next one
+	static const millis_t UNKNOWN_ROUTE_LOG_INTERVAL = 5000;
+
 	// Implement the IFrameSink interface - This is how the receiver pushes data
 	void Ack(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc);
 	void Nack(bool aIsMaster, bool aIsRcvBuffFull, boost::uint16_t aDest, boost::uint16_t aSrc);
@@ -77,22 +102,38 @@ public:
 private:
 
 	ILinkContext* GetDestination(boost::uint16_t aDest, boost::uint16_t aSrc);
-	ILinkContext* GetContext(const LinkRoute&);
+
+	// Unknown routes are logged at most once per interval, the rest are counted
+	void OnUnknownRoute(const LinkRoute& arRoute);
+	void OnUnknownRouteTimeout();
+	void LogUnknownRoutes();
 
 	void CheckForSend();
 
 	std::string mName;
 
-	typedef std::map<LinkRoute, ILinkContext*, LinkRoute::LessThan> AddressMap;
 	typedef std::deque<LinkFrame> TransmitQueue;
 
-	AddressMap mAddressMap;
+	RouteTable mRoutes;
+	std::set<ILinkContext*> mContexts;				// every bound context, to reject binding one twice
+	std::vector<ILinkContext*> mCallbackContexts;	// reused to call back the contexts on open/close
 	TransmitQueue mTransmitQueue;
 
+	StatCounter mUnknownRouteCount;
+	ITimer* mpUnknownRouteTimer;	// running while warnings are being suppressed
+	size_t mNumSuppressed;			// unknown route frames since the last warning
+	LinkRoute mLastUnknownRoute;
+
 	// Handles the parsing of incoming frames
 	LinkLayerReceiver mReceiver;
 	bool mTransmitting;
 
+	// Frames at the front of the queue that are part of the outstanding write
+	std::vector<WriteSegment> mWriteSegments;
+
+	// Upper bound on the number of queued frames that are gathered into a single write
+	static const size_t MAX_FRAMES_PER_WRITE = 16;
+
 	/* Events - NVII delegates from IUpperLayer */
 
 	// Called when the physical layer has read data into to the requested buffer
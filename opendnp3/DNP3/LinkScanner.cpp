@@ -0,0 +1,204 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/LinkScanner.h>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/ITimerSource.h>
+#include <opendnp3/APL/Logger.h>
+#include <opendnp3/DNP3/LinkLayerRouter.h>
+
+#include <boost/bind.hpp>
+
+namespace apl
+{
+namespace dnp
+{
+
+LinkScanConfig::LinkScanConfig(boost::uint16_t aStart, boost::uint16_t aStop) :
+	mLocalAddr(1),
+	mStart(aStart),
+	mStop(aStop),
+	mWindow(16),
+	mTimeout(1000),
+	mNumRetry(1),
+	mProbe(LSP_RESET_LINK_STATES),
+	mIsMaster(true)
+{}
+
+LinkScanner::LinkScanner(Logger* apLogger, const std::string& arName, LinkLayerRouter* apRouter, ITimerSource* apTimerSrc, const LinkScanConfig& arCfg, ILinkScanObserver* apObserver) :
+	Loggable(apLogger),
+	mName(arName),
+	mpRouter(apRouter),
+	mpTimerSrc(apTimerSrc),
+	mCfg(arCfg),
+	mpObserver(apObserver),
+	mNext(arCfg.mStart),
+	mNumProbed(0),
+	mComplete(false)
+{
+	if(arCfg.mStop < arCfg.mStart) throw ArgumentException(LOCATION, "Scan stop address is less than the start address");
+	if(arCfg.mWindow == 0) throw ArgumentException(LOCATION, "Scan window must be at least 1");
+
+	mAnswered.resize(arCfg.mStop - arCfg.mStart + 1, false);
+	for(size_t i = 0; i <= arCfg.mWindow; ++i) mProbes.push_back(new Probe(this));
+}
+
+LinkScanner::~LinkScanner()
+{
+	this->Stop();
+	for(size_t i = 0; i < mProbes.size(); ++i) delete mProbes[i];
+}
+
+void LinkScanner::Start()
+{
+	LOG_BLOCK(LEV_INFO, "Scanning from " << mCfg.mStart << " to " << mCfg.mStop << " with " << mCfg.mWindow << " probes outstanding");
+
+	for(size_t i = 0; i < mCfg.mWindow; ++i) {
+		if(!this->BindNext(mProbes[i])) break;
+	}
+
+	this->CheckComplete();
+}
+
+void LinkScanner::Stop()
+{
+	mNext = static_cast<boost::uint32_t>(mCfg.mStop) + 1;
+	for(size_t i = 0; i < mProbes.size(); ++i) {
+		if(mProbes[i]->mIsBound) this->Unbind(mProbes[i]);
+	}
+}
+
+void LinkScanner::Probe::OnLowerLayerUp()
+{
+	if(mIsBound) mpScanner->Send(this);
+}
+
+void LinkScanner::Probe::OnLowerLayerDown()
+{
+	// the attempt is repeated when the channel comes back
+	mpScanner->CancelTimer(this);
+}
+
+void LinkScanner::Send(Probe* apProbe)
+{
+	++apProbe->mNumAttempts;
+
+	if(mCfg.mProbe == LSP_RESET_LINK_STATES) mFrame.FormatResetLinkStates(mCfg.mIsMaster, apProbe->mAddress, mCfg.mLocalAddr);
+	else mFrame.FormatRequestLinkStatus(mCfg.mIsMaster, apProbe->mAddress, mCfg.mLocalAddr);
+
+	// start the timer first, a failed write closes the channel which cancels it
+	apProbe->mpTimer = mpTimerSrc->Start(mCfg.mTimeout, boost::bind(&LinkScanner::OnTimeout, this, apProbe));
+	mpRouter->Transmit(mFrame);
+}
+
+void LinkScanner::OnTimeout(Probe* apProbe)
+{
+	apProbe->mpTimer = NULL;
+
+	if(apProbe->mNumAttempts <= mCfg.mNumRetry) this->Send(apProbe);
+	else {
+		LOG_BLOCK(LEV_DEBUG, "No answer from address: " << apProbe->mAddress);
+		this->Advance(apProbe);
+	}
+}
+
+void LinkScanner::OnAnswer(Probe* apProbe, boost::uint16_t aSrc)
+{
+	this->CancelTimer(apProbe);
+
+	size_t offset = aSrc - mCfg.mStart;
+	if(!mAnswered[offset]) {
+		mAnswered[offset] = true;
+		mFound.push_back(aSrc);
+		LOG_BLOCK(LEV_EVENT, "Received answer from address: " << aSrc);
+		if(mpObserver) mpObserver->OnAddressFound(mName, aSrc);
+	}
+
+	this->Advance(apProbe);
+}
+
+void LinkScanner::Advance(Probe* apProbe)
+{
+	++mNumProbed;
+
+	for(size_t i = 0; i < mProbes.size(); ++i) {
+		if(!mProbes[i]->mIsBound) {
+			this->BindNext(mProbes[i]);
+			break;
+		}
+	}
+
+	this->Unbind(apProbe);
+	this->CheckComplete();
+}
+
+bool LinkScanner::BindNext(Probe* apProbe)
+{
+	while(mNext <= mCfg.mStop) {
+		apProbe->mAddress = static_cast<boost::uint16_t>(mNext++);
+		apProbe->mNumAttempts = 0;
+		apProbe->mIsBound = true;
+
+		try {
+			// sends the first attempt right away if the channel is open
+			mpRouter->AddContext(apProbe, this->RouteOf(apProbe));
+			return true;
+		}
+		catch(const ArgumentException&) {
+			LOG_BLOCK(LEV_INFO, "Skipping address that is bound to a stack: " << apProbe->mAddress);
+			apProbe->mIsBound = false;
+			++mNumProbed;
+		}
+	}
+
+	return false;
+}
+
+void LinkScanner::Unbind(Probe* apProbe)
+{
+	this->CancelTimer(apProbe);
+	apProbe->mIsBound = false;
+	mpRouter->RemoveContext(this->RouteOf(apProbe));
+}
+
+void LinkScanner::CancelTimer(Probe* apProbe)
+{
+	if(apProbe->mpTimer != NULL) {
+		apProbe->mpTimer->Cancel();
+		apProbe->mpTimer = NULL;
+	}
+}
+
+void LinkScanner::CheckComplete()
+{
+	if(mComplete || mNext <= mCfg.mStop) return;
+
+	for(size_t i = 0; i < mProbes.size(); ++i) {
+		if(mProbes[i]->mIsBound) return;
+	}
+
+	mComplete = true;
+	LOG_BLOCK(LEV_INFO, "Scan complete, " << mFound.size() << " device(s) answered");
+	if(mpObserver) mpObserver->OnScanComplete(mName, mFound);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,218 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __LINK_SCANNER_H_
+#define __LINK_SCANNER_H_
+
+#include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/Types.h>
+#include <opendnp3/DNP3/ILinkContext.h>
+#include <opendnp3/DNP3/LinkFrame.h>
+#include <opendnp3/DNP3/LinkRoute.h>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+namespace apl
+{
+class ITimer;
+class ITimerSource;
+}
+
+namespace apl
+{
+namespace dnp
+{
+
+class LinkLayerRouter;
+
+/// The link layer frame used to find out if an address is in use
+enum LinkScanProbe {
+	LSP_RESET_LINK_STATES,		//!< answered with an ACK
+	LSP_REQUEST_LINK_STATUS		//!< answered with a LINK_STATUS, doesn't touch the link state of the device
+};
+
+struct LinkScanConfig {
+	LinkScanConfig(boost::uint16_t aStart = 0, boost::uint16_t aStop = 0xFFEF);
+
+	/** Address the probes are sent from */
+	boost::uint16_t mLocalAddr;
+
+	/** First and last (inclusive) address to probe */
+	boost::uint16_t mStart;
+	boost::uint16_t mStop;
+
+	/** The maximum number of probes that are waiting for an answer at once */
+	size_t mWindow;
+
+	/** How long to wait for an answer to each attempt */
+	millis_t mTimeout;
+
+	/** Number of times a probe is repeated after the first attempt times out */
+	size_t mNumRetry;
+
+	LinkScanProbe mProbe;
+
+	/** Value of the DIR bit of the probes */
+	bool mIsMaster;
+};
+
+/// Callbacks of a LinkScanner, made from the thread of the router that is scanned
+class ILinkScanObserver
+{
+public:
+	virtual ~ILinkScanObserver() {}
+
+	virtual void OnAddressFound(const std::string& arName, boost::uint16_t aAddress) = 0;
+
+	// @param arFound every address that answered, in the order the answers arrived
+	virtual void OnScanComplete(const std::string& arName, const std::vector<boost::uint16_t>& arFound) = 0;
+};
+
+/**
+ * Finds the devices on a channel by probing a range of link addresses.
+ *
+ * Up to mWindow probes are outstanding at once, each with its own timer and
+ * retries, so a scan takes about (range / window) * timeout instead of
+ * range * timeout. Every address that answers with any frame is reported.
+ *
+ * The router only delivers frames whose route is bound, so each outstanding
+ * probe binds the route of its address as a context of its own. Routes that
+ * are in use by a stack are skipped. Like the stacks, the scanner must only
+ * be used from the thread of its router or while that thread is paused.
+ */
+class LinkScanner : private Loggable
+{
+public:
+
+	/// @throw ArgumentException if the range is reversed or the window is 0
+	LinkScanner(Logger* apLogger, const std::string& arName, LinkLayerRouter* apRouter, ITimerSource* apTimerSrc, const LinkScanConfig& arCfg, ILinkScanObserver* apObserver);
+
+	~LinkScanner();
+
+	void Start();
+
+	/// Abandons the outstanding probes, the observer isn't told that the scan completed
+	void Stop();
+
+	bool IsComplete() const {
+		return mComplete;
+	}
+
+	bool IsFound(boost::uint16_t aAddress) const {
+		return aAddress >= mCfg.mStart && aAddress <= mCfg.mStop && mAnswered[aAddress - mCfg.mStart];
+	}
+
+	const std::vector<boost::uint16_t>& GetFound() const {
+		return mFound;
+	}
+
+	/// Number of addresses that have been given up on or answered
+	size_t NumProbed() const {
+		return mNumProbed;
+	}
+
+private:
+
+	// One outstanding probe, the context of the route of the address it probes
+	class Probe : public ILinkContext
+	{
+	public:
+		Probe(LinkScanner* apScanner) : mpScanner(apScanner), mpTimer(NULL), mAddress(0), mNumAttempts(0), mIsBound(false)
+		{}
+
+		void OnLowerLayerUp();
+		void OnLowerLayerDown();
+
+		// any answer means there's a device at the address
+		void Ack(bool, bool, boost::uint16_t, boost::uint16_t aSrc) {
+			mpScanner->OnAnswer(this, aSrc);
+		}
+		void Nack(bool, bool, boost::uint16_t, boost::uint16_t aSrc) {
+			mpScanner->OnAnswer(this, aSrc);
+		}
+		void LinkStatus(bool, bool, boost::uint16_t, boost::uint16_t aSrc) {
+			mpScanner->OnAnswer(this, aSrc);
+		}
+		void NotSupported(bool, bool, boost::uint16_t, boost::uint16_t aSrc) {
+			mpScanner->OnAnswer(this, aSrc);
+		}
+
+		// primary frames from the address aren't answers
+		void TestLinkStatus(bool, bool, boost::uint16_t, boost::uint16_t) {}
+		void ResetLinkStates(bool, boost::uint16_t, boost::uint16_t) {}
+		void RequestLinkStatus(bool, boost::uint16_t, boost::uint16_t) {}
+		void ConfirmedUserData(bool, bool, boost::uint16_t, boost::uint16_t, const boost::uint8_t*, size_t) {}
+		void UnconfirmedUserData(bool, boost::uint16_t, boost::uint16_t, const boost::uint8_t*, size_t) {}
+
+		LinkScanner* mpScanner;
+		ITimer* mpTimer;
+		boost::uint16_t mAddress;
+		size_t mNumAttempts;
+		bool mIsBound;
+	};
+
+	void Send(Probe* apProbe);
+	void OnAnswer(Probe* apProbe, boost::uint16_t aSrc);
+	void OnTimeout(Probe* apProbe);
+
+	// Moves on from the address of a probe to the next one, if any
+	void Advance(Probe* apProbe);
+
+	// Binds an idle probe to the next address that isn't in use, @return false if there are none
+	bool BindNext(Probe* apProbe);
+	void Unbind(Probe* apProbe);
+	void CancelTimer(Probe* apProbe);
+
+	// Tells the observer once every address has been probed
+	void CheckComplete();
+
+	LinkRoute RouteOf(const Probe* apProbe) const {
+		return LinkRoute(apProbe->mAddress, mCfg.mLocalAddr);
+	}
+
+	std::string mName;
+	LinkLayerRouter* mpRouter;
+	ITimerSource* mpTimerSrc;
+	const LinkScanConfig mCfg;
+	ILinkScanObserver* mpObserver;
+
+	/*
+	 * mWindow + 1 probes. The next address is bound with the spare before the
+	 * route of a finished one is removed, so the router never runs out of
+	 * routes in the middle of a scan and suspends the channel.
+	 */
+	std::vector<Probe*> mProbes;
+
+	std::vector<bool> mAnswered;		// bitmap from address - mStart to whether it answered
+	std::vector<boost::uint16_t> mFound;
+	boost::uint32_t mNext;				// next address to bind, wider than an address so that it can pass 0xFFFF
+	size_t mNumProbed;
+	bool mComplete;
+
+	LinkFrame mFrame;
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
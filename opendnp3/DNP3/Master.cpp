@@ -54,6 +54,7 @@ Master::Master(Logger* apLogger, MasterConfig aCfg, IAppLayer* apAppLayer, IData
 	mpTaskGroup(apTaskGroup),
 	mpTimerSrc(apTimerSrc),
 	mpTimeSrc(apTimeSrc),
+	mpStats(NULL),
 	mpState(AMS_Closed::Inst()),
 	mpTask(NULL),
 	mpScheduledTask(NULL),
@@ -325,7 +326,7 @@ void Master::ScheduleOnDemandIntegrityPoll(void)
     return;
 }
 
-void Master::ScheduleFreeFormPoll(std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> ffInp)
+void Master::ScheduleFreeFormPoll(const std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash>& ffInp)
 {
 	mFreeFormPoll.SetDataPoints(ffInp); //ffInputPoints);
 	mSchedule.AddFreeFormPoll(this);
@@ -338,12 +339,19 @@ void Master::UpdateIntegrityPollRate(millis_t interval)
 	return;
 }
 
+void Master::SetStatistics(StackStatistics* apStats)
+{
+	mpStats = apStats;
+	mClassPoll.SetStatistics(apStats);
+	mFreeFormPoll.SetStatistics(apStats);
+}
+
 /* Private functions */
 
 void Master::ProcessDataResponse(const APDU& arResponse)
 {
 	try {
-		ResponseLoader loader(this->mpLogger, this->mpPublisher, this->GetVtoReader());
+		ResponseLoader loader(this->mpLogger, this->mpPublisher, this->GetVtoReader(), mpStats, &mBatches);
 
 		for(HeaderReadIterator hdr = arResponse.BeginRead(); !hdr.IsEnd(); ++hdr)
 			loader.Process(hdr);
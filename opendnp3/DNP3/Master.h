@@ -34,6 +34,7 @@
 #include <opendnp3/DNP3/MasterSchedule.h>
 #include <opendnp3/DNP3/ObjectInterfaces.h>
 #include <opendnp3/DNP3/ObjectReadIterator.h>
+#include <opendnp3/DNP3/ResponseLoader.h>
 #include <opendnp3/DNP3/StartupTasks.h>
 #include <opendnp3/DNP3/VtoReader.h>
 #include <opendnp3/DNP3/VtoTransmitTask.h>
@@ -57,6 +58,7 @@ namespace dnp
 {
 
 class AMS_Base;
+class StackStatistics;
 
 /**
  * Represents a DNP3 Master endpoint. The tasks functions can perform all the
@@ -141,7 +143,7 @@ public:
 	 *
 	 * @return None
 	 */
-    void ScheduleFreeFormPoll(std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> ffInputPoints);
+    void ScheduleFreeFormPoll(const std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash>& ffInputPoints);
  
 	/**
 	 * Update Integrity Poll Interval
@@ -151,6 +153,14 @@ public:
 	 */
 	void UpdateIntegrityPollRate(millis_t interval);
 
+	/**
+	 * Counts the events received by the polls and unsolicited responses
+	 * and records their age.
+	 *
+	 * @param apStats	the statistics of the stack, NULL to stop counting
+	 */
+	void SetStatistics(StackStatistics* apStats);
+
 private:
 
 	void UpdateState(StackStates aState);
@@ -192,12 +202,14 @@ private:
 	VtoWriter mVtoWriter;
 
 	APDU mRequest;							// APDU that gets reused for requests
+	ResponseBatches mBatches;				// values of unsolicited responses, reused across fragments
 
 	IAppLayer* mpAppLayer;					// lower application layer
 	IDataObserver* mpPublisher;				// where the data measurements are pushed
 	AsyncTaskGroup* mpTaskGroup;			// How task execution is controlled
 	ITimerSource* mpTimerSrc;				// Controls the posting of events to marshall across threads
 	ITimeSource* mpTimeSrc;					// Access to UTC, normally system time but can be a mock for testing
+	StackStatistics* mpStats;				// Optional performance counters
 
 	AMS_Base* mpState;						// Pointer to active state, start in TLS_Closed
 	MasterTaskBase* mpTask;					// The current master task
@@ -30,6 +30,7 @@ MasterStack::MasterStack(Logger* apLogger, ITimerSource* apTimerSrc, IDataObserv
 	mScanScheduler(&mMaster, apTimerSrc, apLogger)
 {
 	mApplication.SetUser(&mMaster);
+	mMaster.SetStatistics(&mStatistics);
 }
 
 IVtoWriter* MasterStack::GetVtoWriter()
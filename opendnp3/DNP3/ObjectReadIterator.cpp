@@ -31,14 +31,19 @@ ObjectReadIterator::ObjectReadIterator(const HeaderInfo& arInfo, const boost::ui
 	mCurrentObjectNum(0),
 	mpPrefixPos(NULL),
 	mpBuffer(apBuffer),
-	mHasData(aHasData)
+	mHasData(aHasData),
+	mObjectType(arInfo.GetObjectType()),
+	mIndexMode(IM_NONE),
+	mIndexBase(0),
+	mStride(0)
 {
 	if(!this->IsEnd()) {
+		this->DecodeHeader();
 		mpPrefixPos = mpBuffer + (mHeaderInfo.GetPosition() + mHeaderInfo.GetHeaderSize());
 		this->SetObjectInfo();
 	}
 
-	if(mHeaderInfo.GetObjectType() == OT_BITFIELD) {
+	if(mObjectType == OT_BITFIELD) {
 		mInfo.mStart = mInfo.mIndex;
 	}
 	else {
@@ -46,10 +51,67 @@ ObjectReadIterator::ObjectReadIterator(const HeaderInfo& arInfo, const boost::ui
 	}
 }
 
-void ObjectReadIterator::SetObjectInfo()
+void ObjectReadIterator::DecodeHeader()
 {
-	if(mHasData) mpPosition = mpPrefixPos + this->mHeaderInfo.GetPrefixSize();
-	mInfo.mIndex = this->CalcIndex();
+	QualifierCode qual = mHeaderInfo.GetQualifier();
+
+	switch(mHeaderInfo.GetHeaderType()) {
+		//For a count you have to examine the prefix code
+	case(OHT_COUNT_1_OCTET):
+	case(OHT_COUNT_2_OCTET):
+	case(OHT_COUNT_4_OCTET):
+		switch(qual) {
+			// if there's no prefix or it's prefixed
+			// with a size assume the index is implicit
+			// based on the object number in the sequence from 0
+		case(QC_1B_CNT):
+		case(QC_2B_CNT):
+		case(QC_4B_CNT):
+		case(QC_ALL_OBJ):
+			mIndexMode = IM_POSITION;
+			break;
+			// if it's prefixed with an index, return the index
+		case(QC_1B_CNT_1B_INDEX):
+			mIndexMode = IM_PREFIX_1B;
+			break;
+		case(QC_2B_CNT_2B_INDEX):
+			mIndexMode = IM_PREFIX_2B;
+			break;
+		case(QC_4B_CNT_4B_INDEX):
+			mIndexMode = IM_PREFIX_4B;
+			break;
+		default:
+			throw Exception(LOCATION, "Invalid qualifier code");
+		}
+		break;
+		// these must be used with no-prefix so
+		// you can just examine the range and current object number
+	case(OHT_RANGED_2_OCTET):
+	case(OHT_RANGED_4_OCTET):
+	case(OHT_RANGED_8_OCTET): {
+			RangeInfo range;
+			static_cast<const IRangeHeader*>(mHeaderInfo.GetHeader())->GetRange(mpBuffer + mHeaderInfo.GetPosition(), range);
+			mIndexMode = IM_POSITION;
+			mIndexBase = range.Start;
+			break;
+		}
+	default:
+		break; // All objects should just use an index of zero since it shouldn't contain objects
+	}
+
+	// objects that aren't prefixed with their size are all the same size
+	switch(qual) {
+	case(QC_1B_VCNT_1B_SIZE):
+	case(QC_1B_VCNT_2B_SIZE):
+	case(QC_1B_VCNT_4B_SIZE):
+		break;
+	default:
+		if(!mHasData) mStride = mHeaderInfo.GetPrefixSize();
+		else if(mObjectType == OT_FIXED) {
+			mStride = mHeaderInfo.GetPrefixSize() + static_cast<const FixedObject*>(mHeaderInfo.GetBaseObject())->GetSize();
+		}
+		break;
+	}
 }
 
 size_t ObjectReadIterator::CalcObjSize(const boost::uint8_t* apPrefixPos)
@@ -66,7 +128,7 @@ size_t ObjectReadIterator::CalcObjSize(const boost::uint8_t* apPrefixPos)
 		return UInt32LE::Read(apPrefixPos);
 	default:
 		//for all other types, the size should be static or collective
-		switch(mHeaderInfo.GetObjectType()) {
+		switch(mObjectType) {
 		case(OT_FIXED):
 			return static_cast<const FixedObject*>(mHeaderInfo.GetBaseObject())->GetSize();
 		case(OT_BITFIELD):
@@ -84,53 +146,17 @@ size_t ObjectReadIterator::CalcObjSize(const boost::uint8_t* apPrefixPos)
 // to there relative position in the header
 size_t ObjectReadIterator::CalcIndex()
 {
-	size_t index = 0;
-
-	switch(mHeaderInfo.GetHeaderType()) {
-		//For a count you have to examine the prefix code
-	case(OHT_COUNT_1_OCTET):
-	case(OHT_COUNT_2_OCTET):
-	case(OHT_COUNT_4_OCTET):
-		index = this->CalcCountIndex(mHeaderInfo.GetQualifier(), mpPrefixPos);
-		break;
-		// these must be used with no-prefix so
-		// you can just examine the range and current object number
-	case(OHT_RANGED_2_OCTET):
-	case(OHT_RANGED_4_OCTET):
-	case(OHT_RANGED_8_OCTET): {
-			RangeInfo range;
-			static_cast<const IRangeHeader*>(mHeaderInfo.GetHeader())->GetRange(mpBuffer + mHeaderInfo.GetPosition(), range);
-			index = range.Start + mCurrentObjectNum;
-			break;
-		}
-	default:
-		break; // All objects should just use an index of zero since it shouldn't contain objects
-	}
-
-	return index;
-}
-
-size_t ObjectReadIterator::CalcCountIndex(QualifierCode aCode, const boost::uint8_t* apPrefixPos)
-{
-	switch(aCode) {
-
-		// if there's no prefix or it's prefixed
-		// with a size assume the index is implicit
-		// based on the object number in the sequence from 0
-	case(QC_1B_CNT):
-	case(QC_2B_CNT):
-	case(QC_4B_CNT):
-	case(QC_ALL_OBJ):
-		return this->mCurrentObjectNum;
-		// if it's prefixed with an index, return the index
-	case(QC_1B_CNT_1B_INDEX):
-		return UInt8::Read(apPrefixPos);
-	case(QC_2B_CNT_2B_INDEX):
-		return UInt16LE::Read(apPrefixPos);
-	case(QC_4B_CNT_4B_INDEX):
-		return UInt32LE::Read(apPrefixPos);
+	switch(mIndexMode) {
+	case(IM_POSITION):
+		return mIndexBase + mCurrentObjectNum;
+	case(IM_PREFIX_1B):
+		return UInt8::Read(mpPrefixPos);
+	case(IM_PREFIX_2B):
+		return UInt16LE::Read(mpPrefixPos);
+	case(IM_PREFIX_4B):
+		return UInt32LE::Read(mpPrefixPos);
 	default:
-		throw Exception(LOCATION, "Invalid qualifier code");
+		return 0;
 	}
 }
 
@@ -86,6 +86,19 @@ public:
 
 private:
 
+	/*
+	 * How the index of each object is determined. This and the distance
+	 * between objects are decoded from the header once, so advancing the
+	 * iterator doesn't have to examine the header for every object.
+	 */
+	enum IndexMode {
+		IM_NONE,		// headers without objects, the index is always zero
+		IM_POSITION,	// mIndexBase + the position of the object in the header
+		IM_PREFIX_1B,	// read from the prefix of each object
+		IM_PREFIX_2B,
+		IM_PREFIX_4B
+	};
+
 	ObjectReadIterator(const HeaderInfo& arInfo, const boost::uint8_t* apBuffer, bool aHasData);
 	HeaderInfo mHeaderInfo;
 	size_t mCurrentObjectNum;
@@ -95,11 +108,16 @@ private:
 	const boost::uint8_t* mpBuffer;
 	bool mHasData;
 
+	ObjectTypes mObjectType;
+	IndexMode mIndexMode;
+	size_t mIndexBase;
+	size_t mStride;		// distance between prefixes, 0 if each object carries its own size
+
 	void SetObjectInfo();
 
 	//private helpers
+	void DecodeHeader();
 	size_t CalcIndex();
-	size_t CalcCountIndex(QualifierCode aCode, const boost::uint8_t* apPrefixPos);
 	size_t CalcObjSize(const boost::uint8_t* apPrefixPos);
 };
 
@@ -124,8 +142,8 @@ inline const ObjectReadIterator& ObjectReadIterator::operator++()
 
 	if(!this->IsEnd()) {
 		//Don't advance the prefix position if the object is a bitfield
-		if(mHeaderInfo.GetObjectType() != OT_BITFIELD) {
-			mpPrefixPos += mHeaderInfo.GetPrefixSize() + this->CalcObjSize(mpPrefixPos);
+		if(mObjectType != OT_BITFIELD) {
+			mpPrefixPos += (mStride > 0) ? mStride : mHeaderInfo.GetPrefixSize() + this->CalcObjSize(mpPrefixPos);
 		}
 
 		this->SetObjectInfo();
@@ -134,6 +152,12 @@ inline const ObjectReadIterator& ObjectReadIterator::operator++()
 	return (*this);
 }
 
+inline void ObjectReadIterator::SetObjectInfo()
+{
+	if(mHasData) mpPosition = mpPrefixPos + mHeaderInfo.GetPrefixSize();
+	mInfo.mIndex = (mIndexMode == IM_POSITION) ? mIndexBase + mCurrentObjectNum : this->CalcIndex();
+}
+
 inline const ObjectReadIterator ObjectReadIterator::operator++(int)
 {
 	ObjectReadIterator tmp(*this);
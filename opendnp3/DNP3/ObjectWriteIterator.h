@@ -48,6 +48,11 @@ public:
 		return mIndex > mStop;
 	};
 
+	/// Number of objects that remain to be written, including the current one
+	size_t Remaining() const {
+		return this->IsEnd() ? 0 : mStop - mIndex + 1;
+	}
+
 	boost::uint8_t* operator*() const;
 
 private:
@@ -0,0 +1,109 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/PointIndexMap.h>
+
+#include <opendnp3/APL/Exception.h>
+
+#include <algorithm>
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+bool StopsBefore(const IndexRun& arRun, size_t aIndex)
+{
+	return arRun.Stop() < aIndex;
+}
+
+bool SlotBefore(size_t aSlot, const IndexRun& arRun)
+{
+	return aSlot < arRun.mSlot;
+}
+
+}
+
+void PointIndexMap::SetDense(size_t aNumPoints)
+{
+	mDense = true;
+	mNumPoints = aNumPoints;
+	mRuns.clear();
+	if(aNumPoints > 0) mRuns.push_back(IndexRun(0, aNumPoints, 0));
+	mPages.clear();
+	mSlots.clear();
+}
+
+void PointIndexMap::SetSparse(const std::vector<size_t>& arIndices)
+{
+	for(size_t i = 1; i < arIndices.size(); ++i) {
+		if(arIndices[i] <= arIndices[i - 1]) throw ArgumentException(LOCATION, "Point indices must be strictly ascending");
+	}
+
+	if(arIndices.empty() || arIndices.back() == arIndices.size() - 1) {
+		this->SetDense(arIndices.size()); // nothing is missing
+		return;
+	}
+
+	mDense = false;
+	mNumPoints = arIndices.size();
+	mRuns.clear();
+	mPages.assign((arIndices.back() >> PAGE_BITS) + 1, static_cast<boost::uint32_t>(NIL));
+	mSlots.clear();
+
+	for(size_t slot = 0; slot < arIndices.size(); ++slot) {
+		size_t index = arIndices[slot];
+
+		if(!mRuns.empty() && mRuns.back().Stop() + 1 == index) ++mRuns.back().mCount;
+		else mRuns.push_back(IndexRun(index, 1, slot));
+
+		size_t page = index >> PAGE_BITS;
+		if(mPages[page] == NIL) {
+			mPages[page] = static_cast<boost::uint32_t>(mSlots.size());
+			mSlots.resize(mSlots.size() + PAGE_SIZE, static_cast<boost::uint32_t>(NIL));
+		}
+		mSlots[mPages[page] + (index & (PAGE_SIZE - 1))] = static_cast<boost::uint32_t>(slot);
+	}
+}
+
+size_t PointIndexMap::IndexOf(size_t aSlot) const
+{
+	if(mDense) return aSlot;
+
+	// the last run that starts at or before the slot
+	std::vector<IndexRun>::const_iterator i = std::upper_bound(mRuns.begin(), mRuns.end(), aSlot, SlotBefore);
+	--i;
+	return i->mStart + (aSlot - i->mSlot);
+}
+
+void PointIndexMap::GetRuns(size_t aStart, size_t aStop, std::vector<IndexRun>& arRuns) const
+{
+	std::vector<IndexRun>::const_iterator i = std::lower_bound(mRuns.begin(), mRuns.end(), aStart, StopsBefore);
+
+	for(; i != mRuns.end() && i->mStart <= aStop; ++i) {
+		size_t start = std::max(i->mStart, aStart);
+		size_t stop = std::min(i->Stop(), aStop);
+		arRuns.push_back(IndexRun(start, stop - start + 1, i->mSlot + (start - i->mStart)));
+	}
+}
+
+}
+}
@@ -0,0 +1,129 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __POINT_INDEX_MAP_H_
+#define __POINT_INDEX_MAP_H_
+
+#include <boost/cstdint.hpp>
+
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/// A run of consecutive point indices stored in consecutive slots
+struct IndexRun {
+	IndexRun(size_t aStart = 0, size_t aCount = 0, size_t aSlot = 0) :
+		mStart(aStart), mCount(aCount), mSlot(aSlot)
+	{}
+
+	size_t Stop() const {
+		return mStart + mCount - 1;
+	}
+
+	size_t mStart;	// first index of the run
+	size_t mCount;	// number of indices in the run
+	size_t mSlot;	// slot of the first index
+};
+
+/**
+ * Maps the DNP3 indices of one measurement type onto the compact slots of a
+ * StaticPointStore.
+ *
+ * The configured indices are kept as a sorted list of runs. Devices numbered
+ * 0 to N-1 are a single run and map every index onto the slot with the same
+ * number. Sparse layouts, e.g. 0-50 and 60000-60100, look indices up in a two
+ * level table of PAGE_SIZE entries per page where only the pages that hold
+ * points are allocated, so lookups stay O(1) without a slot per unused index.
+ */
+class PointIndexMap
+{
+public:
+
+	static const size_t PAGE_BITS = 8;
+	static const size_t PAGE_SIZE = 1 << PAGE_BITS;
+
+	PointIndexMap() : mDense(true), mNumPoints(0)
+	{}
+
+	/// Maps indices 0 to aNumPoints-1 onto the slots with the same number
+	void SetDense(size_t aNumPoints);
+
+	/**
+	 * Maps each index onto the slot of its position in arIndices
+	 * @throw ArgumentException if the indices are not strictly ascending
+	 */
+	void SetSparse(const std::vector<size_t>& arIndices);
+
+	size_t NumPoints() const {
+		return mNumPoints;
+	}
+
+	bool IsDense() const {
+		return mDense;
+	}
+
+	/// @return the highest configured index, only valid if NumPoints() > 0
+	size_t MaxIndex() const {
+		return mRuns.back().Stop();
+	}
+
+	const std::vector<IndexRun>& Runs() const {
+		return mRuns;
+	}
+
+	/// @return false if the index isn't configured
+	bool FindSlot(size_t aIndex, size_t& arSlot) const {
+		if(mDense) {
+			arSlot = aIndex;
+			return aIndex < mNumPoints;
+		}
+
+		size_t page = aIndex >> PAGE_BITS;
+		if(page >= mPages.size() || mPages[page] == NIL) return false;
+		boost::uint32_t slot = mSlots[mPages[page] + (aIndex & (PAGE_SIZE - 1))];
+		if(slot == NIL) return false;
+		arSlot = slot;
+		return true;
+	}
+
+	/// @return the index of a slot that is less than NumPoints()
+	size_t IndexOf(size_t aSlot) const;
+
+	/// Appends the parts of the runs that lie within [aStart, aStop] to arRuns
+	void GetRuns(size_t aStart, size_t aStop, std::vector<IndexRun>& arRuns) const;
+
+private:
+
+	static const boost::uint32_t NIL = 0xFFFFFFFF;
+
+	bool mDense;
+	size_t mNumPoints;
+	std::vector<IndexRun> mRuns;
+
+	std::vector<boost::uint32_t> mPages;	// offset of each page in mSlots or NIL if it holds no points
+	std::vector<boost::uint32_t> mSlots;	// PAGE_SIZE slots per allocated page
+};
+
+}
+}
+
+#endif
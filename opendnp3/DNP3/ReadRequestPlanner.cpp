@@ -0,0 +1,255 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/ReadRequestPlanner.h>
+
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/ObjectInterfaces.h>
+
+#include <algorithm>
+
+namespace apl
+{
+namespace dnp
+{
+
+// object header = group + variation + qualifier
+const size_t OBJ_HDR_SIZE = 3;
+
+// widest possible header is a 4 byte start-stop or a 4 byte count with one 4 byte index
+const size_t MIN_CAPACITY = OBJ_HDR_SIZE + 2 * 4;
+
+inline bool IsIndexed(QualifierCode aCode)
+{
+	return aCode == QC_1B_CNT_1B_INDEX || aCode == QC_2B_CNT_2B_INDEX || aCode == QC_4B_CNT_4B_INDEX;
+}
+
+inline size_t IndexWidth(QualifierCode aCode)
+{
+	switch(aCode) {
+	case(QC_1B_CNT_1B_INDEX): return 1;
+	case(QC_2B_CNT_2B_INDEX): return 2;
+	default: return 4;
+	}
+}
+
+ReadRequestPlanner::ReadRequestPlanner() :
+	mPlannedCapacity(0)
+{}
+
+void ReadRequestPlanner::Clear()
+{
+	mRequests.clear();
+	mPlannedCapacity = 0;
+}
+
+void ReadRequestPlanner::AddPoints(const FixedObject* apObj, const std::vector<boost::uint32_t>& arIndices)
+{
+	if(arIndices.empty()) return;
+
+	Request* pRequest = NULL;
+	for(size_t i = 0; i < mRequests.size(); ++i) {
+		if(mRequests[i].mpObj == apObj) pRequest = &mRequests[i];
+	}
+	if(pRequest == NULL) {
+		mRequests.push_back(Request());
+		pRequest = &mRequests.back();
+		pRequest->mpObj = apObj;
+	}
+
+	std::vector<boost::uint32_t>& indices = pRequest->mIndices;
+	indices.insert(indices.end(), arIndices.begin(), arIndices.end());
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+	mPlannedCapacity = 0;
+}
+
+size_t ReadRequestPlanner::NumFragments(size_t aCapacity)
+{
+	if(mRequests.empty()) return 0;
+	if(aCapacity != mPlannedCapacity) this->Plan(aCapacity);
+	return mFragments.size();
+}
+
+size_t ReadRequestPlanner::GetFragmentSize(size_t aCapacity, size_t aFragment)
+{
+	size_t num = this->NumFragments(aCapacity);
+	if(aFragment >= num) return 0;
+
+	size_t end = (aFragment + 1 < num) ? mFragments[aFragment + 1] : mPacked.size();
+	size_t size = 0;
+	for(size_t i = mFragments[aFragment]; i < end; ++i) size += mPacked[i].mSize;
+	return size;
+}
+
+size_t ReadRequestPlanner::Write(APDU& arAPDU, size_t aFragment)
+{
+	size_t num = this->NumFragments(arAPDU.MaxSize() - arAPDU.Size());
+	if(aFragment >= num) return 0;
+
+	size_t end = (aFragment + 1 < num) ? mFragments[aFragment + 1] : mPacked.size();
+	for(size_t i = mFragments[aFragment]; i < end; ++i) {
+		const Header& h = mPacked[i];
+		if(IsIndexed(h.mCode)) {
+			IndexedWriteIterator itr = arAPDU.WriteIndexed(h.mpObj, h.mStop - h.mStart, h.mCode);
+			if(itr.IsEnd()) throw InvalidStateException(LOCATION, "Planned header does not fit in the fragment");
+			for(size_t j = h.mStart; j < h.mStop && !itr.IsEnd(); ++j) {
+				itr.SetIndex(mIndexList[j]);
+				++itr;
+			}
+		}
+		else {
+			ObjectWriteIterator itr = arAPDU.WriteContiguous(h.mpObj, h.mStart, h.mStop, h.mCode);
+			if(itr.IsEnd()) throw InvalidStateException(LOCATION, "Planned header does not fit in the fragment");
+		}
+	}
+
+	return end - mFragments[aFragment];
+}
+
+void ReadRequestPlanner::Plan(size_t aCapacity)
+{
+	if(aCapacity < MIN_CAPACITY) throw ArgumentException(LOCATION, "Fragment too small for a read request");
+
+	mHeaders.clear();
+	mIndexList.clear();
+	for(size_t i = 0; i < mRequests.size(); ++i) this->PlanObject(mRequests[i]);
+	this->Pack(aCapacity);
+
+	mPlannedCapacity = aCapacity;
+}
+
+void ReadRequestPlanner::PlanObject(const Request& arRequest)
+{
+	// runs that are cheaper to list index by index, by index width 1, 2 and 4
+	std::vector<Range> listed[3];
+
+	const std::vector<boost::uint32_t>& indices = arRequest.mIndices;
+	size_t i = 0;
+	while(i < indices.size()) {
+		Range r = { indices[i], indices[i] };
+		for(++i; i < indices.size() && indices[i] == r.mStop + 1; ++i) r.mStop = indices[i];
+
+		size_t width = WidthOf(r.mStop);
+		size_t count = r.mStop - r.mStart + 1;
+		if(count * width < RangeHeaderSize(r)) listed[width / 2].push_back(r);
+		else this->AddRangeHeader(arRequest.mpObj, r);
+	}
+
+	// an index list pays for its own header, so only use it if that still beats a header per run
+	for(size_t w = 0; w < 3; ++w) {
+		if(listed[w].empty()) continue;
+
+		size_t width = (w == 0) ? 1 : 2 * w;
+		size_t listSize = OBJ_HDR_SIZE + width;
+		size_t rangeSize = 0;
+		for(size_t j = 0; j < listed[w].size(); ++j) {
+			listSize += (listed[w][j].mStop - listed[w][j].mStart + 1) * width;
+			rangeSize += RangeHeaderSize(listed[w][j]);
+		}
+
+		if(listSize < rangeSize) this->AddIndexHeaders(arRequest.mpObj, width, listed[w]);
+		else {
+			for(size_t j = 0; j < listed[w].size(); ++j) this->AddRangeHeader(arRequest.mpObj, listed[w][j]);
+		}
+	}
+}
+
+void ReadRequestPlanner::AddRangeHeader(const FixedObject* apObj, const Range& arRange)
+{
+	static const QualifierCode CODES[] = { QC_1B_START_STOP, QC_2B_START_STOP, QC_4B_START_STOP };
+
+	Header h = { apObj, CODES[WidthOf(arRange.mStop) / 2], arRange.mStart, arRange.mStop, RangeHeaderSize(arRange) };
+	mHeaders.push_back(h);
+}
+
+void ReadRequestPlanner::AddIndexHeaders(const FixedObject* apObj, size_t aWidth, const std::vector<Range>& arRanges)
+{
+	static const QualifierCode CODES[] = { QC_1B_CNT_1B_INDEX, QC_2B_CNT_2B_INDEX, QC_4B_CNT_4B_INDEX };
+	static const size_t MAX_COUNT[] = { 0xFF, 0xFFFF, 0xFFFFFFFF };
+
+	size_t cls = aWidth / 2;
+	size_t start = mIndexList.size();
+	for(size_t i = 0; i < arRanges.size(); ++i) {
+		for(boost::uint32_t j = arRanges[i].mStart; j <= arRanges[i].mStop; ++j) mIndexList.push_back(j);
+	}
+
+	// the count field limits how many indices a single header can carry
+	while(start < mIndexList.size()) {
+		size_t count = std::min(mIndexList.size() - start, MAX_COUNT[cls]);
+		Header h = { apObj, CODES[cls], start, start + count, OBJ_HDR_SIZE + aWidth + count * aWidth };
+		mHeaders.push_back(h);
+		start += count;
+	}
+}
+
+void ReadRequestPlanner::Pack(size_t aCapacity)
+{
+	mPacked.clear();
+	mFragments.clear();
+
+	size_t used = aCapacity; // forces a new fragment for the first header
+	for(size_t i = 0; i < mHeaders.size(); ++i) {
+		const Header& h = mHeaders[i];
+
+		if(!IsIndexed(h.mCode)) {
+			if(used + h.mSize > aCapacity) {
+				mFragments.push_back(mPacked.size());
+				used = 0;
+			}
+			mPacked.push_back(h);
+			used += h.mSize;
+			continue;
+		}
+
+		// index lists are split across fragments instead of being moved whole
+		size_t width = IndexWidth(h.mCode);
+		size_t overhead = OBJ_HDR_SIZE + width;
+		size_t pos = h.mStart;
+		while(pos < h.mStop) {
+			if(used + overhead + width > aCapacity) {
+				mFragments.push_back(mPacked.size());
+				used = 0;
+			}
+			size_t count = std::min(h.mStop - pos, (aCapacity - used - overhead) / width);
+			Header part = { h.mpObj, h.mCode, pos, pos + count, overhead + count * width };
+			mPacked.push_back(part);
+			used += part.mSize;
+			pos += count;
+		}
+	}
+}
+
+size_t ReadRequestPlanner::WidthOf(boost::uint32_t aIndex)
+{
+	if(aIndex <= 0xFF) return 1;
+	if(aIndex <= 0xFFFF) return 2;
+	return 4;
+}
+
+size_t ReadRequestPlanner::RangeHeaderSize(const Range& arRange)
+{
+	return OBJ_HDR_SIZE + 2 * WidthOf(arRange.mStop);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,131 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __READ_REQUEST_PLANNER_H_
+#define __READ_REQUEST_PLANNER_H_
+
+#include <opendnp3/DNP3/APDUConstants.h>
+
+#include <boost/cstdint.hpp>
+
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+class APDU;
+class FixedObject;
+
+/**
+ * Builds READ requests for arbitrary sets of point indices.
+ *
+ * The indices requested for each object are sorted, de-duplicated and merged
+ * into contiguous runs. Each run is encoded either as its own start-stop
+ * header or as part of an index-prefixed list, whichever costs fewer bytes
+ * on the wire, and the resulting headers are packed into as many request
+ * fragments as are needed to stay within the maximum fragment size.
+ *
+ * The plan is computed lazily and reused until the point set or the
+ * fragment size changes, so polling the same points repeatedly only has to
+ * copy the headers into the APDU.
+ */
+class ReadRequestPlanner
+{
+public:
+
+	ReadRequestPlanner();
+
+	/// Removes all of the requested points
+	void Clear();
+
+	/// Adds points to read using the given object, duplicates are ignored
+	void AddPoints(const FixedObject* apObj, const std::vector<boost::uint32_t>& arIndices);
+
+	bool IsEmpty() const {
+		return mRequests.empty();
+	}
+
+	/**
+	 * Returns the number of request fragments needed to read all of the
+	 * points when aCapacity bytes are available for object headers.
+	 */
+	size_t NumFragments(size_t aCapacity);
+
+	/**
+	 * Writes the object headers of one request fragment. The APDU must
+	 * already be set to FC_READ.
+	 *
+	 * @param arAPDU		APDU to write the headers into
+	 * @param aFragment		fragment to write, [0, NumFragments())
+	 * @return				number of object headers written
+	 */
+	size_t Write(APDU& arAPDU, size_t aFragment);
+
+	/// Returns the number of bytes the object headers of a fragment take on the wire
+	size_t GetFragmentSize(size_t aCapacity, size_t aFragment);
+
+private:
+
+	struct Request {
+		const FixedObject* mpObj;
+		std::vector<boost::uint32_t> mIndices;
+	};
+
+	struct Range {
+		boost::uint32_t mStart;
+		boost::uint32_t mStop;
+	};
+
+	/**
+	 * A planned object header. Start-stop headers cover [mStart, mStop],
+	 * index-prefixed headers cover mIndexList[mStart, mStop).
+	 */
+	struct Header {
+		const FixedObject* mpObj;
+		QualifierCode mCode;
+		size_t mStart;
+		size_t mStop;
+		size_t mSize;
+	};
+
+	void Plan(size_t aCapacity);
+	void PlanObject(const Request& arRequest);
+	void AddRangeHeader(const FixedObject* apObj, const Range& arRange);
+	void AddIndexHeaders(const FixedObject* apObj, size_t aWidth, const std::vector<Range>& arRanges);
+	void Pack(size_t aCapacity);
+
+	static size_t WidthOf(boost::uint32_t aIndex);
+	static size_t RangeHeaderSize(const Range& arRange);
+
+	std::vector<Request> mRequests;
+
+	// cached plan, valid while mPlannedCapacity matches the requested capacity
+	size_t mPlannedCapacity;
+	std::vector<Header> mHeaders;
+	std::vector<Header> mPacked;
+	std::vector<size_t> mFragments;		// offset of the first header of each fragment in mPacked
+	std::vector<boost::uint32_t> mIndexList;
+};
+
+}
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include <opendnp3/DNP3/Objects.h>
 #include <opendnp3/DNP3/ResponseContext.h>
 #include <opendnp3/DNP3/SlaveResponseTypes.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
 #include <boost/bind.hpp>
 
@@ -55,6 +56,7 @@ ResponseContext::ResponseContext(Logger* apLogger, Database* apDB, SlaveResponse
 	mFIR(true),
 	mFIN(false),
 	mpRspTypes(apRspTypes),
+	mpStats(NULL),
 	mLoadedEventData(false)
 {}
 
@@ -78,6 +80,7 @@ void ResponseContext::Reset()
 void ResponseContext::ClearWritten()
 {
 	size_t written = mBuffer.ClearWritten();
+	if(mpStats) mpStats->mEventsTx.Increment(written);
 
 	size_t deselected = mBuffer.Deselect();
 
@@ -134,7 +137,7 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 		switch (MACRO_DNP_RADIX(hdr->GetGroup(), hdr->GetVariation())) {
 
 			case(MACRO_DNP_RADIX(1, 0)):
-				this->RecordStaticObjects<BinaryInfo>(mpRspTypes->mpStaticBinary, hdr);
+				this->RecordStaticObjects<BinaryInfo>(mpRspTypes->mpStaticBinary, hdr, mpRspTypes->mAutoVariations);
 				break;
 			case(MACRO_DNP_RADIX(1, 2)):
 				this->RecordStaticObjects<BinaryInfo>(Group1Var2::Inst(), hdr);
@@ -146,7 +149,7 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 				this->RecordStaticObjects<ControlStatusInfo>(Group10Var2::Inst(), hdr);
 				break;
 			case(MACRO_DNP_RADIX(20, 0)):
-				this->RecordStaticObjects<CounterInfo>(mpRspTypes->mpStaticCounter, hdr);
+				this->RecordStaticObjects<CounterInfo>(mpRspTypes->mpStaticCounter, hdr, mpRspTypes->mAutoVariations);
 				break;
 			case(MACRO_DNP_RADIX(20, 1)):
 				this->RecordStaticObjects<CounterInfo>(Group20Var1::Inst(), hdr);
@@ -173,7 +176,7 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 				this->RecordStaticObjects<CounterInfo>(Group20Var8::Inst(), hdr);
 				break;
 			case(MACRO_DNP_RADIX(30, 0)):
-				this->RecordStaticObjects<AnalogInfo>(mpRspTypes->mpStaticAnalog, hdr);
+				this->RecordStaticObjects<AnalogInfo>(mpRspTypes->mpStaticAnalog, hdr, mpRspTypes->mAutoVariations);
 				break;
 			case(MACRO_DNP_RADIX(30, 1)):
 				this->RecordStaticObjects<AnalogInfo>(Group30Var1::Inst(), hdr);
@@ -211,7 +214,7 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 
 				// event objects
 			case(MACRO_DNP_RADIX(2, 0)):
-				this->SelectEvents(PC_ALL_EVENTS, mpRspTypes->mpEventBinary, mBinaryEvents, GetEventCount(hdr.info()));
+				this->SelectEvents(PC_ALL_EVENTS, mpRspTypes->mpEventBinary, mBinaryEvents, GetEventCount(hdr.info()), mpRspTypes->mpEventBinaryCTO);
 				break;
 			case(MACRO_DNP_RADIX(22, 0)):
 				this->SelectEvents(PC_ALL_EVENTS, mpRspTypes->mpEventCounter, mCounterEvents, GetEventCount(hdr.info()));
@@ -233,9 +236,9 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 
 				// Class Objects
 			case(MACRO_DNP_RADIX(60, 1)):
-					this->RecordStaticObjects<BinaryInfo>(mpRspTypes->mpStaticBinary, hdr);
-					this->RecordStaticObjects<AnalogInfo>(mpRspTypes->mpStaticAnalog, hdr);
-					this->RecordStaticObjects<CounterInfo>(mpRspTypes->mpStaticCounter, hdr);
+					this->RecordStaticObjects<BinaryInfo>(mpRspTypes->mpStaticBinary, hdr, mpRspTypes->mAutoVariations);
+					this->RecordStaticObjects<AnalogInfo>(mpRspTypes->mpStaticAnalog, hdr, mpRspTypes->mAutoVariations);
+					this->RecordStaticObjects<CounterInfo>(mpRspTypes->mpStaticCounter, hdr, mpRspTypes->mAutoVariations);
 					this->RecordStaticObjects<ControlStatusInfo>(mpRspTypes->mpStaticControlStatus, hdr);
 					this->RecordStaticObjects<SetpointStatusInfo>(mpRspTypes->mpStaticSetpointStatus, hdr);
 				break;
@@ -270,7 +273,7 @@ void ResponseContext::SelectEvents(PointClass aClass, size_t aNum)
 		mTempIIN.SetEventBufferOverflow(true);
 	}
 
-	numBinaryEvents  = this->SelectEvents(aClass, mpRspTypes->mpEventBinary, mBinaryEvents, remain);
+	numBinaryEvents  = this->SelectEvents(aClass, mpRspTypes->mpEventBinary, mBinaryEvents, remain, mpRspTypes->mpEventBinaryCTO);
 	remain -= numBinaryEvents;
 
 	numAnalogEvents  = this->SelectEvents(aClass, mpRspTypes->mpEventAnalog, mAnalogEvents, remain);
@@ -349,6 +352,21 @@ void ResponseContext::LoadUnsol(APDU& arAPDU, const IINField& arIIN, ClassMask m
 	this->LoadEventData(arAPDU);
 }
 
+bool ResponseContext::WriteStaticBits(size_t aStart, size_t aStop, size_t aSlot, const ResponseKey& arKey, APDU& arAPDU)
+{
+	ObjectWriteIterator owi = arAPDU.WriteContiguous(Group1Var1::Inst(), aStart, aStop);
+
+	size_t count = owi.Remaining();
+	if(count > 0) mpDB->WriteStaticBits(aSlot, count, *owi);
+
+	if(aStart + count <= aStop) { // out of space in the fragment
+		this->mStaticWriteMap[arKey] = boost::bind(&ResponseContext::WriteStaticBits, this, aStart + count, aStop, aSlot + count, arKey, _1);
+		return false;
+	}
+
+	return true;
+}
+
 bool ResponseContext::LoadEventData(APDU& arAPDU)
 {
 	if (!this->LoadEvents<Binary>(arAPDU, mBinaryEvents)) return false;
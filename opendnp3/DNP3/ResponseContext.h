@@ -20,6 +20,7 @@
 
 #include <opendnp3/APL/Loggable.h>
 #include <opendnp3/DNP3/APDU.h>
+#include <opendnp3/DNP3/AutoVariation.h>
 #include <opendnp3/DNP3/ClassMask.h>
 #include <opendnp3/DNP3/DNPDatabaseTypes.h>
 #include <opendnp3/DNP3/Database.h>
@@ -38,6 +39,7 @@ class Database;
 class SlaveEventBuffer;
 class ObjectBase;
 class SlaveResponseTypes;
+class StackStatistics;
 
 
 /**
@@ -92,6 +94,11 @@ public:
 		return &mBuffer;
 	}
 
+	// Counts the events that have been sent and cleared, NULL to stop counting
+	void SetStatistics(StackStatistics* apStats) {
+		mpStats = apStats;
+	}
+
 	// Setup the response context with a new read request
 	IINField Configure(const APDU& arRequest);
 
@@ -152,18 +159,21 @@ private:
 	bool mFIR;
 	bool mFIN;
 	SlaveResponseTypes* mpRspTypes;
+	StackStatistics* mpStats;
 
 	IINField mTempIIN;
 	bool mLoadedEventData;
 
 	template<class T>
 	struct EventRequest {
-		EventRequest(const StreamObject<T>* apObj, size_t aCount = std::numeric_limits<size_t>::max()) :
+		EventRequest(const StreamObject<T>* apObj, size_t aCount = std::numeric_limits<size_t>::max(), const StreamObject<T>* apCTO = NULL) :
 			pObj(apObj),
+			pCTO(apCTO),
 			count(aCount)
 		{}
 
 		const StreamObject<T>* pObj;		// Type to use to write
+		const StreamObject<T>* pCTO;		// Relative time type to switch to if it's cheaper, NULL if none
 		size_t count;						// Number of events to read
 	};
 
@@ -182,6 +192,13 @@ private:
 	// the queue that tracks the pending static write operations
 	WriteMap mStaticWriteMap;
 
+	// scratch space for the populated runs of a static read, reused to avoid allocating per request
+	std::vector<IndexRun> mRuns;
+
+	// scratch space for choosing the variations of a run automatically
+	std::vector<boost::uint8_t> mRequirements;
+	std::vector<AutoSegment> mSegments;
+
 	typedef std::deque< EventRequest<Binary> >				BinaryEventQueue;
 	typedef std::deque< EventRequest<Analog> >				AnalogEventQueue;
 	typedef std::deque< EventRequest<Counter> >				CounterEventQueue;
@@ -202,7 +219,7 @@ private:
 	void SelectEvents(PointClass aClass, size_t aNum = std::numeric_limits<size_t>::max());
 
 	template <class T>
-	size_t SelectEvents(PointClass aClass, const StreamObject<T>* apObj, std::deque< EventRequest<T> >& arQueue, size_t aNum = std::numeric_limits<size_t>::max());
+	size_t SelectEvents(PointClass aClass, const StreamObject<T>* apObj, std::deque< EventRequest<T> >& arQueue, size_t aNum = std::numeric_limits<size_t>::max(), const StreamObject<T>* apCTO = NULL);
 
 	size_t SelectVtoEvents(PointClass aClass, const SizeByVariationObject* apObj, size_t aNum);
 
@@ -217,28 +234,39 @@ private:
 	template <class T>
 	size_t CalcPossibleCTO(typename EvtItr< EventInfo<T> >::Type aIter, size_t aMax);
 
+	// @return true if the next events of the request take fewer bytes with its relative time type
+	template <class T>
+	bool IsCheaperAsCTO(const EventRequest<T>& arRequest, typename EvtItr< EventInfo<T> >::Type aIter);
+
 	size_t IterateIndexed(VtoEventRequest& arRequest, VtoDataEventIter& arIter, APDU& arAPDU);
 
 
 	// Static write functions
 
+	// aAuto selects the variations per run of points, apObject is then the configured default
+	template <class T>
+	void RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter, bool aAuto = false);
+
 	template <class T>
-	void RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter);
+	void RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop, bool aAuto);
 
 	template <class T>
-	void RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop);
+	void RecordAutoObjects(StreamObject<typename T::MeasType>* apDefault, const IndexRun& arRun);
 
 	template <class T>
-	bool WriteStaticObjects(StreamObject<typename T::MeasType>* apObject, typename StaticIter<T>::Type& arStart, typename StaticIter<T>::Type& arStop, const ResponseKey& arKey, APDU& arAPDU);
+	bool WriteStaticObjects(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop, size_t aSlot, const ResponseKey& arKey, APDU& arAPDU);
+
+	// writes binaries as a Group1Var1 bitfield
+	bool WriteStaticBits(size_t aStart, size_t aStop, size_t aSlot, const ResponseKey& arKey, APDU& arAPDU);
 };
 
 template <class T>
-size_t ResponseContext::SelectEvents(PointClass aClass, const StreamObject<T>* apObj, std::deque< EventRequest<T> >& arQueue, size_t aNum)
+size_t ResponseContext::SelectEvents(PointClass aClass, const StreamObject<T>* apObj, std::deque< EventRequest<T> >& arQueue, size_t aNum, const StreamObject<T>* apCTO)
 {
 	size_t num = mBuffer.Select(Convert(T::MeasEnum), aClass, aNum);
 
 	if (num > 0) {
-		EventRequest<T> r(apObj, aNum);
+		EventRequest<T> r(apObj, aNum, apCTO);
 		arQueue.push_back(r);
 	}
 
@@ -246,7 +274,7 @@ size_t ResponseContext::SelectEvents(PointClass aClass, const StreamObject<T>* a
 }
 
 template <class T>
-void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter)
+void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* apObject, const HeaderReadIterator& arIter, bool aAuto)
 {
 	size_t num = mpDB->NumType(T::MeasType::MeasEnum);
 
@@ -255,7 +283,7 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 	{
 		case(OHT_ALL_OBJECTS):
 			{
-				if(num > 0) this->RecordStaticObjectsByRange<T>(apObject, 0, num - 1);
+				if(num > 0) this->RecordStaticObjectsByRange<T>(apObject, 0, mpDB->MaxIndex(T::MeasType::MeasEnum), aAuto);
 			}
 			break;
 
@@ -264,13 +292,13 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 		case(OHT_RANGED_8_OCTET):
 			{
 				if(num > 0) {
-					size_t max = num - 1;
+					size_t max = mpDB->MaxIndex(T::MeasType::MeasEnum);
 					RangeInfo ri;
 					const IRangeHeader* pHeader = reinterpret_cast<const IRangeHeader*>(arIter->GetHeader());
 					pHeader->GetRange(*arIter, ri);
 
 					if(ri.Start > max || ri.Stop > max || ri.Start > ri.Stop) this->mTempIIN.SetParameterError(true);
-					else this->RecordStaticObjectsByRange<T>(apObject, ri.Start, ri.Stop);
+					else this->RecordStaticObjectsByRange<T>(apObject, ri.Start, ri.Stop, aAuto);
 				}
 				else this->mTempIIN.SetParameterError(true);
 			}
@@ -281,14 +309,14 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 		case(OHT_COUNT_4_OCTET):
 			{
 				if(num > 0) {
-					size_t max = num - 1;
+					size_t max = mpDB->MaxIndex(T::MeasType::MeasEnum);
 					size_t count = reinterpret_cast<const ICountHeader*>(arIter->GetHeader())->GetCount(*arIter);
 					if(count > 0) {
 						size_t start = 0;
 						size_t stop = count - 1;
 
 						if(start > max || stop > max || start > stop) this->mTempIIN.SetParameterError(true);
-						else this->RecordStaticObjectsByRange<T>(apObject, start, stop);
+						else this->RecordStaticObjectsByRange<T>(apObject, start, stop, aAuto);
 					}
 					else this->mTempIIN.SetParameterError(true);
 				}
@@ -299,33 +327,72 @@ void ResponseContext::RecordStaticObjects(StreamObject<typename T::MeasType>* ap
 }
 
 template <class T>
-void ResponseContext::RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop)
+void ResponseContext::RecordStaticObjectsByRange(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop, bool aAuto)
 {
-	typename StaticIter<T>::Type first;
-	typename StaticIter<T>::Type last;
-	mpDB->Begin(first);
-	last = first + aStop;
-	first = first + aStart;
-	ResponseKey key(RT_STATIC, this->mStaticWriteMap.size());
-	WriteFunction func = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, apObject, first, last, key, _1);
-	this->mStaticWriteMap[key] = func;
+	// each populated run of indices is written as its own ranged header, so the
+	// gaps of a sparse database are skipped instead of reported as points
+	mRuns.clear();
+	mpDB->GetIndices(T::MeasType::MeasEnum).GetRuns(aStart, aStop, mRuns);
+	if(mRuns.empty()) this->mTempIIN.SetParameterError(true);
+
+	for(size_t i = 0; i < mRuns.size(); ++i) {
+		const IndexRun& r = mRuns[i];
+		if(aAuto) {
+			this->RecordAutoObjects<T>(apObject, r);
+			continue;
+		}
+
+		ResponseKey key(RT_STATIC, this->mStaticWriteMap.size());
+		WriteFunction func = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, apObject, r.mStart, r.Stop(), r.mSlot, key, _1);
+		this->mStaticWriteMap[key] = func;
+	}
 }
 
 template <class T>
-bool ResponseContext::WriteStaticObjects(StreamObject<typename T::MeasType>* apObject, typename StaticIter<T>::Type& arStart, typename StaticIter<T>::Type& arStop, const ResponseKey& arKey, APDU& arAPDU)
+void ResponseContext::RecordAutoObjects(StreamObject<typename T::MeasType>* apDefault, const IndexRun& arRun)
 {
-	size_t start = arStart->mIndex;
-	size_t stop = arStop->mIndex;
-	ObjectWriteIterator owi = arAPDU.WriteContiguous(apObject, start, stop);
+	typedef typename T::MeasType MeasType;
 
-	for(size_t i = start; i <= stop; ++i) {
-		if(owi.IsEnd()) { // out of space in the fragment
-			this->mStaticWriteMap[arKey] = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, apObject, arStart, arStop, arKey, _1);
-			return false;
-		}
-		apObject->Write(*owi, arStart->mValue);
-		++arStart; //increment the iterators
-		++owi;
+	const StaticPointStore<MeasType>* pStore;
+	mpDB->GetStore(pStore);
+
+	mRequirements.resize(arRun.mCount);
+	MeasType value;
+	for(size_t i = 0; i < arRun.mCount; ++i) {
+		pStore->Read(arRun.mSlot + i, value);
+		mRequirements[i] = AutoVariation::Classify(value.GetValue(), value.GetQuality());
+	}
+
+	size_t bits[AR_NUM];
+	AutoVariation::GetBitsPerPoint<MeasType>(apDefault, bits);
+	mSegments.clear();
+	AutoVariation::Segment(&mRequirements[0], arRun.mCount, arRun.mStart, bits, mSegments);
+
+	for(size_t i = 0; i < mSegments.size(); ++i) {
+		const AutoSegment& seg = mSegments[i];
+		size_t start = arRun.mStart + seg.mOffset;
+		size_t stop = start + seg.mCount - 1;
+		size_t slot = arRun.mSlot + seg.mOffset;
+
+		ResponseKey key(RT_STATIC, this->mStaticWriteMap.size());
+		StreamObject<MeasType>* pObj = AutoVariation::Select(apDefault, seg.mReq);
+		if(pObj == NULL) this->mStaticWriteMap[key] = boost::bind(&ResponseContext::WriteStaticBits, this, start, stop, slot, key, _1);
+		else this->mStaticWriteMap[key] = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, pObj, start, stop, slot, key, _1);
+	}
+}
+
+template <class T>
+bool ResponseContext::WriteStaticObjects(StreamObject<typename T::MeasType>* apObject, size_t aStart, size_t aStop, size_t aSlot, const ResponseKey& arKey, APDU& arAPDU)
+{
+	ObjectWriteIterator owi = arAPDU.WriteContiguous(apObject, aStart, aStop);
+
+	// the objects are contiguous, so they're copied from the database's cache of encoded points
+	size_t count = owi.Remaining();
+	if(count > 0) mpDB->WriteStatic(apObject, aSlot, count, *owi);
+
+	if(aStart + count <= aStop) { // out of space in the fragment
+		this->mStaticWriteMap[arKey] = boost::bind(&ResponseContext::WriteStaticObjects<T>, this, apObject, aStart + count, aStop, aSlot + count, arKey, _1);
+		return false;
 	}
 
 	return true;
@@ -354,6 +421,12 @@ bool ResponseContext::LoadEvents(APDU& arAPDU, std::deque< EventRequest<T> >& ar
 			r.count = remain;
 		}
 
+		// pick between absolute and relative time once, when the request is first written
+		if (r.pCTO != NULL) {
+			if (this->IsCheaperAsCTO<T>(r, itr)) r.pObj = r.pCTO;
+			r.pCTO = NULL;
+		}
+
 		LOG_BLOCK(LEV_DEBUG, "[" << __LINE__ << "] r.pObj->UseCTO() = " << r.pObj->UseCTO());
 
 		size_t written = r.pObj->UseCTO() ? this->IterateCTO<T>(r.pObj, r.count, itr, arAPDU) : this->IterateIndexed<T>(r, itr, arAPDU);
@@ -425,6 +498,17 @@ size_t ResponseContext::CalcPossibleCTO(typename EvtItr< EventInfo<T> >::Type aI
 	return num;
 }
 
+template <class T>
+bool ResponseContext::IsCheaperAsCTO(const EventRequest<T>& arRequest, typename EvtItr< EventInfo<T> >::Type aIter)
+{
+	// each relative time header is preceded by a Group51Var1 object with a 1 byte count header
+	const size_t CTO_OVERHEAD = 4 + Group51Var1::Inst()->GetSize();
+
+	size_t num = this->CalcPossibleCTO<T>(aIter, arRequest.count);
+	size_t saved = arRequest.pObj->GetSize() - arRequest.pCTO->GetSize();
+	return num * saved > CTO_OVERHEAD;
+}
+
 // T is the point info type
 template <class T>
 size_t ResponseContext::IterateCTO(const StreamObject<T>* apObj, size_t aCount, typename EvtItr< EventInfo<T> >::Type& arIter, APDU& arAPDU)
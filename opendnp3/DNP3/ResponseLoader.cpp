@@ -21,124 +21,131 @@
 #include <opendnp3/DNP3/Objects.h>
 #include <opendnp3/DNP3/ResponseLoader.h>
 
+#include <assert.h>
+
 namespace apl
 {
 namespace dnp
 {
 
-ResponseLoader::ResponseLoader(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader) :
+ResponseLoader::ResponseLoader(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader, StackStatistics* apStats, ResponseBatches* apBatches) :
 	Loggable(apLogger),
 	mpPublisher(apPublisher),
 	mpVtoReader(apVtoReader),
-	mTransaction(apPublisher)
+	mpStats(apStats),
+	mTransaction(apPublisher),
+	mpBatches(apBatches == NULL ? &mOwnBatches : apBatches)
 {}
 
-void ResponseLoader::Process(HeaderReadIterator& arIter)
+ResponseLoader::DispatchTable::DispatchTable()
 {
-	int grp = arIter->GetGroup();
-	int var = arIter->GetVariation();
+	for(size_t i = 0; i < 256; ++i) {
+		for(size_t j = 0; j < 256; ++j) mSlots[i][j] = 0;
+	}
+	mFuncs.push_back(&ResponseLoader::ReadUnsupported);
+
+	// Control Status
+	this->Add<Group10Var2>(&ResponseLoader::Read<Group10Var2>);
+
+	// Binary
+	this->Add<Group1Var1>(&ResponseLoader::ReadBitfield<Group1Var1>);
+	this->Add<Group1Var2>(&ResponseLoader::Read<Group1Var2>);
+	this->Add<Group2Var1>(&ResponseLoader::Read<Group2Var1>);
+	this->Add<Group2Var2>(&ResponseLoader::Read<Group2Var2>);
+	this->Add<Group2Var3>(&ResponseLoader::Read<Group2Var3>);
+
+	// Counters
+	this->Add<Group20Var1>(&ResponseLoader::Read<Group20Var1>);
+	this->Add<Group20Var2>(&ResponseLoader::Read<Group20Var2>);
+	this->Add<Group20Var3>(&ResponseLoader::Read<Group20Var3>);
+	this->Add<Group20Var4>(&ResponseLoader::Read<Group20Var4>);
+	this->Add<Group20Var5>(&ResponseLoader::Read<Group20Var5>);
+	this->Add<Group20Var6>(&ResponseLoader::Read<Group20Var6>);
+	this->Add<Group20Var7>(&ResponseLoader::Read<Group20Var7>);
+	this->Add<Group20Var8>(&ResponseLoader::Read<Group20Var8>);
+
+	this->Add<Group22Var1>(&ResponseLoader::Read<Group22Var1>);
+	this->Add<Group22Var2>(&ResponseLoader::Read<Group22Var2>);
+	this->Add<Group22Var3>(&ResponseLoader::Read<Group22Var3>);
+	this->Add<Group22Var4>(&ResponseLoader::Read<Group22Var4>);
+
+	// Analogs
+	this->Add<Group30Var1>(&ResponseLoader::Read<Group30Var1>);
+	this->Add<Group30Var2>(&ResponseLoader::Read<Group30Var2>);
+	this->Add<Group30Var3>(&ResponseLoader::Read<Group30Var3>);
+	this->Add<Group30Var4>(&ResponseLoader::Read<Group30Var4>);
+	this->Add<Group30Var5>(&ResponseLoader::Read<Group30Var5>);
+	this->Add<Group30Var6>(&ResponseLoader::Read<Group30Var6>);
+
+	this->Add<Group32Var1>(&ResponseLoader::Read<Group32Var1>);
+	this->Add<Group32Var2>(&ResponseLoader::Read<Group32Var2>);
+	this->Add<Group32Var3>(&ResponseLoader::Read<Group32Var3>);
+	this->Add<Group32Var4>(&ResponseLoader::Read<Group32Var4>);
+	this->Add<Group32Var5>(&ResponseLoader::Read<Group32Var5>);
+	this->Add<Group32Var6>(&ResponseLoader::Read<Group32Var6>);
+	this->Add<Group32Var7>(&ResponseLoader::Read<Group32Var7>);
+	this->Add<Group32Var8>(&ResponseLoader::Read<Group32Var8>);
+
+	// Setpoint Status
+	this->Add<Group40Var1>(&ResponseLoader::Read<Group40Var1>);
+	this->Add<Group40Var2>(&ResponseLoader::Read<Group40Var2>);
+	this->Add<Group40Var3>(&ResponseLoader::Read<Group40Var3>);
+	this->Add<Group40Var4>(&ResponseLoader::Read<Group40Var4>);
+
+	// CTO
+	this->Add<Group51Var1>(&ResponseLoader::ReadCTO<Group51Var1>);
+	this->Add<Group51Var2>(&ResponseLoader::ReadCTO<Group51Var2>);
+
+	// Virtual Terminal Objects, the variation is the size of the data
+	this->AddGroup(112, &ResponseLoader::ReadVto);
+	this->AddGroup(113, &ResponseLoader::ReadVto);
+}
 
-	this->ProcessData(arIter, grp, var);
+void ResponseLoader::DispatchTable::Add(int aGrp, int aVar, ReadFunc aFunc)
+{
+	size_t slot = 0;
+	while(slot < mFuncs.size() && mFuncs[slot] != aFunc) ++slot;
+	if(slot == mFuncs.size()) mFuncs.push_back(aFunc);
 
-	mCTO.NextHeader();
+	assert(slot < 256);
+	mSlots[aGrp][aVar] = static_cast<boost::uint8_t>(slot);
 }
 
-void ResponseLoader::ProcessData(HeaderReadIterator& arIter, int aGrp, int aVar)
+void ResponseLoader::DispatchTable::AddGroup(int aGrp, ReadFunc aFunc)
 {
-	/*
-	 * These objects require matching on both the aGrp and aVar fields.
-	 */
-	switch (MACRO_DNP_RADIX(aGrp, aVar)) {
-		// Control Status
-	case (MACRO_DNP_RADIX(10, 2)): this->Read(arIter, Group10Var2::Inst()); break;
-
-		// Binary
-	case (MACRO_DNP_RADIX(1, 1)): this->ReadBitfield<Group1Var1>(arIter); break;
-
-	case (MACRO_DNP_RADIX(1, 2)): this->Read(arIter, Group1Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(2, 1)): this->Read(arIter, Group2Var1::Inst()); break;
-	case (MACRO_DNP_RADIX(2, 2)): this->Read(arIter, Group2Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(2, 3)): this->Read(arIter, Group2Var3::Inst()); break;
-
-		// Counters
-	case (MACRO_DNP_RADIX(20, 1)): this->Read(arIter, Group20Var1::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 2)): this->Read(arIter, Group20Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 3)): this->Read(arIter, Group20Var3::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 4)): this->Read(arIter, Group20Var4::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 5)): this->Read(arIter, Group20Var5::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 6)): this->Read(arIter, Group20Var6::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 7)): this->Read(arIter, Group20Var7::Inst()); break;
-	case (MACRO_DNP_RADIX(20, 8)): this->Read(arIter, Group20Var8::Inst()); break;
-
-	case (MACRO_DNP_RADIX(22, 1)): this->Read(arIter, Group22Var1::Inst()); break;
-	case (MACRO_DNP_RADIX(22, 2)): this->Read(arIter, Group22Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(22, 3)): this->Read(arIter, Group22Var3::Inst()); break;
-	case (MACRO_DNP_RADIX(22, 4)): this->Read(arIter, Group22Var4::Inst()); break;
-
-		// Analogs
-	case (MACRO_DNP_RADIX(30, 1)): this->Read(arIter, Group30Var1::Inst()); break;
-	case (MACRO_DNP_RADIX(30, 2)): this->Read(arIter, Group30Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(30, 3)): this->Read(arIter, Group30Var3::Inst()); break;
-	case (MACRO_DNP_RADIX(30, 4)): this->Read(arIter, Group30Var4::Inst()); break;
-	case (MACRO_DNP_RADIX(30, 5)): this->Read(arIter, Group30Var5::Inst()); break;
-	case (MACRO_DNP_RADIX(30, 6)): this->Read(arIter, Group30Var6::Inst()); break;
-
-	case (MACRO_DNP_RADIX(32, 1)): this->Read(arIter, Group32Var1::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 2)): this->Read(arIter, Group32Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 3)): this->Read(arIter, Group32Var3::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 4)): this->Read(arIter, Group32Var4::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 5)): this->Read(arIter, Group32Var5::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 6)): this->Read(arIter, Group32Var6::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 7)): this->Read(arIter, Group32Var7::Inst()); break;
-	case (MACRO_DNP_RADIX(32, 8)): this->Read(arIter, Group32Var8::Inst()); break;
-
-		// Setpoint Status
-	case (MACRO_DNP_RADIX(40, 1)): this->Read(arIter, Group40Var1::Inst()); break;
-	case (MACRO_DNP_RADIX(40, 2)): this->Read(arIter, Group40Var2::Inst()); break;
-	case (MACRO_DNP_RADIX(40, 3)): this->Read(arIter, Group40Var3::Inst()); break;
-	case (MACRO_DNP_RADIX(40, 4)): this->Read(arIter, Group40Var4::Inst()); break;
-
-		// CTO
-	case (MACRO_DNP_RADIX(51, 1)): this->ReadCTO<Group51Var1>(arIter); break;
-	case (MACRO_DNP_RADIX(51, 2)): this->ReadCTO<Group51Var2>(arIter); break;
-
-	default:
-		this->ProcessSizeByVariation(arIter, aGrp, aVar);
-		break;
-	}
+	for(int var = 0; var < 256; ++var) this->Add(aGrp, var, aFunc);
 }
 
-void ResponseLoader::ProcessSizeByVariation(HeaderReadIterator& arIter, int aGrp, int aVar)
+const ResponseLoader::DispatchTable& ResponseLoader::Table()
 {
-	/*
-	 * These objects only require matching on the aGrp field.
-	 */
-	switch (aGrp) {
-		/* Virtual Terminal Objects */
-	case (112): this->ReadVto(arIter, Group112Var0::Inst()); break;
-	case (113): this->ReadVto(arIter, Group113Var0::Inst()); break;
-
-	default:
-		/*
-		* If we reach this point, then we don't yet support this object type.
-		*/
-		ERROR_BLOCK(LEV_WARNING,
-		            "Group: " << aGrp << " "
-		            "Var: " << aVar << " "
-		            "does not map to a data type", MERR_UNSUPPORTED_OBJECT_TYPE);
-		break;
-	}
+	static DispatchTable table;
+	return table;
+}
+
+void ResponseLoader::Process(HeaderReadIterator& arIter)
+{
+	boost::uint8_t grp = static_cast<boost::uint8_t>(arIter->GetGroup());
+	boost::uint8_t var = static_cast<boost::uint8_t>(arIter->GetVariation());
+
+	ReadFunc func = Table().Get(grp, var);
+	(this->*func)(arIter);
+
+	mCTO.NextHeader();
 }
 
-void ResponseLoader::ReadVto(HeaderReadIterator& arIter, SizeByVariationObject* apObj)
+void ResponseLoader::ReadUnsupported(HeaderReadIterator& arIter)
+{
+	ERROR_BLOCK(LEV_WARNING,
+	            "Group: " << arIter->GetGroup() << " "
+	            "Var: " << arIter->GetVariation() << " "
+	            "does not map to a data type", MERR_UNSUPPORTED_OBJECT_TYPE);
+}
+
+void ResponseLoader::ReadVto(HeaderReadIterator& arIter)
 {
 	/* Get an iterator to the object data */
 	ObjectReadIterator objIter = arIter.BeginRead();
 
-	/* Copy the object data to a VtoData instance */
-	VtoData data;
-	data.Copy(*objIter, arIter->GetVariation());
-
 	/* Determine the Virtual Terminal port/channel number */
 	size_t index = objIter->Index();
 	if(index > std::numeric_limits<boost::uint8_t>::max()) {
@@ -147,6 +154,9 @@ void ResponseLoader::ReadVto(HeaderReadIterator& arIter, SizeByVariationObject*
 	else {
 		boost::uint8_t channel = static_cast<boost::uint8_t>(index);
 		Transaction t(mpVtoReader);
+
+		/* Copy the object data into the reader's ring, the chunk is passed on by reference */
+		VtoData data = this->mpVtoReader->CopyData(*objIter, arIter->GetVariation());
 		this->mpVtoReader->Update(data, channel);
 	}
 }
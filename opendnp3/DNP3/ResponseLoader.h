@@ -18,6 +18,7 @@
 #ifndef __RESPONSE_LOADER_H_
 #define __RESPONSE_LOADER_H_
 
+#include <opendnp3/APL/DataBatch.h>
 #include <opendnp3/APL/DataInterfaces.h>
 #include <opendnp3/APL/Loggable.h>
 #include <opendnp3/APL/Logger.h>
@@ -25,8 +26,11 @@
 #include <opendnp3/DNP3/CTOHistory.h>
 #include <opendnp3/DNP3/ObjectInterfaces.h>
 #include <opendnp3/DNP3/ObjectReadIterator.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 #include <opendnp3/DNP3/VtoReader.h>
 
+#include <vector>
+
 namespace apl
 {
 namespace dnp
@@ -34,6 +38,41 @@ namespace dnp
 
 class HeaderReadIterator;
 
+/**
+ * Storage for the values of each header that a ResponseLoader passes to
+ * the observer. The batches are cleared and refilled for every header, so
+ * an owner that outlives the loaders (Master, DataPoll) only allocates
+ * when a header is larger than any before it.
+ */
+class ResponseBatches
+{
+public:
+
+	void GetBatch(DataBatch<Binary>*& arpBatch) {
+		arpBatch = &mBinaries;
+	}
+	void GetBatch(DataBatch<Analog>*& arpBatch) {
+		arpBatch = &mAnalogs;
+	}
+	void GetBatch(DataBatch<Counter>*& arpBatch) {
+		arpBatch = &mCounters;
+	}
+	void GetBatch(DataBatch<ControlStatus>*& arpBatch) {
+		arpBatch = &mControlStatii;
+	}
+	void GetBatch(DataBatch<SetpointStatus>*& arpBatch) {
+		arpBatch = &mSetpointStatii;
+	}
+
+private:
+
+	DataBatch<Binary> mBinaries;
+	DataBatch<Analog> mAnalogs;
+	DataBatch<Counter> mCounters;
+	DataBatch<ControlStatus> mControlStatii;
+	DataBatch<SetpointStatus> mSetpointStatii;
+};
+
 /**
  * Dedicated class for processing response data in the master.
  */
@@ -47,16 +86,23 @@ public:
 	 * 						message reporting
 	 * @param apPublisher	the IDataObserver for any responses that match
 	 * @param apVtoReader	the VtoReader for any responses that match
+	 * @param apStats		optional statistics that count the received
+	 * 						events and record their age
+	 * @param apBatches		optional storage for the values of each
+	 * 						header that outlives the loader
 	 *
 	 * @return				a new ResponseLoader instance
 	 */
 	ResponseLoader(Logger* log,
 	               IDataObserver* apPublisher,
-	               VtoReader* apVtoReader);
+	               VtoReader* apVtoReader,
+	               StackStatistics* apStats = NULL,
+	               ResponseBatches* apBatches = NULL);
 
 	/**
 	 * Processes a DNP3 object received by the Master.  The real heavy
-	 * lifting is done in ResponseLoader::ProcessData().
+	 * lifting is done by the read function that the dispatch
+	 * table maps the group/variation of the header to.
 	 *
 	 * @param itr			the header iterator that provides access to
 	 * 						the group, variation, data, etc.
@@ -65,36 +111,54 @@ public:
 
 private:
 
+	typedef void (ResponseLoader::*ReadFunc)(HeaderReadIterator&);
+
 	/**
-	 * Processes the data field of a DNP3 object received by the Master.
-	 * This function multiplexes objects to the Read(), ReadBitfield(), or
-	 * ReadCTO() as is appropriate for the group/variation tuple.
-	 *
-	 * @param itr		the header iterator that provides access to the
-	 * 					group, variation, data, etc.
-	 * @param aGrp		the DNP3 group object id
-	 * @param aVar		the DNP3 variation object id
+	 * Lookup table from every group/variation pair to the function that
+	 * reads it. The table is built once, so dispatching a header is two
+	 * array lookups regardless of how many object types are supported.
 	 */
-	void ProcessData(HeaderReadIterator& itr, int aGrp, int aVar);
+	class DispatchTable
+	{
+	public:
 
-	/**
-	* Processes size by variation objects received by the master.  The
-	* variation id ('aVar') is the size of the data object.
-	*
-	* @param itr		the header iterator that provides access to the
-	* 					group, variation, data, etc.
-	* @param aGrp		the DNP3 group object id
-	* @param aVar		the DNP3 variation id
-	*/
-	void ProcessSizeByVariation(HeaderReadIterator& itr, int aGrp, int aVar);
-
-	template <class T>
-	void Read(HeaderReadIterator& arIter, StreamObject<T>* apObj);
-
-	template <class T>
-	void ReadBitfield(HeaderReadIterator& arHeader);
-
-	template <class T>
+		DispatchTable();
+
+		ReadFunc Get(boost::uint8_t aGrp, boost::uint8_t aVar) const {
+			return mFuncs[mSlots[aGrp][aVar]];
+		}
+
+	private:
+
+		template <class ObjType>
+		void Add(ReadFunc aFunc) {
+			this->Add(ObjType::Inst()->GetGroup(), ObjType::Inst()->GetVariation(), aFunc);
+		}
+
+		void Add(int aGrp, int aVar, ReadFunc aFunc);
+
+		/// Size by variation objects, every variation maps to the same function
+		void AddGroup(int aGrp, ReadFunc aFunc);
+
+		boost::uint8_t mSlots[256][256];	// index into mFuncs, 0 is unsupported
+		std::vector<ReadFunc> mFuncs;
+	};
+
+	static const DispatchTable& Table();
+
+	/*
+	 * The read functions are instantiated with the concrete object type and
+	 * call its members with qualified names, so decoding an object does not
+	 * go through the virtual interface of the object.
+	 */
+
+	template <class ObjType>
+	void Read(HeaderReadIterator& arIter);
+
+	template <class ObjType>
+	void ReadBitfield(HeaderReadIterator& arIter);
+
+	template <class ObjType>
 	void ReadCTO(HeaderReadIterator& arIter);
 
 	/**
@@ -104,10 +168,11 @@ private:
 	 *
 	 * @param arIter	the header iterator that provides access to the
 	 * 					group, variation, data, etc.
-	 * @param apObj		the pointer to the DNP3 object instance that can
-	 * 					read/write the byte stream
 	 */
-	void ReadVto(HeaderReadIterator& arIter, SizeByVariationObject* apObj);
+	void ReadVto(HeaderReadIterator& arIter);
+
+	/// Logs a warning for objects that don't map to a data type
+	void ReadUnsupported(HeaderReadIterator& arIter);
 
 	IDataObserver* mpPublisher;
 
@@ -117,12 +182,17 @@ private:
 	 */
 	VtoReader* mpVtoReader;
 
+	StackStatistics* mpStats;
+
 	Transaction mTransaction;
 
 	CTOHistory mCTO;
+
+	ResponseBatches mOwnBatches;	// used when no batches are lent to the loader
+	ResponseBatches* mpBatches;
 };
 
-template <class T>
+template <class ObjType>
 void ResponseLoader::ReadCTO(HeaderReadIterator& arIter)
 {
 	ObjectReadIterator i = arIter.BeginRead();
@@ -132,58 +202,89 @@ void ResponseLoader::ReadCTO(HeaderReadIterator& arIter)
 		return;
 	}
 
-	TimeStamp_t t = static_cast<TimeStamp_t>(T::Inst()->mTime.Get(*i));
+	TimeStamp_t t = static_cast<TimeStamp_t>(ObjType::Inst()->mTime.Get(*i));
 	mCTO.SetCTO(t);
 }
 
-template <class T>
-void ResponseLoader::Read(HeaderReadIterator& arIter, StreamObject<T>* apObj)
+template <class ObjType>
+void ResponseLoader::Read(HeaderReadIterator& arIter)
 {
+	typedef typename ObjType::DataType T;
+
+	const ObjType* pObj = ObjType::Inst();
+	const bool useCTO = pObj->ObjType::UseCTO();
+	const bool hasQuality = pObj->ObjType::HasQuality();
+	const bool isEvent = (mpStats != NULL) && pObj->ObjType::IsEvent();
+
 	TimeStamp_t t(0); //base time
-	if (apObj->UseCTO() && !mCTO.GetCTO(t)) {
+	if (useCTO && !mCTO.GetCTO(t)) {
 		LOG_BLOCK(LEV_ERROR,
-		          "No CTO for relative time type " << apObj->Name());
+		          "No CTO for relative time type " << pObj->Name());
 		return;
 	}
 
 	ObjectReadIterator obj = arIter.BeginRead();
 	LOG_BLOCK(LEV_INTERPRET,
-	          "Converting " << obj.Count() << " " << apObj->Name() << " "
+	          "Converting " << obj.Count() << " " << pObj->Name() << " "
 	          "To " << typeid(T).name());
 
+	DataBatch<T>* pBatch;
+	mpBatches->GetBatch(pBatch);
+	pBatch->Clear();
+	pBatch->Reserve(obj.Count());
+
+	TimeStamp_t now(0);
+	if (isEvent) {
+		mpStats->mEventsRx.Increment(obj.Count());
+		now = mpStats->Now();
+	}
+
 	for ( ; !obj.IsEnd(); ++obj) {
-		size_t index = obj->Index();
-		T value = apObj->Read(*obj);
+		T value = pObj->ObjType::Read(*obj);
 
 		/* Make sure the value has time information */
-		if (apObj->UseCTO()) {
+		if (useCTO) {
 			value.SetTime(t + value.GetTime());
 		}
 
+		/* Events without time can't be aged */
+		if (isEvent && value.GetTime() != 0) {
+			mpStats->mEventAge.Record(now - value.GetTime());
+		}
+
 		/* Make sure the value has quality information */
-		if (!apObj->HasQuality()) {
+		if (!hasQuality) {
 			value.SetQuality(T::ONLINE);
 		}
 
-		mpPublisher->Update(value, index);
+		pBatch->Add(value, obj->Index());
 	}
+
+	pBatch->Flush(mpPublisher);
 }
 
-template <class T>
+template <class ObjType>
 void ResponseLoader::ReadBitfield(HeaderReadIterator& arIter)
 {
 	Binary b; b.SetQuality(Binary::ONLINE);
 
 	ObjectReadIterator obj = arIter.BeginRead();
 	LOG_BLOCK(LEV_INTERPRET,
-	          "Converting " << obj.Count() << " " << T::Inst()->Name() << " "
+	          "Converting " << obj.Count() << " " << ObjType::Inst()->Name() << " "
 	          "To " << typeid(b).name());
 
+	DataBatch<Binary>* pBatch;
+	mpBatches->GetBatch(pBatch);
+	pBatch->Clear();
+	pBatch->Reserve(obj.Count());
+
 	for (; !obj.IsEnd(); ++obj) {
 		bool val = BitfieldObject::StaticRead(*obj, obj->Start(), obj->Index());
 		b.SetValue(val);
-		mpPublisher->Update(b, obj->Index());
+		pBatch->Add(b, obj->Index());
 	}
+
+	pBatch->Flush(mpPublisher);
 }
 
 }
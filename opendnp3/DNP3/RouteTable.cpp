@@ -0,0 +1,106 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/RouteTable.h>
+
+#include <assert.h>
+
+namespace apl
+{
+namespace dnp
+{
+
+// slots allocated when the first route is added
+static const unsigned MIN_BITS = 4;
+
+RouteTable::RouteTable() :
+	mMask(0),
+	mShift(32),
+	mSize(0)
+{}
+
+bool RouteTable::Insert(const LinkRoute& arRoute, ILinkContext* apContext)
+{
+	assert(apContext != NULL);
+	if(this->Find(arRoute) != NULL) return false;
+
+	// keep the table at most half full
+	if(2 * (mSize + 1) > mSlots.size()) this->Grow();
+
+	boost::uint32_t key = Pack(arRoute);
+	size_t i = this->Home(key);
+	while(mSlots[i].mpContext != NULL) i = (i + 1) & mMask;
+
+	mSlots[i].mKey = key;
+	mSlots[i].mpContext = apContext;
+	mSlots[i].mCounters = RouteCounters();
+	++mSize;
+	return true;
+}
+
+ILinkContext* RouteTable::Erase(const LinkRoute& arRoute)
+{
+	Entry* pEntry = this->Find(arRoute);
+	if(pEntry == NULL) return NULL;
+
+	ILinkContext* pContext = pEntry->mpContext;
+	size_t hole = pEntry - &mSlots[0];
+
+	// shift back the entries of the run that follows whose home is at or before the hole
+	for(size_t j = (hole + 1) & mMask; mSlots[j].mpContext != NULL; j = (j + 1) & mMask) {
+		size_t home = this->Home(mSlots[j].mKey);
+		bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+		if(!stays) {
+			mSlots[hole] = mSlots[j];
+			hole = j;
+		}
+	}
+
+	mSlots[hole] = Entry();
+	--mSize;
+	return pContext;
+}
+
+void RouteTable::GetContexts(std::vector<ILinkContext*>& arContexts) const
+{
+	for(size_t i = 0; i < mSlots.size(); ++i) {
+		if(mSlots[i].mpContext != NULL) arContexts.push_back(mSlots[i].mpContext);
+	}
+}
+
+void RouteTable::Grow()
+{
+	unsigned bits = mSlots.empty() ? MIN_BITS : (32 - mShift) + 1;
+
+	std::vector<Entry> old(static_cast<size_t>(1) << bits);
+	old.swap(mSlots);
+	mMask = mSlots.size() - 1;
+	mShift = 32 - bits;
+
+	for(size_t i = 0; i < old.size(); ++i) {
+		if(old[i].mpContext == NULL) continue;
+		size_t j = this->Home(old[i].mKey);
+		while(mSlots[j].mpContext != NULL) j = (j + 1) & mMask;
+		mSlots[j] = old[i];
+	}
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
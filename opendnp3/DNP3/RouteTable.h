@@ -0,0 +1,123 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __ROUTE_TABLE_H_
+#define __ROUTE_TABLE_H_
+
+#include <opendnp3/DNP3/LinkRoute.h>
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+class ILinkContext;
+
+/// Frames routed to and from a context since it was bound
+struct RouteCounters {
+	RouteCounters() : mNumRx(0), mNumTx(0)
+	{}
+
+	boost::uint64_t mNumRx;
+	boost::uint64_t mNumTx;
+};
+
+/**
+ * Flat hash table from a link route to the context bound to it, used by the
+ * router to dispatch every received frame.
+ *
+ * The key is the route packed into 32 bits. Slots are probed linearly in a
+ * power of two array that is kept at most half full, and erased slots are
+ * filled by shifting the following entries back, so lookups stay short no
+ * matter how many contexts have come and gone. A lookup is a multiply, a
+ * shift and usually a single compare, instead of a walk down a tree with
+ * two compares per node.
+ *
+ * Pointers returned by Find() are invalidated by Insert() and Erase().
+ */
+class RouteTable
+{
+public:
+
+	struct Entry {
+		Entry() : mKey(0), mpContext(NULL)
+		{}
+
+		boost::uint32_t mKey;
+		ILinkContext* mpContext;	// NULL if the slot is empty
+		RouteCounters mCounters;
+	};
+
+	RouteTable();
+
+	static boost::uint32_t Pack(const LinkRoute& arRoute) {
+		return (static_cast<boost::uint32_t>(arRoute.remote) << 16) | arRoute.local;
+	}
+
+	/// @return the entry of a route or NULL if it isn't bound
+	Entry* Find(const LinkRoute& arRoute) {
+		if(mSize == 0) return NULL;
+		boost::uint32_t key = Pack(arRoute);
+		for(size_t i = this->Home(key); mSlots[i].mpContext != NULL; i = (i + 1) & mMask) {
+			if(mSlots[i].mKey == key) return &mSlots[i];
+		}
+		return NULL;
+	}
+
+	/// @return false if the route is already bound
+	bool Insert(const LinkRoute& arRoute, ILinkContext* apContext);
+
+	/// @return the context the route was bound to, NULL if it wasn't bound
+	ILinkContext* Erase(const LinkRoute& arRoute);
+
+	/// Appends every bound context to arContexts, so that they can be called back while the table changes
+	void GetContexts(std::vector<ILinkContext*>& arContexts) const;
+
+	size_t Size() const {
+		return mSize;
+	}
+
+	size_t Capacity() const {
+		return mSlots.size();
+	}
+
+private:
+
+	size_t Home(boost::uint32_t aKey) const {
+		// Fibonacci hashing, the high bits of the product mix all the bits of the key
+		return static_cast<boost::uint32_t>(aKey * 2654435769U) >> mShift;
+	}
+
+	void Grow();
+
+	std::vector<Entry> mSlots;
+	size_t mMask;
+	unsigned mShift;
+	size_t mSize;
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -2,6 +2,8 @@
 #include <opendnp3/DNP3/ScanScheduler.h>
 #include <opendnp3/APL/DataTypes.h>
 
+#include <boost/bind.hpp>
+
 namespace apl {
 namespace dnp {
 
@@ -16,7 +18,7 @@ void ScanScheduler::ScheduleOnDemandPoll(void)
     return;
 }
 
-void ScanScheduler::ScheduleFreeFormPoll(std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> ffInputPoints)
+void ScanScheduler::ScheduleFreeFormPoll(const FreeFormPoints& ffInputPoints)
 {
     /*** Issue free form pool ***/
     LOG_BLOCK(LEV_DEBUG, "Schedule Free Form Poll. #points" << ffInputPoints.size() << " : " );
@@ -27,5 +29,52 @@ void ScanScheduler::ScheduleFreeFormPoll(std::unordered_map<apl::DataTypes, std:
     return;
 }
 
+std::future<void> ScanScheduler::PostOnDemandPoll(void)
+{
+    PromisePtr pPromise(new std::promise<void>());
+    this->PostOnDemandPoll(boost::bind(&ScanScheduler::Fulfill, pPromise));
+    return pPromise->get_future();
+}
+
+void ScanScheduler::PostOnDemandPoll(const CompletionHandler& arHandler)
+{
+    LOG_BLOCK(LEV_DEBUG, "Post On Demand Integrity Poll.");
+
+    mpTimerSrc->Post(boost::bind(&ScanScheduler::OnDemandPoll, this, arHandler));
+}
+
+std::future<void> ScanScheduler::PostFreeFormPoll(const FreeFormPoints& ffInputPoints)
+{
+    PromisePtr pPromise(new std::promise<void>());
+    this->PostFreeFormPoll(ffInputPoints, boost::bind(&ScanScheduler::Fulfill, pPromise));
+    return pPromise->get_future();
+}
+
+void ScanScheduler::PostFreeFormPoll(const FreeFormPoints& ffInputPoints, const CompletionHandler& arHandler)
+{
+    LOG_BLOCK(LEV_DEBUG, "Post Free Form Poll. #points" << ffInputPoints.size() << " : " );
+
+    // the points are copied once into a shared, read-only descriptor so the caller is free to reuse them
+    FreeFormDescriptor pPoints(new FreeFormPoints(ffInputPoints));
+    mpTimerSrc->Post(boost::bind(&ScanScheduler::FreeFormPoll, this, pPoints, arHandler));
+}
+
+void ScanScheduler::OnDemandPoll(const CompletionHandler& arHandler)
+{
+    mMaster->ScheduleOnDemandIntegrityPoll();
+    if (arHandler) arHandler();
+}
+
+void ScanScheduler::FreeFormPoll(const FreeFormDescriptor& apPoints, const CompletionHandler& arHandler)
+{
+    mMaster->ScheduleFreeFormPoll(*apPoints);
+    if (arHandler) arHandler();
+}
+
+void ScanScheduler::Fulfill(const PromisePtr& apPromise)
+{
+    apPromise->set_value();
+}
+
 } // namespace dnp
 } // namespace apl
@@ -6,6 +6,10 @@
 #include <opendnp3/APL/SuspendTimerSource.h>
 #include <opendnp3/APL/DataTypes.h>
 
+#include <boost/function.hpp>
+
+#include <future>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <unordered_map>
@@ -17,20 +21,53 @@ namespace dnp {
 
 class Master;
 
+typedef std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> FreeFormPoints;
+
+/**
+ * Schedules polls on a master from threads other than the one driving it.
+ *
+ * The Schedule* functions pause the io_service running the master, and so
+ * every channel on the same thread, for a round trip between the threads.
+ * The Post* functions instead post an immutable descriptor of the poll to
+ * the master's thread and return immediately. The poll is queued when the
+ * handler runs, which is signalled through the returned future or the
+ * completion callback, both invoked on the master's thread.
+ *
+ * Posts issued before the stack is removed are handled before it is
+ * destroyed, since removal pauses the same thread after them.
+ */
 class ScanScheduler : private Loggable
 {
 public:
+    typedef boost::function<void ()> CompletionHandler;
+
     ScanScheduler(Master* apMaster, ITimerSource* apTimerSrc, Logger* apLogger) :
         Loggable(apLogger),
         mMaster(apMaster),
+        mpTimerSrc(apTimerSrc),
         mSuspendTimerSource(apTimerSrc)
         {};
 
     void ScheduleOnDemandPoll(void);
-    void ScheduleFreeFormPoll(std::unordered_map<apl::DataTypes, std::vector<uint32_t>, std::EnumClassHash> ffInputPoints);
+    void ScheduleFreeFormPoll(const FreeFormPoints& ffInputPoints);
+
+    std::future<void> PostOnDemandPoll(void);
+    void PostOnDemandPoll(const CompletionHandler& arHandler);
+
+    std::future<void> PostFreeFormPoll(const FreeFormPoints& ffInputPoints);
+    void PostFreeFormPoll(const FreeFormPoints& ffInputPoints, const CompletionHandler& arHandler);
 
 private:
+    typedef std::shared_ptr<const FreeFormPoints> FreeFormDescriptor;
+    typedef std::shared_ptr< std::promise<void> > PromisePtr;
+
+    void OnDemandPoll(const CompletionHandler& arHandler);
+    void FreeFormPoll(const FreeFormDescriptor& apPoints, const CompletionHandler& arHandler);
+
+    static void Fulfill(const PromisePtr& apPromise);
+
     Master *mMaster;
+    ITimerSource* mpTimerSrc;
     SuspendTimerSource mSuspendTimerSource;
 };
 
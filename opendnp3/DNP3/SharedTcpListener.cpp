@@ -0,0 +1,305 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/APL/AsyncResult.h>
+#include <opendnp3/APL/Exception.h>
+#include <opendnp3/APL/Logger.h>
+#include <opendnp3/APL/PhysicalLayerAsyncSharedTCPServer.h>
+#include <opendnp3/DNP3/DNPCrc.h>
+#include <opendnp3/DNP3/LinkHeader.h>
+#include <opendnp3/DNP3/SharedTcpListener.h>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#ifndef WIN32
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace apl
+{
+namespace dnp
+{
+
+namespace
+{
+
+#ifdef SO_REUSEPORT
+typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> reuse_port;
+#endif
+
+void Execute(const FunctionVoidZero& arFunc, AsyncResult* apResult)
+{
+	arFunc();
+	apResult->Success();
+}
+
+// Duplicates the handle of an accepted socket so that it can outlive the socket object. The
+// socket can't simply be released, basic_socket::release() only exists in boost 1.70 and later.
+ip::tcp::socket::native_handle_type DuplicateHandle(ip::tcp::socket& arSocket, error_code& arEC)
+{
+#ifdef WIN32
+	WSAPROTOCOL_INFO info;
+	if(::WSADuplicateSocket(arSocket.native_handle(), ::GetCurrentProcessId(), &info) != 0) {
+		arEC = error_code(::WSAGetLastError(), system_category());
+		return INVALID_SOCKET;
+	}
+	SOCKET handle = ::WSASocket(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &info, 0, WSA_FLAG_OVERLAPPED);
+	if(handle == INVALID_SOCKET) arEC = error_code(::WSAGetLastError(), system_category());
+	return handle;
+#else
+	int handle = ::dup(arSocket.native_handle());
+	if(handle < 0) arEC = error_code(errno, system_category());
+	return handle;
+#endif
+}
+
+}
+
+SharedTcpListener::SharedTcpListener(Logger* apLogger, const TcpSettings& arSettings, millis_t aHeaderTimeout, millis_t aAcceptRetry) :
+	Loggable(apLogger),
+	mHeaderTimeout(aHeaderTimeout),
+	mAcceptRetry(aAcceptRetry)
+{
+	error_code ec;
+	ip::address addr = ip::address::from_string(arSettings.mAddress, ec);
+	if(ec) throw ArgumentException(LOCATION, "endpoint: " + arSettings.mAddress + " is invalid");
+	mEndpoint = ip::tcp::endpoint(addr, arSettings.mPort);
+}
+
+SharedTcpListener::~SharedTcpListener()
+{
+	// the shards are only ever released once Stop() has drained them
+	BOOST_FOREACH(boost::shared_ptr<Shard> pShard, mShards) {
+		assert(pShard->mClosed && !pShard->mAccepting && pShard->mConnections.empty());
+	}
+}
+
+void SharedTcpListener::AddService(boost::asio::io_service* apService)
+{
+#ifndef SO_REUSEPORT
+	// without SO_REUSEPORT there's no way to share the endpoint between acceptors
+	if(mShards.size() > 0) return;
+#endif
+
+	boost::shared_ptr<Shard> pShard(new Shard(apService));
+	ip::tcp::acceptor& acceptor = pShard->mAcceptor;
+
+	error_code ec;
+	acceptor.open(mEndpoint.protocol(), ec);
+	if(ec) throw Exception(LOCATION, ec.message());
+
+	acceptor.set_option(ip::tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+	acceptor.set_option(reuse_port(true));
+#endif
+	acceptor.bind(mEndpoint, ec);
+	if(ec) throw Exception(LOCATION, ec.message());
+
+	acceptor.listen(socket_base::max_connections, ec);
+	if(ec) throw Exception(LOCATION, ec.message());
+
+	mShards.push_back(pShard);
+	this->StartAccept(pShard.get());
+}
+
+void SharedTcpListener::Stop()
+{
+	BOOST_FOREACH(boost::shared_ptr<Shard> pShard, mShards) {
+		this->RunOn(pShard.get(), boost::bind(&SharedTcpListener::Close, this, pShard.get()));
+
+		// the aborted handlers are queued behind the close, wait for them to run
+		bool idle = false;
+		while(!idle) this->RunOn(pShard.get(), boost::bind(&SharedTcpListener::IsIdle, this, pShard.get(), &idle));
+	}
+}
+
+void SharedTcpListener::AddLayer(const std::string& arName, PhysicalLayerAsyncSharedTCPServer* apLayer)
+{
+	CriticalSection cs(&mLock);
+	if(mLayers.find(arName) != mLayers.end()) throw ArgumentException(LOCATION, "Layer already exists: " + arName);
+	mLayers[arName] = apLayer;
+}
+
+void SharedTcpListener::RemoveLayer(const std::string& arName)
+{
+	CriticalSection cs(&mLock);
+	mLayers.erase(arName);
+	for(RouteMap::iterator i = mRoutes.begin(); i != mRoutes.end();) {
+		if(i->second == arName) mRoutes.erase(i++);
+		else ++i;
+	}
+}
+
+void SharedTcpListener::AddRoute(const LinkRoute& arRoute, const std::string& arLayerName)
+{
+	CriticalSection cs(&mLock);
+	if(mRoutes.find(arRoute) != mRoutes.end()) throw ArgumentException(LOCATION, "Route already in use: " + arRoute.ToString());
+	mRoutes[arRoute] = arLayerName;
+}
+
+void SharedTcpListener::RemoveRoute(const LinkRoute& arRoute)
+{
+	CriticalSection cs(&mLock);
+	mRoutes.erase(arRoute);
+}
+
+void SharedTcpListener::StartAccept(Shard* apShard)
+{
+	Connection* pConnection = new Connection(*apShard->mpService);
+	apShard->mAccepting = true;
+	apShard->mAcceptor.async_accept(pConnection->mSocket, pConnection->mRemote,
+	                                boost::bind(&SharedTcpListener::OnAccept, this, placeholders::error, apShard, pConnection));
+}
+
+void SharedTcpListener::OnAccept(const error_code& ec, Shard* apShard, Connection* apConnection)
+{
+	apShard->mAccepting = false;
+
+	if(ec || apShard->mClosed) {
+		delete apConnection;
+		if(!apShard->mClosed && ec != error::operation_aborted) {
+			// errors like EMFILE persist until something is released, retrying right away would just spin
+			LOG_BLOCK(LEV_WARNING, "Error accepting connection: " << ec.message() << ", retrying in " << mAcceptRetry << " ms");
+			apShard->mAccepting = true;
+			apShard->mRetryTimer.expires_from_now(boost::posix_time::milliseconds(mAcceptRetry));
+			apShard->mRetryTimer.async_wait(boost::bind(&SharedTcpListener::OnAcceptRetry, this, placeholders::error, apShard));
+		}
+		return;
+	}
+
+	LOG_BLOCK(LEV_DEBUG, "Accepted connection from: " << apConnection->mRemote);
+
+	apShard->mConnections.insert(apConnection);
+	apConnection->mNumPending = 2;
+	async_read(apConnection->mSocket, buffer(apConnection->mHeader, LS_HEADER_SIZE),
+	           boost::bind(&SharedTcpListener::OnHeader, this, placeholders::error, apShard, apConnection));
+	apConnection->mTimer.expires_from_now(boost::posix_time::milliseconds(mHeaderTimeout));
+	apConnection->mTimer.async_wait(boost::bind(&SharedTcpListener::OnHeaderTimeout, this, placeholders::error, apShard, apConnection));
+
+	this->StartAccept(apShard);
+}
+
+void SharedTcpListener::OnAcceptRetry(const error_code& ec, Shard* apShard)
+{
+	apShard->mAccepting = false;
+	if(!ec && !apShard->mClosed) this->StartAccept(apShard);
+}
+
+void SharedTcpListener::OnHeader(const error_code& ec, Shard* apShard, Connection* apConnection)
+{
+	error_code ignored;
+	apConnection->mTimer.cancel(ignored);
+
+	if(ec) {
+		if(!apShard->mClosed) LOG_BLOCK(LEV_INFO, "Connection from " << apConnection->mRemote << " closed before sending a link header: " << ec.message());
+	}
+	else this->Dispatch(apConnection);
+
+	this->Release(apShard, apConnection);
+}
+
+void SharedTcpListener::OnHeaderTimeout(const error_code& ec, Shard* apShard, Connection* apConnection)
+{
+	if(!ec && apConnection->mSocket.is_open()) {
+		LOG_BLOCK(LEV_WARNING, "Closing connection from " << apConnection->mRemote << ", no link header within " << mHeaderTimeout << " ms");
+		error_code ignored;
+		apConnection->mSocket.close(ignored);
+	}
+
+	this->Release(apShard, apConnection);
+}
+
+void SharedTcpListener::Release(Shard* apShard, Connection* apConnection)
+{
+	if(--apConnection->mNumPending == 0) {
+		apShard->mConnections.erase(apConnection);
+		delete apConnection;
+	}
+}
+
+void SharedTcpListener::Dispatch(Connection* apConnection)
+{
+	const boost::uint8_t* pHeader = apConnection->mHeader;
+	if(pHeader[LI_START_05] != 0x05 || pHeader[LI_START_64] != 0x64 || !DNPCrc::IsCorrectCRC(pHeader, LI_CRC)) {
+		LOG_BLOCK(LEV_WARNING, "Closing connection from " << apConnection->mRemote << ", invalid link header");
+		return;
+	}
+
+	LinkHeader header;
+	header.Read(pHeader);
+	LinkRoute route(header.GetSrc(), header.GetDest());
+
+	// the hand-off is made while holding the lock so that a layer which has been removed never receives a connection
+	CriticalSection cs(&mLock);
+
+	RouteMap::iterator r = mRoutes.find(route);
+	LayerMap::iterator l = (r == mRoutes.end()) ? mLayers.end() : mLayers.find(r->second);
+	if(l == mLayers.end()) {
+		LOG_BLOCK(LEV_WARNING, "Closing connection from " << apConnection->mRemote << ", no layer serves route " << route);
+		return;
+	}
+
+	// the layer adopts a duplicate of the handle, the original is closed along with the connection
+	error_code ec;
+	ip::tcp::socket::native_handle_type socket = DuplicateHandle(apConnection->mSocket, ec);
+	error_code ignored;
+	apConnection->mSocket.close(ignored);
+	if(ec) {
+		LOG_BLOCK(LEV_WARNING, "Unable to hand off connection from " << apConnection->mRemote << ": " << ec.message());
+		return;
+	}
+
+	LOG_BLOCK(LEV_INFO, "Routing connection from " << apConnection->mRemote << " with route " << route << " to " << r->second);
+	std::vector<boost::uint8_t> prefix(pHeader, pHeader + LS_HEADER_SIZE);
+	l->second->Adopt(socket, apConnection->mRemote, prefix);
+}
+
+void SharedTcpListener::Close(Shard* apShard)
+{
+	apShard->mClosed = true;
+
+	error_code ec;
+	apShard->mAcceptor.close(ec);
+	apShard->mRetryTimer.cancel(ec);
+	BOOST_FOREACH(Connection * pConnection, apShard->mConnections) {
+		pConnection->mSocket.close(ec);
+		pConnection->mTimer.cancel(ec);
+	}
+}
+
+void SharedTcpListener::IsIdle(Shard* apShard, bool* apIdle)
+{
+	*apIdle = !apShard->mAccepting && apShard->mConnections.empty();
+}
+
+void SharedTcpListener::RunOn(Shard* apShard, const FunctionVoidZero& arFunc)
+{
+	AsyncResult ar;
+	apShard->mpService->post(boost::bind(&Execute, arFunc, &ar));
+	ar.Wait();
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
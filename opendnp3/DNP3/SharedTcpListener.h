@@ -0,0 +1,164 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __SHARED_TCP_LISTENER_H_
+#define __SHARED_TCP_LISTENER_H_
+
+#include <opendnp3/APL/Function.h>
+#include <opendnp3/APL/Lock.h>
+#include <opendnp3/APL/Loggable.h>
+#include <opendnp3/APL/TcpSettings.h>
+#include <opendnp3/DNP3/LinkLayerConstants.h>
+#include <opendnp3/DNP3/LinkRoute.h>
+
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace apl
+{
+
+class PhysicalLayerAsyncSharedTCPServer;
+
+namespace dnp
+{
+
+/**
+	Accepts any number of connections on one TCP endpoint and hands each of
+	them to the PhysicalLayerAsyncSharedTCPServer that serves the route of
+	the first link frame received on it.
+
+	Routes are looked up as the receiving side sees them, i.e. the source of
+	the frame is the remote address and the destination is the local one.
+	Connections whose header is invalid, whose route isn't registered or
+	that don't send a header within the timeout are closed.
+
+	Each io_service added to the listener gets its own acceptor. Where the
+	platform supports SO_REUSEPORT the acceptors are all bound to the
+	endpoint and the kernel spreads incoming connections between them,
+	elsewhere only the first io_service accepts. A connection may be handed
+	to a layer that runs on a different io_service than the one it was
+	accepted on.
+
+	Layers and routes may be added and removed from any thread.
+*/
+class SharedTcpListener : private Loggable, private boost::noncopyable
+{
+public:
+
+	/**
+		@param apLogger - Logger to use
+		@param arSettings - Address and port to listen on
+		@param aHeaderTimeout - How long a new connection has to send the first link header
+		@param aAcceptRetry - How long to wait before accepting again after an accept fails
+	*/
+	SharedTcpListener(Logger* apLogger, const TcpSettings& arSettings, millis_t aHeaderTimeout = 10000, millis_t aAcceptRetry = 1000);
+	~SharedTcpListener();
+
+	/**
+		Starts accepting connections on an io_service.
+		@throw Exception if the endpoint can't be bound
+	*/
+	void AddService(boost::asio::io_service* apService);
+
+	/// Number of acceptors that are bound to the endpoint
+	size_t NumAcceptors() const {
+		return mShards.size();
+	}
+
+	/**
+		Closes the acceptors and any connections that haven't been handed off
+		yet, blocking until their handlers have run. Must not be called from
+		a thread running one of the io_services.
+	*/
+	void Stop();
+
+	/// @throw ArgumentException if a layer with the name already exists
+	void AddLayer(const std::string& arName, PhysicalLayerAsyncSharedTCPServer* apLayer);
+
+	/// Removes a layer along with all of its routes, no connections are handed to it afterwards
+	void RemoveLayer(const std::string& arName);
+
+	/// @throw ArgumentException if the route is already bound to a layer
+	void AddRoute(const LinkRoute& arRoute, const std::string& arLayerName);
+	void RemoveRoute(const LinkRoute& arRoute);
+
+private:
+
+	struct Connection {
+		Connection(boost::asio::io_service& arService) :
+			mSocket(arService), mTimer(arService), mNumPending(0)
+		{}
+
+		boost::asio::ip::tcp::socket mSocket;
+		boost::asio::ip::tcp::endpoint mRemote;
+		boost::asio::deadline_timer mTimer;
+		boost::uint8_t mHeader[LS_HEADER_SIZE];
+		size_t mNumPending;	// outstanding operations, the connection is deleted when it reaches 0
+	};
+
+	/// An acceptor and the connections it has accepted, only used from its io_service
+	struct Shard {
+		Shard(boost::asio::io_service* apService) :
+			mpService(apService), mAcceptor(*apService), mRetryTimer(*apService), mAccepting(false), mClosed(false)
+		{}
+
+		boost::asio::io_service* mpService;
+		boost::asio::ip::tcp::acceptor mAcceptor;
+		boost::asio::deadline_timer mRetryTimer;
+		bool mAccepting;	// an accept or an accept retry is outstanding
+		bool mClosed;
+		std::set<Connection*> mConnections;
+	};
+
+	void StartAccept(Shard*);
+	void OnAccept(const boost::system::error_code&, Shard*, Connection*);
+	void OnAcceptRetry(const boost::system::error_code&, Shard*);
+	void OnHeader(const boost::system::error_code&, Shard*, Connection*);
+	void OnHeaderTimeout(const boost::system::error_code&, Shard*, Connection*);
+	void Release(Shard*, Connection*);
+	void Dispatch(Connection*);
+
+	void Close(Shard*);
+	void IsIdle(Shard*, bool* apIdle);
+	void RunOn(Shard*, const FunctionVoidZero&);
+
+	boost::asio::ip::tcp::endpoint mEndpoint;
+	const millis_t mHeaderTimeout;
+	const millis_t mAcceptRetry;
+
+	typedef std::vector< boost::shared_ptr<Shard> > ShardVector;
+	ShardVector mShards;
+
+	SigLock mLock; // protects the layer and route tables
+
+	typedef std::map<std::string, PhysicalLayerAsyncSharedTCPServer*> LayerMap;
+	LayerMap mLayers;
+
+	typedef std::map<LinkRoute, std::string, LinkRoute::LessThan> RouteMap;
+	RouteMap mRoutes;
+};
+
+}
+}
+
+#endif
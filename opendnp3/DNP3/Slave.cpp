@@ -24,6 +24,7 @@
 #include <opendnp3/DNP3/ObjectReadIterator.h>
 #include <opendnp3/DNP3/Slave.h>
 #include <opendnp3/DNP3/SlaveStates.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 
 #include <boost/bind.hpp>
 
@@ -34,6 +35,7 @@ namespace dnp
 
 Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc, ITimeManager* apTime, Database* apDatabase, IDNPCommandMaster* apCmdMaster, const SlaveConfig& arCfg) :
 	Loggable(apLogger),
+	mChangeBuffer(arCfg.mCoalesceUpdates),
 	mpAppLayer(apAppLayer),
 	mpTimerSrc(apTimerSrc),
 	mpDatabase(apDatabase),
@@ -60,6 +62,9 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, ITimerSource* apTimerSrc,
 	mpObserver(arCfg.mpObserver),
 	mState(SS_UNKNOWN),
 	mLastRxTime(TimeStamp::GetTimeStamp()),
+	mpStats(NULL),
+	mHaveUnsentCommit(false),
+	mUnsentCommitTime(0),
 	mpTimeTimer(NULL),
 	mVtoReader(apLogger),
 	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), arCfg.mVtoWriterQueueSize)
@@ -165,6 +170,7 @@ void Slave::OnUnsolFailure()
 	if (mUnsolExpectCON) {
 		LOG_BLOCK(LEV_WARNING, "Disable unsol response");
 		mUnsolDisable = true;
+		mHaveUnsentCommit = false;
 	}
 
 	mpState->OnUnsolFailure(this);
@@ -280,6 +286,12 @@ size_t Slave::FlushUpdates()
 		return 0;
 	}
 
+	// remember the oldest commit whose events are waiting for an unsol response
+	if(mpStats && num > 0 && !mHaveUnsentCommit && mRspContext.HasEvents(mConfig.mUnsolMask)) {
+		mHaveUnsentCommit = true;
+		mUnsentCommitTime = mChangeBuffer.GetFlushedCommitTime();
+	}
+
 	num += this->FlushVtoUpdates();
 
 	LOG_BLOCK(LEV_DEBUG, "Processed " << num << " updates");
@@ -314,10 +326,26 @@ void Slave::SendUnsolicited(APDU& arAPDU)
 {
 	mRspIIN.BitwiseOR(mIIN);
 	arAPDU.SetIIN(mRspIIN);
+
+	// the startup null unsol doesn't carry any events
+	if(mHaveUnsentCommit && mStartupNullUnsol) {
+		mHaveUnsentCommit = false;
+		if(mpStats) mpStats->mUnsolLatency.Record(mpStats->Now() - mUnsentCommitTime);
+	}
+
 	mpAppLayer->SendUnsolicited(arAPDU);
 	mUnsolExpectCON = (arAPDU.GetControl()).CON;
 }
 
+void Slave::SetStatistics(StackStatistics* apStats)
+{
+	mpStats = apStats;
+	mHaveUnsentCommit = false;
+	// commits have to be stamped with the clock the latency is measured against
+	mChangeBuffer.SetTimeSource(apStats ? apStats->GetTimeSource() : NULL);
+	mRspContext.SetStatistics(apStats);
+}
+
 void Slave::ConfigureDelayMeasurement(const APDU& arRequest)
 {
 	HeaderReadIterator hdr = arRequest.BeginRead();
@@ -349,9 +377,7 @@ void Slave::HandleWriteVto(HeaderReadIterator& arHdr)
 			 */
 			boost::uint8_t channel = static_cast<boost::uint8_t>(index);
 
-			VtoData vto(arHdr->GetVariation());
-
-			Group112Var0::Inst()->Read(*obj, arHdr->GetVariation(), vto.mpData);
+			VtoData vto = mVtoReader.CopyData(*obj, arHdr->GetVariation());
 
 			mVtoReader.Update(vto, channel);
 		}
@@ -608,6 +634,9 @@ void Slave::HandleEnableUnsolicited(const APDU& arRequest, bool aIsEnable)
 				break;
 			}
 		}
+
+		// events of disabled classes won't be reported by an unsol response
+		if (!aIsEnable && !mRspContext.HasEvents(mConfig.mUnsolMask)) mHaveUnsentCommit = false;
 	}
 }
 
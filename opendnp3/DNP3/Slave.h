@@ -50,6 +50,7 @@ namespace dnp
 {
 
 class AS_Base;
+class StackStatistics;
 
 /**
  * @section desc DNP3 outstation.
@@ -157,6 +158,16 @@ public:
 		return mLastRxTime;
 	}
 
+	/**
+	 * Counts the events that are sent and records the time from the
+	 * commit of an update to the unsolicited response that reports it.
+	 * The commit time is taken from the system clock, so the statistics
+	 * should use it as well.
+	 *
+	 * @param apStats	the statistics of the stack, NULL to stop counting
+	 */
+	void SetStatistics(StackStatistics* apStats);
+
 private:
 
 	ChangeBuffer<SigLock> mChangeBuffer;	// how client code gives us updates
@@ -209,6 +220,10 @@ private:
 
 	TimeStamp_t mLastRxTime;				// Timestamp of last message received
 
+	StackStatistics* mpStats;				// Optional performance counters
+	bool mHaveUnsentCommit;					// Events have been flushed that no unsol response has reported yet
+	TimeStamp_t mUnsentCommitTime;			// Commit time of the oldest of those updates
+
 	void UpdateState(StackStates aState);
 
 	void OnVtoUpdate();						// internal event dispatched when user code commits an update to mVtoWriter
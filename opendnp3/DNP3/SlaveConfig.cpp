@@ -50,6 +50,8 @@ SlaveConfig::SlaveConfig() :
 	mUnsolRetryDelay(2000),
 	mMaxFragSize(DEFAULT_FRAG_SIZE),
 	mVtoWriterQueueSize(DEFAULT_VTO_WRITER_QUEUE_SIZE),
+	mCoalesceUpdates(false),
+	mAutoVariations(false),
 	mEventMaxConfig(),
 	mStaticBinary(GrpVar(1, 2)),
 	mStaticAnalog(GrpVar(30, 1)),
@@ -100,6 +100,17 @@ struct SlaveConfig {
 	// The number of objects to store in the VtoWriter queue.
 	size_t mVtoWriterQueueSize;
 
+	// If true, only the latest value of each point written through the data observer between
+	// flushes is applied to the database. Intermediate values are discarded and do not produce
+	// events, so this is intended for high rate producers of static-only points.
+	bool mCoalesceUpdates;
+
+	// If true, class 0 and variation 0 reads are answered with the smallest variation that can
+	// represent each run of points (bit packed binaries, 16 bit and/or flagless analogs and counters)
+	// and binary events use relative time (Group2Var3) when that is cheaper. The variations below
+	// are then upper bounds, a response is never larger than with them.
+	bool mAutoVariations;
+
 	// Structure that defines the maximum number of events to buffer
 	EventMaxConfig mEventMaxConfig;
 
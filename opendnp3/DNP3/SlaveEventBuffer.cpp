@@ -55,6 +55,12 @@ size_t SlaveEventBuffer::NumVtoEventsAvailable()
 	return mVtoEvents.NumAvailable();
 }
 
+void SlaveEventBuffer::ReserveIndices(apl::DataTypes aType, size_t aNumIndices)
+{
+	// binary and analog events are kept in time order, one event per index is only kept for counters
+	if(aType == DT_COUNTER) mCounterEvents.ReserveIndices(aNumIndices);
+}
+
 size_t SlaveEventBuffer::NumSelected(BufferTypes aType)
 {
 	switch(aType) {
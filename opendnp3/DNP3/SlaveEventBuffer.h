@@ -91,6 +91,14 @@ public:
 
 	size_t NumVtoEventsAvailable();
 
+	/**
+	 * Sizes the index lookup of the buffers that keep one event per index.
+	 *
+	 * @param aType			the type of point
+	 * @param aNumIndices	one more than the highest index of the type
+	 */
+	void ReserveIndices(apl::DataTypes aType, size_t aNumIndices);
+
 	/**
 	 * Returns the number of events that were previously selected through
 	 * SlaveEventBuffer::Select().  The selection behavior is restricted
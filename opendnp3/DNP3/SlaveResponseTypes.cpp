@@ -40,6 +40,11 @@ SlaveResponseTypes::SlaveResponseTypes(const SlaveConfig& arCfg)
 
 	/* This is the only valid Slave VTO response, therefore it doesn't need to be configurable */
 	mpEventVto = Group113Var0::Inst();
+
+	mAutoVariations = arCfg.mAutoVariations;
+
+	/* Only absolute time binary events get smaller with a common time object */
+	mpEventBinaryCTO = (mAutoVariations && mpEventBinary == Group2Var2::Inst()) ? Group2Var3::Inst() : NULL;
 }
 
 StreamObject<Binary>* SlaveResponseTypes::GetStaticBinary(GrpVar gv)
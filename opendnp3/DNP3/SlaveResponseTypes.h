@@ -52,6 +52,12 @@ public:
 
 	SizeByVariationObject* mpEventVto;
 
+	// if true, the default static variations are narrowed per run of points, see AutoVariation
+	bool mAutoVariations;
+
+	// relative time variant of mpEventBinary to use when it's cheaper, NULL if never
+	StreamObject<Binary>* mpEventBinaryCTO;
+
 private:
 
 	static StreamObject<Binary>* GetStaticBinary(GrpVar);
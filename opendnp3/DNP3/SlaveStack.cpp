@@ -28,10 +28,25 @@ SlaveStack::SlaveStack(Logger* apLogger, ITimerSource* apTimerSrc, ICommandAccep
 	mDB(apLogger),
 	mCmdMaster(10000),
 	mSlave(apLogger, &mApplication, apTimerSrc, &mTimeSource, &mDB, &mCmdMaster, arCfg.slave)
+{
+	this->Configure(apCmdAcceptor, arCfg.device);
+}
+
+SlaveStack::SlaveStack(Logger* apLogger, ITimerSource* apTimerSrc, ICommandAcceptor* apCmdAcceptor, const SlaveStackConfig& arCfg, const DeviceTemplate& arDevice) :
+	Stack(apLogger->GetSubLogger("slave"), apTimerSrc, arCfg.app, arCfg.link),
+	mDB(apLogger),
+	mCmdMaster(10000),
+	mSlave(apLogger, &mApplication, apTimerSrc, &mTimeSource, &mDB, &mCmdMaster, arCfg.slave)
+{
+	this->Configure(apCmdAcceptor, arDevice);
+}
+
+void SlaveStack::Configure(ICommandAcceptor* apCmdAcceptor, const DeviceTemplate& arDevice)
 {
 	this->mApplication.SetUser(&mSlave);
-	mDB.Configure(arCfg.device);
-	mCmdMaster.Configure(arCfg.device, apCmdAcceptor);
+	this->mSlave.SetStatistics(&mStatistics);
+	mDB.Configure(arDevice);
+	mCmdMaster.Configure(arDevice, apCmdAcceptor);
 }
 
 IVtoWriter* SlaveStack::GetVtoWriter()
@@ -48,6 +48,16 @@ public:
 	        ICommandAcceptor* apCmdAcceptor,
 	        const SlaveStackConfig& arCfg);
 
+	/**
+		Same as above, but the database layout and control behavior are taken from
+		arDevice instead of arCfg.device so that many stacks can share one template.
+	*/
+	SlaveStack(
+	        Logger* apLogger,
+	        ITimerSource* apTimerSrc,
+	        ICommandAcceptor* apCmdAcceptor,
+	        const SlaveStackConfig& arCfg,
+	        const DeviceTemplate& arDevice);
 	IVtoWriter* GetVtoWriter();
 
 	IVtoReader* GetVtoReader();
@@ -56,6 +66,10 @@ public:
 	Database mDB;				// The database holds static event data and forwards to an event buffer
 	DNPCommandMaster mCmdMaster;	// Controls the execution of commands
 	Slave mSlave;				// The dnp3 outstation class
+
+private:
+
+	void Configure(ICommandAcceptor* apCmdAcceptor, const DeviceTemplate& arDevice);
 };
 
 }
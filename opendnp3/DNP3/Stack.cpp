@@ -31,6 +31,9 @@ Stack::Stack(Logger* apLogger, ITimerSource* apTimerSrc, AppConfig aAppCfg, Link
 {
 	mLink.SetUpperLayer(&mTransport);
 	mTransport.SetUpperLayer(&mApplication);
+
+	mLink.SetStatistics(&mStatistics);
+	mApplication.SetStatistics(&mStatistics);
 }
 
 }
@@ -21,6 +21,7 @@
 
 #include <opendnp3/DNP3/AppLayer.h>
 #include <opendnp3/DNP3/LinkLayer.h>
+#include <opendnp3/DNP3/StackStatistics.h>
 #include <opendnp3/DNP3/TransportLayer.h>
 #include <opendnp3/DNP3/VtoDataInterface.h>
 #include <opendnp3/DNP3/VtoReader.h>
@@ -54,6 +55,13 @@ public:
 	 */
 	virtual IVtoReader* GetVtoReader() = 0;
 
+	/**
+	 * Performance counters and latency histograms of the stack. The
+	 * layers update them on the stack's thread, Snapshot() may be
+	 * called from any thread.
+	 */
+	StackStatistics mStatistics;
+
 	LinkLayer mLink;
 	TransportLayer mTransport;
 	AppLayer mApplication;
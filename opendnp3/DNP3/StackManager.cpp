@@ -24,10 +24,10 @@ namespace apl
 namespace dnp
 {
 
-StackManager::StackManager(FilterLevel aLevel, const std::string& logFile)
+StackManager::StackManager(FilterLevel aLevel, const std::string& logFile, size_t aNumThreads, millis_t aTimerWheelTick)
 	: mpLog      ( new EventLog() )
 	, mpLogToFile( new LogToFile(mpLog, logFile) )
-	, mpImpl     ( new AsyncStackManager(mpLog->GetLogger(aLevel, "dnp")) )
+	, mpImpl     ( new AsyncStackManager(mpLog->GetLogger(aLevel, "dnp"), aNumThreads, aTimerWheelTick) )
 {}
 
 void StackManager::AddLogHook(ILogBase* apHook)
@@ -62,6 +62,11 @@ void StackManager::AddTCPv4Server(const std::string& arName, PhysLayerSettings s
 	mpImpl->AddTCPv4Server(arName, s, aTcp);
 }
 
+void StackManager::AddTCPv4SharedServer(const std::string& arName, PhysLayerSettings s, TcpSettings aTcp)
+{
+	mpImpl->AddTCPv4SharedServer(arName, s, aTcp);
+}
+
 void StackManager::AddTCPv6Client(const std::string& arName, PhysLayerSettings s, TcpSettings aTcp)
 {
 	mpImpl->AddTCPv6Client(arName, s, aTcp);
@@ -119,6 +124,11 @@ IDataObserver* StackManager::AddSlave(const std::string& arPortName, const std::
 	return mpImpl->AddSlave(arPortName, arStackName, aLevel, apCmdAcceptor, arCfg);
 }
 
+void StackManager::AddStacks(std::vector<StackSpec>& arSpecs)
+{
+	mpImpl->AddStacks(arSpecs);
+}
+
 void StackManager::Shutdown()
 {
 	mpImpl->Shutdown();
@@ -145,6 +155,31 @@ std::vector<std::string> StackManager::GetPortNames()
 	return mpImpl->GetPortNames();
 }
 
+void StackManager::GetStackStatistics(const std::string& arStackName, StackStatisticsSnapshot& arSnapshot)
+{
+	mpImpl->GetStackStatistics(arStackName, arSnapshot);
+}
+
+void StackManager::SetOpenRateLimit(double aOpensPerSecond, size_t aBurst)
+{
+	mpImpl->SetOpenRateLimit(aOpensPerSecond, aBurst);
+}
+
+size_t StackManager::GetNumPendingOpens()
+{
+	return mpImpl->GetNumPendingOpens();
+}
+
+size_t StackManager::GetNumOpenRetries(const std::string& arPortName)
+{
+	return mpImpl->GetNumOpenRetries(arPortName);
+}
+
+millis_t StackManager::GetOpenRetryDelay(const std::string& arPortName)
+{
+	return mpImpl->GetOpenRetryDelay(arPortName);
+}
+
 void StackManager::StartVtoRouter(const std::string& arPortName, const std::string& arStackName, const VtoRouterSettings& arSettings)
 {
 	mpImpl->StartVtoRouter(arPortName, arStackName, arSettings);
@@ -29,6 +29,7 @@
 #include <opendnp3/DNP3/MasterStackConfig.h>
 #include <opendnp3/DNP3/SlaveStackConfig.h>
 #include <opendnp3/DNP3/Stack.h>
+#include <opendnp3/DNP3/StackSpec.h>
 #include <opendnp3/DNP3/VtoDataInterface.h>
 
 #include <vector>
@@ -55,7 +56,9 @@ class AsyncStackManager;
 class StackManager
 {
 public:
-	StackManager(FilterLevel aLevel, const std::string& logFile);
+	// @param aNumThreads Number of threads driving the ports, see AsyncStackManager
+	// @param aTimerWheelTick Resolution of the timer wheel in milliseconds or 0 for ASIO timers, see AsyncStackManager
+	StackManager(FilterLevel aLevel, const std::string& logFile, size_t aNumThreads = 1, millis_t aTimerWheelTick = 0);
 	~StackManager();
 
 	void AddTCPClient(const std::string& arName,
@@ -74,6 +77,10 @@ public:
 	                    PhysLayerSettings aPhys,
 	                    TcpSettings aTcp);
 
+	void AddTCPv4SharedServer(const std::string& arName,
+	                          PhysLayerSettings aPhys,
+	                          TcpSettings aTcp);
+
 	void AddTCPv6Client(const std::string& arName,
 	                    PhysLayerSettings aPhys,
 	                    TcpSettings aTcp);
@@ -122,6 +129,8 @@ public:
 	                        ICommandAcceptor* apCmdAcceptor,
 	                        const SlaveStackConfig& arCfg);
 
+	void AddStacks(std::vector<StackSpec>& arSpecs);
+
 	void StartVtoRouter(const std::string& arPortName,
 	                    const std::string& arStackName,
 	                    const VtoRouterSettings& arSettings);
@@ -145,6 +154,16 @@ public:
 
 	std::vector<std::string> GetPortNames();
 
+	void GetStackStatistics(const std::string& arStackName, StackStatisticsSnapshot& arSnapshot);
+
+	void SetOpenRateLimit(double aOpensPerSecond, size_t aBurst);
+
+	size_t GetNumPendingOpens();
+
+	size_t GetNumOpenRetries(const std::string& arPortName);
+
+	millis_t GetOpenRetryDelay(const std::string& arPortName);
+
 	void Shutdown();
 
 private:
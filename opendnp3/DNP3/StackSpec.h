@@ -0,0 +1,123 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __STACK_SPEC_H_
+#define __STACK_SPEC_H_
+
+#include <opendnp3/APL/LogTypes.h>
+#include <opendnp3/DNP3/DeviceTemplate.h>
+#include <opendnp3/DNP3/MasterStackConfig.h>
+#include <opendnp3/DNP3/SlaveStackConfig.h>
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace apl
+{
+class ICommandAcceptor;
+class IDataObserver;
+}
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Describes one master or slave stack to be added by
+	AsyncStackManager::AddStacks().
+
+	The point layout of a slave is referenced through mpDevice rather than
+	copied into the spec, so any number of slaves that share a layout hold
+	a single DeviceTemplate. The device member of mSlave is ignored when
+	mpDevice is set and should be left empty.
+*/
+struct StackSpec {
+
+	StackSpec() :
+		mLevel(LEV_WARNING),
+		mIsMaster(true),
+		mpPublisher(NULL),
+		mpCmdAcceptor(NULL),
+		mpMasterCmdAcceptor(NULL),
+		mpSlaveDataObserver(NULL)
+	{}
+
+	static StackSpec Master(const std::string& arPortName,
+	                        const std::string& arStackName,
+	                        FilterLevel aLevel,
+	                        IDataObserver* apPublisher,
+	                        const MasterStackConfig& arCfg) {
+		StackSpec s(arPortName, arStackName, aLevel, true);
+		s.mpPublisher = apPublisher;
+		s.mMaster = arCfg;
+		return s;
+	}
+
+	static StackSpec Slave(const std::string& arPortName,
+	                       const std::string& arStackName,
+	                       FilterLevel aLevel,
+	                       ICommandAcceptor* apCmdAcceptor,
+	                       const SlaveStackConfig& arCfg,
+	                       boost::shared_ptr<const DeviceTemplate> apDevice) {
+		StackSpec s(arPortName, arStackName, aLevel, false);
+		s.mpCmdAcceptor = apCmdAcceptor;
+		s.mSlave = arCfg;
+		s.mpDevice = apDevice;
+		return s;
+	}
+
+	// @return the point layout of a slave stack
+	const DeviceTemplate& GetDevice() const {
+		return mpDevice ? *mpDevice : mSlave.device;
+	}
+
+	std::string mPortName;
+	std::string mStackName;
+	FilterLevel mLevel;
+	bool mIsMaster;
+
+	MasterStackConfig mMaster;	// used by masters
+	SlaveStackConfig mSlave;	// used by slaves
+	boost::shared_ptr<const DeviceTemplate> mpDevice; // shared point layout of a slave
+
+	IDataObserver* mpPublisher;		// receives the measurements of a master
+	ICommandAcceptor* mpCmdAcceptor;	// receives the commands of a slave
+
+	// set by AddStacks(), the same interfaces AddMaster() and AddSlave() return
+	ICommandAcceptor* mpMasterCmdAcceptor;
+	IDataObserver* mpSlaveDataObserver;
+
+private:
+
+	StackSpec(const std::string& arPortName, const std::string& arStackName, FilterLevel aLevel, bool aIsMaster) :
+		mPortName(arPortName),
+		mStackName(arStackName),
+		mLevel(aLevel),
+		mIsMaster(aIsMaster),
+		mpPublisher(NULL),
+		mpCmdAcceptor(NULL),
+		mpMasterCmdAcceptor(NULL),
+		mpSlaveDataObserver(NULL)
+	{}
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,182 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#include <opendnp3/DNP3/StackStatistics.h>
+
+#include <opendnp3/APL/TimeSource.h>
+
+#include <assert.h>
+#include <math.h>
+
+namespace apl
+{
+namespace dnp
+{
+
+/* HistogramSnapshot */
+
+HistogramSnapshot::HistogramSnapshot() :
+	mCounts(LatencyHistogram::NUM_BUCKETS, 0),
+	mCount(0),
+	mSum(0),
+	mMax(0)
+{}
+
+double HistogramSnapshot::Mean() const
+{
+	return (mCount == 0) ? 0.0 : static_cast<double>(mSum) / mCount;
+}
+
+millis_t HistogramSnapshot::Percentile(double aPercent) const
+{
+	if(mCount == 0) return 0;
+
+	// rank of the value, 1 based
+	boost::uint64_t rank = static_cast<boost::uint64_t>(ceil(aPercent / 100.0 * mCount));
+	if(rank < 1) rank = 1;
+	if(rank > mCount) rank = mCount;
+
+	boost::uint64_t seen = 0;
+	for(size_t i = 0; i < mCounts.size(); ++i) {
+		seen += mCounts[i];
+		if(seen >= rank) {
+			millis_t upper = static_cast<millis_t>(LatencyHistogram::UpperBound(i));
+			return (upper < mMax) ? upper : mMax;
+		}
+	}
+
+	return mMax;
+}
+
+/* LatencyHistogram */
+
+LatencyHistogram::LatencyHistogram() :
+	mSum(0),
+	mMax(0)
+{
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) mCounts[i].store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::BucketOf(boost::uint64_t aValue)
+{
+	if(aValue < SUB_BUCKETS) return static_cast<size_t>(aValue);
+
+	// position of the most significant bit
+	size_t msb = 0;
+	for(size_t shift = 32; shift > 0; shift /= 2) {
+		if(aValue >> (msb + shift)) msb += shift;
+	}
+
+	// the bits below the msb select the sub-bucket
+	size_t shift = msb - SUB_BUCKET_BITS;
+	size_t sub = static_cast<size_t>(aValue >> shift) & (SUB_BUCKETS - 1);
+	return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+boost::uint64_t LatencyHistogram::LowerBound(size_t aBucket)
+{
+	assert(aBucket < NUM_BUCKETS);
+	if(aBucket < SUB_BUCKETS) return aBucket;
+	size_t shift = aBucket / SUB_BUCKETS - 1;
+	boost::uint64_t sub = aBucket % SUB_BUCKETS;
+	return (SUB_BUCKETS + sub) << shift;
+}
+
+boost::uint64_t LatencyHistogram::UpperBound(size_t aBucket)
+{
+	assert(aBucket < NUM_BUCKETS);
+	if(aBucket < SUB_BUCKETS) return aBucket;
+	size_t shift = aBucket / SUB_BUCKETS - 1;
+	return LowerBound(aBucket) + ((static_cast<boost::uint64_t>(1) << shift) - 1);
+}
+
+void LatencyHistogram::Record(millis_t aValue)
+{
+	boost::uint64_t value = (aValue < 0) ? 0 : static_cast<boost::uint64_t>(aValue);
+
+	mCounts[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+	mSum.fetch_add(value, std::memory_order_relaxed);
+
+	boost::uint64_t max = mMax.load(std::memory_order_relaxed);
+	while(value > max && !mMax.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Snapshot(HistogramSnapshot& arSnapshot) const
+{
+	arSnapshot.mCounts.resize(NUM_BUCKETS);
+	arSnapshot.mCount = 0;
+
+	// the count is taken from the copied buckets so that percentiles are consistent with it
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) {
+		arSnapshot.mCounts[i] = mCounts[i].load(std::memory_order_relaxed);
+		arSnapshot.mCount += arSnapshot.mCounts[i];
+	}
+
+	arSnapshot.mSum = mSum.load(std::memory_order_relaxed);
+	arSnapshot.mMax = static_cast<millis_t>(mMax.load(std::memory_order_relaxed));
+}
+
+/* StackStatisticsSnapshot */
+
+StackStatisticsSnapshot::StackStatisticsSnapshot() :
+	mBytesRx(0),
+	mBytesTx(0),
+	mFramesRx(0),
+	mFramesTx(0),
+	mCrcFailures(0),
+	mLinkRetries(0),
+	mAppRetries(0),
+	mFragmentsRx(0),
+	mFragmentsTx(0),
+	mEventsRx(0),
+	mEventsTx(0)
+{}
+
+/* StackStatistics */
+
+StackStatistics::StackStatistics(ITimeSource* apTimeSource) :
+	mpTimeSource(apTimeSource == NULL ? TimeSource::Inst() : apTimeSource)
+{}
+
+TimeStamp_t StackStatistics::Now() const
+{
+	return mpTimeSource->GetTimeStampUTC();
+}
+
+void StackStatistics::Snapshot(StackStatisticsSnapshot& arSnapshot) const
+{
+	arSnapshot.mBytesRx = mBytesRx.Get();
+	arSnapshot.mBytesTx = mBytesTx.Get();
+	arSnapshot.mFramesRx = mFramesRx.Get();
+	arSnapshot.mFramesTx = mFramesTx.Get();
+	arSnapshot.mLinkRetries = mLinkRetries.Get();
+	arSnapshot.mAppRetries = mAppRetries.Get();
+	arSnapshot.mFragmentsRx = mFragmentsRx.Get();
+	arSnapshot.mFragmentsTx = mFragmentsTx.Get();
+	arSnapshot.mEventsRx = mEventsRx.Get();
+	arSnapshot.mEventsTx = mEventsTx.Get();
+
+	mResponseLatency.Snapshot(arSnapshot.mResponseLatency);
+	mEventAge.Snapshot(arSnapshot.mEventAge);
+	mUnsolLatency.Snapshot(arSnapshot.mUnsolLatency);
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,210 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __STACK_STATISTICS_H_
+#define __STACK_STATISTICS_H_
+
+#include <opendnp3/APL/Types.h>
+
+#include <boost/cstdint.hpp>
+
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+class ITimeSource;
+}
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+	Event counter that is incremented by the thread that drives a stack and
+	can be read from any other thread without a lock.
+*/
+class StatCounter
+{
+public:
+	StatCounter() : mValue(0) {}
+
+	void Increment(boost::uint64_t aAmount = 1) {
+		mValue.fetch_add(aAmount, std::memory_order_relaxed);
+	}
+
+	boost::uint64_t Get() const {
+		return mValue.load(std::memory_order_relaxed);
+	}
+
+private:
+	StatCounter(const StatCounter&);
+	StatCounter& operator=(const StatCounter&);
+
+	std::atomic<boost::uint64_t> mValue;
+};
+
+/// Copy of a LatencyHistogram taken at one point in time
+struct HistogramSnapshot {
+	HistogramSnapshot();
+
+	/// Number of recorded values
+	boost::uint64_t Count() const {
+		return mCount;
+	}
+
+	/// Largest recorded value, 0 if nothing has been recorded
+	millis_t Max() const {
+		return mMax;
+	}
+
+	/// Mean of the recorded values, 0 if nothing has been recorded
+	double Mean() const;
+
+	/**
+		Value that aPercent of the recorded values are less than or equal to,
+		accurate to the width of the bucket the value falls in (12.5%).
+
+		@param aPercent Percentile in the range [0, 100]
+		@return 0 if nothing has been recorded
+	*/
+	millis_t Percentile(double aPercent) const;
+
+	std::vector<boost::uint64_t> mCounts;	// recorded values per bucket
+	boost::uint64_t mCount;
+	boost::uint64_t mSum;
+	millis_t mMax;
+};
+
+/**
+	Lock-free histogram of millisecond durations with HDR style buckets.
+
+	Values below 8 have a bucket each. Above that every power of two is split
+	into 8 linear sub-buckets, so the relative error of a bucket is bounded
+	by 12.5% over the whole 64 bit range with a fixed, small number of
+	buckets. Recording is a few relaxed atomic increments, so the owning
+	thread never blocks a reader and vice versa.
+*/
+class LatencyHistogram
+{
+public:
+	static const size_t SUB_BUCKET_BITS = 3;
+	static const size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static const size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	LatencyHistogram();
+
+	/// Records a duration, negative values (e.g. from clock adjustments) count as 0
+	void Record(millis_t aValue);
+
+	void Snapshot(HistogramSnapshot& arSnapshot) const;
+
+	static size_t BucketOf(boost::uint64_t aValue);
+
+	/// Smallest value that falls into a bucket
+	static boost::uint64_t LowerBound(size_t aBucket);
+
+	/// Largest value that falls into a bucket
+	static boost::uint64_t UpperBound(size_t aBucket);
+
+private:
+	LatencyHistogram(const LatencyHistogram&);
+	LatencyHistogram& operator=(const LatencyHistogram&);
+
+	std::atomic<boost::uint64_t> mCounts[NUM_BUCKETS];
+	std::atomic<boost::uint64_t> mSum;
+	std::atomic<boost::uint64_t> mMax;
+};
+
+/// Copy of the statistics of a stack taken at one point in time
+struct StackStatisticsSnapshot {
+	StackStatisticsSnapshot();
+
+	boost::uint64_t mBytesRx;
+	boost::uint64_t mBytesTx;
+	boost::uint64_t mFramesRx;
+	boost::uint64_t mFramesTx;
+	boost::uint64_t mCrcFailures;		// counted for the channel, every stack on it reports the same value
+	boost::uint64_t mLinkRetries;
+	boost::uint64_t mAppRetries;
+	boost::uint64_t mFragmentsRx;
+	boost::uint64_t mFragmentsTx;
+	boost::uint64_t mEventsRx;			// events received by a master
+	boost::uint64_t mEventsTx;			// events confirmed by the master of a slave
+
+	HistogramSnapshot mResponseLatency;	// request sent -> first response fragment (master)
+	HistogramSnapshot mEventAge;		// event timestamp -> event received (master)
+	HistogramSnapshot mUnsolLatency;	// update committed -> unsolicited response sent (slave)
+};
+
+/**
+	Performance counters and latency histograms of a stack.
+
+	The block is owned by the Stack and updated by its layers on the thread
+	that drives the stack. Every field is an independent atomic, so a
+	snapshot can be taken from any thread at any time without stopping the
+	io_service. Each value in a snapshot is exact, but values are not read
+	at the same instant, so counters that are updated together may be off by
+	the operations in flight while the snapshot is taken.
+*/
+class StackStatistics
+{
+public:
+	/// @param apTimeSource Clock used to measure the latencies, defaults to system time
+	StackStatistics(ITimeSource* apTimeSource = NULL);
+
+	/// Current time of the clock used to measure latencies
+	TimeStamp_t Now() const;
+
+	/// Clock used to measure latencies
+	ITimeSource* GetTimeSource() const {
+		return mpTimeSource;
+	}
+
+	void Snapshot(StackStatisticsSnapshot& arSnapshot) const;
+
+	StatCounter mBytesRx;
+	StatCounter mBytesTx;
+	StatCounter mFramesRx;
+	StatCounter mFramesTx;
+	StatCounter mLinkRetries;
+	StatCounter mAppRetries;
+	StatCounter mFragmentsRx;
+	StatCounter mFragmentsTx;
+	StatCounter mEventsRx;
+	StatCounter mEventsTx;
+
+	LatencyHistogram mResponseLatency;
+	LatencyHistogram mEventAge;
+	LatencyHistogram mUnsolLatency;
+
+private:
+	StackStatistics(const StackStatistics&);
+	StackStatistics& operator=(const StackStatistics&);
+
+	ITimeSource* mpTimeSource;
+};
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
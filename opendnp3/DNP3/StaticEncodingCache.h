@@ -0,0 +1,166 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __STATIC_ENCODING_CACHE_H_
+#define __STATIC_ENCODING_CACHE_H_
+
+#include <opendnp3/DNP3/ObjectInterfaces.h>
+#include <opendnp3/DNP3/StaticPointStore.h>
+
+#include <boost/cstdint.hpp>
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/**
+ * Keeps the encoded form of every point of a StaticPointStore for each
+ * object type that static responses have been written with.
+ *
+ * Encodings are kept per block of StaticPointStore::POINTS_PER_BLOCK points.
+ * The dirty bitmap of the store invalidates the blocks of every object type
+ * that changed since the last write, so writing a range re-encodes only
+ * those blocks and copies the rest. Integrity polls of data that mostly
+ * doesn't change are then mostly memcpy.
+ *
+ * The cache consumes the dirty bitmap of the store, so there must only be
+ * one cache per store.
+ */
+template <class T>
+class StaticEncodingCache
+{
+public:
+
+	StaticEncodingCache() : mNumEncoded(0)
+	{}
+
+	/**
+	 * Writes the encoding of aCount points starting at aStart with apObj to
+	 * apPos, which must have room for aCount * apObj->GetSize() bytes.
+	 */
+	void Write(StaticPointStore<T>& arStore, const StreamObject<T>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos);
+
+	/// Total number of blocks that have been encoded
+	size_t NumEncoded() const {
+		return mNumEncoded;
+	}
+
+private:
+
+	struct Encoding {
+		const StreamObject<T>* mpObj;
+		std::vector<boost::uint8_t> mBytes;
+		std::vector<bool> mValid;		// per block
+	};
+
+	void Invalidate(StaticPointStore<T>& arStore);
+
+	Encoding& GetEncoding(const StaticPointStore<T>& arStore, const StreamObject<T>* apObj);
+
+	void Encode(const StaticPointStore<T>& arStore, Encoding& arEncoding, size_t aBlock);
+
+	std::vector<Encoding> mEncodings;	// only a handful of object types per measurement type
+	std::vector<size_t> mDirtyBlocks;
+	size_t mNumEncoded;
+};
+
+template <class T>
+void StaticEncodingCache<T> :: Write(StaticPointStore<T>& arStore, const StreamObject<T>* apObj, size_t aStart, size_t aCount, boost::uint8_t* apPos)
+{
+	if(aCount == 0) return;
+	assert(aStart + aCount <= arStore.Size());
+
+	this->Invalidate(arStore);
+	Encoding& e = this->GetEncoding(arStore, apObj);
+
+	size_t first = aStart / StaticPointStore<T>::POINTS_PER_BLOCK;
+	size_t last = (aStart + aCount - 1) / StaticPointStore<T>::POINTS_PER_BLOCK;
+	for(size_t block = first; block <= last; ++block) {
+		if(!e.mValid[block]) this->Encode(arStore, e, block);
+	}
+
+	size_t size = apObj->GetSize();
+	memcpy(apPos, &e.mBytes[aStart * size], aCount * size);
+}
+
+template <class T>
+void StaticEncodingCache<T> :: Invalidate(StaticPointStore<T>& arStore)
+{
+	mDirtyBlocks.clear();
+	arStore.TakeDirtyBlocks(mDirtyBlocks);
+
+	for(size_t i = 0; i < mEncodings.size(); ++i) {
+		Encoding& e = mEncodings[i];
+		for(size_t j = 0; j < mDirtyBlocks.size(); ++j) {
+			if(mDirtyBlocks[j] < e.mValid.size()) e.mValid[mDirtyBlocks[j]] = false;
+		}
+	}
+}
+
+template <class T>
+typename StaticEncodingCache<T>::Encoding& StaticEncodingCache<T> :: GetEncoding(const StaticPointStore<T>& arStore, const StreamObject<T>* apObj)
+{
+	size_t i = 0;
+	while(i < mEncodings.size() && mEncodings[i].mpObj != apObj) ++i;
+
+	if(i == mEncodings.size()) {
+		mEncodings.push_back(Encoding());
+		mEncodings.back().mpObj = apObj;
+	}
+
+	// the store was resized, resizing marks every block dirty so nothing valid is lost
+	Encoding& e = mEncodings[i];
+	size_t bytes = arStore.Size() * apObj->GetSize();
+	if(e.mBytes.size() != bytes) {
+		e.mBytes.resize(bytes);
+		e.mValid.assign(arStore.NumBlocks(), false);
+	}
+
+	return e;
+}
+
+template <class T>
+void StaticEncodingCache<T> :: Encode(const StaticPointStore<T>& arStore, Encoding& arEncoding, size_t aBlock)
+{
+	size_t size = arEncoding.mpObj->GetSize();
+	size_t start = aBlock * StaticPointStore<T>::POINTS_PER_BLOCK;
+	size_t stop = start + StaticPointStore<T>::POINTS_PER_BLOCK;
+	if(stop > arStore.Size()) stop = arStore.Size();
+
+	T value;
+	for(size_t i = start; i < stop; ++i) {
+		arStore.Read(i, value);
+		arEncoding.mpObj->Write(&arEncoding.mBytes[i * size], value);
+	}
+
+	arEncoding.mValid[aBlock] = true;
+	++mNumEncoded;
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
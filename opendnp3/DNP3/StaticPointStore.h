@@ -0,0 +1,357 @@
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one
+// or more contributor license agreements. See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  Green Enery Corp licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+//
+#ifndef __STATIC_POINT_STORE_H_
+#define __STATIC_POINT_STORE_H_
+
+#include <opendnp3/APL/DataTypes.h>
+#include <opendnp3/DNP3/PointClass.h>
+#include <opendnp3/DNP3/PointIndexMap.h>
+
+#include <boost/cstdint.hpp>
+
+#include <limits>
+#include <math.h>
+#include <stddef.h>
+#include <vector>
+
+namespace apl
+{
+namespace dnp
+{
+
+/* Branch free deadband checks shared by the single and batched update paths */
+
+inline bool ValueExceedsDeadband(bool, bool, double)
+{
+	return false; // binary types only generate events on quality/state changes
+}
+
+inline bool ValueExceedsDeadband(boost::uint32_t aValue, boost::uint32_t aLast, double aDeadband)
+{
+	boost::uint32_t diff = (aValue < aLast) ? (aLast - aValue) : (aValue - aLast);
+	return diff > aDeadband;
+}
+
+inline bool ValueExceedsDeadband(double aValue, double aLast, double aDeadband)
+{
+	double diff = fabs(aValue - aLast);
+	return (diff > aDeadband) | (diff == std::numeric_limits<double>::infinity());
+}
+
+/**
+ * Static values of a single measurement type stored as a structure of arrays.
+ *
+ * Value, quality and time each live in their own contiguous array and the
+ * event configuration (class, deadband, last reported value) in separate
+ * ones, so reading a range for a static response only touches the data it
+ * writes and deadband checks run over flat arrays of primitives.
+ *
+ * const_iterator adapts the store to the iterator interface that the
+ * response code used with the old vector of PointInfo, materializing a
+ * measurement for the point it refers to on dereference.
+ *
+ * The arrays are indexed by slot. A PointIndexMap translates the DNP3 index
+ * of a point into its slot, which is the same number unless the store was
+ * configured with a sparse set of indices.
+ *
+ * Points are grouped into blocks of POINTS_PER_BLOCK and a bitmap records
+ * which blocks had a value, quality or time change, so that a cache of
+ * encoded static responses only has to re-encode the blocks that changed.
+ */
+template <class T>
+class StaticPointStore
+{
+public:
+
+	typedef typename T::Type ValueType;
+
+	/// Number of consecutive points that share a bit in the dirty bitmap
+	static const size_t POINTS_PER_BLOCK = 32;
+
+	/// What a const_iterator dereferences to
+	struct Entry {
+		T mValue;
+		PointClass mClass;
+		size_t mIndex;
+	};
+
+	class const_iterator
+	{
+		friend class StaticPointStore<T>;
+
+	public:
+		const_iterator() : mpStore(NULL), mSlot(0) {}
+
+		const Entry& operator*() const {
+			this->Load();
+			return mEntry;
+		}
+		const Entry* operator->() const {
+			this->Load();
+			return &mEntry;
+		}
+		const_iterator& operator++() {
+			++mSlot;
+			return *this;
+		}
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++mSlot;
+			return tmp;
+		}
+		const_iterator operator+(size_t aOffset) const {
+			return const_iterator(mpStore, mSlot + aOffset);
+		}
+		bool operator==(const const_iterator& arRHS) const {
+			return mSlot == arRHS.mSlot;
+		}
+		bool operator!=(const const_iterator& arRHS) const {
+			return mSlot != arRHS.mSlot;
+		}
+
+	private:
+		const_iterator(const StaticPointStore<T>* apStore, size_t aSlot) : mpStore(apStore), mSlot(aSlot) {}
+
+		void Load() const {
+			mpStore->Read(mSlot, mEntry.mValue);
+			mEntry.mClass = mpStore->mClasses[mSlot];
+			mEntry.mIndex = mpStore->mIndices.IndexOf(mSlot);
+		}
+
+		const StaticPointStore<T>* mpStore;
+		size_t mSlot;
+		mutable Entry mEntry;
+	};
+
+	size_t Size() const {
+		return mQualities.size();
+	}
+
+	size_t NumBlocks() const {
+		return (this->Size() + POINTS_PER_BLOCK - 1) / POINTS_PER_BLOCK;
+	}
+
+	const_iterator Begin() const {
+		return const_iterator(this, 0);
+	}
+
+	/// Resizes the store to hold indices 0 to aNumPoints-1, new points take the default value of T
+	void Resize(size_t aNumPoints);
+
+	/**
+	 * Sizes the store to hold exactly the given indices, which must be strictly ascending
+	 * @throw ArgumentException if they aren't
+	 */
+	void Configure(const std::vector<size_t>& arIndices);
+
+	const PointIndexMap& Indices() const {
+		return mIndices;
+	}
+
+	/// @return false if the index isn't configured
+	bool FindSlot(size_t aIndex, size_t& arSlot) const {
+		return mIndices.FindSlot(aIndex, arSlot);
+	}
+
+	void SetAllQuality(boost::uint8_t aQuality);
+
+	void Read(size_t aSlot, T& arValue) const {
+		arValue.SetQuality(mQualities[aSlot]);
+		arValue.SetValue(mValues[aSlot]);
+		arValue.SetTime(mTimes[aSlot]);
+	}
+
+	PointClass GetClass(size_t aSlot) const {
+		return mClasses[aSlot];
+	}
+
+	void SetClass(size_t aSlot, PointClass aClass) {
+		mClasses[aSlot] = aClass;
+	}
+
+	void SetDeadband(size_t aSlot, double aDeadband) {
+		mDeadbands[aSlot] = aDeadband;
+	}
+
+	/**
+	 * Stores a new value for a point that must exist.
+	 * @return true if the change should be reported as an event
+	 */
+	bool Update(const T& arValue, size_t aSlot);
+
+	/// Update with the deadband comparison already made by CheckDeadbands
+	bool Update(const T& arValue, size_t aSlot, bool aExceedsDeadband);
+
+	/// Records the current value of the point as the last one reported as an event
+	void SetReported(size_t aSlot) {
+		mLastEventValues[aSlot] = mValues[aSlot];
+	}
+
+	/**
+	 * Checks aCount new values for the consecutive points starting at aStart
+	 * against their deadbands, setting apExceeds[i] to 1 or 0. The loop has no
+	 * branches so the compiler can vectorize it.
+	 */
+	void CheckDeadbands(size_t aStart, const ValueType* apValues, size_t aCount, boost::uint8_t* apExceeds) const;
+
+	/**
+	 * Appends the blocks that changed since the last call to arBlocks in
+	 * ascending order and clears the dirty bitmap.
+	 */
+	void TakeDirtyBlocks(std::vector<size_t>& arBlocks);
+
+	/* Raw access to the arrays for code that streams a range of points */
+
+	const ValueType* Values() const {
+		return mValues.empty() ? NULL : &mValues[0];
+	}
+	const boost::uint8_t* Qualities() const {
+		return mQualities.empty() ? NULL : &mQualities[0];
+	}
+	const TimeStamp_t* Times() const {
+		return mTimes.empty() ? NULL : &mTimes[0];
+	}
+
+private:
+
+	static const size_t BITS_PER_WORD = 32;
+
+	void MarkDirty(size_t aSlot) {
+		size_t block = aSlot / POINTS_PER_BLOCK;
+		mDirty[block / BITS_PER_WORD] |= (1u << (block % BITS_PER_WORD));
+	}
+
+	void ResizeSlots(size_t aNumSlots);
+
+	void MarkAllDirty() {
+		mDirty.assign((this->NumBlocks() + BITS_PER_WORD - 1) / BITS_PER_WORD, ~0u);
+	}
+
+	PointIndexMap mIndices;
+
+	std::vector<ValueType> mValues;
+	std::vector<boost::uint8_t> mQualities;
+	std::vector<TimeStamp_t> mTimes;
+
+	std::vector<PointClass> mClasses;
+	std::vector<double> mDeadbands;
+	std::vector<ValueType> mLastEventValues;
+
+	std::vector<boost::uint32_t> mDirty;	// one bit per block
+};
+
+template <class T>
+void StaticPointStore<T> :: Resize(size_t aNumPoints)
+{
+	mIndices.SetDense(aNumPoints);
+	this->ResizeSlots(aNumPoints);
+}
+
+template <class T>
+void StaticPointStore<T> :: Configure(const std::vector<size_t>& arIndices)
+{
+	mIndices.SetSparse(arIndices);
+	this->ResizeSlots(arIndices.size());
+}
+
+template <class T>
+void StaticPointStore<T> :: ResizeSlots(size_t aNumSlots)
+{
+	T def;
+	mValues.resize(aNumSlots, def.GetValue());
+	mQualities.resize(aNumSlots, def.GetQuality());
+	mTimes.resize(aNumSlots, def.GetTime());
+	mClasses.resize(aNumSlots, PC_CLASS_0);
+	mDeadbands.resize(aNumSlots, 0);
+	mLastEventValues.resize(aNumSlots, ValueType());
+	this->MarkAllDirty();
+}
+
+template <class T>
+void StaticPointStore<T> :: SetAllQuality(boost::uint8_t aQuality)
+{
+	// go through a measurement so that the binary types keep their state bit
+	T value;
+	for(size_t i = 0; i < this->Size(); ++i) {
+		this->Read(i, value);
+		value.SetQuality(aQuality);
+		mQualities[i] = value.GetQuality();
+	}
+	this->MarkAllDirty();
+}
+
+template <class T>
+bool StaticPointStore<T> :: Update(const T& arValue, size_t aSlot)
+{
+	return this->Update(arValue, aSlot, ValueExceedsDeadband(arValue.GetValue(), mLastEventValues[aSlot], mDeadbands[aSlot]));
+}
+
+template <class T>
+bool StaticPointStore<T> :: Update(const T& arValue, size_t aSlot, bool aExceedsDeadband)
+{
+	ValueType value = arValue.GetValue();
+	boost::uint8_t quality = arValue.GetQuality();
+
+	TimeStamp_t time = arValue.GetTime();
+
+	bool event = (quality != mQualities[aSlot]) || aExceedsDeadband;
+
+	if((value != mValues[aSlot]) || (quality != mQualities[aSlot]) || (time != mTimes[aSlot])) {
+		this->MarkDirty(aSlot);
+	}
+
+	mValues[aSlot] = value;
+	mQualities[aSlot] = quality;
+	mTimes[aSlot] = time;
+
+	return event && ((mClasses[aSlot] & PC_ALL_EVENTS) != 0);
+}
+
+template <class T>
+void StaticPointStore<T> :: CheckDeadbands(size_t aStart, const ValueType* apValues, size_t aCount, boost::uint8_t* apExceeds) const
+{
+	const ValueType* pLast = &mLastEventValues[aStart];
+	const double* pDeadband = &mDeadbands[aStart];
+
+	for(size_t i = 0; i < aCount; ++i) {
+		apExceeds[i] = ValueExceedsDeadband(apValues[i], pLast[i], pDeadband[i]) ? 1 : 0;
+	}
+}
+
+template <class T>
+void StaticPointStore<T> :: TakeDirtyBlocks(std::vector<size_t>& arBlocks)
+{
+	for(size_t w = 0; w < mDirty.size(); ++w) {
+		if(mDirty[w] == 0) continue;
+
+		size_t num = this->NumBlocks();
+		for(size_t b = 0; b < BITS_PER_WORD; ++b) {
+			size_t block = w * BITS_PER_WORD + b;
+			if(block < num && (mDirty[w] & (1u << b))) arBlocks.push_back(block);
+		}
+		mDirty[w] = 0;
+	}
+}
+
+}
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -35,8 +35,7 @@ namespace dnp
 TransportTx::TransportTx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize) :
 	Loggable(apLogger),
 	mpContext(apContext),
-	mBufferAPDU(aFragSize),
-	mBufferTPDU(TL_MAX_TPDU_LENGTH),
+	mBufferTPDUs(NumSegments(aFragSize) * TL_MAX_TPDU_LENGTH),
 	mNumBytesSent(0),
 	mNumBytesToSend(0),
 	mSeq(0)
@@ -45,9 +44,15 @@ TransportTx::TransportTx(Logger* apLogger, TransportLayer* apContext, size_t aFr
 void TransportTx::Send(const boost::uint8_t* apData, size_t aNumBytes)
 {
 	assert(aNumBytes > 0);
-	assert(aNumBytes <= mBufferAPDU.Size());
+	assert(NumSegments(aNumBytes) * TL_MAX_TPDU_LENGTH <= mBufferTPDUs.Size());
+
+	// copy each segment behind the space reserved for its header
+	for(size_t pos = 0; pos < aNumBytes; pos += TL_MAX_TPDU_PAYLOAD) {
+		size_t remainder = aNumBytes - pos;
+		size_t num = remainder < TL_MAX_TPDU_PAYLOAD ? remainder : TL_MAX_TPDU_PAYLOAD;
+		memcpy(mBufferTPDUs + (pos / TL_MAX_TPDU_PAYLOAD) * TL_MAX_TPDU_LENGTH + 1, apData + pos, num);
+	}
 
-	memcpy(mBufferAPDU, apData, aNumBytes);
 	mNumBytesToSend = aNumBytes;
 	mNumBytesSent = 0;
 
@@ -60,15 +65,15 @@ bool TransportTx::CheckForSend()
 
 	if(remainder > 0) {
 		size_t num_to_send = remainder < TL_MAX_TPDU_PAYLOAD ? remainder : TL_MAX_TPDU_PAYLOAD;
-		memcpy(mBufferTPDU + 1, mBufferAPDU + mNumBytesSent, num_to_send);
+		boost::uint8_t* pTPDU = mBufferTPDUs + (mNumBytesSent / TL_MAX_TPDU_PAYLOAD) * TL_MAX_TPDU_LENGTH;
 
 		bool fir = (mNumBytesSent == 0);
 		mNumBytesSent += num_to_send;
 		bool fin = (mNumBytesSent == mNumBytesToSend);
 
-		mBufferTPDU[0] = GetHeader(fir, fin, mSeq);
-		LOG_BLOCK(LEV_INTERPRET, "-> " << TransportLayer::ToString(mBufferTPDU[0]));
-		mpContext->TransmitTPDU(mBufferTPDU, num_to_send + 1);
+		pTPDU[0] = GetHeader(fir, fin, mSeq);
+		LOG_BLOCK(LEV_INTERPRET, "-> " << TransportLayer::ToString(pTPDU[0]));
+		mpContext->TransmitTPDU(pTPDU, num_to_send + 1);
 		return false;
 	}
 	else {
@@ -84,6 +89,11 @@ bool TransportTx::SendSuccess()
 	return this->CheckForSend();
 }
 
+size_t TransportTx::NumSegments(size_t aNumBytes)
+{
+	return (aNumBytes + TL_MAX_TPDU_PAYLOAD - 1) / TL_MAX_TPDU_PAYLOAD;
+}
+
 boost::uint8_t TransportTx::GetHeader(bool aFir, bool aFin, int aSeq)
 {
 	boost::uint8_t hdr = 0;
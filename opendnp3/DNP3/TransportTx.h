@@ -33,6 +33,12 @@ class TransportLayer;
 
 /**
 State/validation for the DNP3 transport layer's send channel.
+
+The APDU is copied once on Send() directly into its TPDU slots, leaving a
+gap for the transport header in front of each segment, so segments can be
+handed to the link layer without another copy. The copy itself is needed
+because the application layer may reformat its APDU once a send has been
+superseded.
 */
 class TransportTx : public Loggable
 {
@@ -46,14 +52,17 @@ public:
 
 	static boost::uint8_t GetHeader(bool aFir, bool aFin, int aSeq);
 
+	// @return Number of TPDUs required to carry an APDU
+	static size_t NumSegments(size_t aNumBytes);
+
 private:
 
 	bool CheckForSend();
 
 	TransportLayer* mpContext;
 
-	CopyableBuffer mBufferAPDU;
-	CopyableBuffer mBufferTPDU;
+	// consecutive TPDUs of TL_MAX_TPDU_LENGTH bytes each
+	CopyableBuffer mBufferTPDUs;
 
 	size_t mNumBytesSent;
 	size_t mNumBytesToSend;
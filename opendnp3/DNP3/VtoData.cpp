@@ -37,25 +37,35 @@ std::string VtoDataTypeToString(VtoDataType aType)
 }
 
 VtoData::VtoData() :
-	mSize(0), mType(VTODT_DATA)
+	mpData(NULL), mSize(0), mType(VTODT_DATA)
 {}
 
 VtoData::VtoData(size_t aSize) :
-	mSize(aSize), mType(VTODT_DATA)
+	mpData(NULL), mSize(aSize), mType(VTODT_DATA)
 {
 	assert(aSize <= MAX_SIZE);
+	if(aSize > 0) {
+		mpBlock = VtoBlockPtr(new VtoBlock(aSize));
+		mpData = mpBlock->Data();
+	}
 }
 
 VtoData::VtoData(VtoDataType aType) :
-	mSize(0), mType(aType)
+	mpData(NULL), mSize(0), mType(aType)
 {}
 
 VtoData::VtoData(const boost::uint8_t* apValue, size_t aSize) :
-	mType(VTODT_DATA)
+	mpData(NULL), mSize(0), mType(VTODT_DATA)
 {
 	this->Copy(apValue, aSize);
 }
 
+VtoData::VtoData(const VtoBlockPtr& arBlock, boost::uint8_t* apData, size_t aSize) :
+	mpData(apData), mpBlock(arBlock), mSize(aSize), mType(VTODT_DATA)
+{
+	assert(aSize <= MAX_SIZE);
+}
+
 size_t VtoData::GetSize() const
 {
 	return this->mSize;
@@ -69,8 +79,47 @@ VtoDataType VtoData::GetType() const
 void VtoData::Copy(const boost::uint8_t* apValue, size_t aSize)
 {
 	assert(aSize <= MAX_SIZE);
-	memcpy(this->mpData, apValue, aSize);
-	this->mSize = aSize;
+	*this = VtoData(aSize);
+	if(aSize > 0) memcpy(this->mpData, apValue, aSize);
+}
+
+VtoByteRing::VtoByteRing(size_t aBlockSize) :
+	mBlockSize(aBlockSize),
+	mCurrent(0),
+	mPos(0)
+{
+	assert(aBlockSize >= VtoData::MAX_SIZE);
+}
+
+VtoData VtoByteRing::Copy(const boost::uint8_t* apData, size_t aSize)
+{
+	assert(aSize <= VtoData::MAX_SIZE);
+	if(mBlocks.empty() || (mPos + aSize) > mBlockSize) this->Advance();
+
+	VtoBlockPtr& block = mBlocks[mCurrent];
+	boost::uint8_t* pos = block->Data() + mPos;
+	if(aSize > 0) memcpy(pos, apData, aSize);
+	mPos += aSize;
+
+	return VtoData(block, pos, aSize);
+}
+
+void VtoByteRing::Advance()
+{
+	// look for the next block whose chunks have all been released, finishing with the current one
+	for(size_t i = 1; i <= mBlocks.size(); ++i) {
+		size_t next = (mCurrent + i) % mBlocks.size();
+		if(mBlocks[next]->NumUses() == 1) {	// the ring's own use
+			mCurrent = next;
+			mPos = 0;
+			return;
+		}
+	}
+
+	// every block still has chunks in flight
+	mBlocks.push_back(VtoBlockPtr(new VtoBlock(mBlockSize)));
+	mCurrent = mBlocks.size() - 1;
+	mPos = 0;
 }
 }
 
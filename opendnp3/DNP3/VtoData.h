@@ -19,8 +19,13 @@
 #define __VTO_DATA_H_
 
 #include <opendnp3/APL/Types.h>
+#include <opendnp3/APL/Uncopyable.h>
 
+#include <boost/intrusive_ptr.hpp>
+
+#include <atomic>
 #include <string>
+#include <vector>
 
 namespace apl
 {
@@ -36,6 +41,58 @@ enum VtoDataType {
 
 std::string VtoDataTypeToString(VtoDataType aType);
 
+/**
+ * Bytes shared by the chunks of a VTO stream.
+ *
+ * Every VtoData that refers to the block holds a use, and gives it back when
+ * it is destroyed, on whatever thread that happens. The block is deleted when
+ * its last use is released.
+ */
+class VtoBlock : private Uncopyable
+{
+public:
+
+	VtoBlock(size_t aSize) : mBytes(aSize), mUses(0) {}
+
+	boost::uint8_t* Data() {
+		return &mBytes[0];
+	}
+
+	/// Number of uses that haven't been released, the bytes of every released chunk are visible afterwards
+	size_t NumUses() const {
+		return mUses.load(std::memory_order_acquire);
+	}
+
+private:
+
+	friend void intrusive_ptr_add_ref(VtoBlock*);
+	friend void intrusive_ptr_release(VtoBlock*);
+
+	std::vector<boost::uint8_t> mBytes;
+
+	std::atomic<size_t> mUses;
+};
+
+inline void intrusive_ptr_add_ref(VtoBlock* apBlock)
+{
+	apBlock->mUses.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void intrusive_ptr_release(VtoBlock* apBlock)
+{
+	if(apBlock->mUses.fetch_sub(1, std::memory_order_acq_rel) == 1) delete apBlock;
+}
+
+typedef boost::intrusive_ptr<VtoBlock> VtoBlockPtr;
+
+/**
+ * A chunk of at most MAX_SIZE bytes of a VTO stream.
+ *
+ * The bytes live in a reference counted block that is normally shared with
+ * the other chunks of the stream (see VtoByteRing), so passing a VtoData
+ * through the writer queue, the event buffers and the router only copies a
+ * reference. The bytes must not be modified once the chunk has been copied.
+ */
 class VtoData
 {
 public:
@@ -44,27 +101,73 @@ public:
 
 	VtoData();
 
+	/// Allocates a private block of aSize bytes that is filled through mpData
 	VtoData(size_t aSize);
 
 	VtoData(const boost::uint8_t* apValue, size_t aSize);
 
 	VtoData(VtoDataType aType);
 
+	/// Refers to aSize bytes at apData inside arBlock without copying them
+	VtoData(const VtoBlockPtr& arBlock, boost::uint8_t* apData, size_t aSize);
+
 	size_t GetSize() const;
 
 	VtoDataType GetType() const;
 
-
+	/// Replaces the contents with a copy of apValue held in a private block
 	void Copy(const boost::uint8_t* apValue, size_t aSize);
 
-	boost::uint8_t mpData[MAX_SIZE];
+	/// The bytes of the chunk, NULL if it has none
+	boost::uint8_t* mpData;
 
 private:
+
+	VtoBlockPtr mpBlock;
+
 	size_t mSize;
 
 	VtoDataType mType;
 };
 
+/**
+ * Carves VtoData chunks out of a ring of fixed size blocks.
+ *
+ * Chunks are allocated back to back from the current block. When it is full
+ * the ring moves on to the next block whose chunks have all been released,
+ * and only grows by a block if all of them are still in flight. Streaming data
+ * therefore costs a single copy into the ring and no allocations once the
+ * ring has reached the stream's high water mark.
+ *
+ * The owner must serialize calls to Copy(), the chunks themselves may be
+ * released from any thread.
+ */
+class VtoByteRing
+{
+public:
+
+	VtoByteRing(size_t aBlockSize = 4096);
+
+	/// Copies aSize bytes into the ring and returns the chunk that refers to them
+	VtoData Copy(const boost::uint8_t* apData, size_t aSize);
+
+	/// Number of blocks that the ring has allocated
+	size_t NumBlocks() const {
+		return mBlocks.size();
+	}
+
+private:
+
+	void Advance();
+
+	const size_t mBlockSize;
+
+	std::vector<VtoBlockPtr> mBlocks;
+
+	size_t mCurrent;
+
+	size_t mPos;
+};
 
 }
 
@@ -122,6 +122,13 @@ void VtoReader::Update(const VtoData& arData,
 	}
 }
 
+VtoData VtoReader::CopyData(const boost::uint8_t* apData, size_t aSize)
+{
+	assert( this->InProgress() );
+
+	return mRing.Copy(apData, aSize);
+}
+
 void VtoReader::_Start()
 {
 	mLock.Lock();
@@ -91,6 +91,19 @@ public:
 	 */
 	void Update(const VtoData& arData, boost::uint8_t aChannelId);
 
+	/**
+	 * Copies received object data into the reader's byte ring. The
+	 * returned chunk can be passed to Update() and queued by the
+	 * channel without being copied again. Must be called from within
+	 * a transaction block.
+	 *
+	 * @param apData			the object data
+	 * @param aSize				the size of the object data (in bytes)
+	 *
+	 * @return					the chunk holding the data
+	 */
+	VtoData CopyData(const boost::uint8_t* apData, size_t aSize);
+
 protected:
 
 	/**
@@ -117,6 +130,8 @@ private:
 	typedef std::map<boost::uint8_t, IVtoCallbacks*> ChannelMap;
 
 	ChannelMap mChannelMap;
+
+	VtoByteRing mRing;
 };
 
 }
@@ -35,8 +35,7 @@ VtoRouter::VtoRouter(const VtoRouterSettings& arSettings, Logger* apLogger, IVto
 	PhysicalLayerMonitor(apLogger, apPhysLayer, apTimerSrc, arSettings.OPEN_RETRY_MS),
 	IVtoCallbacks(arSettings.CHANNEL_ID),
 	mpVtoWriter(apWriter),
-	mReadBuffer(1024),
-	mWriteData(0)
+	mReadBuffer(1024)
 {
 	assert(apLogger != NULL);
 	assert(apWriter != NULL);
@@ -123,6 +122,7 @@ void VtoRouter::CheckForPhysWrite()
 		if(type == VTODT_DATA) {
 			// only write to the physical layer if we have a valid local connection
 			if(mpPhys->CanWrite()) {
+				// the chunk is written straight out of the ring it was received into
 				mWriteData = mPhysLayerTxBuffer.front();
 				mPhysLayerTxBuffer.pop();
 				mpPhys->AsyncWrite(mWriteData.mpData, mWriteData.GetSize());
@@ -192,7 +192,8 @@ private:
 	CopyableBuffer mReadBuffer;
 
 	/**
-	 * Buffer used to write to the physical layer
+	 * The chunk being written to the physical layer, holds a reference
+	 * to its bytes until the write has completed
 	 */
 	VtoData mWriteData;
 
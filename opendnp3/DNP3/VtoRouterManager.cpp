@@ -33,12 +33,13 @@ namespace apl
 namespace dnp
 {
 
-RouterRecord::RouterRecord(const std::string& arPortName, boost::shared_ptr<VtoRouter> apRouter, IVtoWriter* apWriter, IVtoReader *apReader, boost::uint8_t aVtoChannelId) :
+RouterRecord::RouterRecord(const std::string& arPortName, boost::shared_ptr<VtoRouter> apRouter, IVtoWriter* apWriter, IVtoReader *apReader, boost::uint8_t aVtoChannelId, ITimerSource* apTimerSrc) :
 	mPortName(arPortName),
 	mpRouter(apRouter),
 	mpWriter(apWriter),
 	mpReader(apReader),
-	mVtoChannelId(aVtoChannelId)
+	mVtoChannelId(aVtoChannelId),
+	mpTimerSrc(apTimerSrc)
 {
 
 }
@@ -46,8 +47,7 @@ RouterRecord::RouterRecord(const std::string& arPortName, boost::shared_ptr<VtoR
 VtoRouterManager::VtoRouterManager(Logger* apLogger, ITimerSource* apTimerSrc, IPhysicalLayerSource* apPhysSrc) :
 	Loggable(apLogger),
 	mpTimerSrc(apTimerSrc),
-	mpPhysSource(apPhysSrc),
-	mSuspendTimerSource(apTimerSrc)
+	mpPhysSource(apPhysSrc)
 {
 	assert(apTimerSrc != NULL);
 	assert(apPhysSrc != NULL);
@@ -57,28 +57,32 @@ VtoRouter* VtoRouterManager::StartRouter(
     const std::string& arPortName,
     const VtoRouterSettings& arSettings,
     IVtoWriter* apWriter,
-    IVtoReader* apReader)
+    IVtoReader* apReader,
+    ITimerSource* apTimerSrc,
+    boost::asio::io_service* apService)
 {
 	assert(apWriter != NULL);
 	assert(apReader != NULL);
 
-	IPhysicalLayerAsync* pPhys = mpPhysSource->AcquireLayer(arPortName);
+	if(apTimerSrc == NULL) apTimerSrc = mpTimerSrc;
+
+	IPhysicalLayerAsync* pPhys = (apService == NULL) ? mpPhysSource->AcquireLayer(arPortName) : mpPhysSource->AcquireLayer(arPortName, apService);
 	Logger* pLogger = this->GetSubLogger(arPortName, arSettings.CHANNEL_ID);
 
 	boost::shared_ptr<VtoRouter> pRouter;
 	if(arSettings.DISABLE_EXTENSIONS) {
-		pRouter.reset(new AlwaysOpeningVtoRouter(arSettings, pLogger, apWriter, pPhys, mpTimerSrc));
+		pRouter.reset(new AlwaysOpeningVtoRouter(arSettings, pLogger, apWriter, pPhys, apTimerSrc));
 	}
 	else {
 		if(arSettings.START_LOCAL) {
-			pRouter.reset(new ServerSocketVtoRouter(arSettings, pLogger, apWriter, pPhys, mpTimerSrc));
+			pRouter.reset(new ServerSocketVtoRouter(arSettings, pLogger, apWriter, pPhys, apTimerSrc));
 		}
 		else {
-			pRouter.reset(new ClientSocketVtoRouter(arSettings, pLogger, apWriter, pPhys, mpTimerSrc));
+			pRouter.reset(new ClientSocketVtoRouter(arSettings, pLogger, apWriter, pPhys, apTimerSrc));
 		}
 	}
 
-	RouterRecord record(arPortName, pRouter, apWriter, apReader, arSettings.CHANNEL_ID);
+	RouterRecord record(arPortName, pRouter, apWriter, apReader, arSettings.CHANNEL_ID, apTimerSrc);
 
 	this->mRecords.push_back(record);
 
@@ -159,7 +163,8 @@ void VtoRouterManager::StopRouter(VtoRouter* apRouter)
 		if(i->mpRouter.get() == apRouter) {
 
 			{
-				Transaction tr(&mSuspendTimerSource);
+				// pause the thread the router and its stack execute on
+				Transaction tr(this->GetSuspendTimerSource(i->mpTimerSrc));
 				i->mpWriter->RemoveVtoCallback(apRouter);
 				i->mpReader->RemoveVtoChannel(apRouter);
 				i->mpRouter->Shutdown();
@@ -175,6 +180,16 @@ void VtoRouterManager::StopRouter(VtoRouter* apRouter)
 	throw ArgumentException(LOCATION, "Router could not be found in vector");
 }
 
+SuspendTimerSource* VtoRouterManager::GetSuspendTimerSource(ITimerSource* apTimerSrc)
+{
+	SuspendMap::iterator i = mSuspendMap.find(apTimerSrc);
+	if(i != mSuspendMap.end()) return i->second.get();
+
+	boost::shared_ptr<SuspendTimerSource> pSuspend(new SuspendTimerSource(apTimerSrc));
+	mSuspendMap[apTimerSrc] = pSuspend;
+	return pSuspend.get();
+}
+
 Logger* VtoRouterManager::GetSubLogger(const std::string& arId, boost::uint8_t aVtoChannelId)
 {
 	std::ostringstream oss;
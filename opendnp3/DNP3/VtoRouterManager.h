@@ -24,6 +24,7 @@
 #include <opendnp3/APL/Types.h>
 
 #include <boost/shared_ptr.hpp>
+#include <map>
 #include <vector>
 
 namespace apl
@@ -55,13 +56,14 @@ class IVtoDataHandler;
 class RouterRecord
 {
 public:
-	RouterRecord(const std::string& arPortName, boost::shared_ptr<VtoRouter> apRouter, IVtoWriter* apWriter, IVtoReader *apReader, boost::uint8_t aVtoChannelId);
+	RouterRecord(const std::string& arPortName, boost::shared_ptr<VtoRouter> apRouter, IVtoWriter* apWriter, IVtoReader *apReader, boost::uint8_t aVtoChannelId, ITimerSource* apTimerSrc);
 
 	std::string mPortName;
 	boost::shared_ptr<VtoRouter> mpRouter;
 	IVtoWriter* mpWriter;
 	IVtoReader* mpReader;
 	boost::uint8_t mVtoChannelId;
+	ITimerSource* mpTimerSrc;
 };
 
 typedef std::vector<RouterRecord> RouterRecordVector;
@@ -74,11 +76,20 @@ public:
 
 	VtoRouterManager(Logger* apLogger, ITimerSource* apTimerSrc, IPhysicalLayerSource* apPhysSrc);
 
+	/**
+		Starts a router between a stack and a physical layer. The router must
+		execute on the same thread as the stack it is attached to, so callers
+		that run stacks on several io_services pass the stack's timer source and
+		io_service. NULL selects the manager's timer source and the physical
+		layer source's default io_service.
+	*/
 	VtoRouter* StartRouter(
 	        const std::string& arPortName,
 	        const VtoRouterSettings& arSettings,
 	        IVtoWriter* apWriter,
-	        IVtoReader* apReader);
+	        IVtoReader* apReader,
+	        ITimerSource* apTimerSrc = NULL,
+	        boost::asio::io_service* apService = NULL);
 
 	void StopRouter(IVtoWriter* apWriter, boost::uint8_t aVtoChannelId);
 	void StopAllRoutersOnWriter(IVtoWriter* apWriter);
@@ -100,7 +111,12 @@ private:
 
 	ITimerSource* mpTimerSrc;
 	IPhysicalLayerSource* mpPhysSource;
-	SuspendTimerSource mSuspendTimerSource;
+
+	// suspending the thread a router executes on requires an object that outlives the transaction
+	SuspendTimerSource* GetSuspendTimerSource(ITimerSource* apTimerSrc);
+
+	typedef std::map< ITimerSource*, boost::shared_ptr<SuspendTimerSource> > SuspendMap;
+	SuspendMap mSuspendMap;
 };
 
 }
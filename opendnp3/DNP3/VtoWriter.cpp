@@ -110,10 +110,11 @@ void VtoWriter::QueueVtoObject(const boost::uint8_t* apData,
                                boost::uint8_t aChannelId)
 {
 	/*
-	 * Create a new VtoData instance, set the event data associated
+	 * Copy the data into the ring, set the event data associated
 	 * with it, and then push the object onto the transmission queue.
+	 * From here on the chunk is only passed around by reference.
 	 */
-	VtoData vto(apData, aLength);
+	VtoData vto = mRing.Copy(apData, aLength);
 
 	VtoEvent evt(vto, PC_CLASS_1, aChannelId);
 	this->mQueue.push_back(evt);
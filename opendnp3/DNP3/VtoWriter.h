@@ -144,6 +144,11 @@ private:
 
 	const size_t mMaxVtoChunks;
 
+	/**
+	 * Holds the bytes of the queued chunks, protected by mLock
+	 */
+	VtoByteRing mRing;
+
 	typedef std::set<IVtoCallbacks*> CallbackSet;
 	CallbackSet mCallbacks;
 };